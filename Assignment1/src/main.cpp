@@ -2,11 +2,21 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <AsyncSSD1306.h>
+#include <FastText.h>
+#include <SpanRaster.h>
+#include <IsrProf.h>
 
 // ========== DISPLAY SETUP ==========
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+#define OLED_BUS_HZ 400000UL  // fast mode, panel is rated for it
+// display() only queues the frame, a background task pushes it over I2C
+AsyncSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, OLED_BUS_HZ);
+// Pre-rasterized glyphs, prints straight into the frame buffer
+FastText text(display);
+// Border drawn as byte spans, not pixel by pixel
+SpanRaster raster(display);
 
 // ========== PIN DEFINITIONS ==========
 const uint8_t LED_RED    = 12;
@@ -39,10 +49,16 @@ volatile uint32_t lastHomePress = 0;
 // ========== ANIMATION TIMERS ==========
 uint32_t animationTimer = 0;
 uint32_t displayTimer = 0;
+uint32_t statsTimer = 0;
 bool blinkState = false;
 
 // ========== BUTTON INTERRUPT HANDLERS ==========
+// Run time per ISR (bounces included), send 'p' to print, 'r' to reset
+IsrProbe cycleProbe("btn cycle");
+IsrProbe homeProbe("btn home");
+
 void IRAM_ATTR handleCycleButton() {
+  IsrScope scope(cycleProbe);
   uint32_t now = millis();
   if (now - lastCyclePress > 250) {  // 250ms debounce
     requestModeChange = true;
@@ -51,6 +67,7 @@ void IRAM_ATTR handleCycleButton() {
 }
 
 void IRAM_ATTR handleHomeButton() {
+  IsrScope scope(homeProbe);
   uint32_t now = millis();
   if (now - lastHomePress > 250) {  // 250ms debounce
     requestReset = true;
@@ -85,75 +102,86 @@ uint8_t calculateBreathingValue() {
 // ========== DISPLAY UPDATE ==========
 void updateDisplay() {
   display.clearDisplay();
-  display.drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SSD1306_WHITE);
-  display.setTextColor(SSD1306_WHITE);
+  raster.drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SSD1306_WHITE);
+  text.setTextColor(SSD1306_WHITE);
 
   // Title
-  display.setTextSize(1);
-  display.setCursor(35, 8);
-  display.print("~ MODE ~");
+  text.setTextSize(1);
+  text.setCursor(35, 8);
+  text.print("~ MODE ~");
 
   // Mode name (large text)
-  display.setTextSize(2);
-  display.setCursor(15, 24);
+  text.setTextSize(2);
+  text.setCursor(15, 24);
   
   // Emoticon (small text)
-  display.setTextSize(1);
-  display.setCursor(85, 28);
+  text.setTextSize(1);
+  text.setCursor(85, 28);
 
   switch(currentMode) {
     case MODE_SLEEP:
-      display.setCursor(15, 24);
-      display.setTextSize(2);
-      display.print("SLEEP");
-      display.setTextSize(1);
-      display.setCursor(85, 28);
-      display.print("Zzz");
+      text.setCursor(15, 24);
+      text.setTextSize(2);
+      text.print("SLEEP");
+      text.setTextSize(1);
+      text.setCursor(85, 28);
+      text.print("Zzz");
       break;
 
     case MODE_DANCE:
-      display.setCursor(15, 24);
-      display.setTextSize(2);
-      display.print("BLINK");
-      display.setTextSize(1);
-      display.setCursor(85, 28);
-      display.print(blinkState ? "(^_^)" : "(-_-)");
+      text.setCursor(15, 24);
+      text.setTextSize(2);
+      text.print("BLINK");
+      text.setTextSize(1);
+      text.setCursor(85, 28);
+      text.print(blinkState ? "(^_^)" : "(-_-)");
       break;
 
     case MODE_PARTY:
-      display.setCursor(15, 24);
-      display.setTextSize(2);
-      display.print("PARTY!");
-      display.setTextSize(1);
-      display.setCursor(85, 28);
-      display.print("(*_*)");
+      text.setCursor(15, 24);
+      text.setTextSize(2);
+      text.print("PARTY!");
+      text.setTextSize(1);
+      text.setCursor(85, 28);
+      text.print("(*_*)");
       break;
 
     case MODE_BREATHE:
-      display.setCursor(15, 24);
-      display.setTextSize(2);
-      display.print("CHILL");
-      display.setTextSize(1);
-      display.setCursor(85, 28);
-      display.print("(^_^)");
+      text.setCursor(15, 24);
+      text.setTextSize(2);
+      text.print("CHILL");
+      text.setTextSize(1);
+      text.setCursor(85, 28);
+      text.print("(^_^)");
       break;
   }
 
   // Footer
-  display.setCursor(5, 50);
-  display.print("[");
-  display.print((int)currentMode);
-  display.print("/3] Press to cycle");
+  text.setCursor(5, 50);
+  text.print("[");
+  text.print((int)currentMode);
+  text.print("/3] Press to cycle");
 
   display.display();
 }
 
+// ========== DISPLAY STATS ==========
+void printDisplayStats() {
+  AsyncSSD1306Stats s = display.stats();
+  Serial.printf("OLED: frames=%lu dropped=%lu push last=%lu avg=%lu max=%lu us @%lu Hz, errors=%lu\n",
+                (unsigned long)s.frames, (unsigned long)s.dropped,
+                (unsigned long)s.lastPushUs, (unsigned long)s.avgPushUs,
+                (unsigned long)s.maxPushUs, (unsigned long)s.busHz,
+                (unsigned long)s.i2cErrors);
+}
+
 // ========== SETUP ==========
 void setup() {
   Serial.begin(115200);
 
   // Initialize display
   display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  text.begin();  // sizes 1 and 2, ~2.8 KB
 
   // Setup PWM channels
   ledcSetup(PWM_RED_CH, 5000, 8);      // 5kHz frequency, 8-bit resolution
@@ -232,6 +260,17 @@ void loop() {
     displayTimer = now;
     updateDisplay();
   }
+
+  if (now - statsTimer >= 10000) {
+    statsTimer = now;
+    printDisplayStats();
+  }
+
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'p') IsrProbe::printAll(Serial);
+    if (c == 'r') IsrProbe::resetAll();
+  }
 }
 
 
@@ -0,0 +1,92 @@
+// updateDisplay() for every mode against golden PBMs: pio test -e native
+// SSD1306_EMU_UPDATE_GOLDEN=1 pio test -e native rewrites them after
+// an intended change (look at them before committing).
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <AsyncSSD1306.h>
+#include <SSD1306Emu.h>
+
+extern AsyncSSD1306 display;
+extern volatile bool requestModeChange;
+extern volatile bool requestReset;
+extern bool blinkState;
+void setup();
+void loop();
+void updateDisplay();
+
+// golden/<name>.pbm next to this file
+static const char* golden(const char* name) {
+  static char path[512];
+  const char* slash = strrchr(__FILE__, '/');
+  int dir = slash ? (int)(slash - __FILE__ + 1) : 0;
+  snprintf(path, sizeof(path), "%.*sgolden/%s.pbm", dir, __FILE__, name);
+  return path;
+}
+
+// Next mode the way the cycle button gets there
+static void nextMode() {
+  requestModeChange = true;
+  loop();
+}
+
+void setUp() {
+  requestReset = true;
+  loop();
+  blinkState = false;
+}
+
+void tearDown() {}
+
+void test_sleep() {
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("sleep")));
+}
+
+// Both faces of the blink mode
+void test_dance() {
+  nextMode();
+  blinkState = false;
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("dance")));
+
+  blinkState = true;
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("dance_blink")));
+}
+
+void test_party() {
+  nextMode();
+  nextMode();
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("party")));
+}
+
+void test_breathe() {
+  nextMode();
+  nextMode();
+  nextMode();
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("breathe")));
+}
+
+// A fourth press wraps back to sleep
+void test_cycle_wraps_to_sleep() {
+  for (uint8_t i = 0; i < 4; i++) nextMode();
+  updateDisplay();
+  TEST_ASSERT_EQUAL(0, emuDiffPbm(display, golden("sleep")));
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_sleep);
+  RUN_TEST(test_dance);
+  RUN_TEST(test_party);
+  RUN_TEST(test_breathe);
+  RUN_TEST(test_cycle_wraps_to_sleep);
+  return UNITY_END();
+}
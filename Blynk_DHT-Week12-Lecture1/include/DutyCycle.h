@@ -0,0 +1,52 @@
+/****************************************************
+ * DutyCycle
+ * Battery mode: wake from deep sleep, take one reading,
+ * keep it in RTC slow memory and go back to sleep.
+ * Wi-Fi is only started to flush a whole batch.
+ *
+ * RTC slow memory survives deep sleep but not a power
+ * cycle, so a cold boot starts with an empty ring.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#define DUTY_RING_SIZE 48
+
+struct DutySample {
+  uint32_t epochS;     // wall clock, 0 if NTP never synced
+  int16_t  tempX10;    // 0.1 C
+  uint16_t humX10;     // 0.1 %
+};
+
+struct DutyCycleStats {
+  uint32_t cycles;        // wakes since cold boot
+  uint32_t flushes;
+  uint32_t dropped;       // ring overflowed (flushes kept failing)
+  uint32_t lastActiveUs;  // wake -> sleep of the previous cycle
+  uint32_t maxActiveUs;
+  uint32_t avgActiveUs;
+};
+
+// Call first thing in setup(). Returns true on a cold boot.
+bool dutyCycleBegin();
+
+// Woken by the button rather than the timer
+bool dutyCycleWokeByButton();
+
+// Stores a reading. Returns true if it is time to flush:
+// ring has `batch` samples, or temp/hum moved past the thresholds
+// since the last flush.
+bool dutyCycleAppend(float t, float h, uint16_t batch,
+                     float tempThreshold, float humThreshold);
+
+uint16_t dutyCycleCount();
+DutySample dutyCycleAt(uint16_t i);   // 0 = oldest
+void dutyCycleFlushed();              // ring was uploaded
+
+DutyCycleStats dutyCycleStats();
+
+// Records this cycle's active time (from app start, the ROM boot
+// before that isn't counted) and enters deep sleep.
+// wakePin < 0 or not an RTC GPIO -> timer wake only.
+void dutyCycleSleep(uint32_t sleepMs, int wakePin);
@@ -0,0 +1,39 @@
+/****************************************************
+ * LittleFsSpillStore
+ * SpillStore for OfflineQueue backed by one LittleFS file.
+ * Samples are appended as raw records, a read offset marks
+ * what has been replayed. The file is deleted once empty;
+ * while a backlog lasts, the replayed front is cut off
+ * (copy the rest to a new file) once it reaches a quarter
+ * of maxSamples, so the file stays under 1.25 x maxSamples
+ * records.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "OfflineQueue.h"
+
+class LittleFsSpillStore : public SpillStore {
+public:
+  LittleFsSpillStore(const char* path, uint32_t maxSamples)
+    : _path(path), _maxSamples(maxSamples), _readPos(0), _size(0) {}
+
+  // Mount LittleFS and start from an empty file
+  bool begin();
+
+  bool     append(const QueuedSample* samples, uint16_t count) override;
+  uint16_t peek(QueuedSample* out, uint16_t max) override;
+  void     pop(uint16_t count) override;
+  uint32_t size() const override { return _size; }
+  void     clear() override;
+
+private:
+  bool compact();
+
+  const char* _path;
+  uint32_t    _maxSamples;
+  uint32_t    _readPos;   // byte offset of the oldest unsent record
+  uint32_t    _size;      // records not replayed yet
+};
@@ -0,0 +1,126 @@
+/****************************************************
+ * MqttClient
+ * Minimal MQTT 3.1.1 publisher (no Blynk cloud needed).
+ *
+ *  - QoS 0 and QoS 1 publish
+ *  - persistent session (clean session = 0): unacked QoS 1
+ *    messages are re-sent with DUP after a reconnect, in
+ *    the order they were first published
+ *  - pipelined: publish() never waits for PUBACK, up to
+ *    MAX_IN_FLIGHT messages may be unacknowledged
+ *  - keep-alive PINGREQ, an ack or ping timeout closes the
+ *    connection so the caller reconnects
+ *  - inbound PUBLISH (persistent session deliveries) is
+ *    acked and dropped, also when it is bigger than the
+ *    receive buffer
+ *
+ * The socket is behind MqttTransport and the clock is a
+ * function pointer, so the client also runs on a PC
+ * against a local mosquitto broker (PosixSocketTransport).
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MqttTransport {
+public:
+  virtual ~MqttTransport() {}
+  virtual bool   open(const char* host, uint16_t port) = 0;
+  virtual void   close() = 0;
+  virtual bool   isOpen() = 0;
+  virtual size_t write(const uint8_t* data, size_t len) = 0;
+  // Non-blocking, returns 0 if nothing is available
+  virtual int    read(uint8_t* buf, size_t max) = 0;
+};
+
+typedef uint32_t (*MqttClockFn)();
+
+struct MqttStats {
+  uint32_t connects;
+  uint32_t published;     // publish() calls accepted
+  uint32_t acked;         // PUBACKs received
+  uint32_t resent;        // QoS 1 messages re-sent after reconnect
+  uint32_t rejected;      // publish() refused (window full / too big / offline)
+  uint32_t bytesOut;
+  uint32_t bytesIn;
+  uint32_t oversize;      // inbound packets bigger than MAX_PACKET, body skipped
+  uint8_t  maxInFlight;
+};
+
+class MqttClient {
+public:
+  static const uint8_t  MAX_IN_FLIGHT = 8;
+  static const uint16_t MAX_PACKET    = 128;
+
+  MqttClient(MqttTransport& transport, MqttClockFn clock);
+
+  void setServer(const char* host, uint16_t port) { _host = host; _port = port; }
+  void setKeepAlive(uint16_t seconds) { _keepAliveS = seconds; }
+  void setAckTimeout(uint32_t ms) { _ackTimeoutMs = ms; }
+
+  // Blocks until CONNACK or timeout
+  bool connect(const char* clientId, bool cleanSession = false,
+               const char* user = nullptr, const char* pass = nullptr,
+               uint32_t timeoutMs = 5000);
+  bool connected();
+  void disconnect();
+
+  // Returns false if the message was not queued for sending
+  bool publish(const char* topic, const uint8_t* payload, uint16_t len,
+               uint8_t qos = 0, bool retain = false);
+
+  // Call often: reads acks, sends keep-alives
+  void loop();
+
+  uint8_t inFlight() const { return _inFlightCount; }
+  const MqttStats& stats() const { return _stats; }
+
+private:
+  struct InFlight {
+    bool     used;
+    uint16_t id;
+    uint16_t len;
+    uint32_t seq;         // publish order, slots are reused out of order
+    uint32_t sentMs;
+    uint8_t  packet[MAX_PACKET];
+  };
+
+  enum RxState { RX_HEADER, RX_LENGTH, RX_BODY };
+
+  bool     send(const uint8_t* data, size_t len);
+  void     feed(uint8_t b);
+  void     handlePacket(uint8_t header, const uint8_t* body, uint16_t len);
+  void     resendInFlight();
+  uint16_t nextPacketId();
+  void     dropConnection();
+
+  MqttTransport& _transport;
+  MqttClockFn    _clock;
+  const char*    _host;
+  uint16_t       _port;
+  uint16_t       _keepAliveS;
+  uint32_t       _ackTimeoutMs;
+
+  bool     _connected;
+  bool     _connAck;
+  bool     _pingOutstanding;
+  uint32_t _lastOutMs;
+  uint32_t _pingSentMs;
+  uint16_t _packetId;
+  uint32_t _publishSeq;
+
+  InFlight _inFlight[MAX_IN_FLIGHT];
+  uint8_t  _inFlightCount;
+
+  RxState  _rxState;
+  uint8_t  _rxHeader;
+  uint32_t _rxLength;
+  uint32_t _rxMultiplier;
+  uint32_t _rxPos;
+  uint16_t _rxTopicLen;   // PUBLISH: parsed as the bytes arrive, so the
+  uint16_t _rxPacketId;   // id is known even if the packet doesn't fit
+  uint8_t  _rxBuf[MAX_PACKET];
+
+  MqttStats _stats;
+};
@@ -0,0 +1,96 @@
+/****************************************************
+ * OfflineQueue
+ * Store-and-forward buffer for readings taken while
+ * Blynk is disconnected.
+ *
+ *  - bounded RAM ring, oldest samples are dropped when full
+ *  - optional SpillStore (flash): instead of dropping, the
+ *    oldest half of the ring is moved to flash
+ *  - drain() replays the backlog in small batches with a
+ *    minimum gap, so live traffic still gets through
+ *  - if the flash can't be read back, its samples are
+ *    counted as dropped and the RAM ring drains on
+ *
+ * Like TelemetryPublisher it has no Arduino dependency.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+struct QueuedSample {
+  uint32_t timestampMs;  // millis() when the reading was taken
+  uint8_t  pin;
+  float    value;
+};
+
+// Flash (or any other) overflow storage. Always holds the OLDEST samples.
+class SpillStore {
+public:
+  virtual ~SpillStore() {}
+  virtual bool     append(const QueuedSample* samples, uint16_t count) = 0;
+  // Copies up to `max` oldest samples without removing them
+  virtual uint16_t peek(QueuedSample* out, uint16_t max) = 0;
+  // Removes the `count` oldest samples
+  virtual void     pop(uint16_t count) = 0;
+  // Forgets everything, for when peek() can't read what size() claims
+  virtual void     clear() = 0;
+  virtual uint32_t size() const = 0;
+};
+
+// Replays one batch, oldest first. Returns how many samples from the
+// front of the batch went out, 0 to retry the whole batch later.
+typedef uint16_t (*QueueSendFn)(const QueuedSample* samples, uint16_t count, void* ctx);
+
+struct OfflineQueueStats {
+  uint32_t depth;        // RAM + flash
+  uint16_t ramDepth;
+  uint32_t spillDepth;
+  uint32_t queued;       // samples accepted by push()
+  uint32_t dropped;      // samples lost (RAM full / flash failed / flash unreadable)
+  uint32_t spilled;      // samples moved to flash
+  uint32_t drained;      // samples replayed
+  float    drainRate;    // samples/s over the current backlog
+};
+
+class OfflineQueue {
+public:
+  static const uint16_t MAX_BATCH = 32;
+
+  // `storage` must hold `capacity` samples and outlive the queue
+  OfflineQueue(QueuedSample* storage, uint16_t capacity, SpillStore* spill = nullptr);
+
+  void setDrainRate(uint16_t maxPerBatch, uint32_t minBatchGapMs);
+
+  void push(const QueuedSample& sample);
+
+  // Sends at most one batch if the gap since the last one has passed.
+  // Returns the number of samples replayed.
+  uint16_t drain(uint32_t nowMs, QueueSendFn send, void* ctx = nullptr);
+
+  uint32_t depth() const;
+  bool     empty() const { return depth() == 0; }
+  OfflineQueueStats stats(uint32_t nowMs) const;
+
+private:
+  void     spillOldest();
+  uint16_t peekRam(QueuedSample* out, uint16_t max) const;
+  void     popRam(uint16_t count);
+
+  QueuedSample* _buf;
+  uint16_t      _capacity;
+  uint16_t      _head;    // oldest
+  uint16_t      _count;
+  SpillStore*   _spill;
+
+  uint16_t _maxPerBatch;
+  uint32_t _minGapMs;
+  uint32_t _lastBatchMs;
+  bool     _draining;
+  uint32_t _burstStartMs;
+  uint32_t _burstDrained;
+
+  uint32_t _queued;
+  uint32_t _dropped;
+  uint32_t _spilled;
+  uint32_t _drained;
+};
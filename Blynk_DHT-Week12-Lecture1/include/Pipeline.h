@@ -0,0 +1,56 @@
+/****************************************************
+ * Pipeline
+ * Small helpers for the sensor -> display / network
+ * FreeRTOS task pipeline in main.cpp.
+ *
+ *  - Sample: what the sensor task puts in the queues
+ *  - pipelineSend(): queue send with a backpressure policy
+ *  - StageStats / QueueStats: per-stage latency and queue
+ *    high-water marks, printed by printPipelineStats()
+ *
+ * Each stats struct is written by exactly one task, other
+ * tasks only read it (32-bit reads are atomic on the ESP32).
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+struct Sample {
+  uint32_t takenUs;      // micros() when the DHT read finished
+  float    temperature;
+  float    humidity;
+  bool     valid;        // false -> DHT read failed
+  bool     manual;       // triggered by the button
+};
+
+// What to do when a consumer's queue is full
+enum BackpressurePolicy {
+  BP_DROP_NEWEST,   // keep the backlog, lose this sample
+  BP_DROP_OLDEST,   // keep the newest, lose the oldest queued one
+  BP_BLOCK          // wait up to blockTicks, then drop this sample
+};
+
+struct QueueStats {
+  uint32_t sent;
+  uint32_t dropped;
+  uint32_t highWater;   // most items ever waiting at once
+  uint32_t length;      // queue capacity
+};
+
+struct StageStats {
+  uint32_t count;
+  uint32_t serviceSumUs;   // time spent doing the stage's work
+  uint32_t serviceMaxUs;
+  uint32_t waitSumUs;      // sample age when the stage picked it up
+  uint32_t waitMaxUs;
+};
+
+bool pipelineSend(QueueHandle_t q, const Sample& s, BackpressurePolicy policy,
+                  TickType_t blockTicks, QueueStats& stats);
+
+void recordStage(StageStats& stats, uint32_t waitUs, uint32_t serviceUs);
+
+void printStageStats(const char* name, const StageStats& stats);
+void printQueueStats(const char* name, const QueueStats& stats);
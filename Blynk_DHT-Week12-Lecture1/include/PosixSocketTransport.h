@@ -0,0 +1,78 @@
+/****************************************************
+ * PosixSocketTransport
+ * MqttTransport over a BSD socket, for the native env:
+ * the same MqttClient against a broker on the PC
+ * (test_mqtt_broker, tools/bench/mqtt_bench.cpp).
+ * Not for the board, it has WiFiClientTransport.
+ ****************************************************/
+#pragma once
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "MqttClient.h"
+
+class PosixSocketTransport : public MqttTransport {
+public:
+  ~PosixSocketTransport() override { close(); }
+
+  bool open(const char* host, uint16_t port) override {
+    close();
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* list = nullptr;
+    if (getaddrinfo(host, service, &hints, &list) != 0) return false;
+
+    for (addrinfo* a = list; a && _fd < 0; a = a->ai_next) {
+      _fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (_fd < 0) continue;
+      if (::connect(_fd, a->ai_addr, a->ai_addrlen) != 0) close();
+    }
+    freeaddrinfo(list);
+    if (_fd < 0) return false;
+
+    int one = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));  // like setNoDelay()
+    return true;
+  }
+
+  void close() override {
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+  }
+
+  bool isOpen() override { return _fd >= 0; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t done = 0;
+    while (_fd >= 0 && done < len) {
+      ssize_t n = ::send(_fd, data + done, len - done, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        close();
+        break;
+      }
+      done += n;
+    }
+    return done;
+  }
+
+  int read(uint8_t* buf, size_t max) override {
+    if (_fd < 0) return 0;
+    ssize_t n = recv(_fd, buf, max, MSG_DONTWAIT);
+    if (n > 0) return (int)n;
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) close();  // peer closed
+    return 0;
+  }
+
+private:
+  int _fd = -1;
+};
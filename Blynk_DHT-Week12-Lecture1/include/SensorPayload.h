@@ -0,0 +1,136 @@
+/****************************************************
+ * SensorPayload
+ * One MQTT publish = one reading, packed in 9 bytes
+ * (vs. two Blynk messages with text values):
+ *
+ *   [0]    version (1)
+ *   [1..2] temperature, int16 LE, 0.01 C
+ *   [3..4] humidity,    uint16 LE, 0.01 %
+ *   [5..8] timestamp,   uint32 LE, unix seconds (0 = unknown)
+ *
+ * A missing/NaN value is sent as the sentinel below.
+ ****************************************************/
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#define SENSOR_PAYLOAD_VERSION  1
+#define SENSOR_PAYLOAD_SIZE     9
+#define SENSOR_TEMP_MISSING     ((int16_t)0x8000)
+#define SENSOR_HUM_MISSING      ((uint16_t)0xFFFF)
+
+inline uint8_t encodeSensorPayload(uint8_t* out, float tempC, float humPct, uint32_t epochS) {
+  int16_t  t = isnan(tempC)  ? SENSOR_TEMP_MISSING : (int16_t)lroundf(tempC * 100.0f);
+  uint16_t h = isnan(humPct) ? SENSOR_HUM_MISSING  : (uint16_t)lroundf(humPct * 100.0f);
+
+  out[0] = SENSOR_PAYLOAD_VERSION;
+  out[1] = (uint16_t)t & 0xFF;
+  out[2] = (uint16_t)t >> 8;
+  out[3] = h & 0xFF;
+  out[4] = h >> 8;
+  out[5] = epochS & 0xFF;
+  out[6] = (epochS >> 8) & 0xFF;
+  out[7] = (epochS >> 16) & 0xFF;
+  out[8] = epochS >> 24;
+  return SENSOR_PAYLOAD_SIZE;
+}
+
+// Returns false on a wrong size or version
+inline bool decodeSensorPayload(const uint8_t* in, uint8_t len,
+                                float& tempC, float& humPct, uint32_t& epochS) {
+  if (len != SENSOR_PAYLOAD_SIZE || in[0] != SENSOR_PAYLOAD_VERSION) return false;
+
+  int16_t  t = (int16_t)(in[1] | (in[2] << 8));
+  uint16_t h = in[3] | (in[4] << 8);
+  tempC  = t == SENSOR_TEMP_MISSING ? NAN : t / 100.0f;
+  humPct = h == SENSOR_HUM_MISSING  ? NAN : h / 100.0f;
+  epochS = (uint32_t)in[5] | ((uint32_t)in[6] << 8) |
+           ((uint32_t)in[7] << 16) | ((uint32_t)in[8] << 24);
+  return true;
+}
+
+/****************************************************
+ * Window summary (SUMMARY_MODE), one publish per
+ * window on its own topic, 27 bytes:
+ *
+ *   [0]      version (2)
+ *   [1..2]   samples in the window, uint16 LE (the channel
+ *            with more valid readings)
+ *   [3..4]   window length, uint16 LE, seconds
+ *   [5..8]   window end, uint32 LE, unix seconds (0 = unknown)
+ *   [9..16]  temperature mean, min, max, stddev, int16 LE, 0.01 C
+ *   [17..24] humidity    mean, min, max, stddev, int16 LE, 0.01 %
+ *   [25]     temperature anomaly flags (StatFlags, OR of the window)
+ *   [26]     humidity anomaly flags
+ *
+ * A channel with no valid reading in the window has all
+ * four values set to the missing sentinel.
+ ****************************************************/
+
+#define SUMMARY_PAYLOAD_VERSION  2
+#define SUMMARY_PAYLOAD_SIZE     27
+
+struct SummaryChannel {
+  float   mean, min, max, stddev;
+  uint8_t flags;
+};
+
+inline void putSummaryValue(uint8_t* out, float v) {
+  int16_t x = isnan(v) ? SENSOR_TEMP_MISSING : (int16_t)lroundf(v * 100.0f);
+  out[0] = (uint16_t)x & 0xFF;
+  out[1] = (uint16_t)x >> 8;
+}
+
+inline float getSummaryValue(const uint8_t* in) {
+  int16_t x = (int16_t)(in[0] | (in[1] << 8));
+  return x == SENSOR_TEMP_MISSING ? NAN : x / 100.0f;
+}
+
+inline uint8_t encodeSummaryPayload(uint8_t* out, uint16_t count, uint16_t windowS, uint32_t epochS,
+                                    const SummaryChannel& temp, const SummaryChannel& hum) {
+  out[0] = SUMMARY_PAYLOAD_VERSION;
+  out[1] = count & 0xFF;
+  out[2] = count >> 8;
+  out[3] = windowS & 0xFF;
+  out[4] = windowS >> 8;
+  out[5] = epochS & 0xFF;
+  out[6] = (epochS >> 8) & 0xFF;
+  out[7] = (epochS >> 16) & 0xFF;
+  out[8] = epochS >> 24;
+
+  const SummaryChannel* ch[2] = { &temp, &hum };
+  for (uint8_t i = 0; i < 2; i++) {
+    uint8_t* p = out + 9 + i * 8;
+    putSummaryValue(p,     ch[i]->mean);
+    putSummaryValue(p + 2, ch[i]->min);
+    putSummaryValue(p + 4, ch[i]->max);
+    putSummaryValue(p + 6, ch[i]->stddev);
+  }
+  out[25] = temp.flags;
+  out[26] = hum.flags;
+  return SUMMARY_PAYLOAD_SIZE;
+}
+
+// Returns false on a wrong size or version
+inline bool decodeSummaryPayload(const uint8_t* in, uint8_t len, uint16_t& count, uint16_t& windowS,
+                                 uint32_t& epochS, SummaryChannel& temp, SummaryChannel& hum) {
+  if (len != SUMMARY_PAYLOAD_SIZE || in[0] != SUMMARY_PAYLOAD_VERSION) return false;
+
+  count   = in[1] | (in[2] << 8);
+  windowS = in[3] | (in[4] << 8);
+  epochS  = (uint32_t)in[5] | ((uint32_t)in[6] << 8) |
+            ((uint32_t)in[7] << 16) | ((uint32_t)in[8] << 24);
+
+  SummaryChannel* ch[2] = { &temp, &hum };
+  for (uint8_t i = 0; i < 2; i++) {
+    const uint8_t* p = in + 9 + i * 8;
+    ch[i]->mean   = getSummaryValue(p);
+    ch[i]->min    = getSummaryValue(p + 2);
+    ch[i]->max    = getSummaryValue(p + 4);
+    ch[i]->stddev = getSummaryValue(p + 6);
+  }
+  temp.flags = in[25];
+  hum.flags  = in[26];
+  return true;
+}
@@ -0,0 +1,32 @@
+/****************************************************
+ * StoreAndForward
+ * TelemetrySendFn that sends live while the backend is up
+ * and puts the frame into an OfflineQueue while it's down.
+ *
+ * While offline it returns TRUE: the frame has been taken
+ * over by the backlog (drain() replays it with its time),
+ * so TelemetryPublisher must count it as sent and move on.
+ * Returning false would keep the points pending and queue
+ * them again on every poll. Online, the result is the
+ * live transport's.
+ *
+ * No Arduino dependency: the link state and the clock are
+ * function pointers, like the transports.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#include "OfflineQueue.h"
+#include "TelemetryPublisher.h"
+
+struct StoreAndForward {
+  bool            (*online)();
+  TelemetrySendFn live;      // gets liveCtx
+  void*           liveCtx;
+  OfflineQueue*   queue;
+  uint32_t        (*clock)();  // ms, stamped on queued samples
+};
+
+// ctx is the StoreAndForward
+bool storeAndForwardSend(const TelemetryPoint* points, uint8_t count, void* ctx);
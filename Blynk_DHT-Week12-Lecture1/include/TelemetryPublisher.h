@@ -0,0 +1,81 @@
+/****************************************************
+ * TelemetryPublisher
+ * Report-on-change layer in front of Blynk.virtualWrite().
+ *
+ *  - per-channel deadband: small wiggles are not sent
+ *  - min interval: a channel is never sent faster than this
+ *  - max interval: heartbeat, last value is re-sent after this
+ *  - all channels due in one poll() go out as ONE frame
+ *
+ * No Arduino/Blynk dependency, the transport is a plain
+ * function pointer so it can run against a stub on the PC.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+// One value for one virtual pin
+struct TelemetryPoint {
+  uint8_t pin;
+  float   value;
+};
+
+// Sends `count` points as one batched frame.
+// Return false if the frame could not be sent (e.g. offline),
+// the points then stay pending and are retried on the next poll().
+typedef bool (*TelemetrySendFn)(const TelemetryPoint* points, uint8_t count, void* ctx);
+
+struct TelemetryStats {
+  uint32_t offered;       // update() calls
+  uint32_t suppressed;    // samples never sent (deadband / superseded)
+  uint32_t pointsSent;    // values that went out
+  uint32_t framesSent;    // batched messages that went out
+  uint32_t heartbeats;    // values re-sent only because of max interval
+  uint32_t sendFailures;  // frames the transport refused
+};
+
+class TelemetryPublisher {
+public:
+  static const uint8_t MAX_CHANNELS = 8;
+
+  TelemetryPublisher(TelemetrySendFn send, void* ctx = nullptr);
+
+  // Returns the channel index, or -1 if the table is full.
+  // maxIntervalMs = 0 disables the heartbeat.
+  int8_t addChannel(uint8_t pin, float deadband,
+                    uint32_t minIntervalMs, uint32_t maxIntervalMs);
+
+  // Offer a new sample for a channel (cheap, never sends).
+  void update(uint8_t channel, float value);
+
+  // Next poll() sends every channel that has a value (e.g. button press).
+  void forceAll();
+
+  // Sends all due channels in one frame. Returns number of points sent.
+  uint8_t poll(uint32_t nowMs);
+
+  const TelemetryStats& stats() const { return _stats; }
+  void resetStats();
+
+private:
+  struct Channel {
+    uint8_t  pin;
+    float    deadband;
+    uint32_t minIntervalMs;
+    uint32_t maxIntervalMs;
+
+    float    value;        // latest offered value
+    float    lastSent;     // last value that went out
+    uint32_t lastSentMs;
+    bool     hasValue;
+    bool     pending;      // value offered but not sent yet
+    bool     everSent;
+  };
+
+  TelemetrySendFn _send;
+  void*           _ctx;
+  Channel         _channels[MAX_CHANNELS];
+  uint8_t         _count;
+  bool            _force;
+  TelemetryStats  _stats;
+};
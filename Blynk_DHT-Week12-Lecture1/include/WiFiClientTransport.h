@@ -0,0 +1,28 @@
+/****************************************************
+ * WiFiClientTransport
+ * MqttTransport over the Arduino WiFiClient (TCP).
+ ****************************************************/
+#pragma once
+
+#include <WiFiClient.h>
+
+#include "MqttClient.h"
+
+class WiFiClientTransport : public MqttTransport {
+public:
+  bool open(const char* host, uint16_t port) override {
+    if (!_client.connect(host, port)) return false;
+    _client.setNoDelay(true);  // small publishes shouldn't wait for Nagle
+    return true;
+  }
+  void   close() override { _client.stop(); }
+  bool   isOpen() override { return _client.connected(); }
+  size_t write(const uint8_t* data, size_t len) override { return _client.write(data, len); }
+  int    read(uint8_t* buf, size_t max) override {
+    if (_client.available() <= 0) return 0;
+    return _client.read(buf, max);
+  }
+
+private:
+  WiFiClient _client;
+};
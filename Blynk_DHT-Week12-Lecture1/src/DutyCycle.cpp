@@ -0,0 +1,114 @@
+#include "DutyCycle.h"
+
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/rtc_io.h>
+#include <time.h>
+
+#define DUTY_MAGIC 0xD0C1C1E5
+
+// Everything here lives in RTC slow memory
+struct DutyCycleState {
+  uint32_t   magic;
+  DutySample ring[DUTY_RING_SIZE];
+  uint16_t   head;          // oldest
+  uint16_t   count;
+
+  int16_t    flushedTempX10;
+  uint16_t   flushedHumX10;
+  bool       everFlushed;
+
+  uint32_t   cycles;
+  uint32_t   flushes;
+  uint32_t   dropped;
+  uint32_t   lastActiveUs;
+  uint32_t   maxActiveUs;
+  uint64_t   sumActiveUs;
+};
+
+RTC_DATA_ATTR static DutyCycleState state;
+
+bool dutyCycleBegin() {
+  bool cold = state.magic != DUTY_MAGIC ||
+              esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UNDEFINED;
+  if (cold) {
+    memset(&state, 0, sizeof(state));
+    state.magic = DUTY_MAGIC;
+  }
+  state.cycles++;
+  return cold;
+}
+
+bool dutyCycleWokeByButton() {
+  return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0;
+}
+
+bool dutyCycleAppend(float t, float h, uint16_t batch,
+                     float tempThreshold, float humThreshold) {
+  DutySample s;
+  time_t now = time(nullptr);
+  s.epochS  = now > 1600000000 ? (uint32_t)now : 0;
+  s.tempX10 = (int16_t)lroundf(t * 10.0f);
+  s.humX10  = (uint16_t)lroundf(h * 10.0f);
+
+  if (state.count == DUTY_RING_SIZE) {
+    state.head = (state.head + 1) % DUTY_RING_SIZE;
+    state.count--;
+    state.dropped++;
+  }
+  state.ring[(state.head + state.count) % DUTY_RING_SIZE] = s;
+  state.count++;
+
+  if (!state.everFlushed || state.count >= batch) return true;
+
+  float dt = (s.tempX10 - state.flushedTempX10) / 10.0f;
+  float dh = ((int32_t)s.humX10 - (int32_t)state.flushedHumX10) / 10.0f;
+  return fabsf(dt) >= tempThreshold || fabsf(dh) >= humThreshold;
+}
+
+uint16_t dutyCycleCount() {
+  return state.count;
+}
+
+DutySample dutyCycleAt(uint16_t i) {
+  return state.ring[(state.head + i) % DUTY_RING_SIZE];
+}
+
+void dutyCycleFlushed() {
+  if (state.count > 0) {
+    DutySample last = dutyCycleAt(state.count - 1);
+    state.flushedTempX10 = last.tempX10;
+    state.flushedHumX10  = last.humX10;
+    state.everFlushed = true;
+  }
+  state.head = 0;
+  state.count = 0;
+  state.flushes++;
+}
+
+DutyCycleStats dutyCycleStats() {
+  DutyCycleStats s;
+  s.cycles       = state.cycles;
+  s.flushes      = state.flushes;
+  s.dropped      = state.dropped;
+  s.lastActiveUs = state.lastActiveUs;
+  s.maxActiveUs  = state.maxActiveUs;
+  // cycles counts the current one, which isn't finished yet
+  s.avgActiveUs  = state.cycles > 1 ? state.sumActiveUs / (state.cycles - 1) : 0;
+  return s;
+}
+
+void dutyCycleSleep(uint32_t sleepMs, int wakePin) {
+  if (wakePin >= 0 && rtc_gpio_is_valid_gpio((gpio_num_t)wakePin)) {
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)wakePin, 0);  // active LOW
+  }
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+
+  // esp_timer restarts at 0 on every wake from deep sleep
+  uint32_t active = (uint32_t)esp_timer_get_time();
+  state.lastActiveUs = active;
+  state.sumActiveUs += active;
+  if (active > state.maxActiveUs) state.maxActiveUs = active;
+
+  esp_deep_sleep_start();
+}
@@ -0,0 +1,99 @@
+#include "LittleFsSpillStore.h"
+
+bool LittleFsSpillStore::begin() {
+  if (!LittleFS.begin(true)) {  // format on first use
+    Serial.println("LittleFS mount failed, offline queue is RAM only");
+    return false;
+  }
+  LittleFS.remove(_path);
+  _readPos = 0;
+  _size = 0;
+  return true;
+}
+
+bool LittleFsSpillStore::append(const QueuedSample* samples, uint16_t count) {
+  if (_size + count > _maxSamples) return false;
+
+  File f = LittleFS.open(_path, FILE_APPEND);
+  if (!f) return false;
+
+  size_t bytes = count * sizeof(QueuedSample);
+  size_t written = f.write((const uint8_t*)samples, bytes);
+  f.close();
+  if (written != bytes) return false;
+
+  _size += count;
+  return true;
+}
+
+uint16_t LittleFsSpillStore::peek(QueuedSample* out, uint16_t max) {
+  if (_size == 0) return 0;
+  if (max > _size) max = _size;
+
+  File f = LittleFS.open(_path, FILE_READ);
+  if (!f) return 0;
+
+  f.seek(_readPos);
+  size_t got = f.read((uint8_t*)out, max * sizeof(QueuedSample));
+  f.close();
+  return got / sizeof(QueuedSample);
+}
+
+void LittleFsSpillStore::pop(uint16_t count) {
+  if (count > _size) count = _size;
+  _size -= count;
+  _readPos += count * sizeof(QueuedSample);
+
+  // Everything replayed: drop the file
+  if (_size == 0) {
+    clear();
+    return;
+  }
+
+  // Still a backlog: cut off the replayed front now and then. If that
+  // fails the file keeps its front and the next pop() tries again.
+  if (_readPos >= (_maxSamples / 4) * sizeof(QueuedSample)) compact();
+}
+
+void LittleFsSpillStore::clear() {
+  LittleFS.remove(_path);
+  _readPos = 0;
+  _size = 0;
+}
+
+// Copies the records not replayed yet to a new file that replaces the old one
+bool LittleFsSpillStore::compact() {
+  char tmpPath[32];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", _path);
+
+  File in = LittleFS.open(_path, FILE_READ);
+  if (!in || !in.seek(_readPos)) return false;
+  File out = LittleFS.open(tmpPath, FILE_WRITE);
+  if (!out) return false;
+
+  uint8_t buf[16 * sizeof(QueuedSample)];
+  size_t left = _size * sizeof(QueuedSample);
+  while (left > 0) {
+    size_t n = in.read(buf, left < sizeof(buf) ? left : sizeof(buf));
+    if (n == 0 || out.write(buf, n) != n) break;
+    left -= n;
+  }
+  in.close();
+  out.close();
+
+  if (left > 0) {
+    LittleFS.remove(tmpPath);
+    return false;
+  }
+  // begin() starts from an empty store anyway, so a reset between
+  // these two loses nothing that would have survived it
+  LittleFS.remove(_path);
+  if (!LittleFS.rename(tmpPath, _path)) {
+    LittleFS.remove(tmpPath);   // the old file is gone, so is the backlog
+    _readPos = 0;
+    _size = 0;
+    return false;
+  }
+  _readPos = 0;
+  return true;
+}
@@ -0,0 +1,360 @@
+#include "MqttClient.h"
+
+#include <string.h>
+
+// Control packet types (upper nibble of the fixed header)
+#define MQTT_CONNECT     0x10
+#define MQTT_CONNACK     0x20
+#define MQTT_PUBLISH     0x30
+#define MQTT_PUBACK      0x40
+#define MQTT_PINGREQ     0xC0
+#define MQTT_PINGRESP    0xD0
+#define MQTT_DISCONNECT  0xE0
+
+#define MQTT_DUP_FLAG    0x08
+
+// Remaining length as 1..4 byte varint, returns bytes written
+static uint8_t putLength(uint8_t* out, uint32_t len) {
+  uint8_t n = 0;
+  do {
+    uint8_t b = len % 128;
+    len /= 128;
+    if (len > 0) b |= 0x80;
+    out[n++] = b;
+  } while (len > 0 && n < 4);
+  return n;
+}
+
+static uint16_t putString(uint8_t* out, const char* s) {
+  uint16_t len = (uint16_t)strlen(s);
+  out[0] = len >> 8;
+  out[1] = len & 0xFF;
+  memcpy(out + 2, s, len);
+  return len + 2;
+}
+
+MqttClient::MqttClient(MqttTransport& transport, MqttClockFn clock)
+  : _transport(transport), _clock(clock), _host(nullptr), _port(1883),
+    _keepAliveS(30), _ackTimeoutMs(10000),
+    _connected(false), _connAck(false), _pingOutstanding(false),
+    _lastOutMs(0), _pingSentMs(0), _packetId(0), _publishSeq(0), _inFlightCount(0),
+    _rxState(RX_HEADER), _rxHeader(0), _rxLength(0), _rxMultiplier(1), _rxPos(0),
+    _rxTopicLen(0), _rxPacketId(0) {
+  memset(_inFlight, 0, sizeof(_inFlight));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MqttClient::send(const uint8_t* data, size_t len) {
+  if (_transport.write(data, len) != len) {
+    dropConnection();
+    return false;
+  }
+  _stats.bytesOut += len;
+  _lastOutMs = _clock();
+  return true;
+}
+
+bool MqttClient::connect(const char* clientId, bool cleanSession,
+                         const char* user, const char* pass, uint32_t timeoutMs) {
+  if (_transport.isOpen()) _transport.close();
+  _connected = false;
+  _connAck = false;
+  _pingOutstanding = false;
+  _rxState = RX_HEADER;
+
+  if (!_host || !_transport.open(_host, _port)) return false;
+
+  uint8_t body[MAX_PACKET];
+  uint16_t n = 0;
+
+  n += putString(body + n, "MQTT");
+  body[n++] = 4;  // protocol level 3.1.1
+
+  uint8_t flags = cleanSession ? 0x02 : 0x00;
+  if (user) flags |= 0x80;
+  if (pass) flags |= 0x40;
+  body[n++] = flags;
+  body[n++] = _keepAliveS >> 8;
+  body[n++] = _keepAliveS & 0xFF;
+
+  uint16_t need = n + 2 + strlen(clientId) + (user ? 2 + strlen(user) : 0) +
+                  (pass ? 2 + strlen(pass) : 0);
+  if (need > MAX_PACKET) {
+    _transport.close();
+    return false;
+  }
+
+  n += putString(body + n, clientId);
+  if (user) n += putString(body + n, user);
+  if (pass) n += putString(body + n, pass);
+
+  uint8_t header[5];
+  header[0] = MQTT_CONNECT;
+  uint8_t h = 1 + putLength(header + 1, n);
+  if (!send(header, h) || !send(body, n)) return false;
+
+  uint32_t start = _clock();
+  while (!_connAck) {
+    if (!_transport.isOpen() || _clock() - start > timeoutMs) {
+      _transport.close();
+      return false;
+    }
+    loop();
+  }
+
+  _connected = true;
+  _stats.connects++;
+
+  // Persistent session: anything the broker never acked goes again
+  resendInFlight();
+  return _connected;
+}
+
+bool MqttClient::connected() {
+  if (_connected && !_transport.isOpen()) _connected = false;
+  return _connected;
+}
+
+void MqttClient::disconnect() {
+  if (_connected) {
+    uint8_t packet[2] = { MQTT_DISCONNECT, 0 };
+    send(packet, sizeof(packet));
+  }
+  _transport.close();
+  _connected = false;
+}
+
+void MqttClient::dropConnection() {
+  _transport.close();
+  _connected = false;
+}
+
+uint16_t MqttClient::nextPacketId() {
+  if (++_packetId == 0) _packetId = 1;  // 0 is not a valid id
+  return _packetId;
+}
+
+bool MqttClient::publish(const char* topic, const uint8_t* payload, uint16_t len,
+                         uint8_t qos, bool retain) {
+  if (qos > 1 || !connected()) {
+    _stats.rejected++;
+    return false;
+  }
+
+  uint16_t topicLen = (uint16_t)strlen(topic);
+  uint32_t remaining = 2 + topicLen + (qos ? 2 : 0) + len;
+  uint8_t lenBytes[4];
+  uint8_t lenSize = putLength(lenBytes, remaining);
+  if (1 + lenSize + remaining > MAX_PACKET) {
+    _stats.rejected++;
+    return false;
+  }
+
+  InFlight* slot = nullptr;
+  if (qos == 1) {
+    for (uint8_t i = 0; i < MAX_IN_FLIGHT && !slot; i++) {
+      if (!_inFlight[i].used) slot = &_inFlight[i];
+    }
+    if (!slot) {  // window full, caller should back off
+      _stats.rejected++;
+      return false;
+    }
+  }
+
+  uint8_t local[MAX_PACKET];
+  uint8_t* p = slot ? slot->packet : local;
+  uint16_t n = 0;
+
+  p[n++] = MQTT_PUBLISH | (qos << 1) | (retain ? 1 : 0);
+  memcpy(p + n, lenBytes, lenSize);
+  n += lenSize;
+  n += putString(p + n, topic);
+
+  uint16_t id = 0;
+  if (qos == 1) {
+    id = nextPacketId();
+    p[n++] = id >> 8;
+    p[n++] = id & 0xFF;
+  }
+  memcpy(p + n, payload, len);
+  n += len;
+
+  if (slot) {
+    slot->used = true;
+    slot->id = id;
+    slot->len = n;
+    slot->seq = _publishSeq++;
+    slot->sentMs = _clock();
+    _inFlightCount++;
+    if (_inFlightCount > _stats.maxInFlight) _stats.maxInFlight = _inFlightCount;
+  }
+
+  // QoS 1 stays in the window even if this write fails
+  if (!send(p, n)) return qos == 1;
+
+  _stats.published++;
+  return true;
+}
+
+// Oldest first: a freed slot takes the next publish, so slot order
+// is not publish order
+void MqttClient::resendInFlight() {
+  uint8_t order[MAX_IN_FLIGHT];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < MAX_IN_FLIGHT; i++) {
+    if (!_inFlight[i].used) continue;
+    uint8_t k = n++;
+    while (k > 0 && (int32_t)(_inFlight[i].seq - _inFlight[order[k - 1]].seq) < 0) {
+      order[k] = order[k - 1];
+      k--;
+    }
+    order[k] = i;
+  }
+
+  for (uint8_t k = 0; k < n; k++) {
+    InFlight& f = _inFlight[order[k]];
+    f.packet[0] |= MQTT_DUP_FLAG;
+    f.sentMs = _clock();
+    if (!send(f.packet, f.len)) return;
+    _stats.resent++;
+  }
+}
+
+void MqttClient::loop() {
+  if (!_transport.isOpen()) {
+    _connected = false;
+    return;
+  }
+
+  uint8_t buf[64];
+  int got;
+  while ((got = _transport.read(buf, sizeof(buf))) > 0) {
+    _stats.bytesIn += got;
+    for (int i = 0; i < got; i++) feed(buf[i]);
+  }
+
+  if (!_connected) return;
+  uint32_t now = _clock();
+
+  // Broker stopped acking: treat the link as dead and reconnect
+  for (uint8_t i = 0; i < MAX_IN_FLIGHT; i++) {
+    if (_inFlight[i].used && now - _inFlight[i].sentMs > _ackTimeoutMs) {
+      dropConnection();
+      return;
+    }
+  }
+
+  if (_keepAliveS == 0) return;
+  uint32_t keepAliveMs = _keepAliveS * 1000UL;
+
+  if (_pingOutstanding && now - _pingSentMs > keepAliveMs) {
+    dropConnection();
+    return;
+  }
+  if (!_pingOutstanding && now - _lastOutMs >= keepAliveMs) {
+    uint8_t ping[2] = { MQTT_PINGREQ, 0 };
+    if (send(ping, sizeof(ping))) {
+      _pingOutstanding = true;
+      _pingSentMs = now;
+    }
+  }
+}
+
+// Byte-at-a-time parser. Packets bigger than the buffer keep their
+// first MAX_PACKET bytes; only PUBLISH is handled then (to ack it).
+void MqttClient::feed(uint8_t b) {
+  switch (_rxState) {
+    case RX_HEADER:
+      _rxHeader = b;
+      _rxLength = 0;
+      _rxMultiplier = 1;
+      _rxPos = 0;
+      _rxTopicLen = 0;
+      _rxPacketId = 0;
+      _rxState = RX_LENGTH;
+      break;
+
+    case RX_LENGTH:
+      _rxLength += (b & 0x7F) * _rxMultiplier;
+      _rxMultiplier *= 128;
+      if (b & 0x80) {
+        if (_rxMultiplier > 128UL * 128 * 128) dropConnection();  // malformed
+        break;
+      }
+      if (_rxLength == 0) {
+        handlePacket(_rxHeader, _rxBuf, 0);
+        _rxState = RX_HEADER;
+      } else {
+        _rxState = RX_BODY;
+      }
+      break;
+
+    case RX_BODY:
+      if (_rxPos < MAX_PACKET) _rxBuf[_rxPos] = b;
+
+      // PUBLISH variable header: topic length, topic, packet id (QoS > 0)
+      if ((_rxHeader & 0xF0) == MQTT_PUBLISH) {
+        if (_rxPos == 0)                    _rxTopicLen = b << 8;
+        else if (_rxPos == 1)               _rxTopicLen |= b;
+        else if (_rxPos == 2u + _rxTopicLen) _rxPacketId = b << 8;
+        else if (_rxPos == 3u + _rxTopicLen) _rxPacketId |= b;
+      }
+
+      _rxPos++;
+      if (_rxPos == _rxLength) {
+        if (_rxLength <= MAX_PACKET) {
+          handlePacket(_rxHeader, _rxBuf, _rxLength);
+        } else {
+          _stats.oversize++;
+          if ((_rxHeader & 0xF0) == MQTT_PUBLISH) handlePacket(_rxHeader, _rxBuf, MAX_PACKET);
+        }
+        _rxState = RX_HEADER;
+      }
+      break;
+  }
+}
+
+void MqttClient::handlePacket(uint8_t header, const uint8_t* body, uint16_t len) {
+  switch (header & 0xF0) {
+    case MQTT_CONNACK:
+      if (len >= 2 && body[1] == 0) {
+        _connAck = true;
+      } else {
+        dropConnection();  // refused: bad protocol, id, auth...
+      }
+      break;
+
+    case MQTT_PUBACK:
+      if (len >= 2) {
+        uint16_t id = (body[0] << 8) | body[1];
+        for (uint8_t i = 0; i < MAX_IN_FLIGHT; i++) {
+          if (_inFlight[i].used && _inFlight[i].id == id) {
+            _inFlight[i].used = false;
+            _inFlightCount--;
+            _stats.acked++;
+            break;
+          }
+        }
+      }
+      break;
+
+    case MQTT_PINGRESP:
+      _pingOutstanding = false;
+      break;
+
+    case MQTT_PUBLISH: {
+      // We don't subscribe, but a persistent session may still deliver.
+      // Ack QoS 1 so the broker doesn't keep re-sending. The id comes
+      // from feed(), body may be cut short.
+      uint8_t qos = (header >> 1) & 0x03;
+      if (qos == 1 && _rxLength >= _rxTopicLen + 4u) {
+        uint8_t ack[4] = { MQTT_PUBACK, 2, (uint8_t)(_rxPacketId >> 8), (uint8_t)(_rxPacketId & 0xFF) };
+        send(ack, sizeof(ack));
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
@@ -0,0 +1,128 @@
+#include "OfflineQueue.h"
+
+OfflineQueue::OfflineQueue(QueuedSample* storage, uint16_t capacity, SpillStore* spill)
+  : _buf(storage), _capacity(capacity), _head(0), _count(0), _spill(spill),
+    _maxPerBatch(8), _minGapMs(1000), _lastBatchMs(0),
+    _draining(false), _burstStartMs(0), _burstDrained(0),
+    _queued(0), _dropped(0), _spilled(0), _drained(0) {
+}
+
+void OfflineQueue::setDrainRate(uint16_t maxPerBatch, uint32_t minBatchGapMs) {
+  if (maxPerBatch == 0) maxPerBatch = 1;
+  if (maxPerBatch > MAX_BATCH) maxPerBatch = MAX_BATCH;
+  _maxPerBatch = maxPerBatch;
+  _minGapMs = minBatchGapMs;
+}
+
+void OfflineQueue::push(const QueuedSample& sample) {
+  if (_capacity == 0) {
+    _dropped++;
+    return;
+  }
+
+  if (_count == _capacity) {
+    if (_spill) spillOldest();
+
+    // Still full: no flash, or flash write failed -> drop oldest
+    if (_count == _capacity) {
+      _head = (_head + 1) % _capacity;
+      _count--;
+      _dropped++;
+    }
+  }
+
+  _buf[(_head + _count) % _capacity] = sample;
+  _count++;
+  _queued++;
+}
+
+// Moves the oldest half of the RAM ring to flash in one write
+void OfflineQueue::spillOldest() {
+  QueuedSample chunk[MAX_BATCH];
+  uint16_t toMove = _count / 2;
+  if (toMove == 0) toMove = 1;
+
+  while (toMove > 0) {
+    uint16_t n = peekRam(chunk, toMove < MAX_BATCH ? toMove : MAX_BATCH);
+    if (!_spill->append(chunk, n)) return;
+    popRam(n);
+    _spilled += n;
+    toMove -= n;
+  }
+}
+
+uint16_t OfflineQueue::peekRam(QueuedSample* out, uint16_t max) const {
+  uint16_t n = _count < max ? _count : max;
+  for (uint16_t i = 0; i < n; i++) {
+    out[i] = _buf[(_head + i) % _capacity];
+  }
+  return n;
+}
+
+void OfflineQueue::popRam(uint16_t count) {
+  if (count > _count) count = _count;
+  _head = (_head + count) % _capacity;
+  _count -= count;
+}
+
+uint16_t OfflineQueue::drain(uint32_t nowMs, QueueSendFn send, void* ctx) {
+  if (depth() == 0) {
+    _draining = false;
+    return 0;
+  }
+  if (_draining && nowMs - _lastBatchMs < _minGapMs) return 0;
+
+  if (!_draining) {
+    _draining = true;
+    _burstStartMs = nowMs;
+    _burstDrained = 0;
+  }
+
+  // Flash holds the oldest samples, so it goes first
+  QueuedSample batch[MAX_BATCH];
+  bool fromSpill = _spill && _spill->size() > 0;
+  uint16_t n = 0;
+  if (fromSpill) {
+    n = _spill->peek(batch, _maxPerBatch);
+    if (n == 0) {
+      // Flash says it has samples but can't read them: they are lost,
+      // don't let them block the RAM ring forever
+      _dropped += _spill->size();
+      _spill->clear();
+      fromSpill = false;
+    }
+  }
+  if (!fromSpill) n = peekRam(batch, _maxPerBatch);
+  if (n == 0) return 0;
+
+  _lastBatchMs = nowMs;
+  uint16_t sent = send(batch, n, ctx);
+  if (sent == 0) return 0;
+  if (sent < n) n = sent;   // the rest goes again next time
+
+  if (fromSpill) _spill->pop(n);
+  else           popRam(n);
+
+  _drained += n;
+  _burstDrained += n;
+  return n;
+}
+
+uint32_t OfflineQueue::depth() const {
+  return _count + (_spill ? _spill->size() : 0);
+}
+
+OfflineQueueStats OfflineQueue::stats(uint32_t nowMs) const {
+  OfflineQueueStats s;
+  s.ramDepth   = _count;
+  s.spillDepth = _spill ? _spill->size() : 0;
+  s.depth      = s.ramDepth + s.spillDepth;
+  s.queued     = _queued;
+  s.dropped    = _dropped;
+  s.spilled    = _spilled;
+  s.drained    = _drained;
+
+  uint32_t elapsed = nowMs - _burstStartMs;
+  s.drainRate = (_draining && elapsed > 0) ? _burstDrained * 1000.0f / elapsed : 0.0f;
+  return s;
+}
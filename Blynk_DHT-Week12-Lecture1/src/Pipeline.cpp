@@ -0,0 +1,58 @@
+#include "Pipeline.h"
+
+bool pipelineSend(QueueHandle_t q, const Sample& s, BackpressurePolicy policy,
+                  TickType_t blockTicks, QueueStats& stats) {
+  bool ok;
+
+  switch (policy) {
+    case BP_DROP_OLDEST:
+      ok = xQueueSend(q, &s, 0) == pdTRUE;
+      if (!ok) {
+        Sample old;
+        if (xQueueReceive(q, &old, 0) == pdTRUE) stats.dropped++;
+        ok = xQueueSend(q, &s, 0) == pdTRUE;
+      }
+      break;
+
+    case BP_BLOCK:
+      ok = xQueueSend(q, &s, blockTicks) == pdTRUE;
+      break;
+
+    case BP_DROP_NEWEST:
+    default:
+      ok = xQueueSend(q, &s, 0) == pdTRUE;
+      break;
+  }
+
+  if (!ok) {
+    stats.dropped++;
+    return false;
+  }
+
+  stats.sent++;
+  uint32_t waiting = uxQueueMessagesWaiting(q);
+  if (waiting > stats.highWater) stats.highWater = waiting;
+  return true;
+}
+
+void recordStage(StageStats& stats, uint32_t waitUs, uint32_t serviceUs) {
+  stats.count++;
+  stats.waitSumUs += waitUs;
+  stats.serviceSumUs += serviceUs;
+  if (waitUs > stats.waitMaxUs) stats.waitMaxUs = waitUs;
+  if (serviceUs > stats.serviceMaxUs) stats.serviceMaxUs = serviceUs;
+}
+
+void printStageStats(const char* name, const StageStats& stats) {
+  uint32_t n = stats.count ? stats.count : 1;
+  Serial.printf("  %-8s n=%-6lu wait avg=%lu max=%lu us  work avg=%lu max=%lu us\n",
+                name, (unsigned long)stats.count,
+                (unsigned long)(stats.waitSumUs / n), (unsigned long)stats.waitMaxUs,
+                (unsigned long)(stats.serviceSumUs / n), (unsigned long)stats.serviceMaxUs);
+}
+
+void printQueueStats(const char* name, const QueueStats& stats) {
+  Serial.printf("  %-8s sent=%-6lu dropped=%-4lu high-water=%lu/%lu\n",
+                name, (unsigned long)stats.sent, (unsigned long)stats.dropped,
+                (unsigned long)stats.highWater, (unsigned long)stats.length);
+}
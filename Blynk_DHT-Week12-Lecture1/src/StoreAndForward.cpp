@@ -0,0 +1,13 @@
+#include "StoreAndForward.h"
+
+bool storeAndForwardSend(const TelemetryPoint* points, uint8_t count, void* ctx) {
+  StoreAndForward& sf = *(StoreAndForward*)ctx;
+  if (sf.online()) return sf.live(points, count, sf.liveCtx);
+
+  uint32_t now = sf.clock();
+  for (uint8_t i = 0; i < count; i++) {
+    QueuedSample s = { now, points[i].pin, points[i].value };
+    sf.queue->push(s);
+  }
+  return true;
+}
@@ -0,0 +1,131 @@
+#include "TelemetryPublisher.h"
+
+#include <math.h>
+#include <string.h>
+
+TelemetryPublisher::TelemetryPublisher(TelemetrySendFn send, void* ctx)
+  : _send(send), _ctx(ctx), _count(0), _force(false) {
+  memset(_channels, 0, sizeof(_channels));
+  resetStats();
+}
+
+int8_t TelemetryPublisher::addChannel(uint8_t pin, float deadband,
+                                      uint32_t minIntervalMs, uint32_t maxIntervalMs) {
+  if (_count >= MAX_CHANNELS) return -1;
+
+  Channel& c = _channels[_count];
+  c.pin           = pin;
+  c.deadband      = deadband;
+  c.minIntervalMs = minIntervalMs;
+  c.maxIntervalMs = maxIntervalMs;
+  c.hasValue = false;
+  c.pending  = false;
+  c.everSent = false;
+  return (int8_t)_count++;
+}
+
+void TelemetryPublisher::update(uint8_t channel, float value) {
+  if (channel >= _count || isnan(value)) return;
+
+  Channel& c = _channels[channel];
+  _stats.offered++;
+
+  // Previous sample was never sent and is now replaced
+  if (c.pending) _stats.suppressed++;
+
+  c.value    = value;
+  c.hasValue = true;
+  c.pending  = true;
+}
+
+void TelemetryPublisher::forceAll() {
+  _force = true;
+}
+
+uint8_t TelemetryPublisher::poll(uint32_t nowMs) {
+  TelemetryPoint frame[MAX_CHANNELS];
+  uint8_t  frameChannel[MAX_CHANNELS];
+  bool     frameHeartbeat[MAX_CHANNELS];
+  uint8_t  n = 0;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    Channel& c = _channels[i];
+    if (!c.hasValue) continue;
+
+    uint32_t sinceSent = nowMs - c.lastSentMs;
+    bool send = false;
+    bool heartbeat = false;
+
+    if (_force || !c.everSent) {
+      send = true;
+    } else if (c.pending) {
+      bool changed = fabsf(c.value - c.lastSent) >= c.deadband;
+      if (changed && sinceSent >= c.minIntervalMs) {
+        send = true;
+      } else if (!changed) {
+        // Inside the deadband, nothing worth reporting
+        c.pending = false;
+        _stats.suppressed++;
+      }
+      // changed but too early: stay pending, may be superseded
+    }
+
+    if (!send && c.maxIntervalMs > 0 && sinceSent >= c.maxIntervalMs) {
+      send = true;
+      heartbeat = !c.pending;
+    }
+
+    if (send) {
+      frame[n].pin = c.pin;
+      frame[n].value = c.value;
+      frameChannel[n] = i;
+      frameHeartbeat[n] = heartbeat;
+      n++;
+    }
+  }
+
+  if (n == 0) return 0;
+
+  // A frame goes out anyway: let channels that are at least half way
+  // to their heartbeat ride along, so heartbeats stay in one frame.
+  for (uint8_t i = 0; i < _count; i++) {
+    Channel& c = _channels[i];
+    if (!c.hasValue || c.maxIntervalMs == 0) continue;
+    if (nowMs - c.lastSentMs < c.maxIntervalMs / 2) continue;
+
+    bool inFrame = false;
+    for (uint8_t k = 0; k < n; k++) {
+      if (frameChannel[k] == i) inFrame = true;
+    }
+    if (inFrame) continue;
+
+    frame[n].pin = c.pin;
+    frame[n].value = c.value;
+    frameChannel[n] = i;
+    frameHeartbeat[n] = !c.pending;
+    n++;
+  }
+
+  if (!_send(frame, n, _ctx)) {
+    _stats.sendFailures++;
+    return 0;  // keep everything pending, try again next poll
+  }
+
+  _force = false;
+  _stats.framesSent++;
+  _stats.pointsSent += n;
+
+  for (uint8_t k = 0; k < n; k++) {
+    Channel& c = _channels[frameChannel[k]];
+    if (frameHeartbeat[k]) _stats.heartbeats++;
+    c.lastSent   = c.value;
+    c.lastSentMs = nowMs;
+    c.pending    = false;
+    c.everSent   = true;
+  }
+  return n;
+}
+
+void TelemetryPublisher::resetStats() {
+  memset(&_stats, 0, sizeof(_stats));
+}
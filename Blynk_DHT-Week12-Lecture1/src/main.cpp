@@ -23,6 +23,20 @@
 #include <Adafruit_SSD1306.h>
 
 #include "DHT.h"
+#include <FastPin.h>
+#include <LoopProf.h>   // markers are empty unless built with -D LOOP_PROF=1
+#include <FixedFmt.h>   // integer float formatting, no String
+#include <StreamStats.h>
+#include "TelemetryPublisher.h"
+#include "OfflineQueue.h"
+#include "StoreAndForward.h"
+#include "LittleFsSpillStore.h"
+#include "Pipeline.h"
+#include "DutyCycle.h"
+#include "MqttClient.h"
+#include "WiFiClientTransport.h"
+#include "SensorPayload.h"
+#include <time.h>
 
 // ------------ WiFi credentials (for wokwi) ------------
 char ssid[] = "Pixel :3";
@@ -44,19 +58,554 @@ DHT dht(DHTPIN, DHTTYPE);
 
 BlynkTimer timer;
 
-// For simple button edge detection
-int lastButtonState = HIGH;
+// ------------ Task pipeline ------------
+// sensorTask (core 1) --> displayQueue --> displayTask (core 1)
+//                     \-> networkQueue --> networkTask (core 0, Blynk)
+#define SAMPLE_PERIOD_MS     5000
+#define BUTTON_POLL_MS       10
+#define DISPLAY_QUEUE_LEN    1     // display only cares about the newest
+#define NETWORK_QUEUE_LEN    16    // network keeps every sample
+#define NETWORK_BLOCK_MS     50    // then the sample is dropped
+#define STATS_PERIOD_MS      60000
 
-// Forward declaration
-void readAndDisplayAndSend();
+QueueHandle_t displayQueue;
+QueueHandle_t networkQueue;
 
-// Optional: send periodically to Blynk (even without button)
-void periodicSend() {
-  readAndDisplayAndSend();
+QueueStats displayQueueStats = { 0, 0, 0, DISPLAY_QUEUE_LEN };
+QueueStats networkQueueStats = { 0, 0, 0, NETWORK_QUEUE_LEN };
+StageStats sensorStage;
+StageStats displayStage;
+StageStats networkStage;
+
+// ------------ Telemetry (report-on-change) ------------
+// Map: V0 = Temp, V1 = Humidity
+// DHT11 only resolves 1 C / 1 %, so smaller changes are noise.
+#define TEMP_DEADBAND      0.5f
+#define HUM_DEADBAND       1.0f
+#define REPORT_MIN_MS      2000UL    // never faster than this per pin
+#define REPORT_MAX_MS      60000UL   // heartbeat even if unchanged
+
+// ------------ Offline store-and-forward ------------
+#define OFFLINE_RAM_SAMPLES    64
+#define OFFLINE_FLASH_SAMPLES  4096
+#define REPLAY_BATCH           8       // samples per replay message
+#define REPLAY_GAP_MS          1000UL  // leave room for live traffic
+
+QueuedSample offlineBuffer[OFFLINE_RAM_SAMPLES];
+LittleFsSpillStore offlineFlash("/offline.bin", OFFLINE_FLASH_SAMPLES);
+OfflineQueue offlineQueue(offlineBuffer, OFFLINE_RAM_SAMPLES, &offlineFlash);
+
+// ------------ MQTT backend (alternative to Blynk cloud) ------------
+// Build with -D USE_MQTT=1 (env:nodemcu-32s-mqtt). One QoS 1 publish of a
+// 9-byte SensorPayload replaces the two Blynk virtual pin messages.
+#ifndef USE_MQTT
+#define USE_MQTT 0
+#endif
+#ifndef MQTT_BROKER
+#define MQTT_BROKER        "192.168.1.10"
+#endif
+#define MQTT_PORT          1883
+#define MQTT_CLIENT_ID     "env-node-1"
+#define MQTT_TOPIC         "iotlabs/env-node-1/env"
+#define MQTT_QOS           1
+#define MQTT_RECONNECT_MS  5000UL
+
+WiFiClientTransport mqttTransport;
+uint32_t millisClock() { return millis(); }
+MqttClient mqtt(mqttTransport, millisClock);
+uint32_t lastMqttAttempt = 0;
+
+bool backendConnected() {
+#if USE_MQTT
+  return mqtt.connected();
+#else
+  return Blynk.connected();
+#endif
+}
+
+// Keeps the broker session up and processes acks (network task)
+void mqttService() {
+  if (!mqtt.connected() && WiFi.status() == WL_CONNECTED &&
+      millis() - lastMqttAttempt >= MQTT_RECONNECT_MS) {
+    lastMqttAttempt = millis();
+    // clean session = false: broker keeps our unacked QoS 1 messages
+    if (mqtt.connect(MQTT_CLIENT_ID, false)) Serial.println("MQTT connected");
+  }
+  mqtt.loop();
+}
+
+bool publishEnvironment(float t, float h, uint32_t epochS) {
+  uint8_t payload[SENSOR_PAYLOAD_SIZE];
+  uint8_t n = encodeSensorPayload(payload, t, h, epochS);
+  return mqtt.publish(MQTT_TOPIC, payload, n, MQTT_QOS);
+}
+
+// Wall clock in ms for a millis() timestamp, 0 if NTP hasn't synced yet
+uint64_t toEpochMs(uint32_t sampleMs) {
+  time_t now = time(nullptr);
+  if (now < 1600000000) return 0;
+  return (uint64_t)now * 1000ULL - (millis() - sampleMs);
+}
+
+// Replays a backlog batch, samples taken at the same time share one group.
+// Returns the samples that went out; with MQTT it stops at the first
+// group the client refuses, the queue keeps the rest for the next try.
+uint16_t replayBacklog(const QueuedSample* samples, uint16_t count, void* ctx) {
+  if (!backendConnected()) return 0;
+
+#if USE_MQTT
+  // Only start if the whole batch fits the ack window, so a retry
+  // never re-publishes half a batch
+  if (mqtt.inFlight() + count > MqttClient::MAX_IN_FLIGHT) return 0;
+
+  uint16_t i = 0;
+  while (i < count) {
+    uint16_t groupStart = i;
+    uint32_t groupMs = samples[i].timestampMs;
+    float t = NAN, h = NAN;
+    while (i < count && samples[i].timestampMs == groupMs) {
+      if (samples[i].pin == V0) t = samples[i].value;
+      if (samples[i].pin == V1) h = samples[i].value;
+      i++;
+    }
+    if (!publishEnvironment(t, h, (uint32_t)(toEpochMs(groupMs) / 1000ULL))) return groupStart;
+  }
+  return count;
+#else
+  uint16_t i = 0;
+  while (i < count) {
+    uint64_t ts = toEpochMs(samples[i].timestampMs);
+    if (ts) Blynk.beginGroup(ts);
+    else    Blynk.beginGroup();
+
+    uint32_t groupMs = samples[i].timestampMs;
+    while (i < count && samples[i].timestampMs == groupMs) {
+      Blynk.virtualWrite(samples[i].pin, samples[i].value);
+      i++;
+    }
+    Blynk.endGroup();
+  }
+  return count;
+#endif
+}
+
+// Sends all due pins as one message (Blynk group or one MQTT publish)
+bool sendLive(const TelemetryPoint* points, uint8_t count, void* ctx) {
+#if USE_MQTT
+  // Pins not in this frame are sent as "missing", the consumer keeps the old value
+  float t = NAN, h = NAN;
+  for (uint8_t i = 0; i < count; i++) {
+    if (points[i].pin == V0) t = points[i].value;
+    if (points[i].pin == V1) h = points[i].value;
+  }
+  return publishEnvironment(t, h, (uint32_t)(toEpochMs(millis()) / 1000ULL));
+#else
+  Blynk.beginGroup();
+  for (uint8_t i = 0; i < count; i++) {
+    Blynk.virtualWrite(points[i].pin, points[i].value);
+  }
+  Blynk.endGroup();
+  return true;
+#endif
+}
+
+// Live while connected, into the offline queue (reported as sent) otherwise
+StoreAndForward telemetryPath = { backendConnected, sendLive, nullptr, &offlineQueue, millisClock };
+
+TelemetryPublisher telemetry(storeAndForwardSend, &telemetryPath);
+int8_t tempChannel;
+int8_t humChannel;
+
+// ------------ Edge summaries (instead of every reading) ------------
+// Build with -D SUMMARY_MODE=1 (env:nodemcu-32s-summary). Each window sends
+// mean/min/max per channel; a reading is sent on its own only when it is
+// flagged (limit, spike, fast change) or read with the button.
+// Map: V0/V1 = window mean, V3/V4 = temp min/max, V5/V6 = hum min/max,
+//      V7 = flagged readings in the window
+#ifndef SUMMARY_MODE
+#define SUMMARY_MODE 0
+#endif
+
+#define SUMMARY_WINDOW_MS  300000UL  // 60 readings at SAMPLE_PERIOD_MS
+#define STATS_ALPHA        0.2f      // EWMA baseline, ~10 readings
+#define TEMP_LIMIT_LO      5.0f
+#define TEMP_LIMIT_HI      40.0f
+#define HUM_LIMIT_LO       15.0f
+#define HUM_LIMIT_HI       90.0f
+#define SPIKE_Z            4.0f      // baseline sigmas
+#define TEMP_MIN_SIGMA     0.5f      // DHT11 steps 1 C / 1 %, a single step is not a spike
+#define HUM_MIN_SIGMA      1.0f
+// Rate is an EWMA of the per-reading slope: one DHT11 step in 5 s
+// alone reads as 2.4 per minute, so the limits sit above that
+#define TEMP_MAX_RATE      (5.0f / 60)  // C per second
+#define HUM_MAX_RATE       (6.0f / 60)  // % per second
+
+#define MQTT_SUMMARY_TOPIC "iotlabs/env-node-1/summary"
+
+StreamStats tempStats(STATS_ALPHA);
+StreamStats humStats(STATS_ALPHA);
+
+struct SummaryCounters {
+  uint32_t samples;    // readings that went into a window
+  uint32_t windows;    // summaries sent
+  uint32_t flagged;    // readings sent on their own
+};
+SummaryCounters summaryCounters;
+
+// A channel without a valid reading in the window goes out as missing
+void toSummaryChannel(const WindowSummary& w, SummaryChannel& c) {
+  bool valid = w.count > 0;
+  c.mean = valid ? w.mean : NAN;
+  c.min = valid ? w.min : NAN;
+  c.max = valid ? w.max : NAN;
+  c.stddev = valid ? w.stddev : NAN;
+  c.flags = w.flags;
+}
+
+// Closes both windows and sends one summary (network task)
+void sendSummary(uint32_t now) {
+  WindowSummary t, h;
+  tempStats.close(t, now);
+  humStats.close(h, now);
+  if (!t.count && !h.count) return;
+  summaryCounters.windows++;
+
+  Serial.printf("Window %lus: n=%u temp %s (%s..%s sd %s, %s C/min) hum %s (%s..%s) flagged=%u\n",
+                (unsigned long)((t.endMs - t.startMs) / 1000), t.count,
+                FixedNum(t.mean, 1).c_str(), FixedNum(t.min, 1).c_str(), FixedNum(t.max, 1).c_str(),
+                FixedNum(t.stddev, 2).c_str(), FixedNum(t.slopePerMin, 2).c_str(),
+                FixedNum(h.mean, 1).c_str(), FixedNum(h.min, 1).c_str(), FixedNum(h.max, 1).c_str(),
+                t.anomalies + h.anomalies);
+
+  // A channel without a valid reading in the window is left out, so a
+  // failing temperature read doesn't put NaN next to a good humidity.
+  // Offline: the means go to the backlog like ordinary readings.
+  if (!backendConnected()) {
+    if (t.count) {
+      QueuedSample qt = { now, V0, t.mean };
+      offlineQueue.push(qt);
+    }
+    if (h.count) {
+      QueuedSample qh = { now, V1, h.mean };
+      offlineQueue.push(qh);
+    }
+    return;
+  }
+
+#if USE_MQTT
+  SummaryChannel tc, hc;
+  toSummaryChannel(t, tc);
+  toSummaryChannel(h, hc);
+  uint8_t payload[SUMMARY_PAYLOAD_SIZE];
+  uint8_t n = encodeSummaryPayload(payload, t.count > h.count ? t.count : h.count,
+                                   (uint16_t)((t.endMs - t.startMs) / 1000),
+                                   (uint32_t)(toEpochMs(now) / 1000ULL), tc, hc);
+  mqtt.publish(MQTT_SUMMARY_TOPIC, payload, n, MQTT_QOS);
+#else
+  Blynk.beginGroup();
+  if (t.count) {
+    Blynk.virtualWrite(V0, t.mean);
+    Blynk.virtualWrite(V3, t.min);
+    Blynk.virtualWrite(V4, t.max);
+  }
+  if (h.count) {
+    Blynk.virtualWrite(V1, h.mean);
+    Blynk.virtualWrite(V5, h.min);
+    Blynk.virtualWrite(V6, h.max);
+  }
+  Blynk.virtualWrite(V7, t.anomalies + h.anomalies);
+  Blynk.endGroup();
+#endif
+}
+
+// Adds a reading to the windows; flagged or manual ones go out right away
+void summarizeSample(const Sample& s) {
+  uint32_t now = millis();
+  uint8_t tf = tempStats.add(s.temperature, now);
+  uint8_t hf = humStats.add(s.humidity, now);
+  summaryCounters.samples++;
+
+  if (tf || hf) {
+    Serial.printf("Flagged reading: temp 0x%02x hum 0x%02x\n", tf, hf);
+  }
+  if (tf || hf || s.manual) {
+    TelemetryPoint points[2] = { { V0, s.temperature }, { V1, s.humidity } };
+    storeAndForwardSend(points, 2, &telemetryPath);
+    summaryCounters.flagged++;
+  }
+
+  if (now - tempStats.windowStartMs() >= SUMMARY_WINDOW_MS) sendSummary(now);
+}
+
+// Prints how many readings were actually sent (network task only)
+void printTelemetryStats() {
+  const TelemetryStats& s = telemetry.stats();
+  Serial.printf("Telemetry: offered=%lu sent=%lu frames=%lu suppressed=%lu heartbeats=%lu failed=%lu\n",
+                (unsigned long)s.offered, (unsigned long)s.pointsSent,
+                (unsigned long)s.framesSent, (unsigned long)s.suppressed,
+                (unsigned long)s.heartbeats, (unsigned long)s.sendFailures);
+#if SUMMARY_MODE
+  Serial.printf("Summary: samples=%lu windows=%lu flagged=%lu\n",
+                (unsigned long)summaryCounters.samples, (unsigned long)summaryCounters.windows,
+                (unsigned long)summaryCounters.flagged);
+#endif
+
+  OfflineQueueStats q = offlineQueue.stats(millis());
+  Serial.printf("Offline queue: depth=%lu (ram=%u flash=%lu) dropped=%lu drained=%lu rate=%.1f/s\n",
+                (unsigned long)q.depth, q.ramDepth, (unsigned long)q.spillDepth,
+                (unsigned long)q.dropped, (unsigned long)q.drained, q.drainRate);
+
+#if USE_MQTT
+  const MqttStats& m = mqtt.stats();
+  Serial.printf("MQTT: connects=%lu published=%lu acked=%lu resent=%lu rejected=%lu in-flight=%u (max %u) out=%luB\n",
+                (unsigned long)m.connects, (unsigned long)m.published, (unsigned long)m.acked,
+                (unsigned long)m.resent, (unsigned long)m.rejected,
+                mqtt.inFlight(), m.maxInFlight, (unsigned long)m.bytesOut);
+#endif
+}
+
+void printPipelineStats() {
+  Serial.println("Pipeline:");
+  printStageStats("sensor",  sensorStage);
+  printStageStats("display", displayStage);
+  printStageStats("network", networkStage);
+  printQueueStats("dispQ",   displayQueueStats);
+  printQueueStats("netQ",    networkQueueStats);
+}
+
+// ------------ Sensor task: DHT read + button ------------
+void sensorTask(void* arg) {
+  int lastButtonState = HIGH;
+  TickType_t lastSample = xTaskGetTickCount() - pdMS_TO_TICKS(SAMPLE_PERIOD_MS);
+
+  for (;;) {
+    PROF_LOOP("sensor loop");
+    // Simple button edge detection (active LOW)
+    int currentState = FastPin<BUTTON_PIN>::read();
+    bool pressed = lastButtonState == HIGH && currentState == LOW;
+    lastButtonState = currentState;
+    if (pressed) Serial.println("Button pressed: manual DHT read");
+
+    bool due = xTaskGetTickCount() - lastSample >= pdMS_TO_TICKS(SAMPLE_PERIOD_MS);
+    if (pressed || due) {
+      lastSample = xTaskGetTickCount();
+
+      uint32_t start = micros();
+      Sample s;
+      {
+        PROF_SCOPE("dht read");
+        s.humidity    = dht.readHumidity();
+        s.temperature = dht.readTemperature(); // Celsius
+      }
+      s.valid   = !isnan(s.humidity) && !isnan(s.temperature);
+      s.manual  = pressed;
+      s.takenUs = micros();
+      recordStage(sensorStage, 0, s.takenUs - start);
+
+      if (!s.valid) Serial.println("Failed to read from DHT sensor!");
+
+      // Display shows the newest, network must not stall the sensor for long
+      pipelineSend(displayQueue, s, BP_DROP_OLDEST, 0, displayQueueStats);
+      if (s.valid) {
+        pipelineSend(networkQueue, s, BP_BLOCK, pdMS_TO_TICKS(NETWORK_BLOCK_MS), networkQueueStats);
+      }
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(BUTTON_POLL_MS));
+  }
+}
+
+// ------------ Display task: OLED only ------------
+void displayTask(void* arg) {
+  Sample s;
+
+  for (;;) {
+    if (xQueueReceive(displayQueue, &s, portMAX_DELAY) != pdTRUE) continue;
+
+    uint32_t start = micros();
+    display.clearDisplay();
+    display.setCursor(0, 0);
+
+    if (!s.valid) {
+      display.println("DHT Error!");
+    } else {
+      display.println("Environment Node");
+      display.println("-----------------");
+      display.print("Temp: ");
+      display.print(FixedNum(s.temperature, 1));
+      display.println(" C");
+      display.print("Hum : ");
+      display.print(FixedNum(s.humidity, 1));
+      display.println(" %");
+      display.println();
+      display.println("BTN -> manual update");
+    }
+    display.display();
+
+    recordStage(displayStage, start - s.takenUs, micros() - start);
+  }
+}
+
+// ------------ Network task: Blynk, telemetry, backlog ------------
+// Everything Blynk / telemetry / offline queue related runs in this task only.
+void networkTask(void* arg) {
+  Sample s;
+
+  for (;;) {
+    PROF_LOOP("net loop");
+    {
+#if USE_MQTT
+      PROF_SCOPE("mqtt");
+      mqttService();
+#else
+      PROF_SCOPE("blynk.run");
+      Blynk.run();
+#endif
+    }
+    {
+      PROF_SCOPE("timer.run");
+      timer.run();
+    }
+
+    // Short wait so Blynk.run() keeps getting called
+    bool got;
+    {
+      PROF_SCOPE("net wait");
+      got = xQueueReceive(networkQueue, &s, pdMS_TO_TICKS(10)) == pdTRUE;
+    }
+    if (got) {
+      PROF_SCOPE("telemetry");
+      uint32_t start = micros();
+
+      Serial.print("Temp: ");
+      Serial.print(FixedNum(s.temperature, 2));
+      Serial.print(" *C, Hum: ");
+      Serial.print(FixedNum(s.humidity, 2));
+      Serial.println(" %");
+
+#if SUMMARY_MODE
+      summarizeSample(s);
+#else
+      telemetry.update(tempChannel, s.temperature);
+      telemetry.update(humChannel, s.humidity);
+      if (s.manual) telemetry.forceAll();
+      telemetry.poll(millis());
+#endif
+
+      recordStage(networkStage, start - s.takenUs, micros() - start);
+    } else {
+#if !SUMMARY_MODE
+      telemetry.poll(millis());  // heartbeats
+#endif
+    }
+
+    // Backlog from a disconnect goes out in small, spaced batches
+    if (backendConnected()) {
+      PROF_SCOPE("drain");
+      offlineQueue.drain(millis(), replayBacklog);
+    }
+  }
+}
+
+// ------------ Duty-cycle (battery) mode ------------
+// Build with -D DUTY_CYCLE_MODE=1 (env:nodemcu-32s-dutycycle).
+// Wake, read, store in RTC memory, sleep; Wi-Fi only to flush a batch.
+#ifndef DUTY_CYCLE_MODE
+#define DUTY_CYCLE_MODE 0
+#endif
+
+#define DUTY_SLEEP_MS         60000UL  // one reading per minute
+#define DUTY_BATCH            15       // flush every 15 readings...
+#define DUTY_TEMP_THRESHOLD   2.0f     // ...or on a real change
+#define DUTY_HUM_THRESHOLD    5.0f
+#define DUTY_CONNECT_MS       10000UL
+// Wake on button only works from an RTC GPIO (0,2,4,12-15,25-27,32-39).
+// GPIO18 is not one, so the prototype wiring wakes on the timer only.
+#define WAKE_BUTTON_PIN       BUTTON_PIN
+
+// Brings up Wi-Fi + Blynk just long enough to upload the RTC ring
+bool flushDutyCycleBatch() {
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, pass);
+  uint32_t start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start > DUTY_CONNECT_MS) return false;
+    delay(50);
+  }
+
+  Blynk.config(BLYNK_AUTH_TOKEN);
+  if (!Blynk.connect(DUTY_CONNECT_MS)) return false;
+
+  // RTC keeps the clock through deep sleep, this just corrects drift
+  configTime(0, 0, "pool.ntp.org");
+
+  for (uint16_t i = 0; i < dutyCycleCount(); i++) {
+    DutySample s = dutyCycleAt(i);
+    if (s.epochS) Blynk.beginGroup((uint64_t)s.epochS * 1000ULL);
+    else          Blynk.beginGroup();
+    Blynk.virtualWrite(V0, s.tempX10 / 10.0f);
+    Blynk.virtualWrite(V1, s.humX10 / 10.0f);
+    Blynk.endGroup();
+  }
+
+  // V2 = average wake-to-sleep time in ms, to watch the battery budget
+  DutyCycleStats st = dutyCycleStats();
+  Blynk.virtualWrite(V2, st.avgActiveUs / 1000.0f);
+  Blynk.run();
+
+  Blynk.disconnect();
+  WiFi.disconnect(true);
+  return true;
+}
+
+// Never returns, ends in deep sleep
+void dutyCycleRun() {
+  bool cold = dutyCycleBegin();
+
+  if (cold) {
+    // OLED is not used in this mode, make sure it isn't drawing current
+    Wire.begin(21, 22);
+    if (display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+      display.ssd1306_command(SSD1306_DISPLAYOFF);
+    }
+  }
+
+  dht.begin();
+  float h = dht.readHumidity();
+  float t = dht.readTemperature();
+
+  bool flush = dutyCycleWokeByButton();
+  if (!isnan(h) && !isnan(t)) {
+    flush |= dutyCycleAppend(t, h, DUTY_BATCH, DUTY_TEMP_THRESHOLD, DUTY_HUM_THRESHOLD);
+  } else {
+    Serial.println("Failed to read from DHT sensor!");
+  }
+
+  if (flush && dutyCycleCount() > 0) {
+    if (flushDutyCycleBatch()) {
+      dutyCycleFlushed();
+    } else {
+      Serial.println("Flush failed, keeping samples in RTC memory");
+    }
+
+    DutyCycleStats st = dutyCycleStats();
+    Serial.printf("Duty cycle: cycles=%lu flushes=%lu dropped=%lu active last=%lu avg=%lu max=%lu us\n",
+                  (unsigned long)st.cycles, (unsigned long)st.flushes, (unsigned long)st.dropped,
+                  (unsigned long)st.lastActiveUs, (unsigned long)st.avgActiveUs,
+                  (unsigned long)st.maxActiveUs);
+    Serial.flush();
+  }
+
+  dutyCycleSleep(DUTY_SLEEP_MS, WAKE_BUTTON_PIN);
 }
 
 void setup() {
   Serial.begin(115200);
+
+#if DUTY_CYCLE_MODE
+  dutyCycleRun();
+#endif
+
   delay(1000);
   Serial.println();
   Serial.println("ESP32 DHT22 + OLED + Blynk starting...");
@@ -80,66 +629,66 @@ void setup() {
   // DHT sensor
   dht.begin();
 
+#if USE_MQTT
+  Serial.println("Connecting to WiFi...");
+  WiFi.begin(ssid, pass);
+  while (WiFi.status() != WL_CONNECTED) {
+    delay(500);
+    Serial.print(".");
+  }
+  Serial.println();
+
+  mqtt.setServer(MQTT_BROKER, MQTT_PORT);
+  mqtt.setKeepAlive(30);
+#else
   // Blynk (for real hardware WiFi)
   Serial.println("Connecting to Blynk...");
   Blynk.begin(BLYNK_AUTH_TOKEN, ssid, pass);
   // For Wokwi, WiFi is simulated via wokwi.toml [net] config
+#endif
 
-  // Periodic send every 5 seconds (optional)
-  timer.setInterval(5000L, periodicSend);
-}
+  // Wall clock for timestamped replay of offline samples
+  configTime(0, 0, "pool.ntp.org");
 
-// Reads DHT22, updates OLED and sends to Blynk
-void readAndDisplayAndSend() {
-  float h = dht.readHumidity();
-  float t = dht.readTemperature(); // Celsius
+  offlineFlash.begin();
+  offlineQueue.setDrainRate(REPLAY_BATCH, REPLAY_GAP_MS);
 
-  if (isnan(h) || isnan(t)) {
-    Serial.println("Failed to read from DHT sensor!");
-    display.clearDisplay();
-    display.setCursor(0, 0);
-    display.println("DHT Error!");
-    display.display();
-    return;
-  }
+  tempChannel = telemetry.addChannel(V0, TEMP_DEADBAND, REPORT_MIN_MS, REPORT_MAX_MS);
+  humChannel  = telemetry.addChannel(V1, HUM_DEADBAND,  REPORT_MIN_MS, REPORT_MAX_MS);
 
-  Serial.print("Temp: ");
-  Serial.print(t);
-  Serial.print(" *C, Hum: ");
-  Serial.print(h);
-  Serial.println(" %");
+  tempStats.setLimits(TEMP_LIMIT_LO, TEMP_LIMIT_HI);
+  tempStats.setSpike(SPIKE_Z, TEMP_MIN_SIGMA);
+  tempStats.setMaxRate(TEMP_MAX_RATE);
+  humStats.setLimits(HUM_LIMIT_LO, HUM_LIMIT_HI);
+  humStats.setSpike(SPIKE_Z, HUM_MIN_SIGMA);
+  humStats.setMaxRate(HUM_MAX_RATE);
 
-  // --- Update OLED ---
-  display.clearDisplay();
-  display.setCursor(0, 0);
-  display.println("Environment Node");
-  display.println("-----------------");
-  display.print("Temp: ");
-  display.print(t, 1);
-  display.println(" C");
-  display.print("Hum : ");
-  display.print(h, 1);
-  display.println(" %");
-  display.println();
-  display.println("BTN -> manual update");
-  display.display();
+  // Stats from the network task's own timer
+  timer.setInterval(STATS_PERIOD_MS, printTelemetryStats);
 
-  // --- Send to Blynk (Virtual Pins) ---
-  // Map: V0 = Temp, V1 = Humidity
-  Blynk.virtualWrite(V0, t);
-  Blynk.virtualWrite(V1, h);
+  // Pipeline queues and tasks
+  displayQueue = xQueueCreate(DISPLAY_QUEUE_LEN, sizeof(Sample));
+  networkQueue = xQueueCreate(NETWORK_QUEUE_LEN, sizeof(Sample));
+
+  xTaskCreatePinnedToCore(sensorTask,  "sensor",  4096, nullptr, 3, nullptr, 1);
+  xTaskCreatePinnedToCore(displayTask, "display", 4096, nullptr, 1, nullptr, 1);
+  xTaskCreatePinnedToCore(networkTask, "network", 8192, nullptr, 2, nullptr, 0);
 }
 
+// loop() only reports, the work happens in the tasks above
 void loop() {
-  Blynk.run();
-  timer.run();
+  static uint32_t statsTimer = 0;
+  vTaskDelay(pdMS_TO_TICKS(100));
+
+  // 'p' prints the loop profile, 'r' resets it (LOOP_PROF builds)
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'p') loopProfPrint(Serial);
+    if (c == 'r') loopProfReset();
+  }
 
-  // Simple button edge detection (active LOW)
-  int currentState = digitalRead(BUTTON_PIN);
-  if (lastButtonState == HIGH && currentState == LOW) {
-    // Falling edge -> button pressed
-    Serial.println("Button pressed: manual DHT read");
-    readAndDisplayAndSend();
+  if (millis() - statsTimer >= STATS_PERIOD_MS) {
+    statsTimer = millis();
+    printPipelineStats();
   }
-  lastButtonState = currentState;
 }
\ No newline at end of file
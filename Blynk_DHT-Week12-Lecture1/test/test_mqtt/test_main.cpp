@@ -0,0 +1,307 @@
+// MqttClient against an in-process fake broker: pio test -e native
+#include <unity.h>
+
+#include <string.h>
+
+#include "MqttClient.h"
+
+// ---- Fake broker ----
+
+// What the client writes is split into packets; what the test queues
+// with reply() is what the client reads. CONNECT is answered with a
+// CONNACK automatically.
+class FakeBroker : public MqttTransport {
+public:
+  static const size_t BUF = 4096;
+
+  bool    up = true;             // open() succeeds
+  bool    openNow = false;
+  uint8_t out[BUF];              // client -> broker
+  size_t  outLen = 0;
+  size_t  outRead = 0;
+  uint8_t in[BUF];               // broker -> client
+  size_t  inLen = 0;
+  size_t  inPos = 0;
+
+  bool open(const char*, uint16_t) override {
+    openNow = up;
+    return up;
+  }
+  void close() override { openNow = false; }
+  bool isOpen() override { return openNow; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    if (!openNow || outLen + len > BUF) return 0;
+    memcpy(out + outLen, data, len);
+    outLen += len;
+    if ((data[0] & 0xF0) == 0x10) reply((const uint8_t*)"\x20\x02\x00\x00", 4);
+    return len;
+  }
+
+  int read(uint8_t* buf, size_t max) override {
+    size_t n = inLen - inPos;
+    if (n > max) n = max;
+    memcpy(buf, in + inPos, n);
+    inPos += n;
+    return (int)n;
+  }
+
+  void reply(const uint8_t* data, size_t len) {
+    memcpy(in + inLen, data, len);
+    inLen += len;
+  }
+
+  void puback(uint16_t id) {
+    uint8_t p[4] = { 0x40, 2, (uint8_t)(id >> 8), (uint8_t)id };
+    reply(p, 4);
+  }
+
+  // Next packet the client sent: header byte, body, body length
+  bool next(uint8_t& header, const uint8_t*& body, uint32_t& len) {
+    if (outRead >= outLen) return false;
+    header = out[outRead++];
+    len = 0;
+    uint32_t mul = 1;
+    uint8_t b;
+    do {
+      b = out[outRead++];
+      len += (b & 0x7F) * mul;
+      mul *= 128;
+    } while (b & 0x80);
+    body = out + outRead;
+    outRead += len;
+    return true;
+  }
+
+  // Skips to the end of what was written so far
+  void skip() { outRead = outLen; }
+};
+
+static FakeBroker broker;
+static uint32_t nowMs;
+static uint32_t fakeClock() { return nowMs; }
+
+static uint16_t publishedId(const uint8_t* body) {
+  uint16_t topicLen = (body[0] << 8) | body[1];
+  return (body[2 + topicLen] << 8) | body[3 + topicLen];
+}
+
+static void connect(MqttClient& c) {
+  c.setServer("broker", 1883);
+  TEST_ASSERT_TRUE(c.connect("test-node", false));
+  broker.skip();
+}
+
+static const uint8_t payload[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+void setUp() {
+  broker = FakeBroker();
+  nowMs = 1000;
+}
+
+void tearDown() {}
+
+void test_connect_sends_connect_and_waits_for_connack() {
+  MqttClient c(broker, fakeClock);
+  c.setServer("broker", 1883);
+  c.setKeepAlive(30);
+  TEST_ASSERT_TRUE(c.connect("test-node", false));
+  TEST_ASSERT_TRUE(c.connected());
+
+  uint8_t h;
+  const uint8_t* body;
+  uint32_t len;
+  TEST_ASSERT_TRUE(broker.next(h, body, len));
+  TEST_ASSERT_EQUAL_HEX8(0x10, h);
+  TEST_ASSERT_EQUAL(4, body[6]);               // protocol level 3.1.1
+  TEST_ASSERT_EQUAL_HEX8(0x00, body[7]);       // no clean session
+  TEST_ASSERT_EQUAL(30, body[9]);
+  TEST_ASSERT_EQUAL(1, c.stats().connects);
+}
+
+void test_refused_connect() {
+  MqttClient c(broker, fakeClock);
+  c.setServer("broker", 1883);
+  broker.up = false;
+  TEST_ASSERT_FALSE(c.connect("test-node"));
+  TEST_ASSERT_FALSE(c.connected());
+}
+
+void test_qos1_window_and_puback() {
+  MqttClient c(broker, fakeClock);
+  connect(c);
+
+  for (uint8_t i = 0; i < MqttClient::MAX_IN_FLIGHT; i++) {
+    TEST_ASSERT_TRUE(c.publish("t", payload, sizeof(payload), 1));
+  }
+  TEST_ASSERT_FALSE(c.publish("t", payload, sizeof(payload), 1));   // window full
+  TEST_ASSERT_TRUE(c.publish("t", payload, sizeof(payload), 0));    // QoS 0 isn't held
+  TEST_ASSERT_EQUAL(MqttClient::MAX_IN_FLIGHT, c.inFlight());
+  TEST_ASSERT_EQUAL(1, c.stats().rejected);
+
+  broker.puback(3);
+  c.loop();
+  TEST_ASSERT_EQUAL(MqttClient::MAX_IN_FLIGHT - 1, c.inFlight());
+  TEST_ASSERT_EQUAL(1, c.stats().acked);
+  TEST_ASSERT_TRUE(c.publish("t", payload, sizeof(payload), 1));
+}
+
+void test_too_big_publish_is_rejected() {
+  MqttClient c(broker, fakeClock);
+  connect(c);
+  uint8_t big[MqttClient::MAX_PACKET];
+  TEST_ASSERT_FALSE(c.publish("t", big, sizeof(big), 1));
+  TEST_ASSERT_EQUAL(0, c.inFlight());
+}
+
+// Slots freed by acks take the newer messages; the resend after a
+// reconnect must still go out in the order they were published
+void test_resend_after_reconnect_keeps_publish_order() {
+  MqttClient c(broker, fakeClock);
+  connect(c);
+
+  for (uint8_t i = 0; i < MqttClient::MAX_IN_FLIGHT; i++) {
+    c.publish("t", payload, sizeof(payload), 1);    // ids 1..8
+  }
+  broker.puback(1);
+  broker.puback(2);
+  broker.puback(3);
+  c.loop();
+  for (uint8_t i = 0; i < 3; i++) {
+    c.publish("t", payload, sizeof(payload), 1);    // ids 9..11 in slots 0..2
+  }
+
+  broker.close();                                   // link lost
+  TEST_ASSERT_FALSE(c.connected());
+  broker.skip();
+  TEST_ASSERT_TRUE(c.connect("test-node", false));
+
+  uint8_t h;
+  const uint8_t* body;
+  uint32_t len;
+  TEST_ASSERT_TRUE(broker.next(h, body, len));
+  TEST_ASSERT_EQUAL_HEX8(0x10, h);                  // CONNECT first
+  for (uint16_t id = 4; id <= 11; id++) {
+    TEST_ASSERT_TRUE(broker.next(h, body, len));
+    TEST_ASSERT_EQUAL_HEX8(0x30 | 0x08 | 0x02, h);  // PUBLISH, DUP, QoS 1
+    TEST_ASSERT_EQUAL(id, publishedId(body));
+  }
+  TEST_ASSERT_FALSE(broker.next(h, body, len));
+  TEST_ASSERT_EQUAL(8, c.stats().resent);
+}
+
+// Builds a QoS 1 PUBLISH with `topicLen` topic bytes and `payloadLen` payload
+static size_t buildPublish(uint8_t* p, uint16_t topicLen, uint16_t payloadLen, uint16_t id) {
+  uint32_t remaining = 2 + topicLen + 2 + payloadLen;
+  size_t n = 0;
+  p[n++] = 0x32;
+  do {
+    uint8_t b = remaining % 128;
+    remaining /= 128;
+    if (remaining) b |= 0x80;
+    p[n++] = b;
+  } while (remaining);
+  p[n++] = topicLen >> 8;
+  p[n++] = topicLen & 0xFF;
+  memset(p + n, 'a', topicLen);
+  n += topicLen;
+  p[n++] = id >> 8;
+  p[n++] = id & 0xFF;
+  memset(p + n, 0x5A, payloadLen);
+  return n + payloadLen;
+}
+
+static void assertPubackSent(uint16_t id) {
+  uint8_t h;
+  const uint8_t* body;
+  uint32_t len;
+  TEST_ASSERT_TRUE(broker.next(h, body, len));
+  TEST_ASSERT_EQUAL_HEX8(0x40, h);
+  TEST_ASSERT_EQUAL(2, len);
+  TEST_ASSERT_EQUAL(id, (body[0] << 8) | body[1]);
+}
+
+void test_inbound_publish_is_acked() {
+  MqttClient c(broker, fakeClock);
+  connect(c);
+  uint8_t p[64];
+  broker.reply(p, buildPublish(p, 5, 10, 0x0102));
+  c.loop();
+  assertPubackSent(0x0102);
+  TEST_ASSERT_EQUAL(0, c.stats().oversize);
+}
+
+// Bigger than the receive buffer: the payload is skipped, the id is
+// still acked, and the parser is in step for the next packet
+void test_oversize_inbound_publish_is_acked() {
+  MqttClient c(broker, fakeClock);
+  connect(c);
+  c.publish("t", payload, sizeof(payload), 1);
+  broker.skip();
+
+  uint8_t p[1024];
+  broker.reply(p, buildPublish(p, 10, 600, 0x1234));
+  broker.reply(p, buildPublish(p, 300, 20, 0x4321));   // id past the buffer too
+  broker.puback(1);
+  c.loop();
+
+  assertPubackSent(0x1234);
+  assertPubackSent(0x4321);
+  TEST_ASSERT_EQUAL(2, c.stats().oversize);
+  TEST_ASSERT_EQUAL(0, c.inFlight());                  // our ack still parsed
+  TEST_ASSERT_TRUE(c.connected());
+}
+
+void test_ack_timeout_drops_the_connection() {
+  MqttClient c(broker, fakeClock);
+  c.setAckTimeout(10000);
+  connect(c);
+  c.publish("t", payload, sizeof(payload), 1);
+
+  nowMs += 10000;
+  c.loop();
+  TEST_ASSERT_TRUE(c.connected());
+  nowMs += 1;
+  c.loop();
+  TEST_ASSERT_FALSE(c.connected());
+  TEST_ASSERT_EQUAL(1, c.inFlight());                  // kept for the resend
+}
+
+void test_keep_alive_ping_and_timeout() {
+  MqttClient c(broker, fakeClock);
+  c.setKeepAlive(30);
+  connect(c);
+
+  nowMs += 30000;
+  c.loop();
+  uint8_t h;
+  const uint8_t* body;
+  uint32_t len;
+  TEST_ASSERT_TRUE(broker.next(h, body, len));
+  TEST_ASSERT_EQUAL_HEX8(0xC0, h);
+
+  broker.reply((const uint8_t*)"\xD0\x00", 2);           // PINGRESP
+  nowMs += 20000;
+  c.loop();
+  TEST_ASSERT_TRUE(c.connected());
+
+  nowMs += 10000;                                      // second ping, never answered
+  c.loop();
+  nowMs += 30001;
+  c.loop();
+  TEST_ASSERT_FALSE(c.connected());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_connect_sends_connect_and_waits_for_connack);
+  RUN_TEST(test_refused_connect);
+  RUN_TEST(test_qos1_window_and_puback);
+  RUN_TEST(test_too_big_publish_is_rejected);
+  RUN_TEST(test_resend_after_reconnect_keeps_publish_order);
+  RUN_TEST(test_inbound_publish_is_acked);
+  RUN_TEST(test_oversize_inbound_publish_is_acked);
+  RUN_TEST(test_ack_timeout_drops_the_connection);
+  RUN_TEST(test_keep_alive_ping_and_timeout);
+  return UNITY_END();
+}
@@ -0,0 +1,217 @@
+// MqttClient against a real broker over PosixSocketTransport:
+//   mosquitto -p 1883 &
+//   MQTT_TEST_BROKER=127.0.0.1:1883 pio test -e native -f test_mqtt_broker
+// Ignored (not failed) when no broker answers.
+#include <unity.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MqttClient.h"
+#include "PosixSocketTransport.h"
+
+#define TOPIC "iotlabs/test/order"
+
+static char     s_host[64] = "127.0.0.1";
+static uint16_t s_port = 1883;
+
+static uint32_t wallClock() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void sleepMs(long ms) {
+  timespec ts = { ms / 1000, (ms % 1000) * 1000000 };
+  nanosleep(&ts, nullptr);
+}
+
+// ---- Raw QoS 0 subscriber, to see what the broker forwards ----
+
+class Subscriber {
+public:
+  uint32_t seen[64];     // payload counters, in arrival order
+  uint8_t  n = 0;
+
+  bool begin() {
+    if (!_t.open(s_host, s_port)) return false;
+    static const uint8_t connect[] = {
+      0x10, 18, 0, 4, 'M', 'Q', 'T', 'T', 4, 0x02, 0, 30, 0, 6, 's', 'u', 'b', 'o', 'r', 'd'
+    };
+    static const uint8_t subscribe[] = {
+      0x82, 2 + 2 + sizeof(TOPIC) - 1 + 1, 0, 1, 0, sizeof(TOPIC) - 1,
+      'i', 'o', 't', 'l', 'a', 'b', 's', '/', 't', 'e', 's', 't', '/', 'o', 'r', 'd', 'e', 'r', 0
+    };
+    _t.write(connect, sizeof(connect));
+    if (!waitFor(0x20)) return false;
+    _t.write(subscribe, sizeof(subscribe));
+    return waitFor(0x90);
+  }
+
+  // Reads for `ms`, collecting PUBLISH payloads
+  void poll(uint32_t ms) {
+    uint32_t start = wallClock();
+    while (wallClock() - start < ms) {
+      if (!readPacket()) sleepMs(1);
+    }
+  }
+
+private:
+  bool waitFor(uint8_t type) {
+    uint32_t start = wallClock();
+    while (wallClock() - start < 2000) {
+      if (readPacket() && (_header & 0xF0) == type) return true;
+      sleepMs(1);
+    }
+    return false;
+  }
+
+  // One whole packet from the stream buffer, if there is one
+  bool readPacket() {
+    int got = _t.read(_buf + _len, sizeof(_buf) - _len);
+    if (got > 0) _len += got;
+    if (_len < 2) return false;
+
+    uint32_t len = 0, mul = 1;
+    size_t i = 1;
+    while (i < _len && (_buf[i] & 0x80)) len += (_buf[i++] & 0x7F) * mul, mul *= 128;
+    if (i >= _len) return false;
+    len += _buf[i++] * mul;
+    if (_len < i + len) return false;
+
+    _header = _buf[0];
+    if ((_header & 0xF0) == 0x30 && n < 64) {
+      const uint8_t* body = _buf + i;
+      uint16_t topicLen = (body[0] << 8) | body[1];
+      const uint8_t* p = body + 2 + topicLen;   // QoS 0: no id
+      seen[n++] = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+    memmove(_buf, _buf + i + len, _len - i - len);
+    _len -= i + len;
+    return true;
+  }
+
+  PosixSocketTransport _t;
+  uint8_t _buf[4096];
+  size_t  _len = 0;
+  uint8_t _header = 0;
+};
+
+// Reads at most `allow` bytes while gated, so a test decides which acks
+// the client sees
+class GatedTransport : public PosixSocketTransport {
+public:
+  bool   gated = false;
+  size_t allow = 0;
+
+  int read(uint8_t* buf, size_t max) override {
+    if (!gated) return PosixSocketTransport::read(buf, max);
+    if (max > allow) max = allow;
+    if (max == 0) return 0;
+    int n = PosixSocketTransport::read(buf, max);
+    allow -= n;
+    return n;
+  }
+};
+
+static GatedTransport transport;
+
+static bool brokerUp() {
+  PosixSocketTransport probe;
+  return probe.open(s_host, s_port);
+}
+
+static void publishCounter(MqttClient& c, uint32_t i) {
+  uint8_t p[4] = { (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)(i >> 16), (uint8_t)(i >> 24) };
+  TEST_ASSERT_TRUE(c.publish(TOPIC, p, sizeof(p), 1));
+}
+
+static void loopUntilAcked(MqttClient& c) {
+  uint32_t start = wallClock();
+  while (c.inFlight() && wallClock() - start < 3000) {
+    c.loop();
+    sleepMs(1);
+  }
+  TEST_ASSERT_EQUAL(0, c.inFlight());
+}
+
+void setUp() {
+  if (!brokerUp()) TEST_IGNORE_MESSAGE("no MQTT broker, set MQTT_TEST_BROKER=host:port");
+}
+
+void tearDown() {
+  transport.close();
+}
+
+void test_qos1_publishes_arrive_in_order() {
+  Subscriber sub;
+  TEST_ASSERT_TRUE(sub.begin());
+
+  MqttClient c(transport, wallClock);
+  c.setServer(s_host, s_port);
+  TEST_ASSERT_TRUE(c.connect("iotlabs-test-order", true));
+
+  for (uint32_t i = 0; i < 40; i++) {
+    while (c.inFlight() == MqttClient::MAX_IN_FLIGHT) c.loop();
+    publishCounter(c, i);
+  }
+  loopUntilAcked(c);
+  TEST_ASSERT_EQUAL(40, c.stats().acked);
+
+  sub.poll(300);
+  TEST_ASSERT_EQUAL(40, sub.n);
+  for (uint8_t i = 0; i < 40; i++) TEST_ASSERT_EQUAL_UINT32(i, sub.seen[i]);
+  c.disconnect();
+}
+
+// Link dropped before the acks were read: the reconnect resends the
+// window with DUP, oldest first even though the slots were reused
+// out of order, and the broker acks it
+void test_persistent_session_resends_in_publish_order() {
+  Subscriber sub;
+  TEST_ASSERT_TRUE(sub.begin());
+
+  MqttClient c(transport, wallClock);
+  c.setServer(s_host, s_port);
+  TEST_ASSERT_TRUE(c.connect("iotlabs-test-resend", false));
+
+  // 0..7 fill the slots, only the acks of 0..2 are read, 8..10 take
+  // slots 0..2
+  transport.gated = true;
+  for (uint32_t i = 0; i < 8; i++) publishCounter(c, i);
+  sleepMs(200);
+  transport.allow = 3 * 4;                   // three PUBACKs
+  c.loop();
+  TEST_ASSERT_EQUAL(5, c.inFlight());
+  for (uint32_t i = 8; i < 11; i++) publishCounter(c, i);
+  sleepMs(200);                              // let them reach the broker
+
+  transport.close();                         // the other acks are lost with it
+  transport.gated = false;
+  TEST_ASSERT_FALSE(c.connected());
+  TEST_ASSERT_EQUAL(8, c.inFlight());
+  TEST_ASSERT_TRUE(c.connect("iotlabs-test-resend", false));
+  TEST_ASSERT_EQUAL(8, c.stats().resent);
+  loopUntilAcked(c);
+
+  // 0..10 once, then the resent 3..10 again, in order
+  sub.poll(300);
+  TEST_ASSERT_EQUAL(19, sub.n);
+  for (uint8_t i = 0; i < 8; i++) TEST_ASSERT_EQUAL_UINT32(3 + i, sub.seen[11 + i]);
+  c.disconnect();
+}
+
+int main(int argc, char** argv) {
+  if (const char* env = getenv("MQTT_TEST_BROKER")) {
+    snprintf(s_host, sizeof(s_host), "%s", env);
+    if (char* colon = strrchr(s_host, ':')) {
+      *colon = 0;
+      s_port = (uint16_t)atoi(colon + 1);
+    }
+  }
+  UNITY_BEGIN();
+  RUN_TEST(test_qos1_publishes_arrive_in_order);
+  RUN_TEST(test_persistent_session_resends_in_publish_order);
+  return UNITY_END();
+}
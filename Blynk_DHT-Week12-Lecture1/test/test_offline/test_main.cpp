@@ -0,0 +1,386 @@
+// OfflineQueue, LittleFsSpillStore and StoreAndForward against a stub
+// backend whose link can be pulled: pio test -e native
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "LittleFsSpillStore.h"
+#include "OfflineQueue.h"
+#include "StoreAndForward.h"
+#include "TelemetryPublisher.h"
+
+#define TEMP_PIN 0
+#define HUM_PIN  1
+
+// ---- Stubs ----
+
+// The backend: link up or down, records live frames and replayed samples,
+// can take only part of a replay batch
+struct StubBackend {
+  bool         up;
+  bool         refuseLive;
+  uint16_t     replayLimit;      // samples taken per replay call, 0 = all
+  uint16_t     liveFrames;
+  uint16_t     livePoints;
+  QueuedSample replayed[512];
+  uint16_t     nReplayed;
+};
+
+static StubBackend backend;
+static uint32_t nowMs;
+
+static bool stubOnline() { return backend.up; }
+static uint32_t stubClock() { return nowMs; }
+
+static bool stubLive(const TelemetryPoint* points, uint8_t count, void* ctx) {
+  if (!backend.up || backend.refuseLive) return false;
+  backend.liveFrames++;
+  backend.livePoints += count;
+  return true;
+}
+
+static uint16_t stubReplay(const QueuedSample* samples, uint16_t count, void* ctx) {
+  if (!backend.up) return 0;
+  if (backend.replayLimit && count > backend.replayLimit) count = backend.replayLimit;
+  for (uint16_t i = 0; i < count && backend.nReplayed < 512; i++) {
+    backend.replayed[backend.nReplayed++] = samples[i];
+  }
+  return count;
+}
+
+// Flash stand-in in RAM; peek() can be made to fail
+class MemorySpill : public SpillStore {
+public:
+  static const uint16_t CAPACITY = 256;
+  bool failPeek = false;
+
+  bool append(const QueuedSample* samples, uint16_t count) override {
+    if (_size + count > CAPACITY) return false;
+    for (uint16_t i = 0; i < count; i++) _buf[_size++] = samples[i];
+    return true;
+  }
+  uint16_t peek(QueuedSample* out, uint16_t max) override {
+    if (failPeek) return 0;
+    uint16_t n = _size < max ? _size : max;
+    for (uint16_t i = 0; i < n; i++) out[i] = _buf[i];
+    return n;
+  }
+  void pop(uint16_t count) override {
+    if (count > _size) count = _size;
+    for (uint32_t i = count; i < _size; i++) _buf[i - count] = _buf[i];
+    _size -= count;
+  }
+  void clear() override { _size = 0; }
+  uint32_t size() const override { return _size; }
+
+private:
+  QueuedSample _buf[CAPACITY];
+  uint32_t     _size = 0;
+};
+
+static QueuedSample sample(uint32_t i) {
+  QueuedSample s = { i * 1000, (uint8_t)(i % 2), (float)i };
+  return s;
+}
+
+// Replayed samples are exactly first..first+count-1, in order
+static void assertReplayed(uint32_t first, uint16_t count) {
+  TEST_ASSERT_EQUAL(count, backend.nReplayed);
+  for (uint16_t i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_UINT32((first + i) * 1000, backend.replayed[i].timestampMs);
+  }
+}
+
+// Drains until the queue is empty, one batch per gap
+static void drainAll(OfflineQueue& q) {
+  for (int i = 0; i < 1000 && !q.empty(); i++) {
+    nowMs += 1000;
+    q.drain(nowMs, stubReplay);
+  }
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+void setUp() {
+  backend = StubBackend();
+  backend.up = true;
+  nowMs = 0;
+  littleFsEmuFailReads(false);
+}
+
+void tearDown() {}
+
+// ---- OfflineQueue ----
+
+void test_ram_queue_drains_in_spaced_batches() {
+  QueuedSample buf[8];
+  OfflineQueue q(buf, 8);
+  q.setDrainRate(2, 1000);
+  for (uint32_t i = 0; i < 5; i++) q.push(sample(i));
+
+  TEST_ASSERT_EQUAL(2, q.drain(0, stubReplay));
+  TEST_ASSERT_EQUAL(0, q.drain(999, stubReplay));   // gap not over
+  TEST_ASSERT_EQUAL(2, q.drain(1000, stubReplay));
+  TEST_ASSERT_EQUAL(1, q.drain(2000, stubReplay));
+  TEST_ASSERT_EQUAL(0, q.drain(3000, stubReplay));
+  assertReplayed(0, 5);
+  TEST_ASSERT_EQUAL(5, q.stats(3000).drained);
+}
+
+void test_full_ram_drops_oldest_without_spill() {
+  QueuedSample buf[4];
+  OfflineQueue q(buf, 4);
+  for (uint32_t i = 0; i < 6; i++) q.push(sample(i));
+
+  TEST_ASSERT_EQUAL(2, q.stats(0).dropped);
+  drainAll(q);
+  assertReplayed(2, 4);
+}
+
+void test_spill_keeps_the_oldest_and_drains_first() {
+  QueuedSample buf[4];
+  MemorySpill spill;
+  OfflineQueue q(buf, 4, &spill);
+  q.setDrainRate(3, 1000);
+  for (uint32_t i = 0; i < 10; i++) q.push(sample(i));
+
+  OfflineQueueStats s = q.stats(0);
+  TEST_ASSERT_EQUAL(10, s.depth);
+  TEST_ASSERT_EQUAL(0, s.dropped);
+  TEST_ASSERT_GREATER_THAN(0, s.spillDepth);
+  drainAll(q);
+  assertReplayed(0, 10);
+}
+
+void test_partial_send_pops_only_what_went_out() {
+  QueuedSample buf[8];
+  OfflineQueue q(buf, 8);
+  q.setDrainRate(4, 1000);
+  for (uint32_t i = 0; i < 6; i++) q.push(sample(i));
+
+  backend.replayLimit = 3;
+  TEST_ASSERT_EQUAL(3, q.drain(0, stubReplay));
+  TEST_ASSERT_EQUAL(3, q.depth());
+
+  backend.up = false;                       // refuses the whole batch
+  TEST_ASSERT_EQUAL(0, q.drain(1000, stubReplay));
+  TEST_ASSERT_EQUAL(3, q.depth());
+
+  backend.up = true;
+  drainAll(q);
+  assertReplayed(0, 6);                     // nothing twice, nothing lost
+}
+
+void test_unreadable_spill_is_dropped_and_ram_drains() {
+  QueuedSample buf[4];
+  MemorySpill spill;
+  OfflineQueue q(buf, 4, &spill);
+  for (uint32_t i = 0; i < 10; i++) q.push(sample(i));
+  uint32_t inFlash = spill.size();
+  TEST_ASSERT_GREATER_THAN(0, inFlash);
+
+  spill.failPeek = true;
+  TEST_ASSERT_GREATER_THAN(0, q.drain(0, stubReplay));
+  TEST_ASSERT_EQUAL(0, spill.size());
+  TEST_ASSERT_EQUAL(inFlash, q.stats(0).dropped);
+
+  drainAll(q);
+  assertReplayed(inFlash, 10 - inFlash);
+}
+
+// ---- LittleFsSpillStore ----
+
+void test_littlefs_store_round_trip() {
+  LittleFsSpillStore store("/offline.bin", 64);
+  TEST_ASSERT_TRUE(store.begin());
+
+  QueuedSample in[10];
+  for (uint32_t i = 0; i < 10; i++) in[i] = sample(i);
+  TEST_ASSERT_TRUE(store.append(in, 10));
+  TEST_ASSERT_EQUAL(10, store.size());
+
+  QueuedSample out[4];
+  TEST_ASSERT_EQUAL(4, store.peek(out, 4));
+  TEST_ASSERT_EQUAL_UINT32(3000, out[3].timestampMs);
+  store.pop(4);
+  TEST_ASSERT_EQUAL(4, store.peek(out, 4));
+  TEST_ASSERT_EQUAL_UINT32(4000, out[0].timestampMs);
+
+  store.pop(6);
+  TEST_ASSERT_EQUAL(0, store.size());
+  TEST_ASSERT_FALSE(LittleFS.exists("/offline.bin"));
+}
+
+void test_littlefs_store_refuses_past_max() {
+  LittleFsSpillStore store("/offline.bin", 16);
+  store.begin();
+  QueuedSample in[10];
+  for (uint32_t i = 0; i < 10; i++) in[i] = sample(i);
+
+  TEST_ASSERT_TRUE(store.append(in, 10));
+  TEST_ASSERT_FALSE(store.append(in, 10));
+  TEST_ASSERT_EQUAL(10, store.size());
+}
+
+// A backlog that never empties: the replayed front is cut off, the file
+// stays bounded and the order survives every compaction
+void test_littlefs_store_compacts_a_standing_backlog() {
+  const uint32_t maxSamples = 64;
+  LittleFsSpillStore store("/offline.bin", maxSamples);
+  store.begin();
+
+  uint32_t next = 0, expect = 0;
+  QueuedSample in[8], out[8];
+  for (uint8_t i = 0; i < 4; i++) {
+    for (uint8_t k = 0; k < 8; k++) in[k] = sample(next++);
+    TEST_ASSERT_TRUE(store.append(in, 8));
+  }
+
+  size_t biggest = 0;
+  for (int round = 0; round < 200; round++) {
+    for (uint8_t k = 0; k < 8; k++) in[k] = sample(next++);
+    TEST_ASSERT_TRUE(store.append(in, 8));
+
+    File f = LittleFS.open("/offline.bin", FILE_READ);
+    if (f.size() > biggest) biggest = f.size();
+    f.close();
+
+    TEST_ASSERT_EQUAL(8, store.peek(out, 8));
+    for (uint8_t k = 0; k < 8; k++) {
+      TEST_ASSERT_EQUAL_UINT32(expect * 1000, out[k].timestampMs);
+      expect++;
+    }
+    store.pop(8);
+  }
+
+  TEST_ASSERT_EQUAL(32, store.size());
+  TEST_ASSERT_LESS_OR_EQUAL(maxSamples * 5 / 4 * sizeof(QueuedSample), biggest);
+  TEST_ASSERT_FALSE(LittleFS.exists("/offline.bin.tmp"));
+}
+
+void test_littlefs_read_failure_does_not_stall_the_queue() {
+  LittleFsSpillStore store("/offline.bin", 64);
+  store.begin();
+  QueuedSample buf[4];
+  OfflineQueue q(buf, 4, &store);
+  for (uint32_t i = 0; i < 10; i++) q.push(sample(i));
+  uint32_t inFlash = store.size();
+
+  littleFsEmuFailReads(true);
+  TEST_ASSERT_GREATER_THAN(0, q.drain(0, stubReplay));
+  littleFsEmuFailReads(false);
+
+  TEST_ASSERT_EQUAL(inFlash, q.stats(0).dropped);
+  TEST_ASSERT_FALSE(LittleFS.exists("/offline.bin"));
+  drainAll(q);
+  assertReplayed(inFlash, 10 - inFlash);
+}
+
+// ---- StoreAndForward ----
+
+// The contract: offline, the frame is queued and reported as SENT, so
+// TelemetryPublisher neither counts a failure nor offers it again
+void test_offline_frame_is_queued_and_reported_sent() {
+  QueuedSample buf[16];
+  OfflineQueue q(buf, 16);
+  StoreAndForward sf = { stubOnline, stubLive, nullptr, &q, stubClock };
+  TelemetryPublisher pub(storeAndForwardSend, &sf);
+  pub.addChannel(TEMP_PIN, 0.5f, 2000, 60000);
+  pub.addChannel(HUM_PIN, 1.0f, 2000, 60000);
+
+  backend.up = false;
+  nowMs = 7000;
+  pub.update(0, 21.0f);
+  pub.update(1, 40.0f);
+  TEST_ASSERT_EQUAL(2, pub.poll(nowMs));
+  TEST_ASSERT_EQUAL(1, pub.stats().framesSent);
+  TEST_ASSERT_EQUAL(0, pub.stats().sendFailures);
+  TEST_ASSERT_EQUAL(2, q.depth());
+  TEST_ASSERT_EQUAL(0, backend.liveFrames);
+
+  // Not pending any more: later polls add nothing
+  TEST_ASSERT_EQUAL(0, pub.poll(8000));
+  TEST_ASSERT_EQUAL(2, q.depth());
+
+  // Back online: the backlog carries the time the values were taken
+  backend.up = true;
+  TEST_ASSERT_EQUAL(2, q.drain(9000, stubReplay));
+  TEST_ASSERT_EQUAL_UINT32(7000, backend.replayed[0].timestampMs);
+  TEST_ASSERT_EQUAL_UINT32(7000, backend.replayed[1].timestampMs);
+
+  pub.update(0, 23.0f);
+  TEST_ASSERT_EQUAL(1, pub.poll(10000));
+  TEST_ASSERT_EQUAL(1, backend.liveFrames);
+  TEST_ASSERT_EQUAL(0, q.depth());
+}
+
+void test_online_live_failure_stays_pending() {
+  QueuedSample buf[16];
+  OfflineQueue q(buf, 16);
+  StoreAndForward sf = { stubOnline, stubLive, nullptr, &q, stubClock };
+  TelemetryPublisher pub(storeAndForwardSend, &sf);
+  pub.addChannel(TEMP_PIN, 0.5f, 2000, 60000);
+
+  backend.refuseLive = true;
+  pub.update(0, 21.0f);
+  TEST_ASSERT_EQUAL(0, pub.poll(0));
+  TEST_ASSERT_EQUAL(1, pub.stats().sendFailures);
+  TEST_ASSERT_EQUAL(0, q.depth());
+
+  backend.refuseLive = false;
+  TEST_ASSERT_EQUAL(1, pub.poll(100));
+  TEST_ASSERT_EQUAL(1, backend.liveFrames);
+}
+
+// The sketch's loop on a fake clock with the link flapping: every value
+// that went out while down is replayed exactly once, oldest first
+void test_flapping_link_replays_everything_once() {
+  QueuedSample buf[16];
+  LittleFsSpillStore store("/offline.bin", 256);
+  store.begin();
+  OfflineQueue q(buf, 16, &store);
+  q.setDrainRate(8, 1000);
+  StoreAndForward sf = { stubOnline, stubLive, nullptr, &q, stubClock };
+  TelemetryPublisher pub(storeAndForwardSend, &sf);
+  pub.addChannel(TEMP_PIN, 0.5f, 2000, 60000);
+  pub.addChannel(HUM_PIN, 1.0f, 2000, 60000);
+
+  uint32_t queuedWhileDown = 0;
+  for (nowMs = 0; nowMs < 30UL * 60 * 1000; nowMs += 5000) {
+    // down 2-8 min and 12-13 min
+    backend.up = !(nowMs >= 120000 && nowMs < 480000) && !(nowMs >= 720000 && nowMs < 780000);
+
+    uint32_t step = nowMs / 5000;
+    pub.update(0, 20.0f + step % 7);
+    pub.update(1, 40.0f + step % 11);
+    uint32_t before = q.stats(nowMs).queued;
+    pub.poll(nowMs);
+    queuedWhileDown += q.stats(nowMs).queued - before;
+
+    if (backend.up) q.drain(nowMs, stubReplay);
+  }
+
+  TEST_ASSERT_GREATER_THAN(16, queuedWhileDown);   // some went through flash
+  TEST_ASSERT_TRUE(q.empty());
+  TEST_ASSERT_EQUAL(0, q.stats(nowMs).dropped);
+  TEST_ASSERT_EQUAL(queuedWhileDown, backend.nReplayed);
+  for (uint16_t i = 1; i < backend.nReplayed; i++) {
+    TEST_ASSERT_TRUE(backend.replayed[i - 1].timestampMs <= backend.replayed[i].timestampMs);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ram_queue_drains_in_spaced_batches);
+  RUN_TEST(test_full_ram_drops_oldest_without_spill);
+  RUN_TEST(test_spill_keeps_the_oldest_and_drains_first);
+  RUN_TEST(test_partial_send_pops_only_what_went_out);
+  RUN_TEST(test_unreadable_spill_is_dropped_and_ram_drains);
+  RUN_TEST(test_littlefs_store_round_trip);
+  RUN_TEST(test_littlefs_store_refuses_past_max);
+  RUN_TEST(test_littlefs_store_compacts_a_standing_backlog);
+  RUN_TEST(test_littlefs_read_failure_does_not_stall_the_queue);
+  RUN_TEST(test_offline_frame_is_queued_and_reported_sent);
+  RUN_TEST(test_online_live_failure_stays_pending);
+  RUN_TEST(test_flapping_link_replays_everything_once);
+  return UNITY_END();
+}
@@ -0,0 +1,203 @@
+// TelemetryPublisher against a stub transport: pio test -e native
+#include <unity.h>
+
+#include <math.h>
+
+#include "TelemetryPublisher.h"
+
+#define TEMP_PIN 0
+#define HUM_PIN  1
+
+// The stub keeps the last frame it accepted and can refuse one
+struct StubTransport {
+  bool           accept;
+  uint8_t        calls;
+  uint8_t        count;
+  TelemetryPoint frame[TelemetryPublisher::MAX_CHANNELS];
+};
+
+static StubTransport stub;
+
+static bool stubSend(const TelemetryPoint* points, uint8_t count, void* ctx) {
+  StubTransport& s = *(StubTransport*)ctx;
+  s.calls++;
+  if (!s.accept) return false;
+  s.count = count;
+  for (uint8_t i = 0; i < count; i++) s.frame[i] = points[i];
+  return true;
+}
+
+// Value of `pin` in the last frame, NAN if it wasn't in it
+static float sent(uint8_t pin) {
+  for (uint8_t i = 0; i < stub.count; i++) {
+    if (stub.frame[i].pin == pin) return stub.frame[i].value;
+  }
+  return NAN;
+}
+
+// The two channels main.cpp sets up: 2 s min interval, 60 s heartbeat
+static void addChannels(TelemetryPublisher& pub) {
+  TEST_ASSERT_EQUAL(0, pub.addChannel(TEMP_PIN, 0.5f, 2000, 60000));
+  TEST_ASSERT_EQUAL(1, pub.addChannel(HUM_PIN, 1.0f, 2000, 60000));
+}
+
+// Both channels sent once at t = 0
+static void startAtZero(TelemetryPublisher& pub) {
+  addChannels(pub);
+  pub.update(0, 21.0f);
+  pub.update(1, 40.0f);
+  TEST_ASSERT_EQUAL(2, pub.poll(0));
+  stub.calls = 0;
+  stub.count = 0;
+}
+
+void setUp() {
+  stub = StubTransport();
+  stub.accept = true;
+}
+
+void tearDown() {}
+
+void test_first_values_go_out_in_one_frame() {
+  TelemetryPublisher pub(stubSend, &stub);
+  addChannels(pub);
+
+  TEST_ASSERT_EQUAL(0, pub.poll(0));   // nothing offered yet
+  TEST_ASSERT_EQUAL(0, stub.calls);
+
+  pub.update(0, 21.0f);
+  pub.update(1, NAN);                  // failed read, ignored
+  pub.update(1, 40.0f);
+  TEST_ASSERT_EQUAL(2, pub.poll(100));
+  TEST_ASSERT_EQUAL(1, stub.calls);
+  TEST_ASSERT_EQUAL_FLOAT(21.0f, sent(TEMP_PIN));
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, sent(HUM_PIN));
+  TEST_ASSERT_EQUAL(2, pub.stats().offered);
+  TEST_ASSERT_EQUAL(1, pub.stats().framesSent);
+}
+
+void test_deadband_drops_small_changes() {
+  TelemetryPublisher pub(stubSend, &stub);
+  startAtZero(pub);
+
+  pub.update(0, 21.3f);
+  TEST_ASSERT_EQUAL(0, pub.poll(5000));
+  TEST_ASSERT_EQUAL(1, pub.stats().suppressed);
+
+  // Not kept pending: the next poll has nothing either
+  TEST_ASSERT_EQUAL(0, pub.poll(6000));
+  TEST_ASSERT_EQUAL(0, stub.calls);
+}
+
+void test_change_waits_for_min_interval() {
+  TelemetryPublisher pub(stubSend, &stub);
+  startAtZero(pub);
+
+  pub.update(0, 22.0f);
+  TEST_ASSERT_EQUAL(0, pub.poll(1000));
+  pub.update(0, 23.0f);                // supersedes 22.0, never sent
+  TEST_ASSERT_EQUAL(0, pub.poll(1999));
+  TEST_ASSERT_EQUAL(1, pub.poll(2000));
+  TEST_ASSERT_EQUAL_FLOAT(23.0f, sent(TEMP_PIN));
+  TEST_ASSERT_TRUE(isnan(sent(HUM_PIN)));   // far from its heartbeat
+  TEST_ASSERT_EQUAL(1, pub.stats().suppressed);
+}
+
+void test_heartbeat_resends_unchanged_values() {
+  TelemetryPublisher pub(stubSend, &stub);
+  startAtZero(pub);
+
+  TEST_ASSERT_EQUAL(0, pub.poll(59999));
+  TEST_ASSERT_EQUAL(2, pub.poll(60000));
+  TEST_ASSERT_EQUAL(1, stub.calls);      // both in one frame
+  TEST_ASSERT_EQUAL_FLOAT(21.0f, sent(TEMP_PIN));
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, sent(HUM_PIN));
+  TEST_ASSERT_EQUAL(2, pub.stats().heartbeats);
+
+  TEST_ASSERT_EQUAL(0, pub.poll(119999));
+  TEST_ASSERT_EQUAL(2, pub.poll(120000));
+  TEST_ASSERT_EQUAL(4, pub.stats().heartbeats);
+}
+
+void test_zero_max_interval_has_no_heartbeat() {
+  TelemetryPublisher pub(stubSend, &stub);
+  pub.addChannel(TEMP_PIN, 0.5f, 2000, 0);
+  pub.update(0, 21.0f);
+  pub.poll(0);
+
+  TEST_ASSERT_EQUAL(0, pub.poll(10UL * 60 * 60 * 1000));
+  TEST_ASSERT_EQUAL(0, pub.stats().heartbeats);
+}
+
+void test_ride_along_past_half_the_heartbeat() {
+  TelemetryPublisher pub(stubSend, &stub);
+  startAtZero(pub);
+
+  // Humidity is 10 s into a 60 s heartbeat: stays out
+  pub.update(0, 22.0f);
+  TEST_ASSERT_EQUAL(1, pub.poll(10000));
+  TEST_ASSERT_TRUE(isnan(sent(HUM_PIN)));
+
+  // 40 s in, past half: joins the temperature frame as a heartbeat
+  pub.update(0, 23.0f);
+  TEST_ASSERT_EQUAL(2, pub.poll(40000));
+  TEST_ASSERT_EQUAL_FLOAT(23.0f, sent(TEMP_PIN));
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, sent(HUM_PIN));
+  TEST_ASSERT_EQUAL(1, pub.stats().heartbeats);
+
+  // Both were sent at 40 s, so their next heartbeats share a frame
+  stub.calls = 0;
+  TEST_ASSERT_EQUAL(0, pub.poll(99999));
+  TEST_ASSERT_EQUAL(2, pub.poll(100000));
+  TEST_ASSERT_EQUAL(1, stub.calls);
+}
+
+void test_refused_frame_stays_pending() {
+  TelemetryPublisher pub(stubSend, &stub);
+  addChannels(pub);
+
+  stub.accept = false;
+  pub.update(0, 21.0f);
+  pub.update(1, 40.0f);
+  TEST_ASSERT_EQUAL(0, pub.poll(0));
+  TEST_ASSERT_EQUAL(1, pub.stats().sendFailures);
+  TEST_ASSERT_EQUAL(0, pub.stats().framesSent);
+
+  pub.update(0, 21.5f);
+  stub.accept = true;
+  TEST_ASSERT_EQUAL(2, pub.poll(100));
+  TEST_ASSERT_EQUAL_FLOAT(21.5f, sent(TEMP_PIN));
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, sent(HUM_PIN));
+  TEST_ASSERT_EQUAL(0, pub.poll(200));
+}
+
+void test_force_all_sends_unchanged_values() {
+  TelemetryPublisher pub(stubSend, &stub);
+  startAtZero(pub);
+
+  pub.forceAll();
+  TEST_ASSERT_EQUAL(2, pub.poll(500));
+  TEST_ASSERT_EQUAL(0, pub.poll(600));   // only once
+}
+
+void test_channel_table_full() {
+  TelemetryPublisher pub(stubSend, &stub);
+  for (uint8_t i = 0; i < TelemetryPublisher::MAX_CHANNELS; i++) {
+    TEST_ASSERT_EQUAL(i, pub.addChannel(i, 1, 0, 0));
+  }
+  TEST_ASSERT_EQUAL(-1, pub.addChannel(99, 1, 0, 0));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_values_go_out_in_one_frame);
+  RUN_TEST(test_deadband_drops_small_changes);
+  RUN_TEST(test_change_waits_for_min_interval);
+  RUN_TEST(test_heartbeat_resends_unchanged_values);
+  RUN_TEST(test_zero_max_interval_has_no_heartbeat);
+  RUN_TEST(test_ride_along_past_half_the_heartbeat);
+  RUN_TEST(test_refused_frame_stays_pending);
+  RUN_TEST(test_force_all_sends_unchanged_values);
+  RUN_TEST(test_channel_table_full);
+  return UNITY_END();
+}
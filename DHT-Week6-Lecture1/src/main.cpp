@@ -3,6 +3,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <DHT.h>
+#include <FixedFmt.h>   // integer float formatting, no String
 
 // --- Pin configuration ---
 #define DHTPIN 14        // DHT22 data pin
@@ -57,9 +58,9 @@ void loop() {
 
   // Print values on Serial Monitor
   Serial.print("Temperature: ");
-  Serial.print(temperature);
+  Serial.print(FixedNum(temperature, 2));
   Serial.print(" °C  |  Humidity: ");
-  Serial.print(humidity);
+  Serial.print(FixedNum(humidity, 2));
   Serial.println(" %");
 
   // Display on OLED
@@ -69,11 +70,11 @@ void loop() {
   display.println("Hello IoT");
   display.setCursor(0, 16);
   display.print("Temp: ");
-  display.print(temperature);
+  display.print(FixedNum(temperature, 2));
   display.println(" C");
   display.setCursor(0, 32);
   display.print("Humidity: ");
-  display.print(humidity);
+  display.print(FixedNum(humidity, 2));
   display.println(" %");
   display.display();
 
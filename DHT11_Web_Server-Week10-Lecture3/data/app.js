@@ -0,0 +1,55 @@
+// Fills in the page from /data every 5 s (the old page reloaded
+// itself as often); only these few values cross the network.
+var POLL_MS = 5000;
+
+// StreamStats flag bits
+var FLAGS = [[1, "low"], [2, "high"], [4, "spike"], [8, "fast-change"], [16, "read-errors"]];
+
+function $(id) {
+  return document.getElementById(id);
+}
+
+function fixed(v, d) {
+  return v === null ? "--" : v.toFixed(d);
+}
+
+function windowLine(name, unit, w) {
+  var s = "<b>" + name + ":</b> mean " + fixed(w.mean, 1) + unit +
+          ", " + fixed(w.min, 0) + ".." + fixed(w.max, 0) +
+          ", sd " + fixed(w.sd, 2) +
+          ", trend " + fixed(w.trend, 1) + unit + "/h";
+  var words = FLAGS.filter(function (f) { return w.flags & f[0]; })
+                   .map(function (f) { return f[1]; });
+  if (words.length) s += ' <span class="flags">[ ' + words.join(" ") + " ]</span>";
+  return s;
+}
+
+function show(d) {
+  var valid = d.temp !== null && d.hum !== null;
+  $("now").hidden = !valid;
+  $("nodata").hidden = valid;
+  $("temp").textContent = fixed(d.temp, 1);
+  $("hum").textContent = fixed(d.hum, 1);
+
+  $("minutes").textContent = d.minutes;
+  $("n").textContent = d.collecting;
+  $("collecting").hidden = !!d.window;
+  $("window").hidden = !d.window;
+  if (d.window) {
+    $("wtemp").innerHTML = windowLine("Temperature", " &deg;C", d.window.temp);
+    $("whum").innerHTML = windowLine("Humidity", " %", d.window.hum);
+    $("count").textContent = d.window.count;
+    $("flagged").textContent = d.window.flagged;
+  }
+  $("status").textContent = "";
+}
+
+function poll() {
+  fetch("/data")
+    .then(function (r) { return r.json(); })
+    .then(show)
+    .catch(function () { $("status").textContent = "Board not reachable, retrying..."; })
+    .then(function () { setTimeout(poll, POLL_MS); });
+}
+
+poll();
@@ -0,0 +1,107 @@
+// Generated by tools/webassets/embed.py from data/, do not edit.
+#pragma once
+
+#include <WebAssets.h>
+
+// app.js: 1791 bytes, 1511 minified, 709 gzipped
+constexpr uint8_t WEB_app_js[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x54, 0x5d, 0x6f, 0xd3, 0x30,
+  0x14, 0x7d, 0xcf, 0xaf, 0xb8, 0xb3, 0x46, 0x49, 0xd4, 0xd4, 0x6d, 0x27, 0x40, 0x68, 0x69, 0x8b,
+  0xd8, 0xc4, 0x18, 0x52, 0x27, 0x90, 0xd8, 0x5b, 0x55, 0x21, 0xaf, 0x76, 0x12, 0x8f, 0xd4, 0xa9,
+  0x1c, 0xa7, 0xd9, 0x84, 0xf6, 0xdf, 0xb9, 0xb6, 0xd3, 0xb5, 0x61, 0x2b, 0x4f, 0xb1, 0xef, 0x39,
+  0xf7, 0xeb, 0xdc, 0xeb, 0x6c, 0x99, 0x86, 0x1f, 0xdf, 0xe7, 0xf3, 0x5f, 0x37, 0x3f, 0x61, 0x0a,
+  0xef, 0x47, 0xa3, 0x51, 0x12, 0x6c, 0xd1, 0x76, 0x35, 0xff, 0xfc, 0xd5, 0x5a, 0x16, 0x8b, 0x71,
+  0x0c, 0xa4, 0x28, 0x1b, 0xb2, 0x8c, 0x61, 0x71, 0x86, 0xe7, 0x5c, 0x66, 0xb9, 0xbb, 0xbc, 0xc3,
+  0x4b, 0xb5, 0x91, 0xbf, 0x85, 0xbb, 0x7d, 0xc4, 0x5b, 0xca, 0x2a, 0x33, 0x58, 0xe5, 0x4c, 0x65,
+  0xde, 0x36, 0xfe, 0x80, 0x46, 0x2d, 0x18, 0x1f, 0x08, 0xad, 0x4b, 0x5d, 0x91, 0xe5, 0x32, 0x09,
+  0xd2, 0x5a, 0xad, 0x8c, 0x2c, 0x15, 0x9c, 0x86, 0x92, 0x47, 0xf0, 0x27, 0xd0, 0xc2, 0xd4, 0x5a,
+  0x01, 0x2f, 0x57, 0xf5, 0x5a, 0x28, 0x43, 0x33, 0x61, 0xbe, 0x14, 0xc2, 0x1e, 0x2f, 0x1e, 0xbf,
+  0x71, 0x4b, 0x4a, 0x82, 0xa7, 0xbd, 0x5b, 0x2a, 0x1f, 0x04, 0x0f, 0xb7, 0x31, 0x1c, 0x3a, 0x6f,
+  0x61, 0x3a, 0x9d, 0x82, 0xaa, 0x8b, 0x02, 0x3e, 0x01, 0x19, 0x0c, 0x08, 0x9c, 0xc3, 0x96, 0x9a,
+  0xf2, 0xca, 0x91, 0xff, 0x89, 0xd0, 0x48, 0xc5, 0xcb, 0x66, 0x2e, 0x95, 0x08, 0x15, 0x5b, 0x8b,
+  0x18, 0x6a, 0x25, 0x4d, 0x0c, 0x8d, 0x8d, 0x67, 0x7b, 0xaf, 0xb0, 0x6f, 0x32, 0xb9, 0x9b, 0x11,
+  0xe8, 0x83, 0x25, 0xe0, 0x87, 0x9c, 0x4f, 0x86, 0x77, 0x33, 0x58, 0x0b, 0xa6, 0xc0, 0x9a, 0x7d,
+  0x11, 0x0d, 0xb5, 0x86, 0x18, 0xc6, 0x11, 0x9a, 0x6c, 0x10, 0xe8, 0x07, 0x24, 0xee, 0x12, 0x24,
+  0xe2, 0x23, 0x8b, 0x13, 0x4a, 0x3b, 0x00, 0x7b, 0xf0, 0x80, 0xf5, 0xa8, 0x78, 0xc7, 0xa9, 0xe2,
+  0x31, 0x9c, 0xb5, 0x90, 0xd1, 0x42, 0x75, 0x51, 0x67, 0xe9, 0x24, 0x05, 0x32, 0xcc, 0x89, 0x9f,
+  0x5b, 0x53, 0x6a, 0x6e, 0xeb, 0x77, 0xf3, 0xa3, 0xa9, 0x2c, 0x8c, 0xd0, 0xe1, 0x73, 0xe7, 0x61,
+  0x8a, 0x3d, 0x42, 0xab, 0x59, 0x43, 0xd3, 0x82, 0x65, 0x15, 0xf4, 0x20, 0x5d, 0x8c, 0x96, 0x09,
+  0x3c, 0x45, 0x01, 0x56, 0xb5, 0x39, 0xc2, 0x4e, 0x17, 0x63, 0xc7, 0x49, 0x02, 0x99, 0x42, 0xe8,
+  0xd2, 0xd0, 0x42, 0xa8, 0xcc, 0xe4, 0x11, 0x0a, 0xd6, 0x9f, 0xc2, 0x5b, 0x98, 0x54, 0x1b, 0x94,
+  0x67, 0x55, 0xb0, 0xaa, 0x9a, 0x12, 0x17, 0x9b, 0xcc, 0x16, 0x68, 0xef, 0xfb, 0xaa, 0xe8, 0x7d,
+  0x29, 0x55, 0x48, 0x80, 0x38, 0x35, 0x60, 0x39, 0x19, 0x5a, 0xfe, 0x0c, 0x0b, 0x6f, 0x53, 0x54,
+  0x9d, 0x29, 0x55, 0x79, 0xd9, 0x84, 0x7c, 0x37, 0x93, 0x2d, 0x2b, 0x24, 0xc7, 0xbe, 0x38, 0x35,
+  0x62, 0xbd, 0x81, 0x93, 0xdd, 0xb4, 0x7b, 0x3d, 0x34, 0xe5, 0xf5, 0xfa, 0xd9, 0x92, 0x04, 0xa7,
+  0x21, 0x51, 0xb8, 0xaf, 0x11, 0xcd, 0x25, 0xe7, 0x42, 0xa1, 0xd3, 0x89, 0xf3, 0x6e, 0x11, 0xce,
+  0x0c, 0x3b, 0x04, 0xf7, 0x98, 0x8d, 0x8c, 0x88, 0x11, 0x0f, 0xe6, 0xb2, 0x54, 0x06, 0x17, 0x10,
+  0x61, 0xaf, 0xba, 0x4f, 0x6b, 0x45, 0x77, 0x4c, 0x4c, 0x78, 0x94, 0x88, 0xd8, 0x33, 0x0f, 0xa7,
+  0x5f, 0x1b, 0x51, 0xbd, 0xe0, 0x72, 0xda, 0x22, 0xbe, 0xa6, 0x57, 0xf0, 0x55, 0x59, 0x14, 0x02,
+  0x85, 0x50, 0x99, 0xa3, 0xec, 0xaf, 0x9d, 0xbe, 0x4e, 0x38, 0xf5, 0xcb, 0xec, 0x48, 0xfe, 0xd8,
+  0x21, 0xec, 0x71, 0x3b, 0xb5, 0xdd, 0xcd, 0x8a, 0x6a, 0xf9, 0x6d, 0xc3, 0x52, 0x29, 0xa1, 0xaf,
+  0x6f, 0x6f, 0xe6, 0xe8, 0x71, 0xf0, 0x36, 0xc8, 0x2d, 0xc2, 0x42, 0x33, 0x9c, 0x8d, 0x70, 0x5b,
+  0xdd, 0xe3, 0x22, 0x4b, 0x2e, 0xf1, 0xb8, 0x8b, 0xe3, 0x44, 0xf1, 0x9d, 0x36, 0x5e, 0x92, 0x63,
+  0xa1, 0xae, 0xeb, 0xb5, 0xe4, 0xd2, 0x3c, 0xba, 0x38, 0x6f, 0x0e, 0x43, 0xa0, 0x5f, 0xd4, 0xb6,
+  0x58, 0x2b, 0xf3, 0x8a, 0x12, 0x2d, 0xcf, 0xc1, 0x8e, 0x68, 0x37, 0x2b, 0x13, 0xfc, 0x38, 0xb5,
+  0x25, 0xd8, 0x6d, 0x42, 0x7a, 0x65, 0xb0, 0x83, 0x97, 0x23, 0x20, 0xa4, 0xb3, 0x6d, 0x1b, 0x14,
+  0x38, 0xb4, 0xba, 0xa4, 0xc2, 0xac, 0xf2, 0x90, 0x0c, 0xfd, 0x9a, 0x04, 0xd4, 0xe4, 0x42, 0x1d,
+  0x3c, 0x09, 0x7d, 0xf0, 0x24, 0x34, 0xbd, 0xaf, 0x4a, 0x15, 0x46, 0xfe, 0xe9, 0x38, 0xa2, 0x5d,
+  0x5a, 0x3c, 0xaf, 0x98, 0x0d, 0xb2, 0xf7, 0xb2, 0x4e, 0xff, 0x29, 0xe5, 0xa2, 0x64, 0x9a, 0x83,
+  0x2a, 0x0d, 0x46, 0x66, 0xf8, 0xff, 0xbc, 0x2b, 0xf0, 0xa7, 0x84, 0x49, 0xf4, 0x23, 0x0e, 0x9c,
+  0xe2, 0x7f, 0xe3, 0x20, 0x43, 0x37, 0x68, 0x25, 0xcc, 0xad, 0x5c, 0x8b, 0xb2, 0x36, 0xa1, 0xed,
+  0x20, 0xde, 0xfd, 0xcb, 0x23, 0xff, 0x54, 0x9f, 0x02, 0xdf, 0x57, 0xf2, 0x17, 0x48, 0x70, 0x38,
+  0xab, 0xe7, 0x05, 0x00, 0x00,
+};
+
+// index.html: 957 bytes, 900 minified, 509 gzipped
+constexpr uint8_t WEB_index_html[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x5d, 0x53, 0xcb, 0x92, 0x9b, 0x30,
+  0x10, 0xfc, 0x95, 0x89, 0xaa, 0x92, 0xd3, 0x1a, 0x6c, 0x9c, 0xec, 0xe6, 0x01, 0xca, 0xc1, 0x76,
+  0x6a, 0x0f, 0x9b, 0xac, 0x2b, 0x71, 0x0e, 0x39, 0x0a, 0x34, 0x36, 0xca, 0x82, 0x44, 0x49, 0x83,
+  0x5d, 0xfe, 0xfb, 0x1d, 0x1e, 0xb6, 0x49, 0x0e, 0x50, 0xa2, 0x35, 0xd3, 0xdd, 0xd3, 0x35, 0xa4,
+  0x6f, 0xd6, 0xcf, 0xab, 0xdd, 0x9f, 0xed, 0x06, 0x4a, 0xaa, 0x2b, 0x99, 0x8e, 0x6f, 0x54, 0x5a,
+  0xa6, 0x35, 0x92, 0x82, 0xa2, 0x54, 0x3e, 0x20, 0x65, 0xe2, 0xf7, 0xee, 0xdb, 0xec, 0xa3, 0x18,
+  0x51, 0xab, 0x6a, 0xcc, 0xc4, 0xd1, 0xe0, 0xa9, 0x71, 0x9e, 0x04, 0x14, 0xce, 0x12, 0x5a, 0xae,
+  0x3a, 0x19, 0x4d, 0x65, 0xa6, 0xf1, 0x68, 0x0a, 0x9c, 0xf5, 0x1f, 0x77, 0x60, 0xac, 0x21, 0xa3,
+  0xaa, 0x59, 0x28, 0x54, 0x85, 0xd9, 0x82, 0x39, 0xc8, 0x50, 0x85, 0x72, 0xf3, 0x6b, 0xbb, 0x4c,
+  0x60, 0xfd, 0xb8, 0x83, 0xef, 0x8e, 0x4b, 0x9c, 0x4f, 0xe3, 0xe1, 0x22, 0xad, 0x8c, 0x7d, 0x01,
+  0x8f, 0x55, 0x26, 0x02, 0x9d, 0x2b, 0x0c, 0x25, 0x22, 0x8b, 0x94, 0x1e, 0xf7, 0x23, 0x12, 0x15,
+  0x21, 0x7c, 0x3d, 0x66, 0xcb, 0xf9, 0x22, 0x5f, 0xce, 0x93, 0xf9, 0xa7, 0xf7, 0x4b, 0x64, 0xda,
+  0x78, 0xf0, 0x9d, 0x3b, 0x7d, 0xe6, 0x19, 0x92, 0x9b, 0x40, 0x92, 0xc0, 0x4f, 0xbe, 0x32, 0xf6,
+  0x10, 0xb8, 0x28, 0x91, 0xa9, 0x36, 0x47, 0x30, 0x3a, 0x13, 0xd6, 0x9d, 0xb8, 0xaf, 0xe1, 0x1e,
+  0xb9, 0xc3, 0xba, 0x41, 0xaf, 0xa8, 0xf5, 0xf8, 0x39, 0x8d, 0x73, 0x09, 0x69, 0x68, 0x94, 0xed,
+  0xab, 0x88, 0xaf, 0x84, 0x9c, 0xcd, 0xd2, 0xb8, 0x83, 0x24, 0xbc, 0xd3, 0x78, 0xf8, 0xb2, 0x4a,
+  0xe3, 0x66, 0x6c, 0x7d, 0x6c, 0x6b, 0xa3, 0x0d, 0x9d, 0xff, 0xef, 0x2b, 0xdb, 0x7a, 0xda, 0xf6,
+  0xb6, 0xef, 0x88, 0x59, 0x9b, 0xfb, 0x46, 0x79, 0xad, 0x48, 0xf1, 0x64, 0x46, 0x6b, 0xb4, 0x1d,
+  0xd5, 0x0f, 0x07, 0x47, 0x55, 0x19, 0x0d, 0xdd, 0x05, 0x9c, 0x91, 0xa2, 0x8e, 0x33, 0xcd, 0xbd,
+  0xdc, 0x7a, 0x0c, 0x01, 0xa8, 0x44, 0xc8, 0x5b, 0x22, 0x67, 0x81, 0x1c, 0x90, 0x7a, 0x41, 0x50,
+  0x9c, 0x54, 0x3f, 0x5b, 0xd4, 0xf3, 0x97, 0x9e, 0x9f, 0xa5, 0x7c, 0x52, 0x81, 0x26, 0x56, 0x6a,
+  0x63, 0x5b, 0xc2, 0x20, 0xe4, 0x62, 0x7e, 0xb1, 0x33, 0x42, 0x1c, 0xc8, 0xf2, 0xe2, 0xa7, 0x70,
+  0x55, 0x85, 0x05, 0x31, 0x97, 0x90, 0xab, 0xeb, 0xf9, 0x6e, 0xc2, 0x63, 0x85, 0xbc, 0x12, 0x8c,
+  0xb2, 0x01, 0x82, 0x83, 0xbd, 0xf2, 0x83, 0xfc, 0x25, 0xd9, 0x93, 0xb1, 0x9a, 0xc3, 0xbd, 0x8e,
+  0x36, 0x08, 0x9c, 0x86, 0x28, 0x87, 0xe8, 0x06, 0xa4, 0x0f, 0xe9, 0x92, 0xe5, 0x55, 0xa7, 0x70,
+  0xad, 0xa5, 0x0e, 0xff, 0x57, 0x6a, 0x6a, 0x65, 0x5f, 0xa9, 0xc3, 0x01, 0xf5, 0xad, 0x68, 0x04,
+  0xa2, 0x49, 0xcc, 0x5d, 0x18, 0xcd, 0x24, 0xba, 0xa6, 0x3c, 0x07, 0xc3, 0x6b, 0x38, 0xc9, 0xb0,
+  0x6d, 0x38, 0x6a, 0xbc, 0x0d, 0xc3, 0xe8, 0xf3, 0xd3, 0x66, 0x0d, 0xca, 0x6a, 0x28, 0xd1, 0x63,
+  0x34, 0x9a, 0x2d, 0x2a, 0x15, 0x42, 0xb7, 0x7e, 0xbc, 0x22, 0x41, 0xf4, 0x0e, 0xc6, 0xf3, 0xe0,
+  0x3e, 0x14, 0xde, 0x34, 0x04, 0xc1, 0x17, 0x99, 0x50, 0x4d, 0x13, 0xfd, 0xed, 0x16, 0xf4, 0xfe,
+  0xe1, 0xc3, 0x5c, 0xe5, 0x4a, 0xab, 0x87, 0xfb, 0xbc, 0x37, 0xda, 0x17, 0xf1, 0x61, 0xd8, 0xd1,
+  0xb8, 0xff, 0xdd, 0x5e, 0x01, 0xdc, 0x07, 0xe4, 0x3f, 0x84, 0x03, 0x00, 0x00,
+};
+
+// style.css: 207 bytes, 124 minified, 122 gzipped
+constexpr uint8_t WEB_style_css[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x2d, 0x8b, 0x5b, 0x0a, 0xc3, 0x30,
+  0x0c, 0xc0, 0x0e, 0xb3, 0xef, 0x94, 0x8e, 0xc1, 0x08, 0xce, 0x69, 0x9c, 0xe5, 0x51, 0x83, 0x13,
+  0x43, 0x9c, 0xd1, 0x75, 0x25, 0x77, 0xef, 0x58, 0xfb, 0x27, 0x84, 0xe4, 0x25, 0x6c, 0x7b, 0x92,
+  0xda, 0x4d, 0xc2, 0x42, 0xbc, 0x81, 0x62, 0x55, 0xa3, 0xb1, 0x51, 0x72, 0x05, 0x5b, 0xa6, 0x0a,
+  0xf7, 0x58, 0x7e, 0xf8, 0x31, 0x2b, 0x85, 0xbe, 0xc0, 0xe3, 0x19, 0xcb, 0x98, 0x12, 0x63, 0xd6,
+  0xf3, 0x5b, 0x23, 0xe5, 0xa5, 0x83, 0x17, 0x0e, 0xee, 0x25, 0x2c, 0x0d, 0x6e, 0x7e, 0x9e, 0xc7,
+  0xa4, 0x1d, 0xfb, 0x5b, 0xf7, 0x4b, 0x59, 0x6b, 0xdd, 0x3f, 0x57, 0xfa, 0x46, 0xd0, 0x82, 0xcc,
+  0xe3, 0x00, 0x81, 0x0b, 0xd7, 0x87, 0x7c, 0x00, 0x00, 0x00,
+};
+
+constexpr WebAsset WEB_ASSETS[] = {
+  { "/app.js", "application/javascript", WEB_app_js, sizeof(WEB_app_js), "\"6750abada76b\"", true },
+  { "/", "text/html", WEB_index_html, sizeof(WEB_index_html), "\"11f331fed43b\"", false },
+  { "/style.css", "text/css", WEB_style_css, sizeof(WEB_style_css), "\"301b3020943e\"", true },
+};
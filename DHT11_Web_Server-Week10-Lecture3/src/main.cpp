@@ -5,6 +5,15 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include "DHT.h"
+#include <FastPin.h>
+#include <LoopProf.h>   // markers are empty unless built with -D LOOP_PROF=1
+#include <FixedFmt.h>   // integer float formatting, no String
+#include <RingLog.h>    // logs go through a ring, printed by a low-priority task
+#include <StreamStats.h>
+#include <HeapMon.h>      // heap/stack watermarks: 'h' on serial, /heap
+#include <Metrics.h>      // counters for /metrics
+#include <WebAssets.h>
+#include "WebAssetData.h"   // data/, gzipped by tools/webassets/embed.py
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
@@ -15,6 +24,7 @@ Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 #define DHTPIN 17
 #define DHTTYPE DHT11
 #define BUTTON_PIN 18   // Button to GND, use INPUT_PULLUP
+FastPin<BUTTON_PIN> button;  // polled every loop(), one register read
 
 DHT dht(DHTPIN, DHTTYPE);
 
@@ -24,27 +34,144 @@ const char* password = "Ub63HEZt";
 
 WebServer server(80);
 
+// ------------ /metrics (Prometheus text format) ------------
+// Registered at construction, rendered in this order
+MetricCallback uptimeSeconds("uptime_seconds", "Seconds since boot", METRIC_GAUGE,
+                             [] { return (float)(esp_timer_get_time() / 1000000); });
+MetricCallback heapFree("heap_free_bytes", "Free heap", METRIC_GAUGE,
+                        [] { return (float)ESP.getFreeHeap(); });
+MetricCallback heapMinFree("heap_min_free_bytes", "Lowest free heap since boot", METRIC_GAUGE,
+                           [] { return (float)ESP.getMinFreeHeap(); });
+MetricCallback heapMaxAlloc("heap_max_alloc_bytes", "Largest allocatable block", METRIC_GAUGE,
+                            [] { return (float)ESP.getMaxAllocHeap(); });
+MetricCallback heapFrag("heap_fragmentation_percent", "Free heap not available as one block",
+                        METRIC_GAUGE, [] { return (float)heapMonLast().fragPct; });
+MetricCallback heapTrend("heap_largest_trend_bytes_per_hour", "Largest block trend, current window",
+                         METRIC_GAUGE, [] { return heapMonTrend(); });
+MetricCallback heapAlerts("heap_alerts", "HeapMon alert bits, 0 when healthy", METRIC_GAUGE,
+                          [] { return (float)heapMonAlerts(); });
+MetricCallback stackMin("task_stack_min_free_bytes", "Least stack headroom of the watched tasks",
+                        METRIC_GAUGE, [] {
+                          uint32_t m = heapMonStackMin();
+                          return m == UINT32_MAX ? NAN : (float)m;
+                        });
+MetricCallback wifiRssi("wifi_rssi_dbm", "Signal of the connected AP, NaN when not connected",
+                        METRIC_GAUGE,
+                        [] { return WiFi.status() == WL_CONNECTED ? (float)WiFi.RSSI() : NAN; });
+MetricCallback logDropped("ringlog_dropped_total", "Log lines lost to a full ring", METRIC_COUNTER,
+                          [] { return (float)ringLogStats().dropped; });
+
+MetricCounter dhtReads("dht_reads_total", "DHT reads, button and background");
+MetricCounter dhtFailures("dht_read_failures_total", "DHT reads that returned NaN");
+MetricCounter dhtFlagged("dht_flagged_readings_total", "Readings flagged by the window stats");
+static const uint32_t dhtReadBounds[] = { 2000, 5000, 10000, 20000, 30000, 50000, 100000 };
+MetricHistogram<7> dhtReadTime("dht_read_duration_seconds", "Time to read humidity and temperature",
+                               dhtReadBounds, 1e-6f);
+MetricGauge temperatureGauge("dht_temperature_celsius", "Last valid temperature");
+MetricGauge humidityGauge("dht_humidity_percent", "Last valid humidity");
+MetricCounter buttonPresses("button_presses_total", "Debounced button presses");
+
+MetricCounter httpRoot("http_requests_total", "HTTP requests by path", "path=\"/\"");
+MetricCounter httpStatic("http_requests_total", "HTTP requests by path", "path=\"static\"");
+MetricCounter httpData("http_requests_total", "HTTP requests by path", "path=\"/data\"");
+MetricCounter httpMetrics("http_requests_total", "HTTP requests by path", "path=\"/metrics\"");
+MetricCounter httpHeap("http_requests_total", "HTTP requests by path", "path=\"/heap\"");
+MetricCounter httpOther("http_requests_total", "HTTP requests by path", "path=\"other\"");
+static const uint32_t httpBounds[] = { 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000 };
+MetricHistogram<8> httpTime("http_request_duration_seconds", "Handler time, including the send",
+                            httpBounds, 1e-6f);
+MetricCounter httpNotModified("http_not_modified_total", "Pages answered with 304, browser copy current");
+
+// Print that hands the body to the server in chunks from its own buffer
+class ChunkedResponse : public Print {
+public:
+  explicit ChunkedResponse(WebServer& server) : _server(server), _n(0) {}
+
+  size_t write(uint8_t c) override {
+    if (_n == sizeof(_buf)) send();
+    _buf[_n++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* p, size_t len) override {
+    size_t done = 0;
+    while (done < len) {
+      if (_n == sizeof(_buf)) send();
+      size_t n = min(len - done, sizeof(_buf) - _n);
+      memcpy(_buf + _n, p + done, n);
+      _n += n;
+      done += n;
+    }
+    return len;
+  }
+
+  void send() {
+    if (_n) _server.sendContent((const char*)_buf, _n);
+    _n = 0;
+  }
+
+private:
+  WebServer& _server;
+  uint8_t    _buf[512];
+  size_t     _n;
+};
+
 // Last measured values
 float lastTemp = NAN;
 float lastHum  = NAN;
 
 bool lastButtonState = HIGH;
 
+// Window statistics. Readings are also taken in the background for
+// these; the OLED and the values on the page still change on the button.
+#define STATS_SAMPLE_MS   10000UL
+#define STATS_WINDOW_MS   600000UL   // 10 min, 60 readings
+#define STATS_ALPHA       0.2f
+#define SPIKE_Z           4.0f       // baseline sigmas, DHT11 steps 1 C / 1 %
+#define TEMP_MAX_RATE     (5.0f / 60)  // C per second
+#define HUM_MAX_RATE      (6.0f / 60)  // % per second
+
+StreamStats tempStats(STATS_ALPHA);
+StreamStats humStats(STATS_ALPHA);
+WindowSummary tempWindow;   // last closed window, count 0 until then
+WindowSummary humWindow;
+uint32_t lastStatsSample = 0;
+
+// --- Helper: one DHT read, also added to the window stats ---
+bool sampleDHT(float& t, float& h) {
+  uint32_t start = micros();
+  h = dht.readHumidity();
+  t = dht.readTemperature(); // Celsius
+  dhtReadTime.observe(micros() - start);
+  dhtReads.inc();
+
+  uint32_t now = millis();
+  uint8_t tf = tempStats.add(t, now);
+  uint8_t hf = humStats.add(h, now);
+  if ((tf | hf) & ~STAT_INVALID) {
+    RLOG_W("Flagged reading: %.1f *C (0x%02x), %.1f %% (0x%02x)", t, tf, h, hf);
+    dhtFlagged.inc();
+  }
+
+  if (isnan(h) || isnan(t)) {
+    dhtFailures.inc();
+    return false;
+  }
+  temperatureGauge.set(t);
+  humidityGauge.set(h);
+  return true;
+}
+
 // --- Helper: read DHT and update globals ---
 void readDHTValues() {
-  float h = dht.readHumidity();
-  float t = dht.readTemperature(); // Celsius
+  float h, t;
 
-  if (!isnan(h) && !isnan(t)) {
+  if (sampleDHT(t, h)) {
     lastHum  = h;
     lastTemp = t;
-    Serial.print("Temp: ");
-    Serial.print(t);
-    Serial.print(" *C, Humidity: ");
-    Serial.print(h);
-    Serial.println(" %");
+    RLOG_I("Temp: %.2f *C, Humidity: %.2f %%", t, h);
   } else {
-    Serial.println("Failed to read from DHT!");
+    RLOG_W("Failed to read from DHT!");
   }
 }
 
@@ -63,50 +190,144 @@ void showOnOLED() {
 
     display.setCursor(0, 20);
     display.print("Temp: ");
-    display.print(lastTemp, 1);
+    display.print(FixedNum(lastTemp, 1));
     display.println(" C");
 
     display.setCursor(0, 40);
     display.print("Hum:  ");
-    display.print(lastHum, 1);
+    display.print(FixedNum(lastHum, 1));
     display.println(" %");
   }
 
   display.display();
 }
 
-// --- Web handler ---
-void handleRoot() {
-  // Option A: use last measured values
-  // Option B: take fresh reading here, uncomment if you want:
-  // readDHTValues();
+// --- Pages from data/: gzip straight from flash, or 304 ---
+void sendAsset(const WebAsset& a) {
+  uint32_t start = micros();
+  (a.immutable ? httpStatic : httpRoot).inc();
 
-  String html = "<!DOCTYPE html><html><head><meta charset='UTF-8'>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<meta http-equiv='refresh' content='5'>";
-  html += "<title>ESP32 DHT Monitor</title></head><body>";
-  html += "<h2>ESP32 DHT22 Readings</h2>";
-
-  if (isnan(lastTemp) || isnan(lastHum)) {
-    html += "<p><b>No valid data yet.</b><br>Press the button to take a reading.</p>";
+  server.sendHeader("Cache-Control", webAssetCacheControl(a));
+  server.sendHeader("ETag", a.etag);
+  if (webAssetFresh(a, server.header("If-None-Match").c_str())) {
+    httpNotModified.inc();
+    server.send(304);
   } else {
-    html += "<p><b>Temperature:</b> ";
-    html += String(lastTemp, 1);
-    html += " &deg;C</p>";
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, a.type, (const char*)a.gz, a.size);
+  }
+  httpTime.observe(micros() - start);
+}
+
+// --- Helpers: JSON values for /data, NaN as null ---
+void jsonNum(Print& out, const char* key, float v, uint8_t decimals) {
+  out.print('"');
+  out.print(key);
+  out.print("\":");
+  out.print(FixedNum(v, decimals, "null"));
+}
+
+void jsonWindow(Print& out, const WindowSummary& w) {
+  out.print('{');
+  jsonNum(out, "mean", w.mean, 1);
+  out.print(',');
+  jsonNum(out, "min", w.min, 1);
+  out.print(',');
+  jsonNum(out, "max", w.max, 1);
+  out.print(',');
+  jsonNum(out, "sd", w.stddev, 2);
+  out.print(',');
+  jsonNum(out, "trend", w.slopePerMin * 60, 1);   // per hour
+  out.print(",\"flags\":");
+  out.print(w.flags);
+  out.print('}');
+}
 
-    html += "<p><b>Humidity:</b> ";
-    html += String(lastHum, 1);
-    html += " %</p>";
+// --- /data: the live values the page polls, ~250 bytes ---
+void handleData() {
+  uint32_t start = micros();
+  httpData.inc();
+
+  server.sendHeader("Cache-Control", "no-store");
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  ChunkedResponse out(server);
+
+  out.print('{');
+  jsonNum(out, "temp", lastTemp, 1);
+  out.print(',');
+  jsonNum(out, "hum", lastHum, 1);
+  out.print(",\"minutes\":");
+  out.print(STATS_WINDOW_MS / 60000);
+  out.print(",\"collecting\":");
+  out.print(tempStats.count());
+  out.print(",\"window\":");
+  if (tempWindow.count == 0) {
+    out.print("null");
+  } else {
+    out.print("{\"count\":");
+    out.print(tempWindow.count);
+    out.print(",\"flagged\":");
+    out.print(tempWindow.anomalies + humWindow.anomalies);
+    out.print(",\"temp\":");
+    jsonWindow(out, tempWindow);
+    out.print(",\"hum\":");
+    jsonWindow(out, humWindow);
+    out.print('}');
   }
+  out.print('}');
+
+  out.send();
+  server.sendContent("");  // last chunk
+  httpTime.observe(micros() - start);
+}
+
+// --- /metrics: streamed in chunks, the body is never built in memory ---
+void handleMetrics() {
+  uint32_t start = micros();
+  httpMetrics.inc();
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+  ChunkedResponse body(server);
+  metricsRender(body);
+  body.send();
+  server.sendContent("");  // last chunk
+
+  httpTime.observe(micros() - start);
+}
+
+// --- /heap: the heap monitor's report as JSON ---
+void handleHeap() {
+  uint32_t start = micros();
+  httpHeap.inc();
+
+  server.sendHeader("Cache-Control", "no-store");
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  ChunkedResponse body(server);
+  heapMonJson(body);
+  body.send();
+  server.sendContent("");
 
-  html += "<hr><p>Press the physical button to update readings on OLED and here.</p>";
-  html += "</body></html>";
+  httpTime.observe(micros() - start);
+}
 
-  server.send(200, "text/html", html);
+void handleNotFound() {
+  uint32_t start = micros();
+  httpOther.inc();
+  server.send(404, "text/plain", "Not found");
+  httpTime.observe(micros() - start);
 }
 
 void setup() {
   Serial.begin(115200);
+  ringLogBegin(Serial);
+  heapMonWatchTask("loopTask");
+  heapMonWatchTask("ringlog");
+  heapMonWatchTask("heapmon");
+  heapMonWatchTask("tiT");        // lwIP
+  heapMonBegin();
 
   pinMode(BUTTON_PIN, INPUT_PULLUP);
 
@@ -124,6 +345,12 @@ void setup() {
   display.display();
 
   dht.begin();
+  tempStats.setLimits(5, 40);
+  tempStats.setSpike(SPIKE_Z, 0.5f);
+  tempStats.setMaxRate(TEMP_MAX_RATE);
+  humStats.setLimits(15, 90);
+  humStats.setSpike(SPIKE_Z, 1.0f);
+  humStats.setMaxRate(HUM_MAX_RATE);
 
   // WiFi connect
   WiFi.begin(ssid, password);
@@ -152,26 +379,76 @@ void setup() {
   display.println("to read DHT");
   display.display();
 
-  // Web server
-  server.on("/", handleRoot);
+  // Web server: the pages in data/, their live values, metrics
+  for (const WebAsset& a : WEB_ASSETS) {
+    server.on(a.path, HTTP_GET, [&a] { sendAsset(a); });
+  }
+  static const char* headerKeys[] = { "If-None-Match" };
+  server.collectHeaders(headerKeys, 1);
+  server.on("/data", handleData);
+  server.on("/metrics", handleMetrics);
+  server.on("/heap", handleHeap);
+  server.onNotFound(handleNotFound);
   server.begin();
 }
 
 void loop() {
-  server.handleClient();
+  PROF_LOOP("loop");
+
+  // 'p' prints the loop profile, 'r' resets it (LOOP_PROF builds),
+  // 'h' prints the heap monitor
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'p') loopProfPrint(Serial);
+    if (c == 'r') loopProfReset();
+    if (c == 'h') heapMonPrint(Serial);
+  }
+
+  {
+    PROF_SCOPE("web");
+    HEAP_SCOPE("web");
+    server.handleClient();
+  }
 
-  bool currentButtonState = digitalRead(BUTTON_PIN);
+  bool currentButtonState = button.read();
 
   // Detect falling edge (HIGH -> LOW)
   if (lastButtonState == HIGH && currentButtonState == LOW) {
-    // Small debounce delay
-    delay(50);
-    if (digitalRead(BUTTON_PIN) == LOW) {
-      Serial.println("Button pressed: reading DHT + updating OLED");
-      readDHTValues();
-      showOnOLED();
+    {
+      // Small debounce delay
+      PROF_SCOPE("debounce");
+      delay(50);
+    }
+    if (button.read() == LOW) {
+      RLOG_I("Button pressed: reading DHT + updating OLED");
+      buttonPresses.inc();
+      {
+        PROF_SCOPE("dht");
+        HEAP_SCOPE("dht");
+        readDHTValues();
+      }
+      {
+        PROF_SCOPE("oled");
+        HEAP_SCOPE("oled");
+        showOnOLED();
+      }
     }
   }
 
   lastButtonState = currentButtonState;
-}
\ No newline at end of file
+
+  // Background reading for the window stats, then close the window
+  if (millis() - lastStatsSample >= STATS_SAMPLE_MS) {
+    PROF_SCOPE("stats");
+    lastStatsSample = millis();
+    float t, h;
+    sampleDHT(t, h);
+
+    if (tempStats.count() && millis() - tempStats.windowStartMs() >= STATS_WINDOW_MS) {
+      tempStats.close(tempWindow, millis());
+      humStats.close(humWindow, millis());
+      RLOG_I("Window: n=%u temp mean %.1f sd %.2f, hum mean %.1f sd %.2f",
+             tempWindow.count, tempWindow.mean, tempWindow.stddev, humWindow.mean, humWindow.stddev);
+    }
+  }
+}
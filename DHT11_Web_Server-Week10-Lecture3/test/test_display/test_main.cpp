@@ -0,0 +1,88 @@
+// showOnOLED() against golden PBMs: pio test -e native
+// SSD1306_EMU_UPDATE_GOLDEN=1 pio test -e native rewrites them after
+// an intended change (look at them before committing).
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Adafruit_SSD1306.h>
+#include <DHT.h>
+#include <SSD1306Emu.h>
+
+extern Adafruit_SSD1306 display;
+extern float lastTemp;
+extern float lastHum;
+void setup();
+void showOnOLED();
+void readDHTValues();
+
+// golden/<name>.pbm next to this file
+static const char* golden(const char* name) {
+  static char path[512];
+  const char* slash = strrchr(__FILE__, '/');
+  int dir = slash ? (int)(slash - __FILE__ + 1) : 0;
+  snprintf(path, sizeof(path), "%.*sgolden/%s.pbm", dir, __FILE__, name);
+  return path;
+}
+
+void setUp() {}
+
+void tearDown() {
+  dhtEmuClear();
+}
+
+// What setup() leaves on the panel until the first button press
+void test_boot_screen() {
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("boot")));
+}
+
+void test_readings() {
+  lastTemp = 23.4f;
+  lastHum = 51.0f;
+  showOnOLED();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("readings")));
+}
+
+// Sign and rounding go through FixedNum
+void test_negative_reading() {
+  lastTemp = -7.25f;
+  lastHum = 99.96f;
+  showOnOLED();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("negative")));
+}
+
+void test_error_screen() {
+  lastTemp = NAN;
+  lastHum = 40.0f;
+  showOnOLED();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("error")));
+}
+
+// The button path: a DHT read, then the screen
+void test_read_then_show() {
+  dhtEmuSet(26, 47);
+  delay(2100);   // the library reads the bus at most every 2 s
+  readDHTValues();
+  showOnOLED();
+  TEST_ASSERT_EQUAL(0, emuCheckGolden(display, golden("read_26_47")));
+
+  dhtEmuSet(NAN, NAN);
+  delay(2100);
+  readDHTValues();   // a failed read keeps the last values
+  showOnOLED();
+  TEST_ASSERT_EQUAL(0, emuDiffPbm(display, golden("read_26_47")));
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_boot_screen);
+  RUN_TEST(test_readings);
+  RUN_TEST(test_negative_reading);
+  RUN_TEST(test_error_screen);
+  RUN_TEST(test_read_then_show);
+  return UNITY_END();
+}
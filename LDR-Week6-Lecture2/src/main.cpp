@@ -2,6 +2,7 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <FixedFmt.h>   // integer float formatting, no String
 
 #define LDR_PIN 34
 #define SDA_PIN 21
@@ -27,9 +28,9 @@ void loop() {
   display.setTextSize(1);
   display.setCursor(0,10);
   display.print("LDR ADC: "); display.println(adcValue);
-  display.print("Voltage: "); display.print(voltage, 2); display.println(" V");
+  display.print("Voltage: "); display.print(FixedNum(voltage, 2)); display.println(" V");
   display.display();
 
-  Serial.printf("ADC: %d  |  Voltage: %.2f V\n", adcValue, voltage);
+  Serial.printf("ADC: %d  |  Voltage: %s V\n", adcValue, (const char*)FixedNum(voltage, 2));
   delay(1000);
 }
\ No newline at end of file
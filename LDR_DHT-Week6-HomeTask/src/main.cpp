@@ -3,6 +3,9 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <DHT.h>
+#include <Telemetry.h>
+#include <LoopProf.h>
+#include <FixedFmt.h>   // integer float formatting, no String
 
 #define DHTPIN 14
 #define DHTTYPE DHT11
@@ -16,9 +19,46 @@ Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
 DHT dht(DHTPIN, DHTTYPE);
 
+// Serial output: 0 text lines (default), 1 binary frames only,
+// 2 both on the same port (decode with tools/telemdec --text)
+#ifndef TELEM_MODE
+#define TELEM_MODE 0
+#endif
+#define TELEM_PROFILE_EVERY 30   // samples between loop profile dumps
+
+#if TELEM_MODE
+TelemetryWriter telem(Serial, TELEM_MODE == 2);
+
+// Scaled to int16: 23.15 C is sent as 2315
+static const TelemetryField sampleFields[] = {
+  { "temp",     "C",   -2 },
+  { "humidity", "%",   -2 },
+  { "light",    "adc",  0 },
+  { "voltage",  "mV",   0 },
+};
+
+enum { EV_BOOT = 1, EV_DHT_ERROR = 2 };
+
+void sendProfile() {
+  static LoopProfSection snap[LOOP_PROF_SECTIONS];
+  uint8_t n = loopProfSnapshot(snap);
+  for (uint8_t i = 0; i < n; i++) {
+    const LoopProfSection& s = snap[i];
+    uint32_t avg = s.count ? (uint32_t)(s.sumUs / s.count) : 0;
+    telem.profile(s.name, s.count, s.count ? s.minUs : 0, avg, s.maxUs);
+  }
+}
+#endif
+
 void setup() {
   Serial.begin(115200);
+#if TELEM_MODE
+  telem.event(EV_BOOT, "Hello, IoT");
+  telem.setSchema(0, sampleFields, 4);
+#endif
+#if TELEM_MODE != 1
   Serial.println("Hello, IoT");
+#endif
   
   Wire.begin(SDA_PIN, SCL_PIN);
   
@@ -39,52 +79,81 @@ void setup() {
 }
 
 void loop() {
-  float temperature = dht.readTemperature();
-  float humidity = dht.readHumidity();
+  PROF_LOOP("loop");
+  float temperature, humidity;
+  {
+    PROF_SCOPE("dht");
+    temperature = dht.readTemperature();
+    humidity = dht.readHumidity();
+  }
   
   int adcValue = analogRead(LDR_PIN);
   float voltage = (adcValue / 4095.0) * 3.3;
   
   if (isnan(temperature) || isnan(humidity)) {
+#if TELEM_MODE
+    telem.event(EV_DHT_ERROR, "Error reading DHT22 sensor!");
+#endif
+#if TELEM_MODE != 1
     Serial.println("Error reading DHT22 sensor!");
+#endif
     return;
   }
   
+#if TELEM_MODE
+  // 19 bytes on the wire instead of ~86 for the text line
+  int16_t values[] = {
+    (int16_t)lroundf(temperature * 100), (int16_t)lroundf(humidity * 100),
+    (int16_t)adcValue, (int16_t)lroundf(voltage * 1000),
+  };
+  telem.sample(0, values, 4);
+
+  static uint8_t sinceProfile = 0;
+  if (LOOP_PROF && ++sinceProfile >= TELEM_PROFILE_EVERY) {
+    sinceProfile = 0;
+    sendProfile();
+  }
+#endif
+#if TELEM_MODE != 1
   Serial.print("Temperature: ");
-  Serial.print(temperature);
+  Serial.print(FixedNum(temperature, 2));
   Serial.print(" °C  |  Humidity: ");
-  Serial.print(humidity);
+  Serial.print(FixedNum(humidity, 2));
   Serial.print(" %  |  Light ADC: ");
   Serial.print(adcValue);
   Serial.print("  |  Voltage: ");
-  Serial.print(voltage, 2);
+  Serial.print(FixedNum(voltage, 2));
   Serial.println(" V");
+#endif
   
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setCursor(0, 0);
-  display.println("Hello IoT");
-  
-  display.setCursor(0, 16);
-  display.print("Temp: ");
-  display.print(temperature);
-  display.println(" C");
-  
-  display.setCursor(0, 26);
-  display.print("Humidity: ");
-  display.print(humidity);
-  display.println(" %");
-  
-  display.setCursor(0, 36);
-  display.print("Light: ");
-  display.println(adcValue);
-  
-  display.setCursor(0, 46);
-  display.print("Voltage: ");
-  display.print(voltage, 2);
-  display.println(" V");
-  
-  display.display();
+  {
+    PROF_SCOPE("oled");
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("Hello IoT");
+
+    display.setCursor(0, 16);
+    display.print("Temp: ");
+    display.print(FixedNum(temperature, 2));
+    display.println(" C");
+
+    display.setCursor(0, 26);
+    display.print("Humidity: ");
+    display.print(FixedNum(humidity, 2));
+    display.println(" %");
+
+    display.setCursor(0, 36);
+    display.print("Light: ");
+    display.println(adcValue);
+
+    display.setCursor(0, 46);
+    display.print("Voltage: ");
+    display.print(FixedNum(voltage, 2));
+    display.println(" V");
+
+    display.display();
+  }
   
   delay(2000);
 }
\ No newline at end of file
@@ -1,32 +1,97 @@
 #include <Arduino.h>
+#include <HwTimerWheel.h>
+#include <IsrProf.h>
+#include <FastPin.h>
 // hallo mian ^_^
 
 #define LED_PIN 2            // GPIO4 for LED
-hw_timer_t *My_timer = nullptr;
+FastPin<LED_PIN> led;        // register access, safe and cheap in the ISR
 
-// ---- Timer ISR ----
-void IRAM_ATTR onTimer() {
-  digitalWrite(LED_PIN, !digitalRead(LED_PIN));  // toggle LED
+// One hardware timer, any number of software timers on it. Every
+// period below is a multiple of 250 ms, so that is the tick: 4
+// interrupts a second instead of 1000 at the 1 ms default.
+#define TICK_US 250000UL
+HwTimerWheel wheel;
+SoftTimer blinkTimer;
+SoftTimer statusTimer;
+SoftTimer speedUpTimer;
+
+// Times every tick ISR, send 'p' to print, 'r' to reset
+IsrProbe tickProbe("tick", TICK_US);
+
+// ---- Runs in the timer ISR: keep it short ----
+void IRAM_ATTR onBlink(void* arg) {
+  led.toggle();  // toggle LED: one read, one W1TS/W1TC write
+}
+
+// ---- Deferred: run by the wheel's task, Serial is fine here ----
+void onStatus(void* arg) {
+  TimerWheelStats s = wheel.stats();
+  Serial.printf("Wheel: ticks=%lu fired=%lu cascaded=%lu deferred=%lu overruns=%lu max/tick=%u\n",
+                (unsigned long)s.ticks, (unsigned long)s.fired, (unsigned long)s.cascaded,
+                (unsigned long)s.deferredRun, (unsigned long)s.overruns, s.maxPerTick);
 }
 
+// One-shot: after 10 s blink 4x faster
+void onSpeedUp(void* arg) {
+  Serial.println("Blink -> 250 ms");
+  wheel.start(blinkTimer, 250, 250, onBlink, nullptr, TIMER_IN_TICK);
+}
+
+#if FASTPIN_BENCH
+// ---- Toggle rate: digitalWrite vs FastPin (env nodemcu-32s-bench) ----
+#define BENCH_TOGGLES 200000UL   // runs before the wheel starts, nothing else is ticking
+
+void benchToggle() {
+  uint32_t t0 = ESP.getCycleCount();
+  for (uint32_t i = 0; i < BENCH_TOGGLES; i++) {
+    digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+  }
+  uint32_t t1 = ESP.getCycleCount();
+  for (uint32_t i = 0; i < BENCH_TOGGLES; i++) {
+    led.toggle();
+  }
+  uint32_t t2 = ESP.getCycleCount();
+  for (uint32_t i = 0; i < BENCH_TOGGLES / 2; i++) {
+    led.high();
+    led.low();
+  }
+  uint32_t t3 = ESP.getCycleCount();
+
+  float mhz = getCpuFrequencyMhz();
+  const char* names[] = { "digitalWrite(!digitalRead)", "FastPin toggle()", "FastPin high()/low()" };
+  uint32_t cycles[] = { t1 - t0, t2 - t1, t3 - t2 };
+  for (int i = 0; i < 3; i++) {
+    float perToggle = (float)cycles[i] / BENCH_TOGGLES;
+    Serial.printf("%-28s %6.1f cycles/toggle  %7.2f M toggles/s\n",
+                  names[i], perToggle, mhz / perToggle);
+  }
+}
+#endif
+
 // ---- Setup ----
 void setup() {
+  Serial.begin(115200);
   pinMode(LED_PIN, OUTPUT);
+#if FASTPIN_BENCH
+  benchToggle();
+#endif
 
-  // timerBegin(timer number 0-3, prescaler, countUp)
-  // 80 MHz / 80 = 1 MHz → tick = 1 µs
-  My_timer = timerBegin(0, 80, true);
+  // timer 0, 250 ms tick: 80 MHz / 80 = 1 MHz, alarm every 250000 counts
+  wheel.setProbe(&tickProbe);
+  wheel.begin(0, TICK_US);
 
-  // attach ISR to timer, edge-triggered
-  timerAttachInterrupt(My_timer, &onTimer, true);
-
-  // trigger every 1 000 000 µs = 1 s
-  timerAlarmWrite(My_timer, 1000000, true);
-
-  // enable alarm
-  timerAlarmEnable(My_timer);
+  // toggle every 1 000 ms, in the ISR like before
+  wheel.start(blinkTimer, 1000, 1000, onBlink, nullptr, TIMER_IN_TICK);
+  wheel.start(statusTimer, 5000, 5000, onStatus, nullptr, TIMER_DEFERRED);
+  wheel.start(speedUpTimer, 10000, 0, onSpeedUp, nullptr, TIMER_DEFERRED);
 }
 
 void loop() {
   // main loop free for other code
-}
\ No newline at end of file
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'p') IsrProbe::printAll(Serial);
+    if (c == 'r') IsrProbe::resetAll();
+  }
+}
@@ -1,6 +1,7 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <SpanRaster.h>
 
 // ---- OLED setup ----
 #define SCREEN_WIDTH 128
@@ -9,6 +10,8 @@
 
 
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+// Lines as byte spans on the page buffer instead of pixel by pixel
+SpanRaster raster(display);
 
 
 void setup() {
@@ -27,8 +30,8 @@ void loop() {
  
 
   display.clearDisplay();
-  display.drawLine(0, 0, 127, 63, SSD1306_WHITE);
-  display.drawLine(0, 63, 127, 0, SSD1306_WHITE);
+  raster.drawLine(0, 0, 127, 63, SSD1306_WHITE);
+  raster.drawLine(0, 63, 127, 0, SSD1306_WHITE);
   display.display();
   delay(2000);
   display.clearDisplay();
@@ -0,0 +1,68 @@
+// The sketch's frames against golden PBMs: pio test -e native
+// SSD1306_EMU_UPDATE_GOLDEN=1 pio test -e native rewrites them after
+// an intended change (look at them before committing).
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Adafruit_SSD1306.h>
+#include <SSD1306Emu.h>
+
+extern Adafruit_SSD1306 display;
+void setup();
+void loop();
+
+// golden/<name>.pbm next to this file
+static const char* golden(const char* name) {
+  static char path[512];
+  const char* slash = strrchr(__FILE__, '/');
+  int dir = slash ? (int)(slash - __FILE__ + 1) : 0;
+  snprintf(path, sizeof(path), "%.*sgolden/%s.pbm", dir, __FILE__, name);
+  return path;
+}
+
+// One loop() shows three frames, only the last one stays in the buffer
+static const char* const FRAMES[] = { "lines", "hello", "cs_a" };
+#define FRAME_COUNT (sizeof(FRAMES) / sizeof(FRAMES[0]))
+
+static long    frameDiff[FRAME_COUNT];
+static uint8_t framesSeen;
+
+static void checkFrame(Adafruit_SSD1306& d, uint32_t frame) {
+  if (framesSeen < FRAME_COUNT) frameDiff[framesSeen] = emuCheckGolden(d, golden(FRAMES[framesSeen]));
+  framesSeen++;
+}
+
+static void loopMatchesGolden() {
+  framesSeen = 0;
+  emuOnFrame(checkFrame);
+  loop();
+  emuOnFrame(nullptr);
+
+  TEST_ASSERT_EQUAL(FRAME_COUNT, framesSeen);
+  for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+    TEST_ASSERT_EQUAL_MESSAGE(0, frameDiff[i], FRAMES[i]);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_loop_frames_match_golden() {
+  loopMatchesGolden();
+}
+
+// Nothing carries over: the next loop() draws the same frames
+void test_second_loop_is_identical() {
+  loopMatchesGolden();
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_loop_frames_match_golden);
+  RUN_TEST(test_second_loop_is_identical);
+  return UNITY_END();
+}
@@ -0,0 +1,54 @@
+/****************************************************
+ * BuzzerPlayer
+ * ScorePlayer on a buzzer LEDC channel, clocked by a
+ * hardware timer.
+ *
+ * The timer counts in us and its alarm is armed as a
+ * one-shot for exactly the next event, so the CPU is only
+ * interrupted when the tone actually changes. The ISR only
+ * wakes the player task: ScorePlayer::step() and the LEDC
+ * driver calls (which lock and may log) run there, and the
+ * task arms the alarm for the next event. play() queues a
+ * score and returns at once.
+ *
+ * Lateness (step vs. scheduled time, so including the task
+ * wake-up) is tracked in stats(), that is the timing
+ * jitter of the player.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include "ScorePlayer.h"
+
+class BuzzerPlayer {
+public:
+  // Channel must already be set up with ledcSetup()/ledcAttachPin()
+  BuzzerPlayer(uint8_t ledcChannel, uint8_t resolutionBits);
+
+  // The player task should outrank loop() so notes start on time
+  bool begin(uint8_t timerNum = 0, UBaseType_t taskPriority = 5, BaseType_t core = 1);
+
+  // Queues a score (up to ScorePlayer::QUEUE_LEN)
+  bool play(const uint8_t* score);
+  // Silences and drops all scores; returns once the player task did it
+  void stop();
+
+  bool idle() const { return _player.idle(); }
+  uint8_t queued() const { return _player.queued(); }
+  ScoreStats stats() const { return _player.stats(); }
+  void resetStats() { _player.resetStats(); }
+
+private:
+  static void IRAM_ATTR onTimer();
+  static void playerTask(void* arg);
+  static void toneOut(uint16_t hz, void* ctx);
+
+  static BuzzerPlayer* _instance;  // the Arduino timer ISR takes no argument
+
+  ScorePlayer  _player;
+  uint8_t      _channel;
+  uint8_t      _bits;
+  hw_timer_t*  _timer;
+  TaskHandle_t _task;
+  bool         _stopReq;  // __atomic access only
+};
@@ -0,0 +1,41 @@
+/****************************************************
+ * I2sDac
+ * Streams a WaveSynth to the ESP32 built-in DAC through
+ * I2S DMA (DAC1 = GPIO25).
+ *
+ * An audio task renders BLOCK frames at a time and hands
+ * them to i2s_write(), which blocks until a DMA buffer is
+ * free. So the CPU works in one burst per block and sleeps
+ * in between, instead of touching every sample in an ISR.
+ *
+ * The DAC is 8 bit, line level: it needs an amplifier,
+ * the piezo on GPIO27 cannot be driven from here.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include "WaveSynth.h"
+
+struct I2sDacStats {
+  uint32_t blocks;
+  uint32_t renderUsLast;
+  uint32_t renderUsMax;
+  uint8_t  loadPct;       // render time / block play time
+};
+
+class I2sDac {
+public:
+  static const uint16_t BLOCK = 256;   // frames per i2s_write()
+
+  explicit I2sDac(WaveSynth& synth) : _synth(synth) {}
+
+  bool begin(uint8_t core = 1, UBaseType_t priority = 5);
+  I2sDacStats stats() const { return _stats; }
+
+private:
+  static void task(void* arg);
+
+  WaveSynth&  _synth;
+  uint16_t    _frames[2 * BLOCK];
+  I2sDacStats _stats = {};
+};
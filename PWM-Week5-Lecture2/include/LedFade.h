@@ -0,0 +1,72 @@
+/****************************************************
+ * LedFade
+ * LED ramps on the LEDC hardware fade unit.
+ *
+ * fadeTo() programs ledc_set_fade_with_time() and returns
+ * at once; the LEDC steps the duty itself, so a ramp costs
+ * no CPU until the fade-end interrupt. Every channel fades
+ * independently and concurrently.
+ *
+ * Levels are perceptual 0..255 and go through a gamma 2.2
+ * curve to the channel's duty resolution.
+ *
+ * The fade-end ISR only marks the channel idle and queues
+ * a FadeEvent. poll() hands those out in task context and
+ * starts any fade that was requested while the channel was
+ * still busy (latest request wins), because the IDF blocks
+ * if a new fade is set on a running channel.
+ *
+ * Channels are set up with ledcSetup()/ledcAttachPin() as
+ * usual, then attach()ed here.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+
+struct FadeEvent {
+  uint8_t  channel;    // Arduino LEDC channel 0..15
+  uint8_t  level;      // level the fade was aiming for
+  uint32_t duty;       // duty the hardware stopped at
+};
+
+class LedFade {
+public:
+  static const uint8_t MAX_CHANNELS = 16;
+
+  // Installs the fade service and the event queue
+  bool begin(uint8_t queueLength = 16);
+
+  // resolutionBits must match the ledcSetup() call
+  bool attach(uint8_t channel, uint8_t resolutionBits);
+
+  // Ramps to level over ms; queued if a fade is running
+  bool fadeTo(uint8_t channel, uint8_t level, uint32_t ms);
+  // Jumps straight to level, cancels any queued fade
+  bool set(uint8_t channel, uint8_t level);
+
+  bool busy(uint8_t channel) const;
+  uint8_t level(uint8_t channel) const;  // target of the current/last fade
+
+  // Starts queued fades, then returns one completion event if any
+  bool poll(FadeEvent& ev, TickType_t wait = 0);
+
+  uint32_t levelToDuty(uint8_t channel, uint8_t level) const;
+
+private:
+  struct Channel {
+    bool              attached;
+    volatile bool     busy;
+    uint8_t           bits;
+    volatile uint8_t  level;
+    bool              pending;
+    uint8_t           pendingLevel;
+    uint32_t          pendingMs;
+  };
+
+  bool start(uint8_t channel, uint8_t level, uint32_t ms);
+  static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t* param, void* arg);
+
+  Channel       _ch[MAX_CHANNELS] = {};
+  QueueHandle_t _events = nullptr;
+};
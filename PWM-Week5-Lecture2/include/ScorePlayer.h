@@ -0,0 +1,113 @@
+/****************************************************
+ * ScorePlayer
+ * Plays compact byte-code scores on a tone output.
+ *
+ * Score format (const uint8_t[], lives in flash):
+ *   SC_NOTE(hz, ms)                 tone for ms
+ *   SC_REST(ms)                     silence for ms
+ *   SC_SWEEP(from, to, step, ms)    from..to Hz in step Hz
+ *                                   increments, ms per step
+ *   SC_REPEAT(n) ... SC_LOOP()      play the block n times
+ *                                   (nesting up to 4 deep)
+ *   SC_END()
+ * A note is 5 bytes, a rest 3, a whole sweep 8.
+ *
+ * step(nowUs) is the whole engine: it runs every event due
+ * at nowUs and returns how many us until the next one.
+ * Timing is kept against the scheduled time, not nowUs, so
+ * a late call never stretches the score. The ESP32 side
+ * (BuzzerPlayer) calls it from a task woken by a hardware
+ * timer; on a PC it can be driven by a fake clock.
+ *
+ * enqueue() may be called from one task while step() runs in
+ * another (single producer, single consumer ring). The slot
+ * is written before the tail is published with release, and
+ * read after an acquire of the tail, so step() on the other
+ * core never sees the new index with the old pointer.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#define SCORE_OP_END     0x00
+#define SCORE_OP_NOTE    0x01
+#define SCORE_OP_REST    0x02
+#define SCORE_OP_SWEEP   0x03
+#define SCORE_OP_REPEAT  0x04
+#define SCORE_OP_LOOP    0x05
+
+#define SCORE_U16(v)  (uint8_t)((v) & 0xFF), (uint8_t)(((v) >> 8) & 0xFF)
+
+#define SC_NOTE(hz, ms)                SCORE_OP_NOTE, SCORE_U16(hz), SCORE_U16(ms)
+#define SC_REST(ms)                    SCORE_OP_REST, SCORE_U16(ms)
+#define SC_SWEEP(from, to, step, ms)   SCORE_OP_SWEEP, SCORE_U16(from), SCORE_U16(to), \
+                                       SCORE_U16(step), (uint8_t)(ms)
+#define SC_REPEAT(n)                   SCORE_OP_REPEAT, (uint8_t)(n)
+#define SC_LOOP()                      SCORE_OP_LOOP
+#define SC_END()                       SCORE_OP_END
+
+// hz == 0 means silence
+typedef void (*ToneFn)(uint16_t hz, void* ctx);
+
+struct ScoreStats {
+  uint32_t events;        // notes, rests and sweep steps started
+  uint32_t scores;        // scores played to the end
+  uint32_t rejected;      // enqueue() with a full queue
+  uint32_t lateMaxUs;     // worst step() call after its due time
+  uint32_t lateAvgUs;
+};
+
+class ScorePlayer {
+public:
+  static const uint8_t QUEUE_LEN  = 4;
+  static const uint8_t MAX_NEST   = 4;
+
+  ScorePlayer(ToneFn tone, void* ctx = nullptr);
+
+  bool enqueue(const uint8_t* score);
+  bool idle() const { return !_score && queued() == 0; }
+  uint8_t queued() const {
+    return (uint8_t)(__atomic_load_n(&_qTail, __ATOMIC_ACQUIRE) -
+                     __atomic_load_n(&_qHead, __ATOMIC_ACQUIRE));
+  }
+
+  // Runs what is due, returns us until the next event, 0 when idle
+  uint32_t step(uint32_t nowUs);
+  // Silences and drops the current and queued scores (same context as step)
+  void stop();
+
+  ScoreStats stats() const;
+  void resetStats();
+
+private:
+  struct Repeat {
+    const uint8_t* start;
+    uint8_t        left;
+  };
+
+  uint32_t run(uint32_t nowUs);
+  void     tone(uint16_t hz);
+
+  ToneFn _tone;
+  void*  _ctx;
+
+  const uint8_t* _queue[QUEUE_LEN];
+  uint8_t _qHead;   // advanced by step(), __atomic access only
+  uint8_t _qTail;   // advanced by enqueue(), __atomic access only
+
+  const uint8_t* _score;
+  const uint8_t* _pc;
+  uint32_t       _dueUs;
+  Repeat         _repeat[MAX_NEST];
+  uint8_t        _depth;
+  bool           _sweeping;
+  uint16_t       _sweepHz;
+  uint16_t       _lastHz;
+
+  uint32_t _events;
+  uint32_t _scores;
+  uint32_t _rejected;
+  uint32_t _lateMaxUs;
+  uint64_t _lateSumUs;
+  uint32_t _lateCount;
+};
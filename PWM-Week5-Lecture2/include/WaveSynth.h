@@ -0,0 +1,105 @@
+/****************************************************
+ * WaveSynth
+ * Small wavetable synthesizer for the ESP32 internal DAC.
+ *
+ *  - 256-entry int16 tables (sine, triangle, saw, square),
+ *    32-bit phase accumulators, 8.8 linear interpolation
+ *  - SYNTH_VOICES voices, each with a linear ADSR envelope
+ *    in Q16 and a velocity
+ *  - render() fills a whole block at once: every voice is
+ *    mixed into an int32 accumulator, then clipped and
+ *    packed for the DAC
+ *
+ * noteOn()/noteOff() only queue a command (single
+ * producer, single consumer), render() applies queued
+ * commands at the start of each block, so the caller and
+ * the audio task never share voice state. The command is
+ * copied in before the tail is published (release) and
+ * read after the tail is acquired, so a task on the other
+ * core never applies a half-written command.
+ *
+ * No hardware in here: I2sDac feeds the blocks to I2S DMA,
+ * and the same code runs on a PC (test/test_synth, and
+ * tools/bench/wavesynth_bench.cpp for the mixing cost).
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#define SYNTH_VOICES      4
+#define SYNTH_TABLE_BITS  8
+#define SYNTH_TABLE_SIZE  (1 << SYNTH_TABLE_BITS)
+
+enum SynthWave { WAVE_SINE, WAVE_TRIANGLE, WAVE_SAW, WAVE_SQUARE, WAVE_COUNT };
+
+struct SynthEnvelope {
+  uint16_t attackMs;
+  uint16_t decayMs;
+  uint8_t  sustain;     // 0..255 of the velocity
+  uint16_t releaseMs;
+};
+
+class WaveSynth {
+public:
+  static const uint8_t CMD_QUEUE = 16;
+
+  explicit WaveSynth(uint32_t sampleRate);
+
+  void setEnvelope(uint8_t voice, const SynthEnvelope& env);
+  // velocity 0..255, 255 = a quarter of full scale so 4 voices never clip
+  bool noteOn(uint8_t voice, uint16_t hz, SynthWave wave = WAVE_SINE, uint8_t velocity = 255);
+  bool noteOff(uint8_t voice);
+
+  // Mono int16 mix of n samples
+  void render(int16_t* out, uint16_t n);
+  // Same, packed for the built-in DAC over I2S: stereo
+  // frames, sample in the high byte, offset binary
+  void renderDac(uint16_t* frames, uint16_t n);
+
+  bool active(uint8_t voice) const { return _voice[voice].stage != STAGE_IDLE; }
+  uint8_t activeVoices() const;
+  uint32_t sampleRate() const { return _rate; }
+  uint32_t clipped() const { return _clipped; }
+
+private:
+  enum Stage : uint8_t { STAGE_IDLE, STAGE_ATTACK, STAGE_DECAY, STAGE_SUSTAIN, STAGE_RELEASE };
+
+  struct Voice {
+    const int16_t* table;
+    uint32_t phase;
+    uint32_t inc;
+    int32_t  env;        // Q16, 0..65535 * velocity / 255
+    int32_t  peak;
+    int32_t  sustainLevel;
+    int32_t  attackStep;
+    int32_t  decayStep;
+    int32_t  releaseStep;
+    SynthEnvelope shape;
+    Stage    stage;
+  };
+
+  struct Command {
+    uint8_t   voice;
+    bool      on;
+    uint16_t  hz;
+    SynthWave wave;
+    uint8_t   velocity;
+  };
+
+  bool push(const Command& c);
+  void apply(const Command& c);
+  int32_t stepFor(uint16_t ms, int32_t span) const;
+  void mixVoice(Voice& v, int32_t* acc, uint16_t n);
+  void mix(uint16_t n);
+
+  static const uint16_t BLOCK = 128;   // render() works in chunks of this
+
+  uint32_t _rate;
+  Voice    _voice[SYNTH_VOICES];
+  int32_t  _acc[BLOCK];
+  uint32_t _clipped;
+
+  Command _cmd[CMD_QUEUE];
+  uint8_t _cmdHead;   // advanced by render(), __atomic access only
+  uint8_t _cmdTail;   // advanced by push(), __atomic access only
+};
@@ -0,0 +1,85 @@
+#include "BuzzerPlayer.h"
+
+#include <driver/ledc.h>
+
+BuzzerPlayer* BuzzerPlayer::_instance = nullptr;
+
+BuzzerPlayer::BuzzerPlayer(uint8_t ledcChannel, uint8_t resolutionBits)
+  : _player(toneOut, this), _channel(ledcChannel), _bits(resolutionBits),
+    _timer(nullptr), _task(nullptr), _stopReq(false) {
+}
+
+bool BuzzerPlayer::begin(uint8_t timerNum, UBaseType_t taskPriority, BaseType_t core) {
+  if (_instance) return false;  // one player per sketch
+  _instance = this;
+
+  if (xTaskCreatePinnedToCore(playerTask, "buzzer", 2048, this,
+                              taskPriority, &_task, core) != pdPASS) return false;
+
+  // 80 MHz / 80 = 1 MHz, so the counter is the player's us clock
+  _timer = timerBegin(timerNum, 80, true);
+  if (!_timer) return false;
+  timerAttachInterrupt(_timer, &onTimer, true);
+  return true;
+}
+
+// Runs in the player task. Same channel -> group/timer mapping as esp32-hal-ledc.
+void BuzzerPlayer::toneOut(uint16_t hz, void* ctx) {
+  BuzzerPlayer* self = (BuzzerPlayer*)ctx;
+  ledc_mode_t mode = (ledc_mode_t)(self->_channel / 8);
+  ledc_channel_t ch = (ledc_channel_t)(self->_channel % 8);
+  ledc_timer_t timer = (ledc_timer_t)((self->_channel / 2) % 4);
+
+  if (hz == 0) {
+    ledc_set_duty(mode, ch, 0);
+  } else {
+    ledc_set_freq(mode, timer, hz);
+    ledc_set_duty(mode, ch, 1UL << (self->_bits - 1));  // 50 % square wave
+  }
+  ledc_update_duty(mode, ch);
+}
+
+// Alarm interrupt: no driver calls here, wake the player task
+void IRAM_ATTR BuzzerPlayer::onTimer() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(_instance->_task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// The only context that steps the player. A wake-up from play() while
+// a note is sounding is an early step, which just returns the wait.
+void BuzzerPlayer::playerTask(void* arg) {
+  BuzzerPlayer* self = (BuzzerPlayer*)arg;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    if (__atomic_load_n(&self->_stopReq, __ATOMIC_ACQUIRE)) {
+      timerAlarmDisable(self->_timer);
+      self->_player.stop();
+      __atomic_store_n(&self->_stopReq, false, __ATOMIC_RELEASE);
+      continue;
+    }
+
+    uint64_t now = timerRead(self->_timer);
+    uint32_t wait = self->_player.step((uint32_t)now);  // player math wraps fine
+    if (wait) {
+      timerAlarmWrite(self->_timer, now + wait, false);  // one-shot
+      timerAlarmEnable(self->_timer);
+    }
+  }
+}
+
+bool BuzzerPlayer::play(const uint8_t* score) {
+  if (!_timer || !_player.enqueue(score)) return false;
+  xTaskNotifyGive(_task);  // an idle player starts now, a busy one carries on
+  return true;
+}
+
+void BuzzerPlayer::stop() {
+  if (!_timer) return;
+  __atomic_store_n(&_stopReq, true, __ATOMIC_RELEASE);
+  xTaskNotifyGive(_task);
+  // Wait for it, so a play() after stop() is not dropped with the rest
+  while (__atomic_load_n(&_stopReq, __ATOMIC_ACQUIRE)) vTaskDelay(1);
+}
@@ -0,0 +1,42 @@
+#include "I2sDac.h"
+
+#include <driver/i2s.h>
+
+bool I2sDac::begin(uint8_t core, UBaseType_t priority) {
+  i2s_config_t cfg = {};
+  cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN);
+  cfg.sample_rate = _synth.sampleRate();
+  cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+  cfg.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+  cfg.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+  cfg.dma_buf_count = 4;
+  cfg.dma_buf_len = BLOCK;
+  cfg.use_apll = false;
+  cfg.tx_desc_auto_clear = true;  // silence instead of a looping buffer on underrun
+
+  if (i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr) != ESP_OK) return false;
+  i2s_set_pin(I2S_NUM_0, nullptr);                 // built-in DAC, no pins
+  i2s_set_dac_mode(I2S_DAC_CHANNEL_RIGHT_EN);      // GPIO25 only
+
+  return xTaskCreatePinnedToCore(task, "i2s_dac", 4096, this, priority, nullptr, core) == pdPASS;
+}
+
+void I2sDac::task(void* arg) {
+  I2sDac* self = (I2sDac*)arg;
+  uint32_t blockUs = (uint32_t)((uint64_t)BLOCK * 1000000 / self->_synth.sampleRate());
+
+  for (;;) {
+    uint32_t start = micros();
+    self->_synth.renderDac(self->_frames, BLOCK);
+    uint32_t took = micros() - start;
+
+    I2sDacStats& s = self->_stats;
+    s.blocks++;
+    s.renderUsLast = took;
+    if (took > s.renderUsMax) s.renderUsMax = took;
+    s.loadPct = (uint8_t)(took * 100 / blockUs);
+
+    size_t written = 0;
+    i2s_write(I2S_NUM_0, self->_frames, sizeof(self->_frames), &written, portMAX_DELAY);
+  }
+}
@@ -0,0 +1,135 @@
+#include "LedFade.h"
+
+#include <math.h>
+
+// Arduino numbers LEDC channels 0..15: 0..7 high speed, 8..15 low speed
+static inline ledc_mode_t modeOf(uint8_t channel) {
+  return (ledc_mode_t)(channel / 8);
+}
+
+static inline ledc_channel_t idfChannel(uint8_t channel) {
+  return (ledc_channel_t)(channel % 8);
+}
+
+bool LedFade::begin(uint8_t queueLength) {
+  if (!_events) {
+    _events = xQueueCreate(queueLength, sizeof(FadeEvent));
+    if (!_events) return false;
+  }
+
+  esp_err_t err = ledc_fade_func_install(0);
+  return err == ESP_OK || err == ESP_ERR_INVALID_STATE;  // already installed
+}
+
+bool LedFade::attach(uint8_t channel, uint8_t resolutionBits) {
+  if (channel >= MAX_CHANNELS || resolutionBits == 0 || resolutionBits > 20) return false;
+
+  Channel& c = _ch[channel];
+  c.bits = resolutionBits;
+  c.busy = false;
+  c.pending = false;
+  c.level = 0;
+
+  // The channel number rides in the callback param, `this` is the user arg
+  ledc_cbs_t cbs = { .fade_cb = onFadeEnd };
+  if (ledc_cb_register(modeOf(channel), idfChannel(channel), &cbs, this) != ESP_OK) return false;
+
+  c.attached = true;
+  return true;
+}
+
+uint32_t LedFade::levelToDuty(uint8_t channel, uint8_t level) const {
+  uint32_t maxDuty = (1UL << _ch[channel].bits) - 1;
+  if (level == 0)   return 0;
+  if (level == 255) return maxDuty;
+
+  // Gamma 2.2, same curve as the breathing effect in Assignment1
+  float corrected = powf(level / 255.0f, 2.2f);
+  uint32_t duty = (uint32_t)(corrected * maxDuty + 0.5f);
+  return duty ? duty : 1;  // never round a lit level to off
+}
+
+bool LedFade::start(uint8_t channel, uint8_t level, uint32_t ms) {
+  Channel& c = _ch[channel];
+  ledc_mode_t mode = modeOf(channel);
+  ledc_channel_t ch = idfChannel(channel);
+
+  c.level = level;
+  c.busy = true;
+
+  if (ledc_set_fade_with_time(mode, ch, levelToDuty(channel, level), ms) != ESP_OK ||
+      ledc_fade_start(mode, ch, LEDC_FADE_NO_WAIT) != ESP_OK) {
+    c.busy = false;
+    return false;
+  }
+  return true;
+}
+
+bool LedFade::fadeTo(uint8_t channel, uint8_t level, uint32_t ms) {
+  if (channel >= MAX_CHANNELS || !_ch[channel].attached) return false;
+  Channel& c = _ch[channel];
+
+  if (c.busy) {
+    c.pendingLevel = level;
+    c.pendingMs = ms;
+    c.pending = true;
+    return true;
+  }
+  c.pending = false;
+  return start(channel, level, ms);
+}
+
+bool LedFade::set(uint8_t channel, uint8_t level) {
+  if (channel >= MAX_CHANNELS || !_ch[channel].attached) return false;
+  Channel& c = _ch[channel];
+
+  c.pending = false;
+  if (c.busy) {
+    // Let the running ramp land, then jump
+    return fadeTo(channel, level, 1);
+  }
+
+  c.level = level;
+  ledc_mode_t mode = modeOf(channel);
+  return ledc_set_duty(mode, idfChannel(channel), levelToDuty(channel, level)) == ESP_OK &&
+         ledc_update_duty(mode, idfChannel(channel)) == ESP_OK;
+}
+
+bool LedFade::busy(uint8_t channel) const {
+  return channel < MAX_CHANNELS && (_ch[channel].busy || _ch[channel].pending);
+}
+
+uint8_t LedFade::level(uint8_t channel) const {
+  return channel < MAX_CHANNELS ? _ch[channel].level : 0;
+}
+
+bool LedFade::poll(FadeEvent& ev, TickType_t wait) {
+  // Queued fades go first, so they start even if an event was lost
+  for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+    Channel& c = _ch[i];
+    if (c.pending && !c.busy) {
+      c.pending = false;
+      start(i, c.pendingLevel, c.pendingMs);
+    }
+  }
+
+  return _events && xQueueReceive(_events, &ev, wait) == pdTRUE;
+}
+
+// Fade-end interrupt: no driver calls here, mark idle and hand the event on
+bool IRAM_ATTR LedFade::onFadeEnd(const ledc_cb_param_t* param, void* arg) {
+  if (param->event != LEDC_FADE_END_EVT) return false;
+
+  LedFade* self = (LedFade*)arg;
+  uint8_t n = param->speed_mode * 8 + param->channel;
+  self->_ch[n].busy = false;
+
+  FadeEvent ev;
+  ev.channel = n;
+  ev.level = self->_ch[n].level;
+  ev.duty = param->duty;
+
+  BaseType_t woken = pdFALSE;
+  xQueueSendFromISR(self->_events, &ev, &woken);
+  return woken == pdTRUE;
+}
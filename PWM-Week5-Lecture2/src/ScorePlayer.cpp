@@ -0,0 +1,159 @@
+#include "ScorePlayer.h"
+
+static inline uint16_t rd16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+ScorePlayer::ScorePlayer(ToneFn tone, void* ctx)
+  : _tone(tone), _ctx(ctx), _qHead(0), _qTail(0),
+    _score(nullptr), _pc(nullptr), _dueUs(0), _depth(0),
+    _sweeping(false), _sweepHz(0), _lastHz(0) {
+  resetStats();
+}
+
+bool ScorePlayer::enqueue(const uint8_t* score) {
+  uint8_t tail = __atomic_load_n(&_qTail, __ATOMIC_RELAXED);
+  // acquire: step() is done reading the slot it gave back
+  if ((uint8_t)(tail - __atomic_load_n(&_qHead, __ATOMIC_ACQUIRE)) >= QUEUE_LEN) {
+    __atomic_fetch_add(&_rejected, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+  _queue[tail % QUEUE_LEN] = score;
+  __atomic_store_n(&_qTail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);  // slot before index
+  return true;
+}
+
+void ScorePlayer::tone(uint16_t hz) {
+  if (hz == _lastHz) return;
+  _lastHz = hz;
+  _tone(hz, _ctx);
+}
+
+void ScorePlayer::stop() {
+  _score = nullptr;
+  __atomic_store_n(&_qHead, __atomic_load_n(&_qTail, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+  _sweeping = false;
+  tone(0);
+}
+
+uint32_t ScorePlayer::step(uint32_t nowUs) {
+  if (_score) {
+    int32_t early = (int32_t)(_dueUs - nowUs);
+    if (early > 0) return early;  // spurious or early call
+
+    uint32_t late = nowUs - _dueUs;
+    if (late > _lateMaxUs) _lateMaxUs = late;
+    _lateSumUs += late;
+    _lateCount++;
+  }
+  return run(nowUs);
+}
+
+// Interprets op-codes until something takes time
+uint32_t ScorePlayer::run(uint32_t nowUs) {
+  bool fresh = !_score;  // starting from idle, not following a score
+
+  for (;;) {
+    if (!_score) {
+      uint8_t head = __atomic_load_n(&_qHead, __ATOMIC_RELAXED);
+      if (head == __atomic_load_n(&_qTail, __ATOMIC_ACQUIRE)) {
+        tone(0);
+        return 0;
+      }
+      _score = _pc = _queue[head % QUEUE_LEN];
+      __atomic_store_n(&_qHead, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+      _depth = 0;
+      _sweeping = false;
+      if (fresh) _dueUs = nowUs;
+    }
+
+    uint32_t durationUs = 0;
+
+    switch (_pc[0]) {
+      case SCORE_OP_NOTE:
+        tone(rd16(_pc + 1));
+        durationUs = rd16(_pc + 3) * 1000UL;
+        _pc += 5;
+        break;
+
+      case SCORE_OP_REST:
+        tone(0);
+        durationUs = rd16(_pc + 1) * 1000UL;
+        _pc += 3;
+        break;
+
+      case SCORE_OP_SWEEP: {
+        uint16_t from = rd16(_pc + 1);
+        uint16_t to   = rd16(_pc + 3);
+        uint16_t inc  = rd16(_pc + 5);
+        bool up = to >= from;
+
+        if (!_sweeping) {
+          _sweeping = true;
+          _sweepHz = from;
+        } else if (inc == 0 || (up ? to - _sweepHz < inc : _sweepHz - to < inc)) {
+          _sweeping = false;  // next step would pass `to`
+          _pc += 8;
+          continue;
+        } else {
+          _sweepHz = up ? _sweepHz + inc : _sweepHz - inc;
+        }
+        tone(_sweepHz);
+        durationUs = _pc[7] * 1000UL;
+        break;
+      }
+
+      case SCORE_OP_REPEAT:
+        if (_depth < MAX_NEST) {
+          _repeat[_depth].start = _pc + 2;
+          _repeat[_depth].left = _pc[1];
+          _depth++;
+        }
+        _pc += 2;
+        continue;
+
+      case SCORE_OP_LOOP:
+        if (_depth > 0 && --_repeat[_depth - 1].left > 0) {
+          _pc = _repeat[_depth - 1].start;
+        } else {
+          if (_depth > 0) _depth--;
+          _pc += 1;
+        }
+        continue;
+
+      case SCORE_OP_END:
+      default:  // unknown op-code ends the score rather than running off
+        _score = nullptr;
+        _scores++;
+        fresh = false;
+        continue;  // a queued score follows on the same beat
+    }
+
+    _events++;
+    if (durationUs == 0) continue;
+    _dueUs += durationUs;
+
+    // More than a whole event late: play it short rather than skip it
+    int32_t wait = (int32_t)(_dueUs - nowUs);
+    return wait > 0 ? wait : 1;
+  }
+}
+
+ScoreStats ScorePlayer::stats() const {
+  ScoreStats s;
+  s.events    = _events;
+  s.scores    = _scores;
+  s.rejected  = __atomic_load_n(&_rejected, __ATOMIC_RELAXED);
+  s.lateMaxUs = _lateMaxUs;
+  s.lateAvgUs = _lateCount ? (uint32_t)(_lateSumUs / _lateCount) : 0;
+  return s;
+}
+
+void ScorePlayer::resetStats() {
+  _events = 0;
+  _scores = 0;
+  __atomic_store_n(&_rejected, 0, __ATOMIC_RELAXED);
+  _lateMaxUs = 0;
+  _lateSumUs = 0;
+  _lateCount = 0;
+}
@@ -0,0 +1,170 @@
+#include "WaveSynth.h"
+
+#include <math.h>
+#include <string.h>
+
+// Shared by every instance, built once
+static int16_t s_tables[WAVE_COUNT][SYNTH_TABLE_SIZE + 1];  // +1: interpolation guard
+static bool    s_tablesReady = false;
+
+static void buildTables() {
+  for (int i = 0; i <= SYNTH_TABLE_SIZE; i++) {
+    int k = i % SYNTH_TABLE_SIZE;
+    float ph = (float)k / SYNTH_TABLE_SIZE;
+
+    s_tables[WAVE_SINE][i]     = (int16_t)lrintf(32767.0f * sinf(2.0f * (float)M_PI * ph));
+    s_tables[WAVE_TRIANGLE][i] = (int16_t)lrintf(32767.0f * (ph < 0.5f ? 4.0f * ph - 1.0f : 3.0f - 4.0f * ph));
+    s_tables[WAVE_SAW][i]      = (int16_t)lrintf(32767.0f * (2.0f * ph - 1.0f));
+    s_tables[WAVE_SQUARE][i]   = k < SYNTH_TABLE_SIZE / 2 ? 16384 : -16384;  // square is loud, halve it
+  }
+  s_tablesReady = true;
+}
+
+WaveSynth::WaveSynth(uint32_t sampleRate)
+  : _rate(sampleRate), _clipped(0), _cmdHead(0), _cmdTail(0) {
+  if (!s_tablesReady) buildTables();
+
+  memset(_voice, 0, sizeof(_voice));
+  SynthEnvelope def = { 5, 80, 160, 200 };
+  for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+    _voice[i].table = s_tables[WAVE_SINE];
+    _voice[i].shape = def;
+  }
+}
+
+void WaveSynth::setEnvelope(uint8_t voice, const SynthEnvelope& env) {
+  if (voice < SYNTH_VOICES) _voice[voice].shape = env;  // takes effect on next noteOn
+}
+
+bool WaveSynth::push(const Command& c) {
+  uint8_t tail = __atomic_load_n(&_cmdTail, __ATOMIC_RELAXED);
+  // acquire: render() is done reading the slots it gave back
+  if ((uint8_t)(tail - __atomic_load_n(&_cmdHead, __ATOMIC_ACQUIRE)) >= CMD_QUEUE) return false;
+  _cmd[tail % CMD_QUEUE] = c;
+  __atomic_store_n(&_cmdTail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);  // command before index
+  return true;
+}
+
+bool WaveSynth::noteOn(uint8_t voice, uint16_t hz, SynthWave wave, uint8_t velocity) {
+  if (voice >= SYNTH_VOICES || wave >= WAVE_COUNT) return false;
+  Command c = { voice, true, hz, wave, velocity };
+  return push(c);
+}
+
+bool WaveSynth::noteOff(uint8_t voice) {
+  if (voice >= SYNTH_VOICES) return false;
+  Command c = { voice, false, 0, WAVE_SINE, 0 };
+  return push(c);
+}
+
+// Per-sample envelope step that covers span in ms
+int32_t WaveSynth::stepFor(uint16_t ms, int32_t span) const {
+  uint32_t samples = (uint32_t)ms * _rate / 1000;
+  if (samples == 0) return span > 0 ? span : 1;
+  int32_t step = span / (int32_t)samples;
+  return step > 0 ? step : 1;
+}
+
+void WaveSynth::apply(const Command& c) {
+  Voice& v = _voice[c.voice];
+
+  if (!c.on) {
+    if (v.stage != STAGE_IDLE) {
+      v.stage = STAGE_RELEASE;
+      v.releaseStep = stepFor(v.shape.releaseMs, v.env);
+    }
+    return;
+  }
+
+  // Retrigger keeps phase and current level, so no click
+  v.table = s_tables[c.wave];
+  v.inc = (uint32_t)(((uint64_t)c.hz << 32) / _rate);
+  v.peak = (int32_t)65535 * c.velocity / 255;
+  v.sustainLevel = v.peak * v.shape.sustain / 255;
+  v.attackStep = stepFor(v.shape.attackMs, v.peak);
+  v.decayStep = stepFor(v.shape.decayMs, v.peak - v.sustainLevel);
+  v.stage = STAGE_ATTACK;
+}
+
+uint8_t WaveSynth::activeVoices() const {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < SYNTH_VOICES; i++) n += active(i);
+  return n;
+}
+
+// The kernel: one voice added into the accumulator
+void WaveSynth::mixVoice(Voice& v, int32_t* acc, uint16_t n) {
+  const int16_t* table = v.table;
+  uint32_t phase = v.phase;
+  uint32_t inc = v.inc;
+  int32_t env = v.env;
+
+  for (uint16_t i = 0; i < n; i++) {
+    uint32_t idx = phase >> (32 - SYNTH_TABLE_BITS);
+    int32_t frac = (phase >> (24 - SYNTH_TABLE_BITS)) & 0xFF;
+    int32_t a = table[idx];
+    int32_t s = a + (((table[idx + 1] - a) * frac) >> 8);
+
+    // 16 x 16 -> 32, then /4 so four full voices fit in int16
+    acc[i] += (s * (env >> 1)) >> 17;
+    phase += inc;
+
+    switch (v.stage) {
+      case STAGE_ATTACK:
+        env += v.attackStep;
+        if (env >= v.peak) { env = v.peak; v.stage = STAGE_DECAY; }
+        break;
+      case STAGE_DECAY:
+        env -= v.decayStep;
+        if (env <= v.sustainLevel) { env = v.sustainLevel; v.stage = STAGE_SUSTAIN; }
+        break;
+      case STAGE_RELEASE:
+        env -= v.releaseStep;
+        if (env <= 0) { env = 0; v.stage = STAGE_IDLE; }
+        break;
+      default:
+        break;
+    }
+  }
+
+  v.phase = phase;
+  v.env = env;
+}
+
+void WaveSynth::mix(uint16_t n) {
+  memset(_acc, 0, n * sizeof(int32_t));
+  for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+    if (_voice[i].stage != STAGE_IDLE) mixVoice(_voice[i], _acc, n);
+  }
+}
+
+void WaveSynth::render(int16_t* out, uint16_t n) {
+  uint8_t head = __atomic_load_n(&_cmdHead, __ATOMIC_RELAXED);
+  uint8_t tail = __atomic_load_n(&_cmdTail, __ATOMIC_ACQUIRE);
+  while (head != tail) apply(_cmd[head++ % CMD_QUEUE]);
+  __atomic_store_n(&_cmdHead, head, __ATOMIC_RELEASE);
+
+  while (n > 0) {
+    uint16_t chunk = n < BLOCK ? n : BLOCK;
+    mix(chunk);
+    for (uint16_t i = 0; i < chunk; i++) {
+      int32_t s = _acc[i];
+      if (s > 32767)       { s = 32767;  _clipped++; }
+      else if (s < -32768) { s = -32768; _clipped++; }
+      out[i] = (int16_t)s;
+    }
+    out += chunk;
+    n -= chunk;
+  }
+}
+
+void WaveSynth::renderDac(uint16_t* frames, uint16_t n) {
+  // Render mono into the back half, then expand in place front to back
+  int16_t* mono = (int16_t*)frames + n;
+  render(mono, n);
+  for (uint16_t i = 0; i < n; i++) {
+    uint16_t d = (uint16_t)(mono[i] + 32768) & 0xFF00;  // DAC takes the high byte
+    frames[2 * i]     = d;
+    frames[2 * i + 1] = d;
+  }
+}
@@ -1,4 +1,16 @@
 #include <Arduino.h>
+#include "LedFade.h"
+#include "BuzzerPlayer.h"
+
+// 1 = play the demo on the DAC synth (GPIO25 + amplifier) instead of the buzzer
+#ifndef USE_SYNTH
+#define USE_SYNTH 0
+#endif
+
+#if USE_SYNTH
+#include "WaveSynth.h"
+#include "I2sDac.h"
+#endif
 
 #define BUZZER_PIN  27     // GPIO connected to buzzer
 #define BUZ_CH      0      // PWM channel (0–15)
@@ -6,14 +18,83 @@
 #define BUZ_RESOLUTION  10     // 10-bit resolution (0–1023)
 
 #define LED1_PIN 18
-#define LED1_CH 1
+#define LED1_CH 4     // not 1: channels 0/1 share a timer, the buzzer retunes it
 #define LED1_FREQ 5000
 
 #define LED2_PIN 19
 #define LED2_CH 2
 #define LED2_FREQ 8000
 
-#define LED_RES 8
+#define LED_RES 12   // fine steps at the dark end of the gamma curve
+
+#define LED1_RAMP_MS 1200
+#define LED2_RAMP_MS 800
+
+LedFade fader;
+BuzzerPlayer buzzer(BUZ_CH, BUZ_RESOLUTION);
+
+// ---- Scores (flash), played by the buzzer task ----
+const uint8_t startupChirp[] = {
+  SC_REPEAT(2),
+    SC_NOTE(3000, 40),
+    SC_REST(40),
+  SC_LOOP(),
+  SC_REST(300),
+  SC_END()
+};
+
+const uint8_t demoScore[] = {
+  // 1. Simple beep pattern
+  SC_NOTE(2000, 150), SC_REST(150),
+  SC_NOTE(2400, 150), SC_REST(150),
+  SC_NOTE(2800, 150), SC_REST(150),
+
+  // 2. Frequency sweep (400Hz -> 3kHz)
+  SC_SWEEP(400, 3000, 100, 20),
+  SC_REST(500),
+
+  // 3. Short melody
+  SC_NOTE(262, 250), SC_NOTE(294, 250), SC_NOTE(330, 250), SC_NOTE(349, 250),
+  SC_NOTE(392, 250), SC_NOTE(440, 250), SC_NOTE(494, 250), SC_NOTE(523, 250),
+  SC_REST(800),
+  SC_END()
+};
+
+uint32_t lastScores = 0;
+
+#if USE_SYNTH
+#define SYNTH_RATE     22050
+#define SYNTH_STEP_MS  250
+
+WaveSynth synth(SYNTH_RATE);
+I2sDac dac(synth);
+
+const uint16_t melody[] = {262, 294, 330, 349, 392, 440, 494, 523};
+const uint16_t chord[]  = {131, 175, 196, 131};  // pad root, changes every 4 steps
+uint8_t  synthStep = 0;
+uint32_t synthTimer = 0;
+
+// Melody rotates over voices 0-2 so release tails overlap, voice 3 holds a pad
+void synthService() {
+  uint32_t now = millis();
+  if (now - synthTimer < SYNTH_STEP_MS) return;
+  synthTimer = now;
+
+  uint8_t voice = synthStep % 3;
+  synth.noteOff((voice + 2) % 3);
+  synth.noteOn(voice, melody[synthStep % 8], WAVE_TRIANGLE, 200);
+
+  if (synthStep % 4 == 0) synth.noteOn(3, chord[(synthStep / 4) % 4], WAVE_SAW, 90);
+
+  if (++synthStep % 32 == 0) {
+    I2sDacStats d = dac.stats();
+    Serial.printf("Synth: voices=%u blocks=%lu render last=%lu max=%lu us load=%u%% clipped=%lu\n",
+                  synth.activeVoices(), (unsigned long)d.blocks,
+                  (unsigned long)d.renderUsLast, (unsigned long)d.renderUsMax,
+                  d.loadPct, (unsigned long)synth.clipped());
+  }
+}
+#endif
 
 void setup() {
   //LED1
@@ -26,63 +107,48 @@ void setup() {
   ledcSetup(BUZ_CH, BUZ_FREQ, BUZ_RESOLUTION);
   ledcAttachPin(BUZZER_PIN, BUZ_CH);
 
-  // --- 1. Simple beep pattern ---
-  for (int i = 0; i < 3; i++) {
-    ledcWriteTone(BUZ_CH, 2000 + i * 400); // change tone
-    delay(150);
-    ledcWrite(BUZ_CH, 0);                  // stop tone
-    delay(150);
-  }
+  Serial.begin(115200);
+  fader.begin();
+  fader.attach(LED1_CH, LED_RES);
+  fader.attach(LED2_CH, LED_RES);
 
-  // --- 2. Frequency sweep (400Hz → 3kHz) ---
-  for (int f = 400; f <= 3000; f += 100) {
-    ledcWriteTone(BUZ_CH, f);
-    delay(20);
-  }
-  ledcWrite(BUZ_CH, 0);
-  delay(500);
-
-  // --- 3. Short melody ---
-  int melody[] = {262, 294, 330, 349, 392, 440, 494, 523};
-  for (int i = 0; i < 8; i++) {
-    ledcWriteTone(BUZ_CH, melody[i]);
-    delay(250);
-  }
-  ledcWrite(BUZ_CH, 0); // stop buzzer
+#if USE_SYNTH
+  SynthEnvelope pad = { 300, 200, 200, 600 };
+  synth.setEnvelope(3, pad);
+  dac.begin();
+#else
+  buzzer.begin();
+  buzzer.play(startupChirp);
+  buzzer.play(demoScore);
+#endif
+
+  // Start the LED ramps, loop() keeps them going
+  fader.fadeTo(LED1_CH, 255, LED1_RAMP_MS);
+  fader.fadeTo(LED2_CH, 255, LED2_RAMP_MS);
 }
 
 void loop() {
-  for (int i = 0; i < 3; i++) {
-    ledcWriteTone(BUZ_CH, 2000 + i * 400); // change tone
-    delay(150);
-    ledcWrite(BUZ_CH, 0);                  // stop tone
-    delay(150);
-  }
+#if USE_SYNTH
+  synthService();
+#else
+  // Keep one score waiting so the player chains straight into it
+  if (buzzer.queued() == 0) buzzer.play(demoScore);
 
-  // --- 2. Frequency sweep (400Hz → 3kHz) ---
-  for (int f = 400; f <= 3000; f += 100) {
-    ledcWriteTone(BUZ_CH, f);
-    delay(20);
+  ScoreStats st = buzzer.stats();
+  if (st.scores != lastScores) {
+    lastScores = st.scores;
+    Serial.printf("Buzzer: scores=%lu events=%lu late avg=%lu max=%lu us\n",
+                  (unsigned long)st.scores, (unsigned long)st.events,
+                  (unsigned long)st.lateAvgUs, (unsigned long)st.lateMaxUs);
   }
-  ledcWrite(BUZ_CH, 0);
-  delay(500);
-
-  // --- 3. Short melody ---
-  int melody[] = {262, 294, 330, 349, 392, 440, 494, 523};
-  for (int i = 0; i < 8; i++) {
-    ledcWriteTone(BUZ_CH, melody[i]);
-    delay(250);
+#endif
+
+  // LEDs ramp in hardware, each fade-end event turns the ramp around
+  FadeEvent ev;
+  while (fader.poll(ev, pdMS_TO_TICKS(10))) {  // also paces loop()
+    Serial.printf("LED ch%u fade done at level %u (duty %lu)\n",
+                  ev.channel, ev.level, (unsigned long)ev.duty);
+    uint32_t ms = ev.channel == LED1_CH ? LED1_RAMP_MS : LED2_RAMP_MS;
+    fader.fadeTo(ev.channel, ev.level ? 0 : 255, ms);
   }
-  //LED1
-  for (int d=0; d<=255; d=d+10) { 
-ledcWrite(LED1_CH, d); delay(10);
-ledcWrite(LED2_CH, d); delay(10);
-  //LED2
- }
-  for (int d=255; d>=0; d=d-20) { 
-ledcWrite(LED1_CH, d); delay(10);
-ledcWrite(LED2_CH, d); delay(10);
-
- }
-  ledcWrite(BUZ_CH, 0); // stop buzzer
-}
\ No newline at end of file
+}
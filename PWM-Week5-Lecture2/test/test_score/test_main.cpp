@@ -0,0 +1,282 @@
+// ScorePlayer on a fake clock, the way the timer ISR drives it:
+// pio test -e native
+#include <unity.h>
+
+#include <string.h>
+
+#include <thread>
+
+#include "ScorePlayer.h"
+
+// Every tone change with the fake time it happened at
+struct ToneChange {
+  uint32_t us;
+  uint16_t hz;
+};
+
+static uint32_t   fakeUs;
+static ToneChange changes[64];
+static uint8_t    changeCount;
+
+static void logTone(uint16_t hz, void* ctx) {
+  if (changeCount < 64) changes[changeCount++] = { fakeUs, hz };
+}
+
+// step() at each time it asks for, like the one-shot timer; returns the end time
+static uint32_t playOut(ScorePlayer& p, uint32_t startUs) {
+  fakeUs = startUs;
+  for (int guard = 0; guard < 10000; guard++) {
+    uint32_t wait = p.step(fakeUs);
+    if (wait == 0) return fakeUs;
+    fakeUs += wait;
+  }
+  TEST_FAIL_MESSAGE("score did not end");
+  return 0;
+}
+
+static void assertChange(uint8_t i, uint32_t us, uint16_t hz) {
+  TEST_ASSERT_TRUE_MESSAGE(i < changeCount, "missing tone change");
+  TEST_ASSERT_EQUAL_UINT32(us, changes[i].us);
+  TEST_ASSERT_EQUAL_UINT16(hz, changes[i].hz);
+}
+
+void setUp() {
+  fakeUs = 0;
+  changeCount = 0;
+}
+
+void tearDown() {}
+
+void test_notes_and_rests_on_time() {
+  static const uint8_t score[] = { SC_NOTE(440, 100), SC_REST(50), SC_NOTE(880, 20), SC_END() };
+  ScorePlayer p(logTone);
+  TEST_ASSERT_TRUE(p.enqueue(score));
+
+  TEST_ASSERT_EQUAL_UINT32(170000, playOut(p, 0));
+  TEST_ASSERT_EQUAL(4, changeCount);
+  assertChange(0, 0, 440);
+  assertChange(1, 100000, 0);
+  assertChange(2, 150000, 880);
+  assertChange(3, 170000, 0);
+
+  ScoreStats s = p.stats();
+  TEST_ASSERT_EQUAL_UINT32(3, s.events);
+  TEST_ASSERT_EQUAL_UINT32(1, s.scores);
+  TEST_ASSERT_EQUAL_UINT32(0, s.lateMaxUs);
+  TEST_ASSERT_TRUE(p.idle());
+}
+
+// A late call shortens the next event instead of shifting the score
+void test_late_call_keeps_schedule() {
+  static const uint8_t score[] = { SC_NOTE(440, 100), SC_NOTE(660, 100), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  TEST_ASSERT_EQUAL_UINT32(100000, p.step(0));
+  fakeUs = 103000;
+  TEST_ASSERT_EQUAL_UINT32(97000, p.step(fakeUs));
+  assertChange(1, 103000, 660);
+  fakeUs = 200000;
+  TEST_ASSERT_EQUAL_UINT32(0, p.step(fakeUs));
+
+  ScoreStats s = p.stats();
+  TEST_ASSERT_EQUAL_UINT32(3000, s.lateMaxUs);
+  TEST_ASSERT_EQUAL_UINT32(1500, s.lateAvgUs);
+}
+
+// More than a whole event late: the event is still played, for 1 us
+void test_very_late_call_plays_short() {
+  static const uint8_t score[] = { SC_NOTE(440, 10), SC_NOTE(660, 10), SC_NOTE(880, 10), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  p.step(0);
+  fakeUs = 25000;
+  TEST_ASSERT_EQUAL_UINT32(1, p.step(fakeUs));
+  fakeUs = 25001;
+  TEST_ASSERT_EQUAL_UINT32(4999, p.step(fakeUs));   // still due at 30000
+  TEST_ASSERT_EQUAL(3, changeCount);
+  assertChange(2, 25001, 880);
+}
+
+// Early (spurious) calls change nothing and report the time left
+void test_early_call_waits() {
+  static const uint8_t score[] = { SC_NOTE(440, 100), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  p.step(0);
+  TEST_ASSERT_EQUAL_UINT32(60000, p.step(40000));
+  TEST_ASSERT_EQUAL(1, changeCount);
+  TEST_ASSERT_EQUAL_UINT32(1, p.stats().events);
+}
+
+void test_sweeps() {
+  static const uint8_t up[]     = { SC_SWEEP(100, 400, 100, 10), SC_END() };
+  static const uint8_t down[]   = { SC_SWEEP(400, 100, 150, 5), SC_END() };
+  static const uint8_t uneven[] = { SC_SWEEP(100, 350, 100, 10), SC_END() };  // stops at 300
+  ScorePlayer p(logTone);
+
+  p.enqueue(up);
+  TEST_ASSERT_EQUAL_UINT32(40000, playOut(p, 0));
+  assertChange(0, 0, 100);
+  assertChange(1, 10000, 200);
+  assertChange(2, 20000, 300);
+  assertChange(3, 30000, 400);
+  assertChange(4, 40000, 0);
+
+  changeCount = 0;
+  p.enqueue(down);
+  TEST_ASSERT_EQUAL_UINT32(40000 + 15000, playOut(p, 40000));
+  assertChange(0, 40000, 400);
+  assertChange(1, 45000, 250);
+  assertChange(2, 50000, 100);
+
+  changeCount = 0;
+  p.enqueue(uneven);
+  TEST_ASSERT_EQUAL_UINT32(55000 + 30000, playOut(p, 55000));
+  assertChange(2, 75000, 300);
+  assertChange(3, 85000, 0);
+}
+
+// 2 x (3 notes + rest); repeated notes of one pitch don't retrigger the output
+void test_nested_repeats() {
+  static const uint8_t score[] = {
+    SC_REPEAT(2),
+      SC_REPEAT(3), SC_NOTE(1000, 10), SC_LOOP(),
+      SC_REST(20),
+    SC_LOOP(),
+    SC_END()
+  };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  TEST_ASSERT_EQUAL_UINT32(2 * (3 * 10000 + 20000), playOut(p, 0));
+  TEST_ASSERT_EQUAL_UINT32(8, p.stats().events);
+  TEST_ASSERT_EQUAL(4, changeCount);   // ends on the rest, already silent
+  assertChange(1, 30000, 0);
+  assertChange(2, 50000, 1000);
+  assertChange(3, 80000, 0);
+}
+
+// Queued scores follow on the same beat; a full queue refuses
+void test_queue_chains_and_rejects() {
+  static const uint8_t a[] = { SC_NOTE(500, 10), SC_END() };
+  static const uint8_t b[] = { SC_NOTE(700, 10), SC_END() };
+  ScorePlayer p(logTone);
+
+  for (uint8_t i = 0; i < ScorePlayer::QUEUE_LEN; i++) {
+    TEST_ASSERT_TRUE(p.enqueue(i & 1 ? b : a));
+  }
+  TEST_ASSERT_FALSE(p.enqueue(a));
+  TEST_ASSERT_EQUAL(ScorePlayer::QUEUE_LEN, p.queued());
+  TEST_ASSERT_EQUAL_UINT32(1, p.stats().rejected);
+
+  TEST_ASSERT_EQUAL_UINT32(40000, playOut(p, 0));
+  TEST_ASSERT_EQUAL(5, changeCount);
+  assertChange(1, 10000, 700);
+  assertChange(2, 20000, 500);
+  assertChange(3, 30000, 700);
+  TEST_ASSERT_EQUAL_UINT32(ScorePlayer::QUEUE_LEN, p.stats().scores);
+
+  // The ring indices wrap past 255 without losing a slot
+  for (int i = 0; i < 300; i++) {
+    TEST_ASSERT_TRUE(p.enqueue(a));
+    playOut(p, fakeUs);
+  }
+  TEST_ASSERT_TRUE(p.idle());
+}
+
+void test_stop_silences_and_drops_queue() {
+  static const uint8_t score[] = { SC_NOTE(440, 100), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+  p.enqueue(score);
+
+  p.step(0);
+  p.stop();
+  TEST_ASSERT_TRUE(p.idle());
+  TEST_ASSERT_EQUAL(0, p.queued());
+  assertChange(1, 0, 0);
+  TEST_ASSERT_EQUAL_UINT32(0, p.step(100000));
+}
+
+// micros() wraps every 71 minutes; the schedule must not care
+void test_clock_wrap() {
+  static const uint8_t score[] = { SC_NOTE(440, 10), SC_NOTE(660, 10), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  uint32_t start = 0xFFFFFFFFu - 4999;
+  TEST_ASSERT_EQUAL_UINT32(start + 20000, playOut(p, start));
+  assertChange(1, start + 10000, 660);
+  TEST_ASSERT_EQUAL_UINT32(0, p.stats().lateMaxUs);
+}
+
+// An unknown op-code ends the score instead of running off the end
+void test_unknown_op_ends_score() {
+  static const uint8_t score[] = { SC_NOTE(440, 10), 0x7F, SC_NOTE(880, 10), SC_END() };
+  ScorePlayer p(logTone);
+  p.enqueue(score);
+
+  TEST_ASSERT_EQUAL_UINT32(10000, playOut(p, 0));
+  TEST_ASSERT_EQUAL(2, changeCount);
+  TEST_ASSERT_EQUAL_UINT32(1, p.stats().scores);
+}
+
+// enqueue() on one thread while step() runs on another, as the
+// task and the timer ISR do on two cores: every score arrives, in order
+static uint16_t expectHz;
+static uint32_t outOfOrder;
+
+static void checkOrder(uint16_t hz, void* ctx) {
+  if (hz == 0) return;   // queue ran dry for a moment
+  if (hz != expectHz) outOfOrder++;
+  expectHz = hz == 1015 ? 1000 : hz + 1;
+}
+
+void test_enqueue_from_another_thread() {
+  static uint8_t scores[16][7];
+  for (uint8_t i = 0; i < 16; i++) {
+    const uint8_t score[] = { SC_NOTE(1000 + i, 1), SC_END() };
+    memcpy(scores[i], score, sizeof(score));
+  }
+  const uint32_t count = 100000;
+  expectHz = 1000;
+  outOfOrder = 0;
+  ScorePlayer p(checkOrder);
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < count; i++) {
+      while (!p.enqueue(scores[i % 16])) std::this_thread::yield();
+    }
+  });
+
+  uint32_t now = 0;
+  while (p.stats().scores < count) {
+    uint32_t wait = p.step(now);
+    if (!wait) std::this_thread::yield();   // drained, let the producer in
+    now += wait ? wait : 1;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+  TEST_ASSERT_EQUAL_UINT32(count, p.stats().scores);
+  TEST_ASSERT_TRUE(p.idle());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_notes_and_rests_on_time);
+  RUN_TEST(test_late_call_keeps_schedule);
+  RUN_TEST(test_very_late_call_plays_short);
+  RUN_TEST(test_early_call_waits);
+  RUN_TEST(test_sweeps);
+  RUN_TEST(test_nested_repeats);
+  RUN_TEST(test_queue_chains_and_rejects);
+  RUN_TEST(test_stop_silences_and_drops_queue);
+  RUN_TEST(test_clock_wrap);
+  RUN_TEST(test_unknown_op_ends_score);
+  RUN_TEST(test_enqueue_from_another_thread);
+  return UNITY_END();
+}
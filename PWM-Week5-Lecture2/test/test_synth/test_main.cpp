@@ -0,0 +1,118 @@
+// WaveSynth output and command queue on the PC: pio test -e native
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "WaveSynth.h"
+
+#define RATE 22050
+
+static int16_t out[RATE / 10];   // 100 ms
+
+// Past the default 5 ms attack and 80 ms decay
+static void settle(WaveSynth& synth) {
+  for (int i = 0; i < 3; i++) synth.render(out, RATE / 10);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// 1 kHz for 100 ms crosses zero ~200 times; full velocity peaks at a quarter scale
+void test_sine_pitch_and_level() {
+  WaveSynth synth(RATE);
+  SynthEnvelope flat = { 0, 0, 255, 10 };
+  synth.setEnvelope(0, flat);
+  synth.noteOn(0, 1000);
+  synth.render(out, RATE / 10);
+
+  int crossings = 0;
+  int16_t peak = 0;
+  for (int i = 1; i < RATE / 10; i++) {
+    if ((out[i - 1] < 0) != (out[i] < 0)) crossings++;
+    if (out[i] > peak) peak = out[i];
+  }
+  TEST_ASSERT_INT_WITHIN(2, 200, crossings);
+  TEST_ASSERT_INT_WITHIN(64, 8191, peak);
+}
+
+// Four full squares in phase are the worst case, still no clipping
+void test_four_voices_never_clip() {
+  WaveSynth synth(RATE);
+  SynthEnvelope flat = { 0, 0, 255, 10 };
+  for (uint8_t v = 0; v < SYNTH_VOICES; v++) {
+    synth.setEnvelope(v, flat);
+    synth.noteOn(v, 500, WAVE_SQUARE, 255);
+  }
+  settle(synth);
+  TEST_ASSERT_EQUAL(SYNTH_VOICES, synth.activeVoices());
+  TEST_ASSERT_EQUAL_UINT32(0, synth.clipped());
+}
+
+void test_release_goes_idle() {
+  WaveSynth synth(RATE);
+  synth.noteOn(1, 440, WAVE_TRIANGLE);
+  settle(synth);
+  TEST_ASSERT_TRUE(synth.active(1));
+
+  synth.noteOff(1);
+  TEST_ASSERT_TRUE(synth.active(1));   // queued until the next block
+  synth.render(out, RATE / 10);        // 100 ms < 200 ms release
+  TEST_ASSERT_TRUE(synth.active(1));
+  settle(synth);
+  TEST_ASSERT_FALSE(synth.active(1));
+
+  synth.render(out, RATE / 10);
+  for (int i = 0; i < RATE / 10; i++) TEST_ASSERT_EQUAL_INT16(0, out[i]);
+}
+
+void test_queue_full_refuses() {
+  WaveSynth synth(RATE);
+  for (uint8_t i = 0; i < WaveSynth::CMD_QUEUE; i++) TEST_ASSERT_TRUE(synth.noteOn(i % SYNTH_VOICES, 440));
+  TEST_ASSERT_FALSE(synth.noteOn(0, 440));
+  TEST_ASSERT_FALSE(synth.noteOn(SYNTH_VOICES, 440));   // no such voice
+
+  synth.render(out, 1);
+  TEST_ASSERT_TRUE(synth.noteOff(0));
+}
+
+// noteOn/noteOff from one thread while another renders, like the
+// sketch's loop() and the I2S task: nothing is lost, all end released
+void test_commands_from_another_thread() {
+  WaveSynth synth(RATE);
+  SynthEnvelope quick = { 0, 0, 255, 0 };
+  for (uint8_t v = 0; v < SYNTH_VOICES; v++) synth.setEnvelope(v, quick);
+  const uint32_t count = 50000;   // per voice: on, off, ..., off last
+  std::atomic<bool> done(false);
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < count; i++) {
+      uint8_t v = i % SYNTH_VOICES;
+      bool on = (i / SYNTH_VOICES) % 2 == 0;
+      while (!(on ? synth.noteOn(v, 200 + i % 800, (SynthWave)(i % WAVE_COUNT)) : synth.noteOff(v))) {
+        std::this_thread::yield();   // queue full until the next block
+      }
+    }
+    done = true;
+  });
+
+  int16_t block[64];
+  while (!done) {
+    synth.render(block, 64);
+    std::this_thread::yield();
+  }
+  producer.join();
+  synth.render(block, 64);   // whatever came in after the last block
+  TEST_ASSERT_EQUAL(0, synth.activeVoices());
+  TEST_ASSERT_EQUAL_UINT32(0, synth.clipped());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sine_pitch_and_level);
+  RUN_TEST(test_four_voices_never_clip);
+  RUN_TEST(test_release_goes_idle);
+  RUN_TEST(test_queue_full_refuses);
+  RUN_TEST(test_commands_from_another_thread);
+  return UNITY_END();
+}
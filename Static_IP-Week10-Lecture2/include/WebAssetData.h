@@ -0,0 +1,36 @@
+// Generated by tools/webassets/embed.py from data/, do not edit.
+#pragma once
+
+#include <WebAssets.h>
+
+// index.html: 804 bytes, 645 minified, 376 gzipped
+constexpr uint8_t WEB_index_html[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x52, 0x4d, 0x4b, 0x03, 0x31,
+  0x10, 0xbd, 0xf7, 0x57, 0x8c, 0x39, 0x6d, 0xc1, 0x76, 0xad, 0x5e, 0x44, 0x93, 0x15, 0xac, 0x5d,
+  0x10, 0xc4, 0x0a, 0xea, 0xc1, 0x63, 0x9a, 0x9d, 0xba, 0xd1, 0x34, 0x29, 0xc9, 0xd4, 0x2a, 0xe2,
+  0x7f, 0x77, 0xb2, 0x5d, 0x2a, 0x48, 0x0f, 0xf9, 0x9c, 0x37, 0x6f, 0xde, 0xbc, 0x44, 0x1e, 0xdd,
+  0xcc, 0xa7, 0x4f, 0x2f, 0x0f, 0x33, 0x68, 0x69, 0xe5, 0x2a, 0xd9, 0xcf, 0xa8, 0x9b, 0x4a, 0xae,
+  0x90, 0x34, 0x98, 0x56, 0xc7, 0x84, 0xa4, 0xc4, 0xf3, 0x53, 0x3d, 0x3a, 0x17, 0xfd, 0xad, 0xd7,
+  0x2b, 0x54, 0xe2, 0xc3, 0xe2, 0x76, 0x1d, 0x22, 0x09, 0x30, 0xc1, 0x13, 0x7a, 0x46, 0x6d, 0x6d,
+  0x43, 0xad, 0x6a, 0xf0, 0xc3, 0x1a, 0x1c, 0x75, 0x87, 0x63, 0xb0, 0xde, 0x92, 0xd5, 0x6e, 0x94,
+  0x8c, 0x76, 0xa8, 0x26, 0xcc, 0x41, 0x96, 0x1c, 0x56, 0xb3, 0xc7, 0x87, 0xb3, 0x53, 0xb8, 0x9b,
+  0xdd, 0xc0, 0x94, 0xd3, 0x63, 0x70, 0xb2, 0xdc, 0x05, 0x64, 0xb9, 0x13, 0xb0, 0x08, 0xcd, 0x17,
+  0x8b, 0x99, 0x1c, 0x42, 0xf2, 0xad, 0x5c, 0x57, 0x52, 0x43, 0x1b, 0x71, 0xa9, 0x44, 0xc9, 0x41,
+  0x35, 0xbf, 0x17, 0x10, 0xbc, 0x71, 0xd6, 0xbc, 0x2b, 0x11, 0x91, 0x36, 0xd1, 0x83, 0xc3, 0xa6,
+  0x98, 0x0c, 0xb9, 0xe6, 0x62, 0x43, 0x14, 0x7c, 0x95, 0x49, 0xe6, 0xf7, 0xb2, 0xec, 0x8f, 0xb2,
+  0xd4, 0x3c, 0xd6, 0x07, 0xb8, 0xea, 0xfa, 0x30, 0xd9, 0xc9, 0x7f, 0xb2, 0xba, 0x3e, 0xc4, 0x96,
+  0x43, 0x36, 0x81, 0x5c, 0x80, 0x6d, 0x94, 0x48, 0xa4, 0x09, 0x45, 0x75, 0xc5, 0xc8, 0x1d, 0x20,
+  0x99, 0x68, 0xd7, 0x54, 0x2d, 0x37, 0xde, 0x90, 0x0d, 0x1e, 0x52, 0x1b, 0xb6, 0x45, 0x1c, 0xc2,
+  0xf7, 0xa0, 0x2f, 0x15, 0xc7, 0x6f, 0x29, 0xf8, 0x62, 0x38, 0xa6, 0x16, 0x7d, 0xb1, 0xc7, 0x15,
+  0x29, 0x63, 0x9a, 0x60, 0x36, 0x2b, 0xf6, 0x7b, 0xfc, 0x8a, 0x34, 0x73, 0x98, 0xb7, 0xd7, 0x5f,
+  0xb7, 0x4d, 0xd1, 0xd7, 0xe1, 0x24, 0xfc, 0xa4, 0xe9, 0xee, 0x4d, 0x40, 0x41, 0x1a, 0xb3, 0x70,
+  0xb8, 0x02, 0x91, 0x0d, 0xba, 0xe0, 0x85, 0x7b, 0xbb, 0x1c, 0xfc, 0x0c, 0x79, 0x0c, 0xf6, 0xcc,
+  0xb9, 0xb7, 0xe0, 0x33, 0xfb, 0x12, 0xc9, 0xb4, 0xbc, 0xcf, 0x19, 0x7b, 0x5f, 0x2f, 0xe0, 0xcf,
+  0x97, 0x5e, 0x54, 0xd6, 0xcc, 0x1c, 0xbd, 0xe0, 0xa5, 0x76, 0x09, 0x3b, 0xc6, 0x2e, 0x5d, 0x94,
+  0x7b, 0x2d, 0x7f, 0x58, 0x59, 0xf6, 0x7d, 0xb3, 0x0f, 0xdd, 0xdb, 0x96, 0xdd, 0x7f, 0xfb, 0x05,
+  0x27, 0x2e, 0x34, 0x7d, 0x85, 0x02, 0x00, 0x00,
+};
+
+constexpr WebAsset WEB_ASSETS[] = {
+  { "/", "text/html", WEB_index_html, sizeof(WEB_index_html), "\"647a24d706b4\"", false },
+};
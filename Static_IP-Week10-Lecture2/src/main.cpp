@@ -1,4 +1,9 @@
 #include <WiFi.h>
+#include <FastPin.h>
+#include <RingLog.h>   // request logging must not wait for the UART
+#include <WebAssets.h>
+#include <HeapMon.h>    // heap/stack watermarks: 'h' on serial, /heap
+#include "WebAssetData.h"   // data/, gzipped by tools/webassets/embed.py
 
 // -------- WiFi credentials --------
 const char* ssid     = "Pixel :3";
@@ -14,13 +19,57 @@ IPAddress secondaryDNS(8, 8, 4, 4);      // Optional
 // -------- Web server & LED pin --------
 WiFiServer server(80);       // HTTP server on port 80
 const int LED_PIN = 2;       // Change if your LED is on another pin
+FastPin<LED_PIN> led;        // invalid pins fail to compile
+bool ledOn = false;          // for /state
+
+#define REQUEST_TIMEOUT_MS 2000  // request line and headers, then the client is dropped
+
+#if RLOG_BENCH
+// ---- Cost per log call: Serial.printf vs RingLog (env nodemcu-32s-bench) ----
+#define BENCH_CALLS  16   // fits the ring, so nothing is dropped
+#define BENCH_ROUNDS 8
+
+void benchLog() {
+  uint32_t printfCycles = 0, ringCycles = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    Serial.flush();  // start each side with an empty UART FIFO
+    uint32_t t0 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+      Serial.printf("GET /LED=ON HTTP/1.1 #%d t=%.2f\n", i, 23.5f);
+    }
+    uint32_t t1 = ESP.getCycleCount();
+    Serial.flush();
+    delay(50);  // let the drain task empty the ring
+
+    uint32_t t2 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+      RLOG_I("GET /LED=ON HTTP/1.1 #%d t=%.2f", i, 23.5f);
+    }
+    uint32_t t3 = ESP.getCycleCount();
+    delay(200);
+
+    printfCycles += t1 - t0;
+    ringCycles += t3 - t2;
+  }
+
+  uint32_t calls = BENCH_CALLS * BENCH_ROUNDS;
+  RingLogStats st = ringLogStats();
+  Serial.printf("Serial.printf %8lu cycles/call\n", (unsigned long)(printfCycles / calls));
+  Serial.printf("RLOG_I        %8lu cycles/call  (dropped %lu)\n",
+                (unsigned long)(ringCycles / calls), (unsigned long)st.dropped);
+}
+#endif
 
 void setup() {
   Serial.begin(115200);
+  ringLogBegin(Serial);
+#if RLOG_BENCH
+  benchLog();
+#endif
 
   // LED setup
   pinMode(LED_PIN, OUTPUT);
-  digitalWrite(LED_PIN, LOW);
+  led.low();
 
   // Set Static IP (optional, but you wanted it)
   if (!WiFi.config(local_IP, gateway, subnet, primaryDNS, secondaryDNS)) {
@@ -44,50 +93,132 @@ void setup() {
   // Start web server
   server.begin();
   Serial.println("HTTP server started");
+
+  heapMonWatchTask("loopTask");
+  heapMonWatchTask("ringlog");
+  heapMonWatchTask("heapmon");
+  heapMonWatchTask("tiT");        // lwIP
+  heapMonBegin();
+}
+
+// One line without the \r\n, cut to size. False when the client went
+// away or startMs + REQUEST_TIMEOUT_MS passed first, so an idle client
+// can't hold up loop().
+bool readLine(WiFiClient& client, char* line, size_t size, uint32_t startMs) {
+  size_t n = 0;
+  while (client.connected()) {
+    if (!client.available()) {
+      if (millis() - startMs >= REQUEST_TIMEOUT_MS) break;
+      delay(1);   // let the WiFi/lwIP tasks run
+      continue;
+    }
+    char c = client.read();
+    if (c == '\r') continue;   // ignore carriage return
+    if (c == '\n') {
+      line[n] = 0;
+      return true;
+    }
+    if (n < size - 1) line[n++] = c;
+  }
+  line[n] = 0;
+  return false;
+}
+
+// The heap monitor's data as JSON, ends with the connection
+void sendHeap(WiFiClient& client) {
+  static const char head[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+    "Cache-Control: no-store\r\nConnection: close\r\n\r\n";
+  client.write((const uint8_t*)head, sizeof(head) - 1);
+  heapMonJson(client);
+}
+
+// {"led":0|1}, never cached: the page fetches this, not itself.
+// A plain link click (no JS) is sent back to the page instead.
+void sendState(WiFiClient& client, bool navigation) {
+  if (navigation) {
+    static const char back[] =
+      "HTTP/1.1 303 See Other\r\nLocation: /\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    client.write((const uint8_t*)back, sizeof(back) - 1);
+    return;
+  }
+
+  char body[16];
+  int len = snprintf(body, sizeof(body), "{\"led\":%d}", ledOn ? 1 : 0);
+  char resp[160];
+  int n = snprintf(resp, sizeof(resp),
+                   "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: %d\r\n"
+                   "Cache-Control: no-store\r\n"
+                   "Connection: close\r\n\r\n%s", len, body);
+  client.write((const uint8_t*)resp, n);
 }
 
 void loop() {
+  if (Serial.available() && Serial.read() == 'h') heapMonPrint(Serial);
+
   WiFiClient client = server.available();
   if (!client) return;  // No client, exit loop()
 
-  Serial.println("New Client connected");
-
-  String requestLine = "";
-  // Read only the first request line (e.g. "GET /LED=ON HTTP/1.1")
-  while (client.connected()) {
-    if (client.available()) {
-      char c = client.read();
-      if (c == '\r') continue;   // ignore carriage return
-      if (c == '\n') break;      // end of first line
-      requestLine += c;
+  HEAP_SCOPE("request");   // HEAPMON_TRACE builds: allocations below are charged here
+  RLOG_D("New Client connected");
+
+  // First line (e.g. "GET /LED=ON HTTP/1.1"), then the headers up to
+  // the blank line. Reading them all lets the close be a clean FIN
+  // instead of a reset over unread data; only If-None-Match and
+  // whether the browser wants a page (Accept: text/html) are used.
+  // One deadline for the whole request, not per line.
+  char requestLine[96];
+  char header[128];
+  uint32_t startMs = millis();
+  if (!readLine(client, requestLine, sizeof(requestLine), startMs)) {
+    client.stop();   // no complete request line: nothing to answer
+    RLOG_D("Client dropped");
+    return;
+  }
+  RLOG_I("%s", requestLine);  // copied into the ring, printed later
+
+  const char* path = strchr(requestLine, ' ');
+  path = path ? path + 1 : "";
+  const WebAsset* page = webAssetFind(WEB_ASSETS, path);
+  bool fresh = false;
+  bool navigation = false;
+
+  while (readLine(client, header, sizeof(header), startMs) && header[0]) {
+    if (strncasecmp(header, "If-None-Match:", 14) == 0) {
+      fresh = page && webAssetFresh(*page, header + 14);
+    } else if (strncasecmp(header, "Accept:", 7) == 0) {
+      navigation = strstr(header, "text/html") != nullptr;
     }
   }
-  Serial.println(requestLine);
 
   // ----- LED CONTROL -----
-  if (requestLine.indexOf("GET /LED=ON") != -1) {
-    digitalWrite(LED_PIN, HIGH);
-  } else if (requestLine.indexOf("GET /LED=OFF") != -1) {
-    digitalWrite(LED_PIN, LOW);
+  if (strncmp(path, "/LED=ON", 7) == 0) {
+    led.high();
+    ledOn = true;
+    sendState(client, navigation);
+  } else if (strncmp(path, "/LED=OFF", 8) == 0) {
+    led.low();
+    ledOn = false;
+    sendState(client, navigation);
+  } else if (strncmp(path, "/state", 6) == 0) {
+    sendState(client, navigation);
+  } else if (strncmp(path, "/heap", 5) == 0) {
+    sendHeap(client);
+  } else if (page) {
+    // ----- PAGE: gzip from flash, or 304 if the browser has it -----
+    char head[256];
+    size_t n = webAssetHead(head, sizeof(head), *page, fresh);
+    client.write((const uint8_t*)head, n);
+    if (!fresh) client.write(page->gz, page->size);
+  } else {
+    static const char notFound[] =
+      "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    client.write((const uint8_t*)notFound, sizeof(notFound) - 1);
   }
 
-  // ----- RESPONSE PAGE -----
-  String htmlPage =
-    "<!DOCTYPE html><html>"
-    "<head><meta charset='UTF-8'><title>ESP32 LED Control</title></head>"
-    "<body>"
-    "<h1>ESP32 LED Control</h1>"
-    "<p><a href=\"/LED=ON\"><button>LED ON</button></a></p>"
-    "<p><a href=\"/LED=OFF\"><button>LED OFF</button></a></p>"
-    "</body></html>";
-
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  client.println(htmlPage);
-
   delay(1);
   client.stop();
-  Serial.println("Client disconnected");
-}
\ No newline at end of file
+  RLOG_D("Client disconnected");
+}
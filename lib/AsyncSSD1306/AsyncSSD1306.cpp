@@ -0,0 +1,135 @@
+#ifdef ESP32
+
+#include "AsyncSSD1306.h"
+
+// SSD1306 control bytes
+#define CONTROL_COMMAND  0x00
+#define CONTROL_DATA     0x40
+
+// Bytes per I2C transaction, including the control byte
+#ifdef I2C_BUFFER_LENGTH
+#define PUSH_CHUNK I2C_BUFFER_LENGTH
+#else
+#define PUSH_CHUNK 32
+#endif
+
+AsyncSSD1306::AsyncSSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst, uint32_t busHz)
+  // Adafruit switches to clkDuring for its own transfers (init commands)
+  : Adafruit_SSD1306(w, h, twi, rst, busHz, busHz),
+    _addr(0x3C), _busHz(busHz), _frameBytes(w * ((h + 7) / 8)),
+    _pending(nullptr), _front(nullptr), _pendingValid(false), _pushing(false),
+    _lock(nullptr), _task(nullptr),
+    _frames(0), _dropped(0), _i2cErrors(0), _lastPushUs(0), _maxPushUs(0), _sumPushUs(0) {
+}
+
+bool AsyncSSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, int core, UBaseType_t priority) {
+  if (!Adafruit_SSD1306::begin(switchvcc, i2caddr)) return false;
+
+  _addr = i2caddr;
+  _pending = (uint8_t*)calloc(1, _frameBytes);
+  _front   = (uint8_t*)calloc(1, _frameBytes);
+  _lock    = xSemaphoreCreateMutex();
+  if (!_pending || !_front || !_lock) return false;
+
+  setBusClock(_busHz);
+  return xTaskCreatePinnedToCore(pushTaskEntry, "oled_push", 3072, this,
+                                 priority, &_task, core) == pdPASS;
+}
+
+void AsyncSSD1306::display() {
+  if (!_task) {
+    Adafruit_SSD1306::display();  // begin() failed or not called yet
+    return;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (_pendingValid) _dropped++;
+  memcpy(_pending, getBuffer(), _frameBytes);
+  _pendingValid = true;
+  xSemaphoreGive(_lock);
+
+  xTaskNotifyGive(_task);
+}
+
+void AsyncSSD1306::waitIdle() {
+  while (_pendingValid || _pushing) vTaskDelay(1);
+}
+
+void AsyncSSD1306::setBusClock(uint32_t hz) {
+  _busHz = hz;
+  wire->setClock(hz);
+}
+
+AsyncSSD1306Stats AsyncSSD1306::stats() {
+  AsyncSSD1306Stats s;
+  s.frames     = _frames;
+  s.dropped    = _dropped;
+  s.i2cErrors  = _i2cErrors;
+  s.lastPushUs = _lastPushUs;
+  s.maxPushUs  = _maxPushUs;
+  s.avgPushUs  = _frames ? (uint32_t)(_sumPushUs / _frames) : 0;
+  s.busHz      = _busHz;
+  return s;
+}
+
+void AsyncSSD1306::pushTaskEntry(void* self) {
+  ((AsyncSSD1306*)self)->pushLoop();
+}
+
+void AsyncSSD1306::pushLoop() {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!_pendingValid) {
+      xSemaphoreGive(_lock);
+      continue;
+    }
+    uint8_t* frame = _pending;
+    _pending = _front;
+    _front = frame;
+    _pendingValid = false;
+    _pushing = true;
+    xSemaphoreGive(_lock);
+
+    uint32_t start = micros();
+    if (!pushFrame(_front)) _i2cErrors++;
+    uint32_t took = micros() - start;
+
+    _lastPushUs = took;
+    _sumPushUs += took;
+    if (took > _maxPushUs) _maxPushUs = took;
+    _frames++;
+    _pushing = false;
+  }
+}
+
+// Full-screen write in horizontal addressing mode
+bool AsyncSSD1306::pushFrame(const uint8_t* frame) {
+  bool ok = true;
+
+  wire->beginTransmission(_addr);
+  wire->write(CONTROL_COMMAND);
+  wire->write(SSD1306_PAGEADDR);
+  wire->write(0);
+  wire->write(0xFF);
+  wire->write(SSD1306_COLUMNADDR);
+  wire->write(0);
+  wire->write(WIDTH - 1);
+  ok &= wire->endTransmission() == 0;
+
+  uint16_t sent = 0;
+  while (sent < _frameBytes) {
+    uint16_t n = _frameBytes - sent;
+    if (n > PUSH_CHUNK - 1) n = PUSH_CHUNK - 1;
+
+    wire->beginTransmission(_addr);
+    wire->write(CONTROL_DATA);
+    wire->write(frame + sent, n);
+    ok &= wire->endTransmission() == 0;
+    sent += n;
+  }
+  return ok;
+}
+
+#endif  // ESP32
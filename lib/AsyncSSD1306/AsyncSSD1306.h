@@ -0,0 +1,106 @@
+/****************************************************
+ * AsyncSSD1306
+ * Drop-in Adafruit_SSD1306 whose display() doesn't wait
+ * for the I2C bus.
+ *
+ *  - you draw into the normal Adafruit buffer
+ *  - display() copies it into a pending frame (~1 KB memcpy)
+ *    and wakes a push task, then returns
+ *  - the push task swaps pending <-> front and streams the
+ *    front frame while you draw the next one
+ *  - if a new frame arrives before the pending one was
+ *    pushed, the old one is dropped and counted
+ *
+ * Only the push task touches the bus after begin(). Call
+ * waitIdle() before using invertDisplay(), dim(), scrolling
+ * or anything else that sends commands directly.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+struct AsyncSSD1306Stats {
+  uint32_t frames;       // frames pushed to the panel
+  uint32_t dropped;      // frames replaced before they were pushed
+  uint32_t i2cErrors;
+  uint32_t lastPushUs;
+  uint32_t maxPushUs;
+  uint32_t avgPushUs;
+  uint32_t busHz;
+};
+
+#ifndef ESP32
+// Host build (SSD1306 emulator): same API, display() is synchronous
+class AsyncSSD1306 : public Adafruit_SSD1306 {
+public:
+  AsyncSSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst = -1,
+               uint32_t busHz = 400000UL)
+    : Adafruit_SSD1306(w, h, twi, rst, busHz, busHz), _busHz(busHz) {}
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0x3C,
+             int core = 0, unsigned priority = 1) {
+    return Adafruit_SSD1306::begin(switchvcc, i2caddr);
+  }
+  void waitIdle() {}
+  void setBusClock(uint32_t hz) { _busHz = hz; wire->setClock(hz); }
+  AsyncSSD1306Stats stats() {
+    AsyncSSD1306Stats s = {};
+    s.busHz = _busHz;
+    return s;
+  }
+
+private:
+  uint32_t _busHz;
+};
+#else
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+class AsyncSSD1306 : public Adafruit_SSD1306 {
+public:
+  // busHz: 100000 (standard), 400000 (fast) or up to 1000000 (fast mode plus)
+  AsyncSSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst = -1,
+               uint32_t busHz = 400000UL);
+
+  // Same as Adafruit begin(), plus the two frame buffers and the push task.
+  // The task is pinned to `core` (default: the one not running loop()).
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0x3C,
+             int core = 0, UBaseType_t priority = 1);
+
+  // Hands the current drawing to the push task, never waits for I2C
+  void display();
+
+  // Blocks until nothing is pending or being pushed
+  void waitIdle();
+
+  void setBusClock(uint32_t hz);
+  AsyncSSD1306Stats stats();
+
+private:
+  static void pushTaskEntry(void* self);
+  void        pushLoop();
+  bool        pushFrame(const uint8_t* frame);
+
+  uint8_t           _addr;
+  uint32_t          _busHz;
+  uint16_t          _frameBytes;
+  uint8_t*          _pending;
+  uint8_t*          _front;
+  volatile bool     _pendingValid;
+  volatile bool     _pushing;
+  SemaphoreHandle_t _lock;
+  TaskHandle_t      _task;
+
+  uint32_t          _frames;
+  uint32_t          _dropped;
+  uint32_t          _i2cErrors;
+  uint32_t          _lastPushUs;
+  uint32_t          _maxPushUs;
+  uint64_t          _sumPushUs;
+};
+
+#endif  // ESP32
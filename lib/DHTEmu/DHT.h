@@ -0,0 +1,51 @@
+/****************************************************
+ * DHT (emulator)
+ * Adafruit DHT sensor library API for the `native` env.
+ *
+ *  - readings follow a slow day-like curve (or the value
+ *    set with dhtEmuSet()), rounded to what the part
+ *    resolves: 1 C / 1 % for the DHT11, 0.1 for the others
+ *  - like the real library, a bus read happens at most
+ *    every 2 s, calls in between return the cached result
+ *  - a bus read costs what the real one blocks for: the
+ *    start pulse (20 ms DHT11, 1.1 ms others) plus ~4.5 ms
+ *    of bits, on the fake clock; 5 bytes are counted in
+ *    nativeStats().oneWireBytes
+ *  - DHT_EMU_FAIL_EVERY=N in the environment makes every
+ *    Nth bus read fail (NaN), like a loose wire
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#define DHT11  11
+#define DHT12  12
+#define DHT21  21
+#define DHT22  22
+#define AM2301 21
+
+class DHT {
+public:
+  DHT(uint8_t pin, uint8_t type, uint8_t count = 6);
+
+  void  begin(uint8_t usec = 55);
+  bool  read(bool force = false);
+  float readTemperature(bool fahrenheit = false, bool force = false);
+  float readHumidity(bool force = false);
+
+  float convertCtoF(float c) { return c * 1.8f + 32; }
+  float convertFtoC(float f) { return (f - 32) * 0.55555f; }
+  float computeHeatIndex(float temperature, float humidity, bool fahrenheit = true);
+
+private:
+  uint8_t  _pin;
+  uint8_t  _type;
+  uint32_t _lastReadMs;
+  bool     _lastResult;
+  float    _temp;
+  float    _hum;
+};
+
+// Fixed readings instead of the curve (NaN for either = failed read)
+void dhtEmuSet(float tempC, float humPct);
+void dhtEmuClear();
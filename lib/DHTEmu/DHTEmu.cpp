@@ -0,0 +1,101 @@
+#include "DHT.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define DHT_MIN_INTERVAL_MS  2000
+#define DHT_BITS_US          4500   // response + 40 bits
+
+static bool     s_fixed = false;
+static float    s_fixedTemp;
+static float    s_fixedHum;
+static uint32_t s_busReads = 0;
+
+void dhtEmuSet(float tempC, float humPct) {
+  s_fixed = true;
+  s_fixedTemp = tempC;
+  s_fixedHum = humPct;
+}
+
+void dhtEmuClear() {
+  s_fixed = false;
+}
+
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count)
+  : _pin(pin), _type(type), _lastReadMs(0), _lastResult(false), _temp(NAN), _hum(NAN) {}
+
+void DHT::begin(uint8_t usec) {
+  pinMode(_pin, INPUT_PULLUP);
+  _lastReadMs = millis() - DHT_MIN_INTERVAL_MS;  // first read goes to the bus
+}
+
+bool DHT::read(bool force) {
+  uint32_t now = millis();
+  if (!force && now - _lastReadMs < DHT_MIN_INTERVAL_MS) return _lastResult;
+  _lastReadMs = now;
+
+  // What the real read blocks for
+  if (_type == DHT11) delay(20);
+  else                delayMicroseconds(1100);
+  delayMicroseconds(DHT_BITS_US);
+  nativeStats().oneWireBytes += 5;
+
+  static long failEvery = -1;
+  if (failEvery < 0) {
+    const char* env = getenv("DHT_EMU_FAIL_EVERY");
+    failEvery = env ? atol(env) : 0;
+  }
+  s_busReads++;
+
+  float t, h;
+  if (failEvery > 0 && s_busReads % failEvery == 0) {
+    t = h = NAN;
+  } else if (s_fixed) {
+    t = s_fixedTemp;
+    h = s_fixedHum;
+  } else {
+    // One "day" per hour of fake time, so a bench run sees values move
+    float phase = (float)(now % 3600000UL) / 3600000.0f * 2.0f * (float)PI;
+    t = 23.0f + 3.0f * sinf(phase);
+    h = 50.0f - 8.0f * sinf(phase);
+  }
+
+  float step = _type == DHT11 ? 1.0f : 0.1f;
+  _temp = roundf(t / step) * step;
+  _hum = roundf(h / step) * step;
+  _lastResult = !isnan(_temp) && !isnan(_hum);
+  return _lastResult;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+  if (!read(force)) return NAN;
+  return fahrenheit ? convertCtoF(_temp) : _temp;
+}
+
+float DHT::readHumidity(bool force) {
+  if (!read(force)) return NAN;
+  return _hum;
+}
+
+// Rothfusz regression with Steadman below 80 F, as in the Adafruit library
+float DHT::computeHeatIndex(float temperature, float humidity, bool fahrenheit) {
+  if (!fahrenheit) temperature = convertCtoF(temperature);
+
+  float hi = 0.5f * (temperature + 61.0f + ((temperature - 68.0f) * 1.2f) + (humidity * 0.094f));
+  if (hi > 79) {
+    hi = -42.379f + 2.04901523f * temperature + 10.14333127f * humidity +
+         -0.22475541f * temperature * humidity +
+         -0.00683783f * temperature * temperature +
+         -0.05481717f * humidity * humidity +
+         0.00122874f * temperature * temperature * humidity +
+         0.00085282f * temperature * humidity * humidity +
+         -0.00000199f * temperature * temperature * humidity * humidity;
+
+    if (humidity < 13 && temperature >= 80.0f && temperature <= 112.0f)
+      hi -= ((13.0f - humidity) * 0.25f) * sqrtf((17.0f - fabsf(temperature - 95.0f)) * 0.05882f);
+    else if (humidity > 85.0f && temperature >= 80.0f && temperature <= 87.0f)
+      hi += ((humidity - 85.0f) * 0.1f) * ((87.0f - temperature) * 0.2f);
+  }
+
+  return fahrenheit ? hi : convertFtoC(hi);
+}
@@ -0,0 +1,94 @@
+/****************************************************
+ * FastPin
+ * GPIO access with the pin fixed at compile time.
+ *
+ *   FastPin<2> led;
+ *   led.mode(OUTPUT);      // once, same as pinMode()
+ *   led.toggle();          // ISR-safe, no function call
+ *
+ * On the ESP32 high()/low() are one store to GPIO_OUT_W1TS /
+ * GPIO_OUT_W1TC (or the OUT1 pair for 32/33), read() is one
+ * load of GPIO_IN(1), toggle() is a load plus a store.
+ * digitalWrite() instead goes through a non-inlined call,
+ * pin-table lookups and the IO-MUX checks each time.
+ *
+ * Pins that don't exist or belong to the SPI flash (6-11)
+ * fail to compile, and so do writes to the input-only pins
+ * 34-39. Pin mode/pull-ups still come from pinMode().
+ *
+ * Everything is static and inline, so ISRs may use it.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <soc/gpio_reg.h>
+#endif
+
+template <uint8_t N>
+class FastPin {
+  static constexpr bool exists() {
+    return N <= 39 && !(N >= 6 && N <= 11) && N != 20 && N != 24 && !(N >= 28 && N <= 31);
+  }
+  static constexpr bool canOutput() { return N <= 33; }
+
+  static_assert(exists(), "FastPin: no such GPIO on the ESP32 (or it is wired to the flash)");
+
+#ifdef ESP32
+  static constexpr uint32_t MASK = 1UL << (N & 31);
+  static constexpr uint32_t SET  = N < 32 ? GPIO_OUT_W1TS_REG : GPIO_OUT1_W1TS_REG;
+  static constexpr uint32_t CLR  = N < 32 ? GPIO_OUT_W1TC_REG : GPIO_OUT1_W1TC_REG;
+  static constexpr uint32_t OUT  = N < 32 ? GPIO_OUT_REG      : GPIO_OUT1_REG;
+  static constexpr uint32_t IN   = N < 32 ? GPIO_IN_REG       : GPIO_IN1_REG;
+
+  static inline volatile uint32_t& reg(uint32_t addr) { return *(volatile uint32_t*)addr; }
+#endif
+
+public:
+  static constexpr uint8_t pin = N;
+
+  static void mode(uint8_t m) { pinMode(N, m); }
+
+  __attribute__((always_inline)) static inline void high() {
+    static_assert(canOutput(), "FastPin: GPIO34-39 are input only");
+#ifdef ESP32
+    reg(SET) = MASK;
+#else
+    digitalWrite(N, HIGH);
+#endif
+  }
+
+  __attribute__((always_inline)) static inline void low() {
+    static_assert(canOutput(), "FastPin: GPIO34-39 are input only");
+#ifdef ESP32
+    reg(CLR) = MASK;
+#else
+    digitalWrite(N, LOW);
+#endif
+  }
+
+  __attribute__((always_inline)) static inline void write(bool v) {
+    if (v) high();
+    else   low();
+  }
+
+  // Flips the output latch (not the level read back from the pad)
+  __attribute__((always_inline)) static inline void toggle() {
+    static_assert(canOutput(), "FastPin: GPIO34-39 are input only");
+#ifdef ESP32
+    if (reg(OUT) & MASK) reg(CLR) = MASK;
+    else                 reg(SET) = MASK;
+#else
+    digitalWrite(N, !digitalRead(N));
+#endif
+  }
+
+  __attribute__((always_inline)) static inline bool read() {
+#ifdef ESP32
+    return (reg(IN) & MASK) != 0;
+#else
+    return digitalRead(N) != 0;
+#endif
+  }
+};
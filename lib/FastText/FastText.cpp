@@ -0,0 +1,105 @@
+#include "FastText.h"
+
+FastText::FastText(Adafruit_SSD1306& display)
+  : _display(display), _maxSize(0), _x(0), _y(0), _size(1),
+    _color(SSD1306_WHITE), _wrap(true) {
+  for (uint8_t i = 0; i < FASTTEXT_MAX_SIZE; i++) _cols[i] = nullptr;
+}
+
+FastText::~FastText() {
+  for (uint8_t i = 0; i < FASTTEXT_MAX_SIZE; i++) free(_cols[i]);
+}
+
+bool FastText::begin(uint8_t maxSize) {
+  if (maxSize > FASTTEXT_MAX_SIZE) maxSize = FASTTEXT_MAX_SIZE;
+
+  for (uint8_t s = 1; s <= maxSize; s++) {
+    uint8_t width = 5 * s;   // 6th column is spacing, never lit
+    uint16_t* cols = (uint16_t*)calloc(FASTTEXT_GLYPHS * width, sizeof(uint16_t));
+    if (!cols) return false;
+
+    // Let GFX draw the glyph, then read it back column by column
+    GFXcanvas1 canvas(6 * s, 8 * s);
+    for (uint8_t g = 0; g < FASTTEXT_GLYPHS; g++) {
+      canvas.fillScreen(0);
+      canvas.drawChar(0, 0, FASTTEXT_FIRST + g, 1, 1, s);
+
+      for (uint8_t x = 0; x < width; x++) {
+        uint16_t bits = 0;
+        for (uint8_t y = 0; y < 8 * s; y++) {
+          if (canvas.getPixel(x, y)) bits |= 1 << y;
+        }
+        cols[g * width + x] = bits;
+      }
+    }
+
+    free(_cols[s - 1]);
+    _cols[s - 1] = cols;
+  }
+
+  _maxSize = maxSize;
+  return true;
+}
+
+const uint16_t* FastText::glyph(uint8_t c, uint8_t size) const {
+  if (size == 0 || size > _maxSize || c < FASTTEXT_FIRST || c > FASTTEXT_LAST) return nullptr;
+  return _cols[size - 1] + (c - FASTTEXT_FIRST) * 5 * size;
+}
+
+void FastText::drawGlyph(int16_t x, int16_t y, uint8_t c, uint8_t size, uint16_t color) {
+  const uint16_t* cols = glyph(c, size);
+  if (!cols || _display.getRotation() != 0) {
+    // Not cached: stock path (transparent background, same as setTextColor(c))
+    _display.drawChar(x, y, c, color, color, size);
+    return;
+  }
+
+  int16_t w = _display.width();
+  int16_t h = _display.height();
+  uint8_t rows = 8 * size;
+  if (x >= w || y >= h || x + 5 * size <= 0 || y + rows <= 0) return;
+
+  uint8_t* buf = _display.getBuffer();
+  int16_t pages = (h + 7) / 8;
+
+  // A glyph column spans at most 3 pages once shifted to y's bit offset
+  int16_t firstPage = y >= 0 ? y / 8 : -((7 - y) / 8);
+  uint8_t shift = y & 7;
+
+  for (uint8_t i = 0; i < 5 * size; i++) {
+    int16_t cx = x + i;
+    if (cx < 0 || cx >= w) continue;
+
+    uint32_t bits = (uint32_t)cols[i] << shift;
+    for (int16_t p = 0; bits; p++, bits >>= 8) {
+      int16_t page = firstPage + p;
+      uint8_t b = bits & 0xFF;
+      if (!b || page < 0 || page >= pages) continue;
+
+      uint8_t& dst = buf[page * w + cx];
+      switch (color) {
+        case SSD1306_WHITE:   dst |= b;  break;
+        case SSD1306_BLACK:   dst &= ~b; break;
+        case SSD1306_INVERSE: dst ^= b;  break;
+      }
+    }
+  }
+
+  // Bottom rows that fall below the panel are cut by the page check
+}
+
+// Same cursor rules as Adafruit_GFX::write()
+size_t FastText::write(uint8_t c) {
+  if (c == '\n') {
+    _x = 0;
+    _y += _size * 8;
+  } else if (c != '\r') {
+    if (_wrap && (_x + _size * 6) > _display.width()) {
+      _x = 0;
+      _y += _size * 8;
+    }
+    drawGlyph(_x, _y, c, _size, _color);
+    _x += _size * 6;
+  }
+  return 1;
+}
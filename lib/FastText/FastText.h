@@ -0,0 +1,64 @@
+/****************************************************
+ * FastText
+ * Text renderer for SSD1306 status screens.
+ *
+ * begin() draws every printable ASCII glyph once through
+ * Adafruit GFX (so the pixels are exactly the stock font)
+ * and keeps each glyph as column bitmaps. Printing then
+ * ORs whole columns into the SSD1306 page buffer, 1-2
+ * byte writes per column instead of one drawPixel (size 1)
+ * or fillRect (size 2) per lit pixel.
+ *
+ * It is a Print, so it is used like the display itself:
+ *   text.setCursor(0, 16); text.setTextSize(2); text.print(t, 1);
+ *
+ * Cached sizes: 1..FASTTEXT_MAX_SIZE. Larger sizes and
+ * rotated displays fall back to the GFX path. Text is always
+ * transparent (there is no background color): clear the
+ * area with fillRect() first to overwrite old text.
+ *
+ * tools/bench/fasttext_bench.cpp compares chars/s with GFX.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+#define FASTTEXT_MAX_SIZE  2      // columns are 16 bits -> 2 x 8 rows
+#define FASTTEXT_FIRST     0x20
+#define FASTTEXT_LAST      0x7E
+#define FASTTEXT_GLYPHS    (FASTTEXT_LAST - FASTTEXT_FIRST + 1)
+
+class FastText : public Print {
+public:
+  explicit FastText(Adafruit_SSD1306& display);
+  ~FastText();
+
+  // Rasterizes sizes 1..maxSize, returns false if out of memory
+  bool begin(uint8_t maxSize = FASTTEXT_MAX_SIZE);
+
+  void setCursor(int16_t x, int16_t y) { _x = x; _y = y; }
+  void setTextSize(uint8_t s) { _size = s ? s : 1; }
+  void setTextColor(uint16_t c) { _color = c; }
+  void setTextWrap(bool w) { _wrap = w; }
+  int16_t getCursorX() const { return _x; }
+  int16_t getCursorY() const { return _y; }
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Draws one glyph at (x, y), top-left of its 6x8 (x size) cell
+  void drawGlyph(int16_t x, int16_t y, uint8_t c, uint8_t size, uint16_t color);
+
+private:
+  const uint16_t* glyph(uint8_t c, uint8_t size) const;
+
+  Adafruit_SSD1306& _display;
+  uint16_t* _cols[FASTTEXT_MAX_SIZE];   // per size: GLYPHS x (5 * size) columns
+  uint8_t   _maxSize;
+  int16_t   _x;
+  int16_t   _y;
+  uint8_t   _size;
+  uint16_t  _color;
+  bool      _wrap;
+};
@@ -0,0 +1,94 @@
+#include "FixedFmt.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const uint32_t s_pow10[FIXED_MAX_DECIMALS + 1] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000
+};
+
+// Copies s if it fits, else leaves buf empty
+static size_t put(char* buf, size_t size, const char* s, size_t len) {
+  if (len + 1 > size) {
+    if (size) buf[0] = 0;
+    return 0;
+  }
+  memcpy(buf, s, len + 1);
+  return len;
+}
+
+size_t fmtFixed(char* buf, size_t size, float v, uint8_t decimals, const char* err) {
+  if (decimals > FIXED_MAX_DECIMALS) decimals = FIXED_MAX_DECIMALS;
+
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  bool neg = bits >> 31;
+  int32_t exp = (bits >> 23) & 0xFF;
+  uint32_t mant = bits & 0x7FFFFF;
+
+  if (exp == 0xFF) {
+    if (err) return put(buf, size, err, strlen(err));
+    const char* s = mant ? (neg ? "-nan" : "nan") : (neg ? "-inf" : "inf");
+    return put(buf, size, s, strlen(s));
+  }
+
+  // v = mant * 2^exp exactly
+  if (exp == 0) {
+    exp = -149;  // subnormal
+  } else {
+    mant |= 0x800000;
+    exp -= 150;
+  }
+
+  // 10^decimals * v, rounded half to even. scaled < 2^44.
+  uint64_t scaled = (uint64_t)mant * s_pow10[decimals];
+  uint64_t q;
+  if (exp >= 0) {
+    if (exp > 19) {
+      // >= 2^43: not a sensor value, let the C library do it
+      char tmp[64];
+      int n = snprintf(tmp, sizeof(tmp), "%.*f", decimals, (double)v);
+      return put(buf, size, tmp, n);
+    }
+    q = scaled << exp;
+  } else if (-exp >= 64) {
+    q = 0;  // below 2^-64 * 2^44, nowhere near half a unit
+  } else {
+    uint32_t shift = -exp;
+    q = scaled >> shift;
+    uint64_t rest = scaled & ((1ULL << shift) - 1);
+    uint64_t half = 1ULL << (shift - 1);
+    if (rest > half || (rest == half && (q & 1))) q++;
+  }
+
+  // Digits backwards: the decimals, the point, then at least one integer digit
+  char tmp[FIXED_NUM_SIZE];
+  char* p = tmp + sizeof(tmp);
+  *--p = 0;
+
+  if (q <= UINT32_MAX) {
+    uint32_t q32 = (uint32_t)q;  // 32-bit division is a lot cheaper on the ESP32
+    for (uint8_t i = 0; i < decimals; i++) {
+      *--p = '0' + q32 % 10;
+      q32 /= 10;
+    }
+    if (decimals) *--p = '.';
+    do {
+      *--p = '0' + q32 % 10;
+      q32 /= 10;
+    } while (q32);
+  } else {
+    for (uint8_t i = 0; i < decimals; i++) {
+      *--p = '0' + q % 10;
+      q /= 10;
+    }
+    if (decimals) *--p = '.';
+    do {
+      *--p = '0' + q % 10;
+      q /= 10;
+    } while (q);
+  }
+  if (neg) *--p = '-';  // "-0.0" too, like printf
+
+  return put(buf, size, p, tmp + sizeof(tmp) - 1 - p);
+}
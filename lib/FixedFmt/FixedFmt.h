@@ -0,0 +1,54 @@
+/****************************************************
+ * FixedFmt
+ * Float to fixed-decimal text without printf, String or
+ * the Arduino Print float path.
+ *
+ *   char buf[FIXED_NUM_SIZE];
+ *   fmtFixed(buf, sizeof(buf), 23.25f, 1);   // "23.2"
+ *   display.print(FixedNum(t, 1));            // temporary on the stack
+ *   html += FixedNum(h, 1, "--");             // NaN shows as "--"
+ *
+ * The float is split into its 24-bit mantissa and binary
+ * exponent and scaled by 10^decimals in a 64-bit integer,
+ * so the result is the exact value rounded half to even:
+ * the same text snprintf("%.*f") gives. (Arduino's
+ * print(float, n) adds 0.5 in float and can be off by one
+ * in the last digit.) Sensor-sized values, up to 2^43,
+ * take the integer path. Bigger ones fall back to snprintf
+ * and still return the same text.
+ *
+ * NaN and infinity print as "nan"/"inf" like snprintf, or
+ * as the caller's error text when one is given: that is
+ * what the DHT read-failure NaN turns into.
+ *
+ * tools/libtest's test_fixedfmt checks the text against
+ * snprintf; tools/bench/fixedfmt_bench times it.
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FIXED_MAX_DECIMALS  6
+#define FIXED_NUM_SIZE      24    // sign, 19 digits, point, \0 on the integer path
+
+// Writes v with `decimals` digits after the point (clamped to
+// FIXED_MAX_DECIMALS). Returns the length; if it does not fit in size,
+// returns 0 and buf is "". err replaces "nan"/"inf" when not null.
+size_t fmtFixed(char* buf, size_t size, float v, uint8_t decimals, const char* err = nullptr);
+
+// Formats into its own buffer, for print()/String concatenation
+class FixedNum {
+public:
+  FixedNum(float v, uint8_t decimals, const char* err = nullptr) {
+    _len = (uint8_t)fmtFixed(_buf, sizeof(_buf), v, decimals, err);
+  }
+
+  operator const char*() const { return _buf; }
+  const char* c_str() const { return _buf; }
+  uint8_t length() const { return _len; }
+
+private:
+  char    _buf[FIXED_NUM_SIZE];
+  uint8_t _len;
+};
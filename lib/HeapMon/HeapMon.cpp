@@ -0,0 +1,361 @@
+#include "HeapMon.h"
+#include <RingLog.h>
+#include <StreamStats.h>
+
+#ifdef ESP32
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// The sampling task writes, loop() and the web server read
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+#define HM_LOCK()    portENTER_CRITICAL(&s_mux)
+#define HM_UNLOCK()  portEXIT_CRITICAL(&s_mux)
+#else
+#define HM_LOCK()
+#define HM_UNLOCK()
+#endif
+
+static HeapMonLimits s_limits;
+static HeapSample    s_last;
+static uint8_t       s_alerts = 0;
+static uint32_t      s_periodMs = 0;
+
+static HeapTaskStack s_tasks[HEAPMON_TASKS];
+static uint8_t       s_nTasks = 0;
+
+// Trend of the largest block: one StreamStats window per HeapWindow
+static StreamStats   s_largest(0.2f);
+static HeapWindow    s_open;                     // lows of the window being filled
+static HeapWindow    s_history[HEAPMON_HISTORY]; // closed windows, ring
+static uint8_t       s_historyNext = 0;
+static uint8_t       s_historyCount = 0;
+
+static void resetOpenWindow() {
+  s_open.endMs = 0;
+  s_open.minFree = UINT32_MAX;
+  s_open.minLargest = UINT32_MAX;
+  s_open.maxFragPct = 0;
+  s_open.largestPerHour = 0;
+}
+
+// ---- Sources ----
+
+static void readHeap(HeapSample& s) {
+#ifdef ESP32
+  s.freeBytes    = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  s.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  s.minFreeEver  = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+#else
+  // What operator new holds, out of a made-up heap that never fragments
+  static uint32_t lowest = HEAPMON_NATIVE_HEAP;
+  uint64_t live = nativeStats().liveBytes;
+  s.freeBytes = live < HEAPMON_NATIVE_HEAP ? HEAPMON_NATIVE_HEAP - (uint32_t)live : 0;
+  s.largestBlock = s.freeBytes;
+  if (s.freeBytes < lowest) lowest = s.freeBytes;
+  s.minFreeEver = lowest;
+#endif
+  s.fragPct = s.freeBytes ? 100 - (uint8_t)((uint64_t)s.largestBlock * 100 / s.freeBytes) : 0;
+}
+
+// Bytes of stack the task has never used, UINT32_MAX if it isn't running
+static uint32_t readStack(const char* name) {
+#ifdef ESP32
+  TaskHandle_t h = xTaskGetHandle(name);
+  return h ? uxTaskGetStackHighWaterMark(h) : UINT32_MAX;   // bytes on ESP-IDF
+#else
+  return UINT32_MAX;
+#endif
+}
+
+// ---- Sampling ----
+
+static uint8_t checkAlerts() {
+  uint8_t a = 0;
+  if (s_last.freeBytes < s_limits.minFree) a |= HEAP_ALERT_LOW;
+  if (s_last.fragPct > s_limits.maxFragPct) a |= HEAP_ALERT_FRAG;
+  if (s_historyCount) {
+    const HeapWindow& w = s_history[(s_historyNext + HEAPMON_HISTORY - 1) % HEAPMON_HISTORY];
+    if (w.largestPerHour < -(float)s_limits.shrinkPerHour) a |= HEAP_ALERT_SHRINK;
+  }
+  for (uint8_t i = 0; i < s_nTasks; i++) {
+    if (s_tasks[i].minFree < s_limits.minStack) a |= HEAP_ALERT_STACK;
+  }
+  return a;
+}
+
+void heapMonSample() {
+  HeapSample s;
+  readHeap(s);
+  s.ms = millis();
+
+  uint32_t stacks[HEAPMON_TASKS];
+  for (uint8_t i = 0; i < s_nTasks; i++) stacks[i] = readStack(s_tasks[i].name);
+
+  HM_LOCK();
+  s_last = s;
+  for (uint8_t i = 0; i < s_nTasks; i++) {
+    if (stacks[i] < s_tasks[i].minFree) s_tasks[i].minFree = stacks[i];
+  }
+
+  s_largest.add((float)s.largestBlock, s.ms);
+  if (s.freeBytes < s_open.minFree) s_open.minFree = s.freeBytes;
+  if (s.largestBlock < s_open.minLargest) s_open.minLargest = s.largestBlock;
+  if (s.fragPct > s_open.maxFragPct) s_open.maxFragPct = s.fragPct;
+
+  if (s.ms - s_largest.windowStartMs() >= HEAPMON_WINDOW_MS) {
+    WindowSummary w;
+    s_largest.close(w, s.ms);
+    s_open.endMs = s.ms;
+    s_open.largestPerHour = w.slopePerMin * 60;
+    s_history[s_historyNext] = s_open;
+    s_historyNext = (s_historyNext + 1) % HEAPMON_HISTORY;
+    if (s_historyCount < HEAPMON_HISTORY) s_historyCount++;
+    resetOpenWindow();
+  }
+
+  uint8_t before = s_alerts;
+  s_alerts = checkAlerts();
+  uint8_t raised = s_alerts & ~before;
+  uint8_t cleared = before & ~s_alerts;
+  HM_UNLOCK();
+
+  for (uint8_t bit = 1; bit <= HEAP_ALERT_STACK; bit <<= 1) {
+    if (raised & bit) {
+      RLOG_W("Heap alert %s: free %lu, largest %lu, frag %u%%, stack min %lu", heapAlertName(bit),
+             (unsigned long)s.freeBytes, (unsigned long)s.largestBlock, s.fragPct,
+             (unsigned long)heapMonStackMin());
+    }
+    if (cleared & bit) RLOG_I("Heap alert %s cleared", heapAlertName(bit));
+  }
+}
+
+#ifdef ESP32
+
+static void sampleTask(void* arg) {
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(s_periodMs));
+    heapMonSample();
+  }
+}
+
+bool heapMonBegin(uint32_t periodMs) {
+  if (s_periodMs) return false;
+  s_periodMs = periodMs;
+  resetOpenWindow();
+#if HEAPMON_TRACE
+  heapMonTraceBegin();
+#endif
+  heapMonSample();
+  return xTaskCreatePinnedToCore(sampleTask, "heapmon", 2560, nullptr, 1, nullptr, 0) == pdPASS;
+}
+
+#else
+
+static void sampleAfterLoop() {
+  static uint32_t last = 0;
+  if (millis() - last < s_periodMs) return;
+  last = millis();
+  heapMonSample();
+}
+
+bool heapMonBegin(uint32_t periodMs) {
+  if (s_periodMs) return false;
+  s_periodMs = periodMs;
+  resetOpenWindow();
+#if HEAPMON_TRACE
+  heapMonTraceBegin();
+#endif
+  heapMonSample();
+  return nativeOnLoop(sampleAfterLoop);
+}
+
+#endif
+
+bool heapMonWatchTask(const char* name) {
+  HM_LOCK();
+  bool ok = s_nTasks < HEAPMON_TASKS;
+  if (ok) s_tasks[s_nTasks++] = { name, UINT32_MAX };
+  HM_UNLOCK();
+  return ok;
+}
+
+void heapMonSetLimits(const HeapMonLimits& limits) {
+  HM_LOCK();
+  s_limits = limits;
+  HM_UNLOCK();
+}
+
+HeapSample heapMonLast() {
+  HM_LOCK();
+  HeapSample s = s_last;
+  HM_UNLOCK();
+  return s;
+}
+
+uint8_t heapMonAlerts() {
+  return __atomic_load_n(&s_alerts, __ATOMIC_RELAXED);
+}
+
+uint32_t heapMonStackMin() {
+  uint32_t m = UINT32_MAX;
+  HM_LOCK();
+  for (uint8_t i = 0; i < s_nTasks; i++) {
+    if (s_tasks[i].minFree < m) m = s_tasks[i].minFree;
+  }
+  HM_UNLOCK();
+  return m;
+}
+
+float heapMonTrend() {
+  WindowSummary w;
+  HM_LOCK();
+  s_largest.summary(w, millis());
+  HM_UNLOCK();
+  return w.slopePerMin * 60;
+}
+
+const char* heapAlertName(uint8_t bit) {
+  switch (bit) {
+    case HEAP_ALERT_LOW:    return "low";
+    case HEAP_ALERT_FRAG:   return "fragmented";
+    case HEAP_ALERT_SHRINK: return "shrinking";
+    case HEAP_ALERT_STACK:  return "stack";
+  }
+  return "?";
+}
+
+// ---- Output ----
+// Each printf stays under 64 characters: longer ones make the ESP32
+// core's Print::printf malloc a buffer, not what a heap report should do.
+
+// Everything in one copy, so a report belongs to one instant
+struct HeapSnapshot {
+  HeapSample    last;
+  uint8_t       alerts;
+  float         trend;
+  uint16_t      trendSamples;
+  uint8_t       nTasks;
+  HeapTaskStack tasks[HEAPMON_TASKS];
+  uint8_t       nHistory;
+  HeapWindow    history[HEAPMON_HISTORY];   // oldest first
+  uint8_t       nSites;
+  HeapSite      sites[HEAPMON_SITES];
+  uint32_t      untracked;
+};
+
+static HeapSnapshot s_snap;   // one report at a time, from loop()
+
+static const HeapSnapshot& snapshot() {
+  HeapSnapshot& n = s_snap;
+  WindowSummary w;
+  HM_LOCK();
+  n.last = s_last;
+  n.alerts = s_alerts;
+  s_largest.summary(w, millis());
+  n.nTasks = s_nTasks;
+  memcpy(n.tasks, s_tasks, sizeof(HeapTaskStack) * s_nTasks);
+  n.nHistory = s_historyCount;
+  for (uint8_t i = 0; i < s_historyCount; i++) {
+    n.history[i] = s_history[(s_historyNext + HEAPMON_HISTORY - s_historyCount + i) % HEAPMON_HISTORY];
+  }
+  HM_UNLOCK();
+  n.trend = w.slopePerMin * 60;
+  n.trendSamples = w.count;
+  n.nSites = heapMonSites(n.sites);   // its own lock
+  n.untracked = heapMonUntracked();
+  return n;
+}
+
+void heapMonPrint(Print& out) {
+  const HeapSnapshot& n = snapshot();
+  uint32_t now = millis();
+
+  out.printf("heap free %lu, largest %lu, ", (unsigned long)n.last.freeBytes,
+             (unsigned long)n.last.largestBlock);
+  out.printf("min ever %lu, frag %u%%\n", (unsigned long)n.last.minFreeEver, n.last.fragPct);
+  out.printf("largest block trend %ld B/h (%u samples)\n", (long)n.trend, n.trendSamples);
+  out.print("alerts:");
+  if (!n.alerts) out.print(" none");
+  for (uint8_t bit = 1; bit <= HEAP_ALERT_STACK; bit <<= 1) {
+    if (n.alerts & bit) {
+      out.print(' ');
+      out.print(heapAlertName(bit));
+    }
+  }
+  out.println();
+
+  if (n.nHistory) {
+    out.printf("%8s %9s %11s %5s %9s\n", "ended", "min free", "min largest", "frag", "trend B/h");
+    for (uint8_t i = 0; i < n.nHistory; i++) {
+      const HeapWindow& w = n.history[i];
+      out.printf("%6lum %9lu %11lu %4u%% %9ld\n", (unsigned long)((now - w.endMs) / 60000),
+                 (unsigned long)w.minFree, (unsigned long)w.minLargest, w.maxFragPct,
+                 (long)w.largestPerHour);
+    }
+  }
+
+  for (uint8_t i = 0; i < n.nTasks; i++) {
+    if (n.tasks[i].minFree == UINT32_MAX) out.printf("stack %-16s not running\n", n.tasks[i].name);
+    else out.printf("stack %-16s %6lu free\n", n.tasks[i].name, (unsigned long)n.tasks[i].minFree);
+  }
+
+  if (n.nSites) {
+    out.printf("%-14s %8s %9s %6s %9s %6s\n", "site", "allocs", "bytes", "failed", "live B", "blocks");
+    for (uint8_t i = 0; i < n.nSites; i++) {
+      const HeapSite& s = n.sites[i];
+      out.printf("%-14s %8lu %9lu %6lu", s.name, (unsigned long)s.allocs,
+                 (unsigned long)s.bytes, (unsigned long)s.failed);
+      out.printf(" %9ld %6lu\n", (long)s.liveBytes, (unsigned long)s.liveBlocks);
+    }
+    if (n.untracked) out.printf("(%lu blocks not tracked, raise HEAPMON_TRACKED)\n", (unsigned long)n.untracked);
+  }
+}
+
+void heapMonJson(Print& out) {
+  const HeapSnapshot& n = snapshot();
+  uint32_t now = millis();
+
+  out.printf("{\"free\":%lu,\"largest\":%lu,", (unsigned long)n.last.freeBytes,
+             (unsigned long)n.last.largestBlock);
+  out.printf("\"minEver\":%lu,\"frag\":%u,", (unsigned long)n.last.minFreeEver, n.last.fragPct);
+  out.printf("\"trendPerHour\":%ld,", (long)n.trend);
+
+  out.print("\"alerts\":[");
+  bool first = true;
+  for (uint8_t bit = 1; bit <= HEAP_ALERT_STACK; bit <<= 1) {
+    if (!(n.alerts & bit)) continue;
+    out.printf("%s\"%s\"", first ? "" : ",", heapAlertName(bit));
+    first = false;
+  }
+
+  out.print("],\"tasks\":[");
+  for (uint8_t i = 0; i < n.nTasks; i++) {
+    out.printf("%s{\"name\":\"%s\",\"stackFree\":", i ? "," : "", n.tasks[i].name);
+    if (n.tasks[i].minFree == UINT32_MAX) out.print("null}");
+    else out.printf("%lu}", (unsigned long)n.tasks[i].minFree);
+  }
+
+  out.print("],\"history\":[");
+  for (uint8_t i = 0; i < n.nHistory; i++) {
+    const HeapWindow& w = n.history[i];
+    out.printf("%s{\"agoMin\":%lu,\"minFree\":%lu,", i ? "," : "",
+               (unsigned long)((now - w.endMs) / 60000), (unsigned long)w.minFree);
+    out.printf("\"minLargest\":%lu,\"maxFrag\":%u,", (unsigned long)w.minLargest, w.maxFragPct);
+    out.printf("\"trendPerHour\":%ld}", (long)w.largestPerHour);
+  }
+  out.print(']');
+
+  if (n.nSites) {
+    out.print(",\"sites\":[");
+    for (uint8_t i = 0; i < n.nSites; i++) {
+      const HeapSite& s = n.sites[i];
+      out.printf("%s{\"name\":\"%s\",", i ? "," : "", s.name);
+      out.printf("\"allocs\":%lu,\"bytes\":%lu,\"failed\":%lu,", (unsigned long)s.allocs,
+                 (unsigned long)s.bytes, (unsigned long)s.failed);
+      out.printf("\"live\":%ld,\"blocks\":%lu}", (long)s.liveBytes, (unsigned long)s.liveBlocks);
+    }
+    out.printf("],\"untracked\":%lu", (unsigned long)n.untracked);
+  }
+  out.print('}');
+}
@@ -0,0 +1,166 @@
+/****************************************************
+ * HeapMon
+ * Heap and stack watermarks for nodes that run for weeks.
+ *
+ *   heapMonWatchTask("loopTask");         // and other tasks by name
+ *   heapMonBegin();                       // in setup(), samples every 10 s
+ *   heapMonPrint(Serial);                 // report
+ *   heapMonJson(out);                     // the same for HTTP
+ *
+ * A low-priority task samples the 8-bit heap (heap_caps:
+ * free bytes, largest free block, lowest free since boot)
+ * and the stack high-water mark of each watched task.
+ * Fragmentation is 100 - largest * 100 / free: the share
+ * of free memory that can't be had in one piece.
+ *
+ * The largest block goes through a StreamStats window
+ * (HEAPMON_WINDOW_MS); each closed window keeps its lows
+ * and least-squares trend in a history of HEAPMON_HISTORY.
+ * A largest block that keeps shrinking while free stays
+ * flat is fragmentation, and shows up hours before a
+ * malloc fails.
+ *
+ * Alerts are bits, logged through RingLog as they appear
+ * and clear:
+ *   HEAP_ALERT_LOW     free below limits.minFree
+ *   HEAP_ALERT_FRAG    fragmentation above limits.maxFragPct
+ *   HEAP_ALERT_SHRINK  last window's largest-block trend
+ *                      below -limits.shrinkPerHour
+ *   HEAP_ALERT_STACK   a watched task within limits.minStack
+ *                      bytes of the end of its stack
+ *
+ * Built with -D HEAPMON_TRACE=1, allocations are also
+ * charged to the innermost HEAP_SCOPE() of the task that
+ * made them (like LoopProf's PROF_SCOPE): count, bytes,
+ * failures, and bytes still live. On the ESP32 this needs
+ * malloc wrapped at link time (see the -heap env in
+ * DHT11_Web_Server), on the PC operator new is hooked.
+ * Otherwise HEAP_SCOPE is empty.
+ *
+ * On the PC (native env) the heap is HEAPMON_NATIVE_HEAP
+ * bytes minus what operator new holds, never fragmented,
+ * and there are no task stacks.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef HEAPMON_TRACE
+#define HEAPMON_TRACE 0
+#endif
+
+#ifndef HEAPMON_WINDOW_MS
+#define HEAPMON_WINDOW_MS   3600000UL   // trend window, 1 h
+#endif
+#define HEAPMON_HISTORY     24          // closed windows kept
+#define HEAPMON_TASKS       8
+#define HEAPMON_SITES       16          // HEAP_SCOPE names, HEAPMON_TRACE only
+#define HEAPMON_TRACKED     256         // live blocks remembered, HEAPMON_TRACE only
+#define HEAPMON_NATIVE_HEAP 200000
+
+enum HeapAlert : uint8_t {
+  HEAP_ALERT_LOW    = 0x01,
+  HEAP_ALERT_FRAG   = 0x02,
+  HEAP_ALERT_SHRINK = 0x04,
+  HEAP_ALERT_STACK  = 0x08,
+};
+
+struct HeapMonLimits {
+  uint32_t minFree       = 20000;
+  uint8_t  maxFragPct    = 60;
+  uint32_t shrinkPerHour = 4096;   // largest block, bytes
+  uint32_t minStack      = 512;
+};
+
+struct HeapSample {
+  uint32_t ms;
+  uint32_t freeBytes;
+  uint32_t largestBlock;
+  uint32_t minFreeEver;   // lowest free since boot, from the allocator
+  uint8_t  fragPct;
+};
+
+struct HeapWindow {
+  uint32_t endMs;
+  uint32_t minFree;
+  uint32_t minLargest;
+  uint8_t  maxFragPct;
+  float    largestPerHour;   // least-squares trend, bytes/h
+};
+
+struct HeapTaskStack {
+  const char* name;
+  uint32_t    minFree;   // bytes of stack never touched; UINT32_MAX until found
+};
+
+// Starts the sampling task (on the PC: sampled after loop()).
+// Takes one sample right away.
+bool heapMonBegin(uint32_t periodMs = 10000);
+
+// Tasks are looked up by name on each sample, so one that
+// starts later, or ends, is fine. False when the table is full.
+bool heapMonWatchTask(const char* name);
+
+void heapMonSetLimits(const HeapMonLimits& limits);
+
+// One sample now; the task calls this, so only call it without heapMonBegin()
+void heapMonSample();
+
+HeapSample heapMonLast();
+uint8_t    heapMonAlerts();
+uint32_t   heapMonStackMin();   // lowest over the watched tasks, UINT32_MAX if none
+float      heapMonTrend();      // largest block, bytes/h, current window so far
+
+// Human-readable table / one JSON object with everything
+void heapMonPrint(Print& out);
+void heapMonJson(Print& out);
+
+const char* heapAlertName(uint8_t bit);
+
+// ---- Allocation sites (HEAPMON_TRACE) ----
+
+struct HeapSite {
+  const char* name;
+  uint32_t    allocs;
+  uint32_t    bytes;       // total requested
+  uint32_t    failed;
+  int32_t     liveBytes;   // of the blocks still tracked
+  uint32_t    liveBlocks;
+};
+
+#if HEAPMON_TRACE
+
+int8_t heapMonSiteRegister(const char* name);
+
+class HeapMonScope {
+public:
+  explicit HeapMonScope(int8_t id);
+  ~HeapMonScope();
+
+private:
+  int8_t _prev;
+};
+
+// Copy of the site table, site 0 is "(other)". out holds HEAPMON_SITES.
+uint8_t heapMonSites(HeapSite* out);
+uint32_t heapMonUntracked();   // blocks that did not fit HEAPMON_TRACKED
+
+// Called by the allocator hooks
+void heapMonTraceAlloc(void* p, size_t size);
+void heapMonTraceFree(void* p);
+void heapMonTraceBegin();
+
+#define HEAPMON_CAT2(a, b)  a##b
+#define HEAPMON_CAT(a, b)   HEAPMON_CAT2(a, b)
+
+#define HEAP_SCOPE(name) \
+  static const int8_t HEAPMON_CAT(_heapSite, __LINE__) = heapMonSiteRegister(name); \
+  HeapMonScope HEAPMON_CAT(_heapScope, __LINE__)(HEAPMON_CAT(_heapSite, __LINE__))
+
+#else
+
+#define HEAP_SCOPE(name)  ((void)0)
+inline uint8_t heapMonSites(HeapSite*) { return 0; }
+inline uint32_t heapMonUntracked() { return 0; }
+
+#endif
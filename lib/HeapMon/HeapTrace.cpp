@@ -0,0 +1,222 @@
+// Allocation sites for HeapMon (HEAPMON_TRACE builds)
+#include "HeapMon.h"
+
+#if HEAPMON_TRACE
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+
+// Taken inside malloc/free from any task, never from an ISR
+static portMUX_TYPE s_traceMux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK()    portENTER_CRITICAL(&s_traceMux)
+#define TRACE_UNLOCK()  portEXIT_CRITICAL(&s_traceMux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+static_assert((HEAPMON_TRACKED & (HEAPMON_TRACKED - 1)) == 0, "HEAPMON_TRACKED: power of two");
+
+static HeapSite s_sites[HEAPMON_SITES] = { { "(other)", 0, 0, 0, 0, 0 } };
+static uint8_t  s_nSites = 1;
+
+// Live blocks, so a free is charged to the site that allocated.
+// Open addressing, linear probing, backward-shift delete. One slot
+// always stays empty: every probe and shift ends at an empty slot.
+struct Tracked {
+  void*    p;
+  uint32_t size;
+  int8_t   site;
+};
+
+static Tracked  s_tracked[HEAPMON_TRACKED];
+static uint32_t s_nTracked = 0;
+static uint32_t s_untracked = 0;
+static bool     s_on = false;
+
+// Innermost HEAP_SCOPE of the running task (0: none). Each FreeRTOS
+// task has its own copy; only read once s_on, when TLS is set up.
+static __thread int8_t t_site = 0;
+
+static inline uint32_t home(void* p) {
+  return ((uint32_t)((uintptr_t)p >> 3) * 2654435761u) & (HEAPMON_TRACKED - 1);
+}
+
+int8_t heapMonSiteRegister(const char* name) {
+  TRACE_LOCK();
+  int8_t id = 0;   // "(other)" once the table is full
+  if (s_nSites < HEAPMON_SITES) {
+    id = s_nSites++;
+    s_sites[id] = { name, 0, 0, 0, 0, 0 };
+  }
+  TRACE_UNLOCK();
+  return id;
+}
+
+HeapMonScope::HeapMonScope(int8_t id) : _prev(t_site) {
+  t_site = id;
+}
+
+HeapMonScope::~HeapMonScope() {
+  t_site = _prev;
+}
+
+void heapMonTraceAlloc(void* p, size_t size) {
+  if (!s_on) return;
+  int8_t site = t_site;
+
+  TRACE_LOCK();
+  HeapSite& s = s_sites[site];
+  if (!p) {
+    s.failed++;
+    TRACE_UNLOCK();
+    return;
+  }
+  s.allocs++;
+  s.bytes += size;
+
+  if (s_nTracked == HEAPMON_TRACKED - 1) {
+    s_untracked++;
+    TRACE_UNLOCK();
+    return;
+  }
+  uint32_t i = home(p);
+  while (s_tracked[i].p) i = (i + 1) & (HEAPMON_TRACKED - 1);
+  s_tracked[i] = { p, (uint32_t)size, site };
+  s_nTracked++;
+  s.liveBytes += size;
+  s.liveBlocks++;
+  TRACE_UNLOCK();
+}
+
+// Takes p out of the table and its site's live counts; the entry goes
+// to *was. False if p is not tracked.
+static bool untrack(void* p, Tracked* was) {
+  if (!s_on || !p) return false;
+
+  TRACE_LOCK();
+  uint32_t i = home(p);
+  while (s_tracked[i].p != p) {
+    if (!s_tracked[i].p) {   // not ours: from before begin, or untracked
+      TRACE_UNLOCK();
+      return false;
+    }
+    i = (i + 1) & (HEAPMON_TRACKED - 1);
+  }
+
+  if (was) *was = s_tracked[i];
+  HeapSite& s = s_sites[s_tracked[i].site];
+  s.liveBytes -= s_tracked[i].size;
+  s.liveBlocks--;
+  s_nTracked--;
+
+  // Pull later entries of the probe run back over the hole
+  s_tracked[i].p = nullptr;
+  uint32_t j = i;
+  for (;;) {
+    j = (j + 1) & (HEAPMON_TRACKED - 1);
+    if (!s_tracked[j].p) break;
+    uint32_t k = home(s_tracked[j].p);
+    bool between = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+    if (!between) {
+      s_tracked[i] = s_tracked[j];
+      s_tracked[j].p = nullptr;
+      i = j;
+    }
+  }
+  TRACE_UNLOCK();
+  return true;
+}
+
+void heapMonTraceFree(void* p) {
+  untrack(p, nullptr);
+}
+
+uint8_t heapMonSites(HeapSite* out) {
+  TRACE_LOCK();
+  uint8_t n = s_nSites;
+  memcpy(out, s_sites, sizeof(HeapSite) * n);
+  TRACE_UNLOCK();
+  return n;
+}
+
+uint32_t heapMonUntracked() {
+  return __atomic_load_n(&s_untracked, __ATOMIC_RELAXED);
+}
+
+#ifdef ESP32
+
+// Puts an entry untrack() took back, with its site's live counts
+static void retrack(const Tracked& was) {
+  TRACE_LOCK();
+  if (s_nTracked == HEAPMON_TRACKED - 1) {   // filled up in the meantime
+    s_untracked++;
+    TRACE_UNLOCK();
+    return;
+  }
+  uint32_t i = home(was.p);
+  while (s_tracked[i].p) i = (i + 1) & (HEAPMON_TRACKED - 1);
+  s_tracked[i] = was;
+  s_nTracked++;
+  HeapSite& s = s_sites[was.site];
+  s.liveBytes += was.size;
+  s.liveBlocks++;
+  TRACE_UNLOCK();
+}
+
+// Linked with -Wl,--wrap=malloc,--wrap=free,--wrap=realloc,--wrap=calloc:
+// every reference to malloc in the image (new, String, lwIP) lands here.
+// heap_caps_malloc() called directly is not seen.
+extern "C" {
+void* __real_malloc(size_t size);
+void  __real_free(void* p);
+void* __real_realloc(void* p, size_t size);
+void* __real_calloc(size_t n, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  void* p = __real_malloc(size);
+  heapMonTraceAlloc(p, size);
+  return p;
+}
+
+void __wrap_free(void* p) {
+  heapMonTraceFree(p);   // before the block can be handed out again
+  __real_free(p);
+}
+
+void* __wrap_realloc(void* old, size_t size) {
+  // old leaves the table before the call, like in free: once realloc
+  // has moved the block, another task may be handed that address
+  Tracked was;
+  bool tracked = untrack(old, &was);
+  void* p = __real_realloc(old, size);
+  if (p) {
+    heapMonTraceAlloc(p, size);
+  } else if (size) {
+    if (tracked) retrack(was);          // failed, old is still live
+    heapMonTraceAlloc(nullptr, size);
+  }                                     // else realloc(p, 0) freed it
+  return p;
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+  void* p = __real_calloc(n, size);
+  heapMonTraceAlloc(p, n * size);
+  return p;
+}
+}
+
+void heapMonTraceBegin() {
+  s_on = true;
+}
+
+#else
+
+void heapMonTraceBegin() {
+  s_on = true;
+  nativeOnAlloc(heapMonTraceAlloc, heapMonTraceFree);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+#include "IsrProf.h"
+
+#include <string.h>
+
+#ifndef ESP32
+#include <chrono>
+// Host: 1 "cycle" = 1 ns, printed as if the CPU ran at 1000 MHz
+uint32_t isrProfHostCycles() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static uint32_t cpuMhz() { return 1000; }
+#else
+static uint32_t cpuMhz() { return getCpuFrequencyMhz(); }
+#endif
+
+IsrProbe* IsrProbe::_first = nullptr;
+
+IsrProbe::IsrProbe(const char* name, uint32_t periodUs)
+  : _name(name), _nextProbe(_first), _periodCycles(periodUs * cpuMhz()) {
+  _first = this;
+  reset();
+}
+
+void IsrProbe::reset() {
+  _count = 0;
+  _synced = false;
+  _resyncs = 0;
+  _latencyMax = 0;
+  _runtimeMax = 0;
+  memset((void*)_latency, 0, sizeof(_latency));
+  memset((void*)_runtime, 0, sizeof(_runtime));
+}
+
+// Largest value that lands in bucket b
+uint32_t IsrProbe::bucketTop(uint8_t b) {
+  if (b < 4) return b;
+  uint8_t msb = b / 4 + 1;
+  uint64_t low = (uint64_t)(4 + b % 4) << (msb - 2);
+  uint64_t top = low + (1ULL << (msb - 2)) - 1;
+  return top > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)top;
+}
+
+uint32_t IsrProbe::percentile(const uint32_t* hist, uint32_t total, uint8_t pct, uint32_t max) {
+  if (total == 0) return 0;
+  uint64_t want = ((uint64_t)total * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (uint8_t b = 0; b < ISRPROF_BUCKETS; b++) {
+    seen += hist[b];
+    if (seen >= want) return bucketTop(b) < max ? bucketTop(b) : max;  // max is exact
+  }
+  return max;
+}
+
+void IsrProbe::print(Print& out) const {
+  // Snapshot first so the numbers on one line agree with each other
+  uint32_t runtime[ISRPROF_BUCKETS];
+  uint32_t latency[ISRPROF_BUCKETS];
+  uint32_t runTotal = 0, latTotal = 0;
+  for (uint8_t b = 0; b < ISRPROF_BUCKETS; b++) {
+    runtime[b] = _runtime[b];
+    latency[b] = _latency[b];
+    runTotal += runtime[b];
+    latTotal += latency[b];
+  }
+
+  float mhz = cpuMhz();
+  uint32_t runMax = _runtimeMax;
+  out.printf("%-10s n=%lu run us: p50=%.2f p90=%.2f p99=%.2f max=%.2f\n",
+             _name, (unsigned long)_count,
+             percentile(runtime, runTotal, 50, runMax) / mhz, percentile(runtime, runTotal, 90, runMax) / mhz,
+             percentile(runtime, runTotal, 99, runMax) / mhz, runMax / mhz);
+
+  if (_periodCycles) {
+    uint32_t latMax = _latencyMax;
+    out.printf("%-10s late us: p50=%.2f p90=%.2f p99=%.2f max=%.2f resyncs=%lu\n",
+               "", percentile(latency, latTotal, 50, latMax) / mhz, percentile(latency, latTotal, 90, latMax) / mhz,
+               percentile(latency, latTotal, 99, latMax) / mhz, latMax / mhz,
+               (unsigned long)_resyncs);
+  }
+}
+
+uint32_t IsrProbe::overheadCycles() {
+  static uint32_t cached = 0;
+  if (cached) return cached;
+
+  // Best of many: what enter()+exit() add on top of the two reads that bracket them
+  IsrProbe probe("calib", 1);
+  uint32_t best = 0xFFFFFFFF, bare = 0xFFFFFFFF;
+  for (int i = 0; i < 1000; i++) {
+    uint32_t t0 = ISRPROF_CYCLES();
+    uint32_t t1 = ISRPROF_CYCLES();
+    if (t1 - t0 < bare) bare = t1 - t0;
+
+    t0 = ISRPROF_CYCLES();
+    probe.exit(probe.enter());
+    t1 = ISRPROF_CYCLES();
+    if (t1 - t0 < best) best = t1 - t0;
+  }
+
+  // Unlink the calibration probe again
+  _first = probe._nextProbe;
+
+  cached = best > bare ? best - bare : 1;
+  return cached;
+}
+
+void IsrProbe::printAll(Print& out) {
+  uint32_t overhead = overheadCycles();
+  out.printf("ISR profile (probe overhead %lu cycles = %.2f us per ISR)\n",
+             (unsigned long)overhead, overhead / (float)cpuMhz());
+  for (IsrProbe* p = _first; p; p = p->_nextProbe) p->print(out);
+}
+
+void IsrProbe::resetAll() {
+  for (IsrProbe* p = _first; p; p = p->_nextProbe) p->reset();
+}
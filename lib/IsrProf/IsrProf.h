@@ -0,0 +1,119 @@
+/****************************************************
+ * IsrProf
+ * Per-ISR latency and run time histograms from the CPU
+ * cycle counter.
+ *
+ *   IsrProbe tickProbe("tick", 1000);   // periodic, 1000 us
+ *   void IRAM_ATTR onTimer() {
+ *     IsrScope scope(tickProbe);
+ *     ...
+ *   }
+ *   IsrProbe::printAll(Serial);         // from a task
+ *
+ * enter()/exit() are forced inline, so they end up in the
+ * ISR's own IRAM code. Each one reads CCOUNT once and
+ * bumps one histogram counter, no locks, no calls.
+ *
+ * Run time is entry -> exit. Latency is only known for
+ * periodic sources: each entry is compared with the
+ * previous one plus the period, relative to the earliest
+ * entry seen (the absolute interrupt latency is not
+ * visible from software). Edge ISRs get run time and
+ * count only.
+ *
+ * Histograms are log-linear: 4 sub-buckets per power of
+ * two, so a percentile is within 25 % (the upper bucket
+ * edge is reported) and max is exact. The cost of one
+ * enter/exit pair is measured on the first printAll(), in
+ * the calling task, and printed with every dump.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <soc/cpu.h>
+#define ISRPROF_CYCLES()  esp_cpu_get_ccount()
+#else
+uint32_t isrProfHostCycles();
+#define ISRPROF_CYCLES()  isrProfHostCycles()
+#endif
+
+#define ISRPROF_BUCKETS  124   // 0..3 exact, then 4 per octave up to 2^32
+
+class IsrProbe {
+public:
+  explicit IsrProbe(const char* name, uint32_t periodUs = 0);
+
+  __attribute__((always_inline)) inline uint32_t enter() {
+    uint32_t now = ISRPROF_CYCLES();
+    if (_periodCycles) {
+      if (!_synced) {
+        _next = now + _periodCycles;
+        _synced = true;
+      } else {
+        int32_t late = (int32_t)(now - _next);
+        if (late < 0 || (uint32_t)late >= _periodCycles) {
+          _next = now;  // earlier than any entry so far, or a skipped tick
+          _resyncs++;
+          late = 0;
+        }
+        _latency[bucket(late)]++;
+        if ((uint32_t)late > _latencyMax) _latencyMax = late;
+        _next += _periodCycles;
+      }
+    }
+    return now;
+  }
+
+  __attribute__((always_inline)) inline void exit(uint32_t entry) {
+    uint32_t took = ISRPROF_CYCLES() - entry;
+    _runtime[bucket(took)]++;
+    if (took > _runtimeMax) _runtimeMax = took;
+    _count++;
+  }
+
+  // Task context only. A sample racing the reset may be half-counted.
+  void reset();
+  void print(Print& out) const;
+
+  static void printAll(Print& out);
+  static void resetAll();
+  // Cycles one enter()+exit() adds to an ISR, measured on the first call
+  static uint32_t overheadCycles();
+
+private:
+  __attribute__((always_inline)) static inline uint8_t bucket(uint32_t v) {
+    if (v < 4) return v;
+    uint8_t msb = 31 - __builtin_clz(v);
+    return (msb - 1) * 4 + ((v >> (msb - 2)) & 3);
+  }
+  static uint32_t bucketTop(uint8_t b);
+  static uint32_t percentile(const uint32_t* hist, uint32_t total, uint8_t pct, uint32_t max);
+
+  const char* _name;
+  IsrProbe*   _nextProbe;
+  uint32_t    _periodCycles;
+
+  volatile uint32_t _count;
+  volatile uint32_t _next;
+  volatile bool     _synced;
+  volatile uint32_t _resyncs;
+  volatile uint32_t _latencyMax;
+  volatile uint32_t _runtimeMax;
+  volatile uint32_t _latency[ISRPROF_BUCKETS];
+  volatile uint32_t _runtime[ISRPROF_BUCKETS];
+
+  static IsrProbe* _first;
+};
+
+// Times the enclosing block
+class IsrScope {
+public:
+  __attribute__((always_inline)) inline explicit IsrScope(IsrProbe& p) : _p(p), _t(p.enter()) {}
+  __attribute__((always_inline)) inline ~IsrScope() { _p.exit(_t); }
+
+private:
+  IsrProbe& _p;
+  uint32_t  _t;
+};
@@ -0,0 +1,88 @@
+/****************************************************
+ * LittleFS (emulator)
+ * The ESP32 core's LittleFS and File for the `native`
+ * env. Files live in RAM, nothing is written to disk.
+ *
+ *  - at most LITTLEFS_EMU_FILES files, LITTLEFS_EMU_SIZE
+ *    bytes between them (the nodemcu-32s data partition);
+ *    a write past that is cut short like on a full flash
+ *  - FILE_READ / FILE_WRITE / FILE_APPEND as on the board,
+ *    rename() replaces an existing target
+ *  - littleFsEmuStats() counts bytes read and written, so
+ *    tests can see what a store costs in flash wear
+ *  - littleFsEmuFailReads(true) makes every read return 0
+ *    bytes, like a corrupted block
+ *
+ * Files take their blocks from malloc, not operator new,
+ * so flash doesn't show up as heap in nativeStats().
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#define LITTLEFS_EMU_FILES  8
+#define LITTLEFS_EMU_NAME   32
+#define LITTLEFS_EMU_SIZE   0x160000
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct LittleFsEmuStats {
+  uint64_t bytesRead;
+  uint64_t bytesWritten;
+  uint32_t opens;
+};
+
+LittleFsEmuStats& littleFsEmuStats();
+void littleFsEmuFailReads(bool fail);
+
+class File : public Print {
+public:
+  File() : _slot(-1), _pos(0), _write(false) {}
+  File(int8_t slot, bool write, bool append);
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+
+  int    read();
+  size_t read(uint8_t* buf, size_t size);
+  int    available();
+  bool   seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const { return _pos; }
+  size_t size() const;
+  const char* name() const;
+  void   flush() {}
+  void   close() { _slot = -1; }
+
+  operator bool() const { return _slot >= 0; }
+
+private:
+  int8_t _slot;
+  size_t _pos;
+  bool   _write;
+};
+
+class LittleFSFS {
+public:
+  bool   begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* label = "spiffs");
+  void   end() { _mounted = false; }
+  bool   format();
+
+  File   open(const char* path, const char* mode = FILE_READ, bool create = false);
+  bool   exists(const char* path);
+  bool   remove(const char* path);
+  bool   rename(const char* from, const char* to);
+
+  size_t totalBytes() { return LITTLEFS_EMU_SIZE; }
+  size_t usedBytes();
+
+private:
+  bool _mounted = false;
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,171 @@
+#include "LittleFS.h"
+
+#include <stdlib.h>
+
+LittleFSFS LittleFS;
+
+static LittleFsEmuStats s_stats;
+static bool s_failReads = false;
+
+LittleFsEmuStats& littleFsEmuStats() { return s_stats; }
+void littleFsEmuFailReads(bool fail) { s_failReads = fail; }
+
+// ---- File table ----
+
+struct EmuFile {
+  bool     used;
+  char     name[LITTLEFS_EMU_NAME];
+  uint8_t* data;
+  size_t   size;
+  size_t   cap;
+};
+
+static EmuFile s_files[LITTLEFS_EMU_FILES];
+
+static int8_t findFile(const char* path) {
+  for (int8_t i = 0; i < LITTLEFS_EMU_FILES; i++) {
+    if (s_files[i].used && !strcmp(s_files[i].name, path)) return i;
+  }
+  return -1;
+}
+
+static void freeFile(EmuFile& f) {
+  free(f.data);
+  memset(&f, 0, sizeof(f));
+}
+
+static int8_t createFile(const char* path) {
+  if (strlen(path) >= LITTLEFS_EMU_NAME) return -1;
+  for (int8_t i = 0; i < LITTLEFS_EMU_FILES; i++) {
+    if (s_files[i].used) continue;
+    memset(&s_files[i], 0, sizeof(EmuFile));
+    s_files[i].used = true;
+    strcpy(s_files[i].name, path);
+    return i;
+  }
+  return -1;
+}
+
+static size_t usedTotal() {
+  size_t n = 0;
+  for (const EmuFile& f : s_files) n += f.used ? f.size : 0;
+  return n;
+}
+
+// ---- File ----
+
+File::File(int8_t slot, bool write, bool append)
+    : _slot(slot), _pos(append ? s_files[slot].size : 0), _write(write) {}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+  if (_slot < 0 || !_write) return 0;
+  EmuFile& f = s_files[_slot];
+
+  // A full partition takes what still fits
+  size_t grow = _pos + size > f.size ? _pos + size - f.size : 0;
+  size_t room = LITTLEFS_EMU_SIZE - usedTotal();
+  if (grow > room) size -= grow - room;
+
+  if (_pos + size > f.cap) {
+    size_t cap = f.cap ? f.cap : 256;
+    while (cap < _pos + size) cap *= 2;
+    uint8_t* p = (uint8_t*)realloc(f.data, cap);
+    if (!p) return 0;
+    f.data = p;
+    f.cap = cap;
+  }
+  memcpy(f.data + _pos, buf, size);
+  _pos += size;
+  if (_pos > f.size) f.size = _pos;
+  s_stats.bytesWritten += size;
+  return size;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+  if (_slot < 0 || s_failReads) return 0;
+  EmuFile& f = s_files[_slot];
+  size_t n = _pos < f.size ? f.size - _pos : 0;
+  if (n > size) n = size;
+  memcpy(buf, f.data + _pos, n);
+  _pos += n;
+  s_stats.bytesRead += n;
+  return n;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) ? c : -1;
+}
+
+int File::available() {
+  if (_slot < 0) return 0;
+  size_t size = s_files[_slot].size;
+  return _pos < size ? (int)(size - _pos) : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (_slot < 0) return false;
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? _pos : s_files[_slot].size;
+  if (base + pos > s_files[_slot].size) return false;
+  _pos = base + pos;
+  return true;
+}
+
+size_t File::size() const {
+  return _slot >= 0 ? s_files[_slot].size : 0;
+}
+
+const char* File::name() const {
+  return _slot >= 0 ? s_files[_slot].name : "";
+}
+
+// ---- LittleFSFS ----
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                       const char* label) {
+  _mounted = true;
+  return true;
+}
+
+bool LittleFSFS::format() {
+  for (EmuFile& f : s_files) freeFile(f);
+  return true;
+}
+
+File LittleFSFS::open(const char* path, const char* mode, bool create) {
+  if (!_mounted) return File();
+  s_stats.opens++;
+
+  int8_t slot = findFile(path);
+  if (mode[0] == 'r') {
+    return slot >= 0 ? File(slot, mode[1] == '+', false) : File();
+  }
+  if (slot < 0) slot = createFile(path);
+  if (slot < 0) return File();
+  if (mode[0] == 'w') s_files[slot].size = 0;
+  return File(slot, true, mode[0] == 'a');
+}
+
+bool LittleFSFS::exists(const char* path) {
+  return _mounted && findFile(path) >= 0;
+}
+
+bool LittleFSFS::remove(const char* path) {
+  int8_t slot = _mounted ? findFile(path) : -1;
+  if (slot < 0) return false;
+  freeFile(s_files[slot]);
+  return true;
+}
+
+bool LittleFSFS::rename(const char* from, const char* to) {
+  int8_t slot = _mounted ? findFile(from) : -1;
+  if (slot < 0 || strlen(to) >= LITTLEFS_EMU_NAME) return false;
+  int8_t old = findFile(to);
+  if (old >= 0 && old != slot) freeFile(s_files[old]);
+  strcpy(s_files[slot].name, to);
+  return true;
+}
+
+size_t LittleFSFS::usedBytes() {
+  return usedTotal();
+}
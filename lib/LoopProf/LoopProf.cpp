@@ -0,0 +1,108 @@
+#include "LoopProf.h"
+
+#if LOOP_PROF
+
+#include <string.h>
+
+static LoopProfSection s_sections[LOOP_PROF_SECTIONS];
+static volatile uint8_t s_used = 0;
+static uint32_t s_dropped = 0;   // registrations beyond the table
+
+// Called once per marker (function-local static), possibly from several tasks
+int8_t loopProfRegister(const char* name, bool isLoop) {
+  uint8_t id = __atomic_fetch_add(&s_used, 1, __ATOMIC_RELAXED);
+  if (id >= LOOP_PROF_SECTIONS) {
+    s_dropped++;
+    return -1;
+  }
+
+  LoopProfSection& s = s_sections[id];
+  memset(&s, 0, sizeof(s));
+  s.name = name;
+  s.isLoop = isLoop;
+  s.minUs = UINT32_MAX;
+  s.skipNext = true;  // first mark has nothing to measure from
+  return id;
+}
+
+static inline uint8_t bucketOf(uint32_t us) {
+  uint8_t b = us ? 32 - __builtin_clz(us) : 0;
+  return b < LOOP_PROF_BUCKETS ? b : LOOP_PROF_BUCKETS - 1;
+}
+
+void loopProfRecord(int8_t id, uint32_t us) {
+  if (id < 0) return;
+  LoopProfSection& s = s_sections[id];
+  s.count++;
+  s.sumUs += us;
+  if (us < s.minUs) s.minUs = us;
+  if (us > s.maxUs) s.maxUs = us;
+  s.hist[bucketOf(us)]++;
+}
+
+void loopProfMark(int8_t id) {
+  if (id < 0) return;
+  LoopProfSection& s = s_sections[id];
+  uint32_t now = micros();
+
+  if (s.skipNext) s.skipNext = false;
+  else            loopProfRecord(id, now - s.lastMarkUs);
+  s.lastMarkUs = now;
+}
+
+void loopProfReset() {
+  uint8_t n = s_used < LOOP_PROF_SECTIONS ? s_used : LOOP_PROF_SECTIONS;
+  for (uint8_t i = 0; i < n; i++) {
+    LoopProfSection& s = s_sections[i];
+    s.count = 0;
+    s.sumUs = 0;
+    s.minUs = UINT32_MAX;
+    s.maxUs = 0;
+    memset(s.hist, 0, sizeof(s.hist));
+    s.skipNext = true;
+  }
+}
+
+uint8_t loopProfSnapshot(LoopProfSection* out) {
+  uint8_t n = s_used < LOOP_PROF_SECTIONS ? s_used : LOOP_PROF_SECTIONS;
+  memcpy(out, s_sections, n * sizeof(LoopProfSection));
+
+  // The pass that reports is not a stall
+  for (uint8_t i = 0; i < n; i++) {
+    if (s_sections[i].isLoop) s_sections[i].skipNext = true;
+  }
+  return n;
+}
+
+void loopProfPrint(Print& out) {
+  // Copy first, format after: the numbers belong to one instant
+  static LoopProfSection snap[LOOP_PROF_SECTIONS];
+  uint8_t n = loopProfSnapshot(snap);
+
+  out.printf("%-14s %8s %9s %9s %9s %9s\n", "section", "count", "min us", "avg us", "max us", "rate Hz");
+  for (uint8_t i = 0; i < n; i++) {
+    const LoopProfSection& s = snap[i];
+    if (s.count == 0) {
+      out.printf("%-14s %8lu\n", s.name, 0UL);
+      continue;
+    }
+    uint32_t avg = (uint32_t)(s.sumUs / s.count);
+    out.printf("%-14s %8lu %9lu %9lu %9lu", s.name, (unsigned long)s.count,
+               (unsigned long)s.minUs, (unsigned long)avg, (unsigned long)s.maxUs);
+    if (s.isLoop) out.printf(" %9.1f", s.sumUs ? s.count * 1e6 / s.sumUs : 0.0);
+    out.println();
+
+    // Histogram: only the non-empty buckets, as "<upper bound>:count"
+    out.print("   ");
+    for (uint8_t b = 0; b < LOOP_PROF_BUCKETS; b++) {
+      if (!s.hist[b]) continue;
+      uint32_t top = b ? (1UL << b) - 1 : 0;
+      if (b == LOOP_PROF_BUCKETS - 1) out.printf(" >%lu:%lu", (unsigned long)(1UL << (b - 1)), (unsigned long)s.hist[b]);
+      else                            out.printf(" <=%lu:%lu", (unsigned long)top, (unsigned long)s.hist[b]);
+    }
+    out.println();
+  }
+  if (s_dropped) out.printf("(%lu sections did not fit, raise LOOP_PROF_SECTIONS)\n", (unsigned long)s_dropped);
+}
+
+#endif
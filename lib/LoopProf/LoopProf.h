@@ -0,0 +1,94 @@
+/****************************************************
+ * LoopProf
+ * Where does loop() time go?
+ *
+ *   void loop() {
+ *     PROF_LOOP("loop");                 // once per pass
+ *     { PROF_SCOPE("web"); server.handleClient(); }
+ *     ...
+ *   }
+ *   loopProfPrint(Serial);               // the table
+ *
+ * PROF_SCOPE times the enclosing block. PROF_LOOP times
+ * the interval between two passes, which gives the loop
+ * frequency and the worst stall. Each section keeps count,
+ * min/avg/max and a log2 histogram (1 us .. 8 s) in a
+ * fixed table of LOOP_PROF_SECTIONS entries, registered on
+ * first use. No heap, one micros() per marker edge.
+ *
+ * A section should only be entered from one task at a
+ * time; different tasks may own different sections.
+ *
+ * Printing snapshots the table before formatting, and the
+ * pass that printed is not counted, so a dump doesn't show
+ * up as a stall.
+ *
+ * Build with -D LOOP_PROF=1. Otherwise the markers are
+ * empty and the functions are inline no-ops.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef LOOP_PROF
+#define LOOP_PROF 0
+#endif
+
+#define LOOP_PROF_SECTIONS  16
+#define LOOP_PROF_BUCKETS   24   // bucket b: [2^(b-1), 2^b) us, bucket 0: 0 us
+
+struct LoopProfSection {
+  const char* name;
+  bool        isLoop;
+  uint32_t    count;
+  uint64_t    sumUs;
+  uint32_t    minUs;
+  uint32_t    maxUs;
+  uint32_t    hist[LOOP_PROF_BUCKETS];
+  uint32_t    lastMarkUs;   // loop sections only
+  bool        skipNext;     // loop sections: drop the interval that printed
+};
+
+#if LOOP_PROF
+
+int8_t loopProfRegister(const char* name, bool isLoop);
+void   loopProfRecord(int8_t id, uint32_t us);
+void   loopProfMark(int8_t id);
+void   loopProfPrint(Print& out);
+void   loopProfReset();
+
+// Copy of the table for other outputs (e.g. binary telemetry), returns
+// the number of sections. out must hold LOOP_PROF_SECTIONS entries.
+uint8_t loopProfSnapshot(LoopProfSection* out);
+
+class LoopProfScope {
+public:
+  explicit LoopProfScope(int8_t id) : _id(id), _start(micros()) {}
+  ~LoopProfScope() { loopProfRecord(_id, micros() - _start); }
+
+private:
+  int8_t   _id;
+  uint32_t _start;
+};
+
+#define LOOP_PROF_CAT2(a, b)  a##b
+#define LOOP_PROF_CAT(a, b)   LOOP_PROF_CAT2(a, b)
+
+#define PROF_SCOPE(name) \
+  static const int8_t LOOP_PROF_CAT(_profId, __LINE__) = loopProfRegister(name, false); \
+  LoopProfScope LOOP_PROF_CAT(_profScope, __LINE__)(LOOP_PROF_CAT(_profId, __LINE__))
+
+#define PROF_LOOP(name) do { \
+  static const int8_t _profLoopId = loopProfRegister(name, true); \
+  loopProfMark(_profLoopId); \
+} while (0)
+
+#else
+
+#define PROF_SCOPE(name)  ((void)0)
+#define PROF_LOOP(name)   ((void)0)
+inline void loopProfPrint(Print&) {}
+inline void loopProfReset() {}
+inline uint8_t loopProfSnapshot(LoopProfSection*) { return 0; }
+
+#endif
@@ -0,0 +1,171 @@
+#include "Metrics.h"
+#include <FixedFmt.h>
+
+#include <math.h>
+#include <string.h>
+
+static Metric* s_first = nullptr;
+static Metric* s_last = nullptr;
+
+Metric::Metric(const char* name, const char* help, MetricType type, const char* labels)
+  : _name(name), _help(help), _labels(labels), _type(type), _next(nullptr) {
+  // Registration order is output order
+  if (s_last) s_last->_next = this;
+  else        s_first = this;
+  s_last = this;
+}
+
+const Metric* metricsFirst() {
+  return s_first;
+}
+
+// ---- Output helpers ----
+
+static void writeStr(Print& out, const char* s) {
+  out.write((const uint8_t*)s, strlen(s));
+}
+
+static void writeUint(Print& out, uint32_t v) {
+  char buf[11];
+  char* p = buf + sizeof(buf);
+  do {
+    *--p = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  out.write((const uint8_t*)p, buf + sizeof(buf) - p);
+}
+
+// Shortest of up to 6 decimals, Prometheus spellings for NaN/Inf
+static void writeFloat(Print& out, float v) {
+  if (isnan(v)) return writeStr(out, "NaN");
+  if (isinf(v)) return writeStr(out, v > 0 ? "+Inf" : "-Inf");
+
+  char buf[FIXED_NUM_SIZE + 40];
+  size_t n = fmtFixed(buf, sizeof(buf), v, 6);
+  while (n > 1 && buf[n - 1] == '0') n--;
+  if (n > 1 && buf[n - 1] == '.') n--;
+  out.write((const uint8_t*)buf, n);
+}
+
+// name{labels,extra} or name{extra} or name
+static void writeName(Print& out, const Metric& m, const char* suffix, const char* extra = nullptr) {
+  writeStr(out, m.name());
+  if (suffix) writeStr(out, suffix);
+  if (!m.labels() && !extra) return;
+
+  out.write('{');
+  if (m.labels()) writeStr(out, m.labels());
+  if (m.labels() && extra) out.write(',');
+  if (extra) writeStr(out, extra);
+  out.write('}');
+}
+
+// ---- Metric types ----
+
+void MetricCounter::render(Print& out) const {
+  writeName(out, *this, nullptr);
+  out.write(' ');
+  writeUint(out, value());
+  out.write('\n');
+}
+
+void MetricGauge::set(float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  __atomic_store_n(&_bits, bits, __ATOMIC_RELAXED);
+}
+
+float MetricGauge::value() const {
+  uint32_t bits = __atomic_load_n(&_bits, __ATOMIC_RELAXED);
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+void MetricGauge::render(Print& out) const {
+  writeName(out, *this, nullptr);
+  out.write(' ');
+  writeFloat(out, value());
+  out.write('\n');
+}
+
+void MetricCallback::render(Print& out) const {
+  writeName(out, *this, nullptr);
+  out.write(' ');
+  writeFloat(out, _fn());
+  out.write('\n');
+}
+
+MetricHistogramBase::MetricHistogramBase(const char* name, const char* help,
+                                         const uint32_t* bounds, uint8_t nBounds,
+                                         uint32_t* counts, float scale, const char* labels)
+  : Metric(name, help, METRIC_HISTOGRAM, labels), _bounds(bounds), _counts(counts),
+    _nBounds(nBounds), _scale(scale), _count(0), _sum(0) {}
+
+void MetricHistogramBase::observe(uint32_t v) {
+  uint8_t b = 0;
+  while (b < _nBounds && v > _bounds[b]) b++;   // le: v <= bound
+  __atomic_fetch_add(&_counts[b], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&_sum, v, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&_count, 1, __ATOMIC_RELAXED);
+}
+
+void MetricHistogramBase::render(Print& out) const {
+  // _count is not read here: the +Inf bucket and the _count line both
+  // print the sum of the buckets as read in this pass, so they agree
+  // even when an observe() runs during the scrape
+  char le[FIXED_NUM_SIZE + 8];
+  uint32_t cumulative = 0;
+
+  for (uint8_t b = 0; b <= _nBounds; b++) {
+    cumulative += __atomic_load_n(&_counts[b], __ATOMIC_RELAXED);
+    if (b < _nBounds) {
+      strcpy(le, "le=\"");
+      size_t n = 4 + fmtFixed(le + 4, sizeof(le) - 6, _bounds[b] * _scale, 6);
+      while (le[n - 1] == '0') n--;
+      if (le[n - 1] == '.') n--;
+      le[n++] = '"';
+      le[n] = 0;
+    } else {
+      strcpy(le, "le=\"+Inf\"");
+    }
+    writeName(out, *this, "_bucket", le);
+    out.write(' ');
+    writeUint(out, cumulative);
+    out.write('\n');
+  }
+
+  writeName(out, *this, "_sum");
+  out.write(' ');
+  writeFloat(out, __atomic_load_n(&_sum, __ATOMIC_RELAXED) * _scale);
+  out.write('\n');
+
+  writeName(out, *this, "_count");
+  out.write(' ');
+  writeUint(out, cumulative);
+  out.write('\n');
+}
+
+// ---- Registry ----
+
+static const char* s_typeName[] = { "counter", "gauge", "histogram" };
+
+void metricsRender(Print& out) {
+  const char* family = nullptr;
+
+  for (const Metric* m = s_first; m; m = m->next()) {
+    if (!family || strcmp(family, m->name()) != 0) {
+      family = m->name();
+      writeStr(out, "# HELP ");
+      writeStr(out, family);
+      out.write(' ');
+      writeStr(out, m->help());
+      writeStr(out, "\n# TYPE ");
+      writeStr(out, family);
+      out.write(' ');
+      writeStr(out, s_typeName[m->type()]);
+      out.write('\n');
+    }
+    m->render(out);
+  }
+}
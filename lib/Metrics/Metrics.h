@@ -0,0 +1,148 @@
+/****************************************************
+ * Metrics
+ * Counters, gauges and fixed-bucket histograms with a
+ * Prometheus text renderer, for a /metrics endpoint.
+ *
+ *   MetricCounter dhtFailures("dht_read_failures_total",
+ *                             "DHT reads that returned NaN");
+ *   static const uint32_t latencyBounds[] = { 1000, 5000, 20000, 100000 };
+ *   MetricHistogram<4> httpLatency("http_request_duration_seconds",
+ *                                  "Handler time", latencyBounds, 1e-6f);
+ *   MetricCallback heapFree("heap_free_bytes", "Free heap",
+ *                           METRIC_GAUGE, [] { return (float)ESP.getFreeHeap(); });
+ *
+ *   dhtFailures.inc();
+ *   httpLatency.observe(micros() - start);   // in the bounds' unit
+ *   metricsRender(out);                      // any Print
+ *
+ * Metrics register themselves when constructed: a module
+ * declares them as globals next to the code they count,
+ * nothing else to call. The registry is an intrusive list,
+ * no heap and no size limit. Create them at startup only,
+ * the list is not locked.
+ *
+ * Updates are single 32-bit atomic operations, safe from
+ * any task and never blocking; a scrape reads each value
+ * once and never stops a writer. A histogram's buckets and
+ * count always agree in the output; its sum can be one
+ * observation ahead or behind.
+ *
+ * Counters and histogram sums are 32-bit and wrap;
+ * Prometheus reads a wrap as a counter reset.
+ *
+ * Metrics with the same name (different labels) should
+ * be declared next to each other: HELP/TYPE is written
+ * once per run of equal names.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+enum MetricType : uint8_t {
+  METRIC_COUNTER,
+  METRIC_GAUGE,
+  METRIC_HISTOGRAM,
+};
+
+class Metric {
+public:
+  const char* name() const { return _name; }
+  const char* help() const { return _help; }
+  const char* labels() const { return _labels; }
+  MetricType  type() const { return _type; }
+  const Metric* next() const { return _next; }
+
+  // Writes the sample lines (not HELP/TYPE)
+  virtual void render(Print& out) const = 0;
+
+protected:
+  // labels: `path="/"`, without braces, or nullptr
+  Metric(const char* name, const char* help, MetricType type, const char* labels);
+
+  const char* _name;
+  const char* _help;
+  const char* _labels;
+  MetricType  _type;
+  Metric*     _next;
+};
+
+class MetricCounter : public Metric {
+public:
+  MetricCounter(const char* name, const char* help, const char* labels = nullptr)
+    : Metric(name, help, METRIC_COUNTER, labels), _value(0) {}
+
+  void inc(uint32_t n = 1) { __atomic_fetch_add(&_value, n, __ATOMIC_RELAXED); }
+  uint32_t value() const { return __atomic_load_n(&_value, __ATOMIC_RELAXED); }
+
+  void render(Print& out) const override;
+
+private:
+  uint32_t _value;
+};
+
+class MetricGauge : public Metric {
+public:
+  MetricGauge(const char* name, const char* help, const char* labels = nullptr)
+    : Metric(name, help, METRIC_GAUGE, labels), _bits(0x7FC00000) {}   // NaN until set
+
+  void set(float v);
+  float value() const;
+
+  void render(Print& out) const override;
+
+private:
+  uint32_t _bits;   // the float, stored whole so a reader never sees half of it
+};
+
+// Value computed at scrape time (heap, RSSI, another module's stats).
+// fn runs in the task that renders, it must be cheap.
+typedef float (*MetricFn)();
+
+class MetricCallback : public Metric {
+public:
+  MetricCallback(const char* name, const char* help, MetricType type, MetricFn fn,
+                 const char* labels = nullptr)
+    : Metric(name, help, type, labels), _fn(fn) {}
+
+  void render(Print& out) const override;
+
+private:
+  MetricFn _fn;
+};
+
+class MetricHistogramBase : public Metric {
+public:
+  // bounds: ascending upper bounds in the unit observe() gets;
+  // scale converts that unit for the output (1e-6f: us -> seconds)
+  MetricHistogramBase(const char* name, const char* help, const uint32_t* bounds,
+                      uint8_t nBounds, uint32_t* counts, float scale, const char* labels);
+
+  void observe(uint32_t v);
+  uint32_t count() const { return __atomic_load_n(&_count, __ATOMIC_RELAXED); }
+
+  void render(Print& out) const override;
+
+private:
+  const uint32_t* _bounds;
+  uint32_t*       _counts;   // per bucket, not cumulative; the last one is +Inf
+  uint8_t         _nBounds;
+  float           _scale;
+  uint32_t        _count;
+  uint32_t        _sum;
+};
+
+template <uint8_t N>
+class MetricHistogram : public MetricHistogramBase {
+public:
+  MetricHistogram(const char* name, const char* help, const uint32_t (&bounds)[N],
+                  float scale = 1.0f, const char* labels = nullptr)
+    : MetricHistogramBase(name, help, bounds, N, _buckets, scale, labels), _buckets() {}
+
+private:
+  uint32_t _buckets[N + 1];
+};
+
+// Prometheus text format (version 0.0.4) for every registered metric
+void metricsRender(Print& out);
+
+const Metric* metricsFirst();
@@ -0,0 +1,164 @@
+/****************************************************
+ * NativeArduino
+ * Minimal Arduino core for the `native` PlatformIO env.
+ *
+ *  - millis()/micros() run on a fake clock: delay() and
+ *    each loop() iteration advance it, nothing really waits
+ *  - GPIO/LEDC/ADC calls are stubs that remember values
+ *  - Serial prints to stdout
+ *  - nativeStats() counts what the sketch did to the
+ *    "hardware" and the heap: pin writes, ADC reads, UART
+ *    bytes, operator new calls. Wire, DHTEmu and WiFiEmu
+ *    add their own bus traffic.
+ *
+ * main() is provided here: setup(), then loop() as many
+ * times as --loops says, --bench reports per-loop cost
+ * (see NativeMain.cpp). What the ESP32 does in tasks
+ * (RingLog's drain) is hooked in with nativeOnLoop().
+ * Under `pio test` (PIO_UNIT_TESTING) the test has the
+ * main(): it calls setup()/loop() itself and moves time
+ * on with nativeTick().
+ ****************************************************/
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "Print.h"
+#include "WString.h"
+
+#define NATIVE_ARDUINO 1
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+#define RISING   0x01
+#define FALLING  0x02
+#define CHANGE   0x03
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)   (*(void* const*)(addr))
+
+using std::min;
+using std::max;
+
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ---- Fake clock ----
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+void     delayMicroseconds(uint32_t us);
+void     yield();
+void     nativeAdvanceMicros(uint64_t us);
+uint64_t nativeMicros64();
+inline int64_t esp_timer_get_time() { return (int64_t)nativeMicros64(); }
+
+// ---- GPIO / ADC / LEDC stubs ----
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void     nativeSetPin(uint8_t pin, uint8_t val);       // drive an input from outside
+void     nativeSetAnalog(uint8_t pin, uint16_t raw);
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void     ledcAttachPin(uint8_t pin, uint8_t channel);
+void     ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+double   ledcWriteTone(uint8_t channel, double freq);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+// ---- Counters for --bench ----
+struct NativeStats {
+  uint64_t gpioWrites;
+  uint64_t adcReads;
+  uint64_t ledcWrites;
+  uint64_t serialBytes;
+  uint64_t oneWireBytes;   // DHTEmu
+  uint64_t netRxBytes;     // WiFiEmu, read by the sketch
+  uint64_t netTxBytes;     // WiFiEmu, written by the sketch
+  uint64_t allocs;         // operator new / new[]
+  uint64_t allocBytes;
+  uint64_t frees;
+  uint64_t liveBytes;      // allocated and not yet deleted
+  uint64_t peakLiveBytes;  // most liveBytes ever, for ESP.getMinFreeHeap()
+};
+
+NativeStats& nativeStats();
+
+// Called on every operator new / delete, for allocation tracing
+typedef void (*NativeAllocHook)(void* p, size_t size);
+typedef void (*NativeFreeHook)(void* p);
+void nativeOnAlloc(NativeAllocHook onAlloc, NativeFreeHook onFree);
+
+// fn runs after every loop(), in place of a background task (max 8)
+bool nativeOnLoop(void (*fn)());
+
+// What main() does after each loop(): run the hooks, advance the clock
+void nativeTick(uint32_t us);
+
+// ---- ESP ----
+// The heap is NATIVE_HEAP_SIZE bytes minus what operator new holds
+#define NATIVE_HEAP_SIZE 200000
+
+class EspClass {
+public:
+  uint32_t getHeapSize() { return NATIVE_HEAP_SIZE; }
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap() { return getFreeHeap(); }   // never fragmented
+  uint32_t getCycleCount() { return (uint32_t)(nativeMicros64() * 240); }
+  uint32_t getCpuFreqMHz() { return 240; }
+  void     restart() { exit(0); }
+};
+
+extern EspClass ESP;
+
+// ---- Serial ----
+class HardwareSerial : public Print {
+public:
+  void   begin(unsigned long) {}
+  void   end() {}
+  int    available() { return 0; }
+  int    read() { return -1; }
+  void   flush();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// ---- Sketch entry points ----
+void setup();
+void loop();
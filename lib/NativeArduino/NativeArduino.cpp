@@ -0,0 +1,160 @@
+#include "Arduino.h"
+
+#include <stdio.h>
+
+#include <new>
+
+// ---- Counters ----
+static NativeStats stats;
+
+NativeStats& nativeStats() { return stats; }
+
+static NativeAllocHook allocHook = nullptr;
+static NativeFreeHook  freeHook = nullptr;
+
+void nativeOnAlloc(NativeAllocHook onAlloc, NativeFreeHook onFree) {
+  allocHook = onAlloc;
+  freeHook = onFree;
+}
+
+// Every C++ allocation (String, containers, new) is counted. The size
+// sits in front of the block so delete can take it off liveBytes;
+// 16 bytes keep the block aligned for any type.
+#define ALLOC_PREFIX 16
+
+void* operator new(size_t size) {
+  stats.allocs++;
+  stats.allocBytes += size;
+  stats.liveBytes += size;
+  if (stats.liveBytes > stats.peakLiveBytes) stats.peakLiveBytes = stats.liveBytes;
+  uint8_t* block = (uint8_t*)malloc(size + ALLOC_PREFIX);
+  if (!block) throw std::bad_alloc();
+  *(size_t*)block = size;
+  void* p = block + ALLOC_PREFIX;
+  if (allocHook) allocHook(p, size);
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept {
+  if (!p) return;
+  uint8_t* block = (uint8_t*)p - ALLOC_PREFIX;
+  stats.frees++;
+  stats.liveBytes -= *(size_t*)block;
+  if (freeHook) freeHook(p);
+  free(block);
+}
+
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// ---- Fake clock ----
+static uint64_t nowUs = 0;
+
+uint32_t millis()                    { return (uint32_t)(nowUs / 1000ULL); }
+uint32_t micros()                    { return (uint32_t)nowUs; }
+void     delay(uint32_t ms)          { nowUs += ms * 1000ULL; }
+void     delayMicroseconds(uint32_t us) { nowUs += us; }
+void     yield()                     {}
+void     nativeAdvanceMicros(uint64_t us) { nowUs += us; }
+
+// ---- ESP ----
+EspClass ESP;
+
+static uint32_t heapLeft(uint64_t used) {
+  return used < NATIVE_HEAP_SIZE ? NATIVE_HEAP_SIZE - (uint32_t)used : 0;
+}
+
+uint32_t EspClass::getFreeHeap()    { return heapLeft(stats.liveBytes); }
+uint32_t EspClass::getMinFreeHeap() { return heapLeft(stats.peakLiveBytes); }
+
+// ---- GPIO / ADC / LEDC stubs ----
+#define NATIVE_PINS     40
+#define NATIVE_CHANNELS 16
+
+static uint8_t  pinLevel[NATIVE_PINS];
+static uint16_t pinAnalog[NATIVE_PINS];
+static uint32_t ledcDuty[NATIVE_CHANNELS];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NATIVE_PINS && mode == INPUT_PULLUP) pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  stats.gpioWrites++;
+  if (pin < NATIVE_PINS) pinLevel[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < NATIVE_PINS ? pinLevel[pin] : LOW;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  stats.adcReads++;
+  return pin < NATIVE_PINS ? pinAnalog[pin] : 0;
+}
+
+void nativeSetPin(uint8_t pin, uint8_t val) {
+  if (pin < NATIVE_PINS) pinLevel[pin] = val ? HIGH : LOW;
+}
+
+void nativeSetAnalog(uint8_t pin, uint16_t raw) {
+  if (pin < NATIVE_PINS) pinAnalog[pin] = raw;
+}
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits) { return freq; }
+void     ledcAttachPin(uint8_t pin, uint8_t channel) {}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+  stats.ledcWrites++;
+  if (channel < NATIVE_CHANNELS) ledcDuty[channel] = duty;
+}
+
+uint32_t ledcRead(uint8_t channel) {
+  return channel < NATIVE_CHANNELS ? ledcDuty[channel] : 0;
+}
+
+double ledcWriteTone(uint8_t channel, double freq) { return freq; }
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {}
+void detachInterrupt(uint8_t pin) {}
+
+// ---- Serial ----
+HardwareSerial Serial;
+
+void HardwareSerial::flush() { fflush(stdout); }
+
+// Text comes a byte at a time (println's '\r' is dropped here), binary
+// blocks (lib/Telemetry frames) go out untouched
+size_t HardwareSerial::write(uint8_t c) {
+  stats.serialBytes++;
+  if (c != '\r') putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t size) {
+  stats.serialBytes += size;
+  return fwrite(buf, 1, size, stdout);
+}
+
+// ---- Loop hooks ----
+#define NATIVE_LOOP_HOOKS 8
+
+static void (*loopHooks[NATIVE_LOOP_HOOKS])();
+static uint8_t loopHookCount = 0;
+
+bool nativeOnLoop(void (*fn)()) {
+  if (loopHookCount == NATIVE_LOOP_HOOKS) return false;
+  loopHooks[loopHookCount++] = fn;
+  return true;
+}
+
+// After every loop(): the hooks, then the fake clock moves on
+void nativeTick(uint32_t us) {
+  for (uint8_t h = 0; h < loopHookCount; h++) loopHooks[h]();
+  nowUs += us;
+}
+
+uint64_t nativeMicros64() { return nowUs; }
@@ -0,0 +1,73 @@
+// main() for the sketch programs. `pio test` builds bring their own
+// (Unity's runner), so this one stays out of those.
+#ifndef PIO_UNIT_TESTING
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <stdio.h>
+
+#include <chrono>
+
+// One line of key=value pairs on stderr, loop() only (setup excluded):
+// real time per iteration, heap calls and bytes on each simulated bus
+static void printBench(const char* name, unsigned long loops, double wallNs,
+                       const NativeStats& a, const NativeStats& b,
+                       uint64_t i2cBytes, uint64_t fakeUs) {
+  double n = loops ? (double)loops : 1.0;
+  fprintf(stderr,
+          "bench: name=%s loops=%lu ns/loop=%.1f loops/s=%.0f fake_s=%.1f "
+          "allocs/loop=%.2f alloc_bytes/loop=%.1f live_allocs=%lld setup_allocs=%llu "
+          "i2c_bytes/loop=%.1f serial_bytes/loop=%.1f onewire_bytes/loop=%.2f "
+          "net_rx/loop=%.1f net_tx/loop=%.1f gpio/loop=%.2f adc/loop=%.2f ledc/loop=%.2f\n",
+          name, loops, wallNs / n, wallNs > 0 ? n * 1e9 / wallNs : 0.0, fakeUs / 1e6,
+          (b.allocs - a.allocs) / n, (b.allocBytes - a.allocBytes) / n,
+          (long long)(b.allocs - b.frees), (unsigned long long)a.allocs,
+          i2cBytes / n, (b.serialBytes - a.serialBytes) / n, (b.oneWireBytes - a.oneWireBytes) / n,
+          (b.netRxBytes - a.netRxBytes) / n, (b.netTxBytes - a.netTxBytes) / n,
+          (b.gpioWrites - a.gpioWrites) / n, (b.adcReads - a.adcReads) / n,
+          (b.ledcWrites - a.ledcWrites) / n);
+}
+
+// ---- Entry point ----
+// --loops N     loop() iterations (default 1000)
+// --tick-us N   fake time added after every loop() (default 1000)
+// --bench NAME  print the per-loop cost line for NAME on stderr
+int main(int argc, char** argv) {
+  unsigned long loops = 1000;
+  unsigned long tickUs = 1000;
+  const char* bench = nullptr;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--loops"))   loops  = strtoul(argv[i + 1], nullptr, 10);
+    if (!strcmp(argv[i], "--tick-us")) tickUs = strtoul(argv[i + 1], nullptr, 10);
+    if (!strcmp(argv[i], "--bench"))   bench  = argv[i + 1];
+  }
+
+  setup();
+
+  NativeStats before = nativeStats();
+  uint64_t i2cBefore = Wire.stats().bytes;
+  uint64_t fakeBefore = nativeMicros64();
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned long i = 0; i < loops; i++) {
+    loop();
+    nativeTick(tickUs);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  if (bench) {
+    printBench(bench, loops, std::chrono::duration<double, std::nano>(end - start).count(),
+               before, nativeStats(), Wire.stats().bytes - i2cBefore,
+               nativeMicros64() - fakeBefore);
+  }
+
+  const I2cBusStats& bus = Wire.stats();
+  fprintf(stderr, "I2C: %u transactions, %llu bytes, %.1f ms bus time\n",
+          bus.transactions, (unsigned long long)bus.bytes,
+          bus.busTimeUs / 1000.0);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "Print.h"
+#include "WString.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t* buf, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buf++);
+  return n;
+}
+
+size_t Print::write(const char* s) {
+  return s ? write((const uint8_t*)s, strlen(s)) : 0;
+}
+
+size_t Print::print(const char* s)               { return write(s); }
+size_t Print::print(char c)                      { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base)   { return print((unsigned long)n, base); }
+size_t Print::print(int n, int base)             { return print((long)n, base); }
+size_t Print::print(unsigned int n, int base)    { return print((unsigned long)n, base); }
+
+size_t Print::print(long n, int base) {
+  if (base == 0) return write((uint8_t)n);
+  if (base == 10 && n < 0) {
+    size_t t = print('-');
+    return t + printNumber(-(unsigned long)n, 10);
+  }
+  return printNumber((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  if (base == 0) return write((uint8_t)n);
+  return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) { return printFloat(n, digits); }
+size_t Print::print(const String& s)      { return write((const uint8_t*)s.c_str(), s.length()); }
+
+size_t Print::println()                              { return write((uint8_t)'\r') + write((uint8_t)'\n'); }
+size_t Print::println(const char* s)                 { size_t n = print(s); return n + println(); }
+size_t Print::println(char c)                        { size_t n = print(c); return n + println(); }
+size_t Print::println(unsigned char v, int base)     { size_t n = print(v, base); return n + println(); }
+size_t Print::println(int v, int base)               { size_t n = print(v, base); return n + println(); }
+size_t Print::println(unsigned int v, int base)      { size_t n = print(v, base); return n + println(); }
+size_t Print::println(long v, int base)              { size_t n = print(v, base); return n + println(); }
+size_t Print::println(unsigned long v, int base)     { size_t n = print(v, base); return n + println(); }
+size_t Print::println(double v, int digits)          { size_t n = print(v, digits); return n + println(); }
+size_t Print::println(const String& s)               { size_t n = print(s); return n + println(); }
+size_t Print::println(const Printable& x)            { size_t n = print(x); return n + println(); }
+
+size_t Print::printf(const char* format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+  return write((const uint8_t*)buf, len);
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base) {
+  char buf[8 * sizeof(long) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+
+  return write(str);
+}
+
+// Same algorithm as the Arduino core, including its rounding
+size_t Print::printFloat(double number, uint8_t digits) {
+  size_t n = 0;
+
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0)  return print("ovf");
+  if (number < -4294967040.0) return print("ovf");
+
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0;
+  number += rounding;
+
+  unsigned long intPart = (unsigned long)number;
+  double remainder = number - (double)intPart;
+  n += print(intPart);
+
+  if (digits > 0) n += print('.');
+
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int toPrint = (unsigned int)remainder;
+    n += print(toPrint);
+    remainder -= toPrint;
+  }
+  return n;
+}
@@ -0,0 +1,63 @@
+/****************************************************
+ * Print
+ * Arduino-compatible Print base class. Number formatting
+ * follows the Arduino core (same float rounding), so text
+ * rendered on the host matches the board.
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print;
+class String;
+
+// Anything that knows how to print itself (IPAddress)
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t size);
+  size_t write(const char* s);
+
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+  size_t print(const String& s);
+  size_t print(const Printable& x) { return x.printTo(*this); }
+
+  size_t println();
+  size_t println(const char* s);
+  size_t println(char c);
+  size_t println(unsigned char n, int base = DEC);
+  size_t println(int n, int base = DEC);
+  size_t println(unsigned int n, int base = DEC);
+  size_t println(long n, int base = DEC);
+  size_t println(unsigned long n, int base = DEC);
+  size_t println(double n, int digits = 2);
+  size_t println(const String& s);
+  size_t println(const Printable& x);
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+  size_t printNumber(unsigned long n, uint8_t base);
+  size_t printFloat(double number, uint8_t digits);
+};
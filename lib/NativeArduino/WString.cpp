@@ -0,0 +1,207 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+String::String(const char* s) : _heap(nullptr), _len(0), _cap(SSO_CAP) {
+  _sso[0] = 0;
+  if (s) concat(s);
+}
+
+String::String(const String& s) : String() {
+  concat(s);
+}
+
+String::String(String&& s) noexcept : _heap(s._heap), _len(s._len), _cap(s._cap) {
+  memcpy(_sso, s._sso, sizeof(_sso));
+  s._heap = nullptr;
+  s._len = 0;
+  s._cap = SSO_CAP;
+  s._sso[0] = 0;
+}
+
+String::String(char c) : String() {
+  concat(c);
+}
+
+String::String(int v, unsigned char base) : String((long)v, base) {}
+String::String(unsigned int v, unsigned char base) : String((unsigned long)v, base) {}
+
+String::String(long v, unsigned char base) : String() {
+  if (base == 10) {
+    char tmp[24];
+    snprintf(tmp, sizeof(tmp), "%ld", v);
+    concat(tmp);
+  } else {
+    *this = String((unsigned long)v, base);
+  }
+}
+
+String::String(unsigned long v, unsigned char base) : String() {
+  char tmp[8 * sizeof(long) + 1];
+  char* p = tmp + sizeof(tmp);
+  *--p = 0;
+  if (base < 2) base = 10;
+  do {
+    char d = v % base;
+    v /= base;
+    *--p = d < 10 ? d + '0' : d + 'a' - 10;
+  } while (v);
+  concat(p);
+}
+
+String::String(float v, unsigned char decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned char decimals) : String() {
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "%.*f", decimals, v);
+  concat(tmp);
+}
+
+String::~String() {
+  delete[] _heap;
+}
+
+String& String::operator=(const String& s) {
+  if (this != &s) {
+    _len = 0;
+    buf()[0] = 0;
+    concat(s);
+  }
+  return *this;
+}
+
+String& String::operator=(String&& s) noexcept {
+  if (this != &s) {
+    delete[] _heap;
+    _heap = s._heap;
+    _len = s._len;
+    _cap = s._cap;
+    memcpy(_sso, s._sso, sizeof(_sso));
+    s._heap = nullptr;
+    s._len = 0;
+    s._cap = SSO_CAP;
+    s._sso[0] = 0;
+  }
+  return *this;
+}
+
+String& String::operator=(const char* s) {
+  _len = 0;
+  buf()[0] = 0;
+  if (s) concat(s);
+  return *this;
+}
+
+// Like the core's changeBuffer(): a new block of (size + 16) & ~15,
+// contents copied over, old block freed. Never shrinks.
+bool String::reserve(unsigned int size) {
+  if (size <= _cap) return true;
+
+  unsigned int bytes = (size + 16) & ~15u;
+  char* block = new char[bytes];
+  memcpy(block, buf(), _len + 1);
+  delete[] _heap;
+  _heap = block;
+  _cap = bytes - 1;
+  return true;
+}
+
+bool String::concat(const char* s, unsigned int len) {
+  if (!s) return false;
+  if (!len) return true;
+  // s may point into this string (s += s), find it again after reserve()
+  bool self = s >= buf() && s <= buf() + _len;
+  size_t offset = self ? s - buf() : 0;
+  reserve(_len + len);
+  if (self) s = buf() + offset;
+  memmove(buf() + _len, s, len);
+  _len += len;
+  buf()[_len] = 0;
+  return true;
+}
+
+bool String::concat(const char* s) {
+  return s ? concat(s, strlen(s)) : false;
+}
+
+bool String::concat(int v)           { return concat(String(v)); }
+bool String::concat(unsigned int v)  { return concat(String(v)); }
+bool String::concat(long v)          { return concat(String(v)); }
+bool String::concat(unsigned long v) { return concat(String(v)); }
+bool String::concat(float v)         { return concat(String(v)); }
+bool String::concat(double v)        { return concat(String(v)); }
+
+int String::indexOf(char c, unsigned int from) const {
+  if (from >= _len) return -1;
+  const char* p = strchr(buf() + from, c);
+  return p ? (int)(p - buf()) : -1;
+}
+
+int String::indexOf(const char* s, unsigned int from) const {
+  if (from > _len) return -1;
+  const char* p = strstr(buf() + from, s);
+  return p ? (int)(p - buf()) : -1;
+}
+
+bool String::startsWith(const char* s) const {
+  size_t n = strlen(s);
+  return n <= _len && strncmp(buf(), s, n) == 0;
+}
+
+bool String::endsWith(const char* s) const {
+  size_t n = strlen(s);
+  return n <= _len && strcmp(buf() + _len - n, s) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) {
+    unsigned int t = from;
+    from = to;
+    to = t;
+  }
+  if (from >= _len) return String();
+  if (to > _len) to = _len;
+  String out;
+  out.concat(buf() + from, to - from);
+  return out;
+}
+
+long String::toInt() const {
+  return strtol(buf(), nullptr, 10);
+}
+
+float String::toFloat() const {
+  return strtof(buf(), nullptr);
+}
+
+void String::trim() {
+  char* b = buf();
+  unsigned int start = 0;
+  while (start < _len && isspace((unsigned char)b[start])) start++;
+  unsigned int end = _len;
+  while (end > start && isspace((unsigned char)b[end - 1])) end--;
+  _len = end - start;
+  memmove(b, b + start, _len);
+  b[_len] = 0;
+}
+
+void String::toUpperCase() {
+  for (unsigned int i = 0; i < _len; i++) buf()[i] = toupper((unsigned char)buf()[i]);
+}
+
+void String::toLowerCase() {
+  for (unsigned int i = 0; i < _len; i++) buf()[i] = tolower((unsigned char)buf()[i]);
+}
+
+bool String::equals(const char* s) const {
+  return strcmp(buf(), s ? s : "") == 0;
+}
+
+String operator+(const char* a, const String& b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
@@ -0,0 +1,97 @@
+/****************************************************
+ * String (native)
+ * The part of Arduino's String the sketches use. Memory
+ * follows the ESP32 core: up to 10 characters live inside
+ * the object, longer strings get a heap block rounded up
+ * to 16 bytes and reallocated each time they outgrow it.
+ * Every block goes through operator new, which the native
+ * build counts (see nativeStats()).
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class String {
+public:
+  String(const char* s = "");
+  String(const String& s);
+  String(String&& s) noexcept;
+  explicit String(char c);
+  explicit String(int v, unsigned char base = 10);
+  explicit String(unsigned int v, unsigned char base = 10);
+  explicit String(long v, unsigned char base = 10);
+  explicit String(unsigned long v, unsigned char base = 10);
+  explicit String(float v, unsigned char decimals = 2);
+  explicit String(double v, unsigned char decimals = 2);
+  ~String();
+
+  String& operator=(const String& s);
+  String& operator=(String&& s) noexcept;
+  String& operator=(const char* s);
+
+  bool reserve(unsigned int size);
+  unsigned int length() const { return _len; }
+  const char* c_str() const { return buf(); }
+
+  bool concat(const char* s, unsigned int len);
+  bool concat(const char* s);
+  bool concat(const String& s) { return concat(s.c_str(), s._len); }
+  bool concat(char c) { return concat(&c, 1); }
+  bool concat(int v);
+  bool concat(unsigned int v);
+  bool concat(long v);
+  bool concat(unsigned long v);
+  bool concat(float v);
+  bool concat(double v);
+
+  template <typename T>
+  String& operator+=(const T& v) {
+    concat(v);
+    return *this;
+  }
+
+  char charAt(unsigned int i) const { return i < _len ? buf()[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const char* s, unsigned int from = 0) const;
+  int indexOf(const String& s, unsigned int from = 0) const { return indexOf(s.c_str(), from); }
+  bool startsWith(const char* s) const;
+  bool startsWith(const String& s) const { return startsWith(s.c_str()); }
+  bool endsWith(const char* s) const;
+  String substring(unsigned int from, unsigned int to = 0xFFFFFFFF) const;
+  long toInt() const;
+  float toFloat() const;
+  void trim();
+  void toUpperCase();
+  void toLowerCase();
+
+  bool equals(const char* s) const;
+  bool equals(const String& s) const { return equals(s.c_str()); }
+  bool operator==(const char* s) const { return equals(s); }
+  bool operator==(const String& s) const { return equals(s); }
+  bool operator!=(const char* s) const { return !equals(s); }
+  bool operator!=(const String& s) const { return !equals(s); }
+
+private:
+  static const unsigned int SSO_CAP = 10;
+
+  char* buf() { return _heap ? _heap : _sso; }
+  const char* buf() const { return _heap ? _heap : _sso; }
+
+  char*        _heap;    // nullptr while the text fits _sso
+  unsigned int _len;
+  unsigned int _cap;     // characters, without the \0
+  char         _sso[SSO_CAP + 1];
+};
+
+// s + anything concat() takes (text, char, numbers)
+template <typename T>
+String operator+(const String& a, const T& b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+
+String operator+(const char* a, const String& b);
@@ -0,0 +1,45 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+bool TwoWire::begin(int sda, int scl, uint32_t freq) {
+  if (freq) _clockHz = freq;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _inTx = true;
+  _txLen = 1;  // address byte
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (!_inTx || _txLen >= I2C_BUFFER_LENGTH + 1) return 0;
+  _txLen++;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* buf, size_t size) {
+  size_t n = 0;
+  while (n < size && write(buf[n])) n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  if (!_inTx) return 4;
+  _inTx = false;
+
+  _stats.transactions++;
+  _stats.bytes += _txLen;
+  // 9 clocks per byte (8 data + ACK), ~2 more for start and stop
+  uint64_t clocks = _txLen * 9ULL + 2;
+  _stats.busTimeUs += clocks * 1000000ULL / _clockHz;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  return 0;
+}
+
+void TwoWire::resetStats() {
+  _stats = I2cBusStats();
+}
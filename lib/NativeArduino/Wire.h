@@ -0,0 +1,46 @@
+/****************************************************
+ * Wire (native)
+ * TwoWire that goes nowhere but counts what would have
+ * been on the bus: transactions, bytes (address byte
+ * included) and the time that takes at the set clock.
+ ****************************************************/
+#pragma once
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH 128   // same as the ESP32 core
+
+struct I2cBusStats {
+  uint32_t transactions;
+  uint64_t bytes;
+  uint64_t busTimeUs;    // 9 clocks per byte + start/stop
+};
+
+class TwoWire : public Print {
+public:
+  bool    begin() { return true; }
+  bool    begin(int sda, int scl, uint32_t freq = 0);
+  void    setClock(uint32_t hz) { _clockHz = hz; }
+  uint32_t getClock() const { return _clockHz; }
+
+  void    beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t  write(uint8_t c) override;
+  size_t  write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+  int     available() { return 0; }
+  int     read() { return -1; }
+
+  const I2cBusStats& stats() const { return _stats; }
+  void    resetStats();
+
+private:
+  uint32_t    _clockHz = 100000;
+  uint16_t    _txLen = 0;
+  bool        _inTx = false;
+  I2cBusStats _stats = {};
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,234 @@
+#include "RingLog.h"
+#include <FixedFmt.h>
+
+#include <stdio.h>
+
+#define RLOG_MASK (RLOG_SLOTS - 1)
+static_assert((RLOG_SLOTS & RLOG_MASK) == 0, "RLOG_SLOTS must be a power of two");
+
+// Slot i is free for position p when seq == p, holds a record for the
+// reader when seq == p + 1. seq is stored minus i, so the zeroed table
+// is already a valid empty ring and logging works before setup().
+static RingLogRecord s_slots[RLOG_SLOTS];
+static uint32_t s_writePos = 0;    // next position to claim, shared by producers
+static uint32_t s_readPos = 0;     // drainer only
+static uint32_t s_reportedDrops = 0;
+static RingLogStats s_stats;
+
+static inline uint32_t loadAcquire(const uint32_t* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+RingLogRecord* IRAM_ATTR ringLogClaim(uint32_t& pos) {
+  pos = __atomic_load_n(&s_writePos, __ATOMIC_RELAXED);
+  for (;;) {
+    uint32_t i = pos & RLOG_MASK;
+    RingLogRecord* r = &s_slots[i];
+    int32_t diff = (int32_t)(loadAcquire(&r->seq) + i - pos);
+
+    if (diff == 0) {
+      // Free: take it unless another producer got there first
+      if (__atomic_compare_exchange_n(&s_writePos, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        uint32_t used = pos + 1 - __atomic_load_n(&s_readPos, __ATOMIC_RELAXED);
+        if (used > s_stats.maxUsed) s_stats.maxUsed = used;  // racy, a hint
+        r->us = micros();
+        return r;
+      }
+      // pos was reloaded by the failed exchange
+    } else if (diff < 0) {
+      // Still holds an undrained record from one lap ago: full
+      __atomic_fetch_add(&s_stats.dropped, 1, __ATOMIC_RELAXED);
+      return nullptr;
+    } else {
+      pos = __atomic_load_n(&s_writePos, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+void IRAM_ATTR ringLogPublish(RingLogRecord* r, uint32_t pos) {
+  __atomic_fetch_add(&s_stats.written, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&r->seq, pos + 1 - (pos & RLOG_MASK), __ATOMIC_RELEASE);
+}
+
+void IRAM_ATTR ringLogIsr(uint8_t level, const char* fmt, uint32_t a, uint32_t b) {
+  uint32_t pos;
+  RingLogRecord* r = ringLogClaim(pos);
+  if (!r) return;
+  r->level = level;
+  r->fmt = fmt;
+  r->nargs = 2;
+  r->textLen = 0;
+  r->types[0] = RLOG_ARG_UINT;
+  r->types[1] = RLOG_ARG_UINT;
+  r->args[0].u = a;
+  r->args[1].u = b;
+  ringLogPublish(r, pos);
+}
+
+// ---- Formatting, drain side only ----
+
+// printf for one record. Every conversion is formatted on its own with
+// the type the argument was stored as, so a %d given a float prints a
+// number, not garbage. Length modifiers are ignored: all args are 32-bit.
+static size_t formatRecord(const RingLogRecord& r, char* line, size_t size) {
+  size_t n = 0;
+  uint8_t arg = 0;
+  const char* p = r.fmt;
+
+  while (*p && n < size - 1) {
+    if (*p != '%') {
+      line[n++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      line[n++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // Copy "%[flags][width][.prec]" into spec, skip length modifiers
+    char spec[16];
+    uint8_t s = 0;
+    const char* start = p;
+    spec[s++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && s < sizeof(spec) - 3) spec[s++] = *p++;
+    while (*p && strchr("hlLqjzt", *p)) p++;
+    char conv = *p;
+    if (!conv) break;
+    p++;
+
+    if (arg >= r.nargs) {
+      // Missing argument: show the conversion as written
+      size_t len = p - start;
+      if (len > size - 1 - n) len = size - 1 - n;
+      memcpy(line + n, start, len);
+      n += len;
+      continue;
+    }
+
+    const RingLogArg& v = r.args[arg];
+    uint8_t type = r.types[arg++];
+    int w;
+    spec[s + 1] = 0;
+
+    switch (conv) {
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+        float f = type == RLOG_ARG_FLOAT ? v.f : type == RLOG_ARG_INT ? v.i : (float)v.u;
+        // Plain "%.Nf" (the usual sensor case) skips printf, same text
+        if (conv == 'f' && s == 3 && spec[1] == '.' &&
+            spec[2] >= '0' && spec[2] <= '0' + FIXED_MAX_DECIMALS) {
+          w = fmtFixed(line + n, size - n, f, spec[2] - '0');
+          break;
+        }
+        spec[s] = conv;
+        w = snprintf(line + n, size - n, spec, (double)f);
+        break;
+      }
+      case 's':
+        spec[s] = 's';
+        w = snprintf(line + n, size - n, spec, type == RLOG_ARG_STR ? r.text + v.u : "?");
+        break;
+      case 'd': case 'i':
+        spec[s] = 'd';
+        w = snprintf(line + n, size - n, spec,
+                     type == RLOG_ARG_FLOAT ? (int)v.f : (int)v.i);
+        break;
+      default:  // u x X o c p
+        spec[s] = conv == 'p' ? 'x' : conv;
+        w = snprintf(line + n, size - n, spec,
+                     type == RLOG_ARG_FLOAT ? (unsigned)v.f : (unsigned)v.u);
+        break;
+    }
+    if (w > 0) n += (size_t)w < size - n ? (size_t)w : size - 1 - n;
+  }
+  line[n] = 0;
+  return n;
+}
+
+static const char s_levelChar[] = { 'D', 'I', 'W', 'E' };
+
+uint32_t ringLogDrain(Print& out, uint32_t max) {
+  char line[RLOG_LINE + 24];
+  uint32_t done = 0;
+
+  while (done < max) {
+    uint32_t dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED);
+    if (dropped != s_reportedDrops) {
+      int n = snprintf(line, sizeof(line), "[ringlog] %lu messages dropped\n",
+                       (unsigned long)(dropped - s_reportedDrops));
+      out.write((const uint8_t*)line, n);
+      s_reportedDrops = dropped;
+    }
+
+    uint32_t pos = s_readPos;
+    uint32_t i = pos & RLOG_MASK;
+    RingLogRecord& r = s_slots[i];
+    if (loadAcquire(&r.seq) + i != pos + 1) break;  // empty, or claimed but not published
+
+    // Prefix: seconds.millis and level, like "[  12.345] I "
+    uint32_t ms = r.us / 1000;
+    int n = snprintf(line, sizeof(line), "[%5lu.%03lu] %c ", (unsigned long)(ms / 1000),
+                     (unsigned long)(ms % 1000), r.level < 4 ? s_levelChar[r.level] : '?');
+    n += formatRecord(r, line + n, RLOG_LINE);
+    line[n++] = '\n';
+
+    // Hand the slot back before the slow part
+    __atomic_store_n(&r.seq, pos + RLOG_SLOTS - i, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_readPos, pos + 1, __ATOMIC_RELAXED);
+
+    out.write((const uint8_t*)line, n);
+    s_stats.drained++;
+    done++;
+  }
+  return done;
+}
+
+RingLogStats ringLogStats() {
+  return s_stats;
+}
+
+void ringLogResetStats() {
+  uint32_t dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED);
+  s_stats.written = 0;
+  s_stats.drained = 0;
+  s_stats.maxUsed = 0;
+  __atomic_fetch_sub(&s_stats.dropped, dropped, __ATOMIC_RELAXED);
+  s_reportedDrops -= dropped;
+}
+
+#ifdef ESP32
+
+#define RLOG_DRAIN_MS 10
+
+static Print* s_out = nullptr;
+
+static void drainTask(void* arg) {
+  for (;;) {
+    ringLogDrain(*s_out);
+    vTaskDelay(pdMS_TO_TICKS(RLOG_DRAIN_MS));
+  }
+}
+
+bool ringLogBegin(Print& out, UBaseType_t priority, BaseType_t core) {
+  if (s_out) return false;
+  s_out = &out;
+  return xTaskCreatePinnedToCore(drainTask, "ringlog", 3072, nullptr,
+                                 priority, nullptr, core) == pdPASS;
+}
+
+#elif defined(NATIVE_ARDUINO)
+
+static Print* s_out = nullptr;
+
+static void drainAfterLoop() {
+  ringLogDrain(*s_out);
+}
+
+bool ringLogBegin(Print& out) {
+  if (s_out) return false;
+  s_out = &out;
+  return nativeOnLoop(drainAfterLoop);
+}
+
+#endif
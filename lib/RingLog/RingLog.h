@@ -0,0 +1,176 @@
+/****************************************************
+ * RingLog
+ * Logging that never waits for the UART.
+ *
+ *   ringLogBegin(Serial);                 // in setup()
+ *   RLOG_I("Temp: %.1f C", t);            // any task
+ *   RLOG_ISR(RLOG_LEVEL_WARN, "late %u", n, 0);   // ISR
+ *
+ * A log call only stores the format pointer, a timestamp
+ * and the arguments in a ring slot; the text is built
+ * later by a low-priority drain task that owns Serial. A
+ * call costs a slot claim and a few copies, never a
+ * printf, and when the ring is full the record is counted
+ * as dropped instead of blocking. The drain task prints
+ * the count in the stream.
+ *
+ * The ring is a bounded multi-producer queue (one
+ * compare-and-swap to claim, a per-slot sequence number
+ * to publish), no locks: any number of tasks on both
+ * cores and ISRs can log at once. A producer preempted
+ * between claim and publish only holds the drain back
+ * until it resumes.
+ *
+ * Arguments are 32-bit: integers, float/double (stored as
+ * float) and strings. The format must be a literal, but
+ * string arguments are copied (RLOG_TEXT bytes for all of
+ * them in one record), so String and stack buffers are
+ * fine. ISRs get RLOG_ISR with two integers only: no
+ * floats in an ISR, no string copies in IRAM.
+ *
+ * Levels below RLOG_LEVEL compile to nothing, arguments
+ * included, so don't put side effects in them.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#define RLOG_LEVEL_DEBUG  0
+#define RLOG_LEVEL_INFO   1
+#define RLOG_LEVEL_WARN   2
+#define RLOG_LEVEL_ERROR  3
+#define RLOG_LEVEL_NONE   4
+
+#ifndef RLOG_LEVEL
+#define RLOG_LEVEL RLOG_LEVEL_INFO
+#endif
+
+#ifndef RLOG_SLOTS
+#define RLOG_SLOTS 32        // power of two
+#endif
+#define RLOG_MAX_ARGS  6
+#define RLOG_TEXT      48    // copied string arguments, per record
+#define RLOG_LINE      160   // longest formatted line
+
+enum RingLogArgType : uint8_t { RLOG_ARG_INT, RLOG_ARG_UINT, RLOG_ARG_FLOAT, RLOG_ARG_STR };
+
+union RingLogArg {
+  int32_t  i;
+  uint32_t u;
+  float    f;
+};
+
+struct RingLogRecord {
+  uint32_t    seq;           // ring sequence, owned by RingLog.cpp
+  uint32_t    us;
+  const char* fmt;
+  uint8_t     level;
+  uint8_t     nargs;
+  uint8_t     textLen;
+  uint8_t     types[RLOG_MAX_ARGS];
+  RingLogArg  args[RLOG_MAX_ARGS];
+  char        text[RLOG_TEXT];   // string arguments, each \0 terminated
+};
+
+struct RingLogStats {
+  uint32_t written;
+  uint32_t dropped;    // ring full
+  uint32_t drained;
+  uint32_t maxUsed;    // high water mark, slots
+};
+
+// Producer side, used by the macros below
+RingLogRecord* ringLogClaim(uint32_t& pos);
+void           ringLogPublish(RingLogRecord* r, uint32_t pos);
+void           ringLogIsr(uint8_t level, const char* fmt, uint32_t a, uint32_t b);
+
+// Consumer side: one drainer at a time. ringLogBegin() starts a task that
+// calls ringLogDrain() (on the PC: after every loop()); without it call
+// it yourself.
+#ifdef ESP32
+bool     ringLogBegin(Print& out, UBaseType_t priority = 1, BaseType_t core = 0);
+#elif defined(NATIVE_ARDUINO)
+bool     ringLogBegin(Print& out);   // drained after every loop() instead
+#endif
+uint32_t ringLogDrain(Print& out, uint32_t max = UINT32_MAX);
+RingLogStats ringLogStats();
+void     ringLogResetStats();
+
+inline void ringLogPut(RingLogRecord& r, RingLogArgType type, RingLogArg v) {
+  r.types[r.nargs] = type;
+  r.args[r.nargs++] = v;
+}
+
+inline void ringLogPut(RingLogRecord& r, int v)           { RingLogArg a; a.i = v;           ringLogPut(r, RLOG_ARG_INT, a); }
+inline void ringLogPut(RingLogRecord& r, long v)          { RingLogArg a; a.i = (int32_t)v;  ringLogPut(r, RLOG_ARG_INT, a); }
+inline void ringLogPut(RingLogRecord& r, unsigned v)      { RingLogArg a; a.u = v;           ringLogPut(r, RLOG_ARG_UINT, a); }
+inline void ringLogPut(RingLogRecord& r, unsigned long v) { RingLogArg a; a.u = (uint32_t)v; ringLogPut(r, RLOG_ARG_UINT, a); }
+inline void ringLogPut(RingLogRecord& r, long long v)     { RingLogArg a; a.i = (int32_t)v;  ringLogPut(r, RLOG_ARG_INT, a); }
+inline void ringLogPut(RingLogRecord& r, unsigned long long v) { RingLogArg a; a.u = (uint32_t)v; ringLogPut(r, RLOG_ARG_UINT, a); }
+inline void ringLogPut(RingLogRecord& r, double v)        { RingLogArg a; a.f = (float)v;    ringLogPut(r, RLOG_ARG_FLOAT, a); }
+inline void ringLogPut(RingLogRecord& r, float v)         { RingLogArg a; a.f = v;           ringLogPut(r, RLOG_ARG_FLOAT, a); }
+
+// Strings are copied, cut to what is left of text[] (the last byte
+// stays \0, so a string that found no room reads as "")
+inline void ringLogPut(RingLogRecord& r, const char* s) {
+  RingLogArg a;
+  a.u = r.textLen;
+  if (!s) s = "(null)";
+  uint8_t i = r.textLen;
+  while (*s && i < RLOG_TEXT - 1) r.text[i++] = *s++;
+  r.text[i] = 0;
+  r.textLen = i + 1 < RLOG_TEXT - 1 ? i + 1 : RLOG_TEXT - 1;
+  ringLogPut(r, RLOG_ARG_STR, a);
+}
+
+inline void ringLogPut(RingLogRecord& r, char* s) { ringLogPut(r, (const char*)s); }
+
+#if defined(ESP32) || defined(NATIVE_ARDUINO)
+inline void ringLogPut(RingLogRecord& r, const String& s) { ringLogPut(r, s.c_str()); }
+#endif
+
+template <typename... Args>
+inline void ringLog(uint8_t level, const char* fmt, const Args&... args) {
+  static_assert(sizeof...(Args) <= RLOG_MAX_ARGS, "RingLog: too many arguments");
+  uint32_t pos;
+  RingLogRecord* r = ringLogClaim(pos);
+  if (!r) return;
+  r->level = level;
+  r->fmt = fmt;
+  r->nargs = 0;
+  r->textLen = 0;
+  r->text[RLOG_TEXT - 1] = 0;
+  int expand[] = { 0, (ringLogPut(*r, args), 0)... };
+  (void)expand;
+  ringLogPublish(r, pos);
+}
+
+// "" fmt "" only compiles for a literal: the pointer has to outlive the call
+#if RLOG_LEVEL <= RLOG_LEVEL_DEBUG
+#define RLOG_D(fmt, ...)  ringLog(RLOG_LEVEL_DEBUG, "" fmt "", ##__VA_ARGS__)
+#else
+#define RLOG_D(fmt, ...)  ((void)0)
+#endif
+
+#if RLOG_LEVEL <= RLOG_LEVEL_INFO
+#define RLOG_I(fmt, ...)  ringLog(RLOG_LEVEL_INFO, "" fmt "", ##__VA_ARGS__)
+#else
+#define RLOG_I(fmt, ...)  ((void)0)
+#endif
+
+#if RLOG_LEVEL <= RLOG_LEVEL_WARN
+#define RLOG_W(fmt, ...)  ringLog(RLOG_LEVEL_WARN, "" fmt "", ##__VA_ARGS__)
+#else
+#define RLOG_W(fmt, ...)  ((void)0)
+#endif
+
+#if RLOG_LEVEL <= RLOG_LEVEL_ERROR
+#define RLOG_E(fmt, ...)  ringLog(RLOG_LEVEL_ERROR, "" fmt "", ##__VA_ARGS__)
+#else
+#define RLOG_E(fmt, ...)  ((void)0)
+#endif
+
+// level is a constant, the test folds away
+#define RLOG_ISR(level, fmt, a, b) do { \
+  if ((level) >= RLOG_LEVEL) ringLogIsr((level), "" fmt "", (uint32_t)(a), (uint32_t)(b)); \
+} while (0)
@@ -0,0 +1,169 @@
+#include "Adafruit_SSD1306.h"
+#include "SSD1306Emu.h"
+
+#define swapInt16(a, b) { int16_t t = a; a = b; b = t; }
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin,
+                                   uint32_t clkDuring, uint32_t clkAfter)
+  : Adafruit_GFX(w, h), wire(twi), buffer(nullptr), i2caddr(0x3C),
+    wireClk(clkDuring), restoreClk(clkAfter), renderStartNs(0), rendering(false) {
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t addr, bool reset, bool periphBegin) {
+  if (!buffer && !(buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) return false;
+  clearDisplay();
+  rendering = false;
+
+  i2caddr = addr ? addr : ((HEIGHT == 32) ? 0x3C : 0x3D);
+  if (periphBegin) wire->begin();
+
+  // Same init sequence as the real driver, for the byte count
+  static const uint8_t init[] = {
+    SSD1306_DISPLAYOFF, SSD1306_SETDISPLAYCLOCKDIV, 0x80, SSD1306_SETMULTIPLEX
+  };
+  ssd1306_commandList(init, sizeof(init));
+  ssd1306_command(HEIGHT - 1);
+
+  static const uint8_t init2[] = {
+    SSD1306_SETDISPLAYOFFSET, 0x00, SSD1306_SETSTARTLINE | 0x00, SSD1306_CHARGEPUMP
+  };
+  ssd1306_commandList(init2, sizeof(init2));
+  ssd1306_command(switchvcc == SSD1306_EXTERNALVCC ? 0x10 : 0x14);
+
+  static const uint8_t init3[] = {
+    SSD1306_MEMORYMODE, 0x00, SSD1306_SEGREMAP | 0x1, SSD1306_COMSCANDEC
+  };
+  ssd1306_commandList(init3, sizeof(init3));
+
+  static const uint8_t init4[] = {
+    SSD1306_SETCOMPINS, 0x12, SSD1306_SETCONTRAST, 0xCF
+  };
+  ssd1306_commandList(init4, sizeof(init4));
+
+  ssd1306_command(SSD1306_SETPRECHARGE);
+  ssd1306_command(switchvcc == SSD1306_EXTERNALVCC ? 0x22 : 0xF1);
+
+  static const uint8_t init5[] = {
+    SSD1306_SETVCOMDETECT, 0x40, SSD1306_DISPLAYALLON_RESUME,
+    SSD1306_NORMALDISPLAY, SSD1306_DEACTIVATE_SCROLL, SSD1306_DISPLAYON
+  };
+  ssd1306_commandList(init5, sizeof(init5));
+  return true;
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->setClock(wireClk);
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  wire->write(c);
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::ssd1306_commandList(const uint8_t* c, uint8_t n) {
+  wire->setClock(wireClk);
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  while (n--) wire->write(*c++);
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  if (buffer) memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+  renderStartNs = emuNowNs();
+  rendering = true;
+}
+
+void Adafruit_SSD1306::display() {
+  uint64_t renderNs = rendering ? emuNowNs() - renderStartNs : 0;
+  rendering = false;
+  if (!buffer) return;
+
+  static const uint8_t dlist1[] = {
+    SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0
+  };
+  ssd1306_commandList(dlist1, sizeof(dlist1));
+  ssd1306_command(WIDTH - 1);
+
+  // Data in buffer-sized transactions, 0x40 control byte each
+  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+  const uint8_t* ptr = buffer;
+  wire->setClock(wireClk);
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);
+  uint16_t bytesOut = 1;
+  while (count--) {
+    if (bytesOut >= I2C_BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40);
+      bytesOut = 1;
+    }
+    wire->write(*ptr++);
+    bytesOut++;
+  }
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+
+  emuFrameDone(*this, renderNs);
+}
+
+void Adafruit_SSD1306::invertDisplay(bool i) {
+  ssd1306_command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+  ssd1306_command(SSD1306_SETCONTRAST);
+  ssd1306_command(dim ? 0 : 0xCF);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || x < 0 || x >= width() || y < 0 || y >= height()) return;
+
+  switch (getRotation()) {
+    case 1: swapInt16(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: swapInt16(x, y); y = HEIGHT - y - 1; break;
+  }
+
+  uint8_t& b = buffer[x + (y / 8) * WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE:   b |= bit;  break;
+    case SSD1306_BLACK:   b &= ~bit; break;
+    case SSD1306_INVERSE: b ^= bit;  break;
+  }
+}
+
+// Pixel loops are fine here, only the result has to match the real driver
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (!buffer || x < 0 || x >= width() || y < 0 || y >= height()) return false;
+
+  switch (getRotation()) {
+    case 1: swapInt16(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: swapInt16(x, y); y = HEIGHT - y - 1; break;
+  }
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
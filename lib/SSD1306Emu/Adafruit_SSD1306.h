@@ -0,0 +1,83 @@
+/****************************************************
+ * Adafruit_SSD1306 (emulator)
+ * In-memory SSD1306 for the `native` env. Same page
+ * layout as the panel (byte = 8 vertical pixels, LSB on
+ * top). display() "sends" the frame through the native
+ * Wire exactly like the real driver, so the I2C byte count
+ * is what the board would put on the bus.
+ *
+ * See SSD1306Emu.h for frame dumps and render timing.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "Adafruit_GFX.h"
+
+#define SSD1306_BLACK    0
+#define SSD1306_WHITE    1
+#define SSD1306_INVERSE  2
+
+#ifndef NO_ADAFRUIT_SSD1306_COLOR_COMPATIBILITY
+#define BLACK    SSD1306_BLACK
+#define WHITE    SSD1306_WHITE
+#define INVERSE  SSD1306_INVERSE
+#endif
+
+#define SSD1306_MEMORYMODE           0x20
+#define SSD1306_COLUMNADDR           0x21
+#define SSD1306_PAGEADDR             0x22
+#define SSD1306_SETCONTRAST          0x81
+#define SSD1306_CHARGEPUMP           0x8D
+#define SSD1306_SEGREMAP             0xA0
+#define SSD1306_DISPLAYALLON_RESUME  0xA4
+#define SSD1306_NORMALDISPLAY        0xA6
+#define SSD1306_INVERTDISPLAY        0xA7
+#define SSD1306_SETMULTIPLEX         0xA8
+#define SSD1306_DISPLAYOFF           0xAE
+#define SSD1306_DISPLAYON            0xAF
+#define SSD1306_COMSCANDEC           0xC8
+#define SSD1306_SETDISPLAYOFFSET     0xD3
+#define SSD1306_SETDISPLAYCLOCKDIV   0xD5
+#define SSD1306_SETPRECHARGE         0xD9
+#define SSD1306_SETCOMPINS           0xDA
+#define SSD1306_SETVCOMDETECT        0xDB
+#define SSD1306_SETSTARTLINE         0x40
+#define SSD1306_DEACTIVATE_SCROLL    0x2E
+#define SSD1306_EXTERNALVCC          0x01
+#define SSD1306_SWITCHCAPVCC         0x02
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+  ~Adafruit_SSD1306();
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+             bool reset = true, bool periphBegin = true);
+  void display();
+  void clearDisplay();
+  void invertDisplay(bool i) override;
+  void dim(bool dim);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void startscrollright(uint8_t start, uint8_t stop) {}
+  void startscrollleft(uint8_t start, uint8_t stop) {}
+  void stopscroll() {}
+  void ssd1306_command(uint8_t c);
+  bool getPixel(int16_t x, int16_t y);
+  uint8_t* getBuffer() { return buffer; }
+
+protected:
+  void ssd1306_commandList(const uint8_t* c, uint8_t n);
+
+  TwoWire* wire;
+  uint8_t* buffer;
+  int8_t   i2caddr;
+  uint32_t wireClk;
+  uint32_t restoreClk;
+  uint64_t renderStartNs;  // real time, see SSD1306Emu.h
+  bool     rendering;
+};
@@ -0,0 +1,151 @@
+#include "SSD1306Emu.h"
+#include "Adafruit_SSD1306.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#define EMU_MAX_SCOPES 16
+
+struct EmuScopeStats {
+  const char* name;
+  uint32_t    count;
+  uint64_t    totalNs;
+  uint64_t    maxNs;
+};
+
+static EmuRenderStats        renderStats;
+static std::vector<uint8_t>  panel;   // what the emulated panel shows
+static EmuScopeStats         scopes[EMU_MAX_SCOPES];
+static uint8_t               scopeCount;
+static void                (*frameHook)(Adafruit_SSD1306&, uint32_t);
+
+uint64_t emuNowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+EmuRenderStats emuRenderStats() {
+  return renderStats;
+}
+
+// PBM P4: rows, MSB first, 1 = black. We write lit pixels as 1.
+bool emuSavePbm(Adafruit_SSD1306& d, const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+
+  int16_t w = d.width();
+  int16_t h = d.height();
+  fprintf(f, "P4\n%d %d\n", w, h);
+
+  for (int16_t y = 0; y < h; y++) {
+    uint8_t b = 0;
+    for (int16_t x = 0; x < w; x++) {
+      if (d.getPixel(x, y)) b |= 0x80 >> (x & 7);
+      if ((x & 7) == 7 || x == w - 1) {
+        fputc(b, f);
+        b = 0;
+      }
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+long emuDiffPbm(Adafruit_SSD1306& d, const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return -1;
+
+  int w, h;
+  if (fscanf(f, "P4 %d %d", &w, &h) != 2 || w != d.width() || h != d.height()) {
+    fclose(f);
+    return -1;
+  }
+  fgetc(f);  // single whitespace before the raster
+
+  long diff = 0;
+  int rowBytes = (w + 7) / 8;
+  std::vector<uint8_t> row(rowBytes);
+  for (int y = 0; y < h; y++) {
+    if (fread(row.data(), 1, rowBytes, f) != (size_t)rowBytes) {
+      fclose(f);
+      return -1;
+    }
+    for (int x = 0; x < w; x++) {
+      bool golden = row[x / 8] & (0x80 >> (x & 7));
+      if (golden != d.getPixel(x, y)) diff++;
+    }
+  }
+  fclose(f);
+  return diff;
+}
+
+long emuCheckGolden(Adafruit_SSD1306& d, const char* path) {
+  if (getenv("SSD1306_EMU_UPDATE_GOLDEN")) return emuSavePbm(d, path) ? 0 : -1;
+  return emuDiffPbm(d, path);
+}
+
+void emuOnFrame(void (*fn)(Adafruit_SSD1306& d, uint32_t frame)) {
+  frameHook = fn;
+}
+
+void emuFrameDone(Adafruit_SSD1306& d, uint64_t renderNs) {
+  renderStats.frames++;
+  renderStats.renderNs += renderNs;
+  if (renderNs > renderStats.maxRenderNs) renderStats.maxRenderNs = renderNs;
+
+  size_t size = d.width() * ((d.height() + 7) / 8);
+  const uint8_t* buf = d.getBuffer();
+  if (panel.size() == size && memcmp(panel.data(), buf, size) == 0) return;
+
+  panel.assign(buf, buf + size);
+  renderStats.changedFrames++;
+
+  const char* dir = getenv("SSD1306_EMU_FRAMES");
+  if (dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05u.pbm", dir, renderStats.changedFrames);
+    emuSavePbm(d, path);
+  }
+  if (frameHook) frameHook(d, renderStats.changedFrames);
+}
+
+EmuScope::EmuScope(const char* name) : _name(name), _start(emuNowNs()) {}
+
+EmuScope::~EmuScope() {
+  uint64_t took = emuNowNs() - _start;
+
+  EmuScopeStats* s = nullptr;
+  for (uint8_t i = 0; i < scopeCount && !s; i++) {
+    if (!strcmp(scopes[i].name, _name)) s = &scopes[i];
+  }
+  if (!s) {
+    if (scopeCount == EMU_MAX_SCOPES) return;
+    s = &scopes[scopeCount++];
+    s->name = _name;
+  }
+
+  s->count++;
+  s->totalNs += took;
+  if (took > s->maxNs) s->maxNs = took;
+}
+
+// Summary on exit
+static struct EmuReport {
+  ~EmuReport() {
+    const EmuRenderStats& r = renderStats;
+    if (r.frames == 0) return;
+
+    fprintf(stderr, "SSD1306: %u frames (%u changed), render avg %.1f us, max %.1f us\n",
+            r.frames, r.changedFrames,
+            r.renderNs / 1000.0 / r.frames, r.maxRenderNs / 1000.0);
+    for (uint8_t i = 0; i < scopeCount; i++) {
+      fprintf(stderr, "  %-20s n=%-8u avg %.2f us  max %.2f us\n", scopes[i].name,
+              scopes[i].count, scopes[i].totalNs / 1000.0 / scopes[i].count,
+              scopes[i].maxNs / 1000.0);
+    }
+  }
+} emuReport;
@@ -0,0 +1,51 @@
+/****************************************************
+ * SSD1306Emu
+ * Host-only helpers around the emulated Adafruit_SSD1306.
+ *
+ *  - frame dumps: set SSD1306_EMU_FRAMES=<dir> and every
+ *    display() that changes the panel writes frame_NNNNN.pbm
+ *  - golden images: emuDiffPbm() counts pixels that differ
+ *    from a saved PBM (0 = identical); emuCheckGolden() does
+ *    the same, or rewrites the file when SSD1306_EMU_UPDATE_GOLDEN
+ *    is set in the environment
+ *  - emuOnFrame() calls back on every frame that changes the
+ *    panel, for tests that check frames a loop() overwrites
+ *  - render timing (real CPU time, not the fake clock):
+ *    clearDisplay() -> display() is timed automatically,
+ *    EmuScope times any block under a name
+ *
+ * A summary is printed to stderr when the program exits.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+class Adafruit_SSD1306;
+
+struct EmuRenderStats {
+  uint32_t frames;         // display() calls
+  uint32_t changedFrames;  // frames that changed what the panel shows
+  uint64_t renderNs;       // clearDisplay() -> display(), summed
+  uint64_t maxRenderNs;
+};
+
+bool     emuSavePbm(Adafruit_SSD1306& d, const char* path);
+long     emuDiffPbm(Adafruit_SSD1306& d, const char* path);   // -1 if unreadable
+long     emuCheckGolden(Adafruit_SSD1306& d, const char* path);
+void     emuOnFrame(void (*fn)(Adafruit_SSD1306& d, uint32_t frame));   // nullptr to stop
+EmuRenderStats emuRenderStats();
+uint64_t emuNowNs();
+
+// Called by the emulated display(), not meant for sketches
+void     emuFrameDone(Adafruit_SSD1306& d, uint64_t renderNs);
+
+// Times the enclosing block, results are grouped by name
+class EmuScope {
+public:
+  explicit EmuScope(const char* name);
+  ~EmuScope();
+
+private:
+  const char* _name;
+  uint64_t    _start;
+};
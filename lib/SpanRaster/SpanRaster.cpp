@@ -0,0 +1,164 @@
+#include "SpanRaster.h"
+
+#include <string.h>
+
+static inline void applyByte(uint8_t& dst, uint8_t mask, uint16_t color) {
+  switch (color) {
+    case SSD1306_WHITE:   dst |= mask;  break;
+    case SSD1306_BLACK:   dst &= ~mask; break;
+    case SSD1306_INVERSE: dst ^= mask;  break;
+  }
+}
+
+// Bits lo..hi (inclusive) of a page byte
+static inline uint8_t rowMask(uint8_t lo, uint8_t hi) {
+  return (uint8_t)((0xFF << lo) & (0xFF >> (7 - hi)));
+}
+
+// ---- Clipped spans on the raw buffer (rotation 0 only) ----
+
+void SpanRaster::hspan(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  int16_t width = _display.width();
+  if (y < 0 || y >= _display.height()) return;
+  if (x < 0) { w += x; x = 0; }
+  if (x + w > width) w = width - x;
+  if (w <= 0) return;
+
+  uint8_t* p = _display.getBuffer() + (y / 8) * width + x;
+  uint8_t mask = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE:   while (w--) *p++ |= mask;  break;
+    case SSD1306_BLACK:   mask = ~mask; while (w--) *p++ &= mask; break;
+    case SSD1306_INVERSE: while (w--) *p++ ^= mask;  break;
+  }
+}
+
+void SpanRaster::vspan(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  int16_t width = _display.width();
+  if (x < 0 || x >= width) return;
+  if (y < 0) { h += y; y = 0; }
+  if (y + h > _display.height()) h = _display.height() - y;
+  if (h <= 0) return;
+
+  int16_t last = y + h - 1;
+  int16_t page = y / 8;
+  int16_t lastPage = last / 8;
+  uint8_t* p = _display.getBuffer() + page * width + x;
+
+  if (page == lastPage) {
+    applyByte(*p, rowMask(y & 7, last & 7), color);
+    return;
+  }
+
+  applyByte(*p, rowMask(y & 7, 7), color);
+  for (p += width, page++; page < lastPage; p += width, page++) {
+    applyByte(*p, 0xFF, color);
+  }
+  applyByte(*p, rowMask(0, last & 7), color);
+}
+
+void SpanRaster::fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  int16_t width = _display.width();
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width) w = width - x;
+  if (y + h > _display.height()) h = _display.height() - y;
+  if (w <= 0 || h <= 0) return;
+
+  int16_t last = y + h - 1;
+  uint8_t* buf = _display.getBuffer();
+
+  for (int16_t page = y / 8; page <= last / 8; page++) {
+    uint8_t lo = page == y / 8 ? (y & 7) : 0;
+    uint8_t hi = page == last / 8 ? (last & 7) : 7;
+    uint8_t mask = rowMask(lo, hi);
+    uint8_t* p = buf + page * width + x;
+
+    if (mask == 0xFF && color != SSD1306_INVERSE) {
+      memset(p, color == SSD1306_WHITE ? 0xFF : 0x00, w);  // 8 rows per byte
+      continue;
+    }
+    for (int16_t i = 0; i < w; i++) applyByte(p[i], mask, color);
+  }
+}
+
+// ---- Public API, same argument rules as GFX ----
+
+void SpanRaster::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (!direct()) { _display.drawFastHLine(x, y, w, color); return; }
+  if (w < 0) { x += w + 1; w = -w; }
+  hspan(x, y, w, color);
+}
+
+void SpanRaster::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (!direct()) { _display.drawFastVLine(x, y, h, color); return; }
+  if (h < 0) { y += h + 1; h = -h; }
+  vspan(x, y, h, color);
+}
+
+void SpanRaster::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  if (!direct()) { _display.drawLine(x0, y0, x1, y1, color); return; }
+
+  if (x0 == x1) {
+    vspan(x0, y0 < y1 ? y0 : y1, abs(y1 - y0) + 1, color);
+    return;
+  }
+  if (y0 == y1) {
+    hspan(x0 < x1 ? x0 : x1, y0, abs(x1 - x0) + 1, color);
+    return;
+  }
+
+  // Identical stepping to Adafruit_GFX::writeLine()
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    int16_t t = x0; x0 = y0; y0 = t;
+    t = x1; x1 = y1; y1 = t;
+  }
+  if (x0 > x1) {
+    int16_t t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+
+  int32_t dx = x1 - x0;
+  int32_t dy = abs(y1 - y0);
+  int32_t err = dx / 2;
+  int16_t ystep = y0 < y1 ? 1 : -1;
+
+  // GFX plots a pixel, then err -= dy and steps y once err < 0.
+  // So a run at one y is err / dy + 1 pixels long.
+  while (x0 <= x1) {
+    int32_t run = err / dy + 1;
+    if (run > x1 - x0 + 1) run = x1 - x0 + 1;
+
+    if (steep) vspan(y0, x0, run, color);
+    else       hspan(x0, y0, run, color);
+
+    x0 += run;
+    err -= run * dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void SpanRaster::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!direct()) { _display.drawRect(x, y, w, h, color); return; }
+
+  // Same four edges as GFX so INVERSE corners cancel the same way
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void SpanRaster::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!direct()) { _display.fillRect(x, y, w, h, color); return; }
+  if (w <= 0) return;
+  if (h < 0) { y += h + 1; h = -h; }
+  fill(x, y, w, h, color);
+}
+
+void SpanRaster::fillScreen(uint16_t color) {
+  fillRect(0, 0, _display.width(), _display.height(), color);
+}
@@ -0,0 +1,42 @@
+/****************************************************
+ * SpanRaster
+ * Line and rectangle primitives that write the SSD1306
+ * page buffer directly instead of going pixel by pixel.
+ *
+ *  - horizontal span: one mask, one OR per column
+ *  - vertical span: partial top byte, whole 0xFF bytes,
+ *    partial bottom byte
+ *  - lines: same Bresenham as GFX, but each run of pixels
+ *    on one row (or column, for steep lines) is emitted as
+ *    a single span, run length computed by division
+ *  - fillRect: one mask per page, whole pages memset
+ *
+ * Output is pixel-identical to Adafruit GFX, including
+ * INVERSE overdraw at rectangle corners (tools/libtest,
+ * test_spanraster). Rotated displays fall back to the GFX
+ * calls. tools/bench/spanraster_bench.cpp times both.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+class SpanRaster {
+public:
+  explicit SpanRaster(Adafruit_SSD1306& display) : _display(display) {}
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color);
+
+private:
+  bool direct() const { return _display.getRotation() == 0 && _display.getBuffer(); }
+  void hspan(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void vspan(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  Adafruit_SSD1306& _display;
+};
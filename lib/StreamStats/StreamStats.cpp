@@ -0,0 +1,123 @@
+#include "StreamStats.h"
+
+#include <math.h>
+
+StreamStats::StreamStats(float alpha)
+  : _alpha(alpha), _lo(NAN), _hi(NAN), _zLimit(0), _minSigma(0), _warmup(8),
+    _maxRate(0), _seen(0), _ewma(0), _ewvar(0), _rate(0), _prevV(0), _prevMs(0) {
+  resetWindow(0);
+}
+
+void StreamStats::setLimits(float lo, float hi) {
+  _lo = lo;
+  _hi = hi;
+}
+
+void StreamStats::setSpike(float zLimit, float minSigma, uint16_t warmup) {
+  _zLimit = zLimit;
+  _minSigma = minSigma;
+  _warmup = warmup;
+}
+
+void StreamStats::setMaxRate(float perSecond) {
+  _maxRate = perSecond;
+}
+
+void StreamStats::resetWindow(uint32_t ms) {
+  _startMs = ms;
+  _started = false;
+  _n = _invalid = _anomalies = 0;
+  _flags = 0;
+  _mean = _m2 = 0;
+  _meanT = _m2T = _cTV = 0;
+  _min = _max = _last = NAN;
+}
+
+uint8_t StreamStats::add(float v, uint32_t ms) {
+  if (!_started) {
+    // The window starts at its first sample, not at close(), so an
+    // idle gap does not flatten the slope
+    _startMs = ms;
+    _started = true;
+  }
+
+  if (isnan(v)) {
+    if (_invalid < UINT16_MAX) _invalid++;
+    _flags |= STAT_INVALID;
+    return STAT_INVALID;
+  }
+
+  uint8_t f = 0;
+  if (v < _lo) f |= STAT_LOW;    // false for NAN limits
+  if (v > _hi) f |= STAT_HIGH;
+
+  // Against the baseline before this sample moves it
+  if (_seen >= _warmup) {
+    float d = v - _ewma;
+    float sigma = sqrtf(_ewvar);
+    if (sigma < _minSigma) sigma = _minSigma;
+    if (_zLimit > 0 && fabsf(d) > _zLimit * sigma) f |= STAT_SPIKE;
+  }
+  if (_seen > 0 && ms != _prevMs) {
+    float r = (v - _prevV) * 1000.0f / (float)(ms - _prevMs);
+    _rate = _seen > 1 ? _rate + _alpha * (r - _rate) : r;
+    if (_maxRate > 0 && fabsf(_rate) > _maxRate) f |= STAT_RATE;
+  }
+
+  // EWMA and its variance (West's incremental form)
+  if (_seen == 0) {
+    _ewma = v;
+    _ewvar = 0;
+  } else {
+    float d = v - _ewma;
+    float inc = _alpha * d;
+    _ewma += inc;
+    _ewvar = (1.0f - _alpha) * (_ewvar + d * inc);
+  }
+  _seen++;
+  _prevV = v;
+  _prevMs = ms;
+
+  // Window: Welford for the value, co-moment with time for the slope
+  if (_n < UINT16_MAX) {
+    _n++;
+    float t = (float)(ms - _startMs) * 0.001f;
+    float dt = t - _meanT;
+    float dv = v - _mean;
+    _meanT += dt / _n;
+    _mean += dv / _n;
+    _m2T += dt * (t - _meanT);
+    _m2 += dv * (v - _mean);
+    _cTV += dt * (v - _mean);
+  }
+  if (_n == 1 || v < _min) _min = v;
+  if (_n == 1 || v > _max) _max = v;
+  _last = v;
+
+  if (f) {
+    if (_anomalies < UINT16_MAX) _anomalies++;
+    _flags |= f;
+  }
+  return f;
+}
+
+void StreamStats::summary(WindowSummary& out, uint32_t ms) const {
+  out.startMs = _started ? _startMs : ms;
+  out.endMs = ms;
+  out.count = _n;
+  out.invalid = _invalid;
+  out.anomalies = _anomalies;
+  out.flags = _flags;
+  out.mean = _n ? _mean : NAN;
+  out.stddev = _n > 1 ? sqrtf(_m2 / (_n - 1)) : 0;
+  out.min = _min;
+  out.max = _max;
+  out.last = _last;
+  out.slopePerMin = _m2T > 0 ? _cTV / _m2T * 60.0f : 0;
+  out.ewma = _seen ? _ewma : NAN;
+}
+
+void StreamStats::close(WindowSummary& out, uint32_t ms) {
+  summary(out, ms);
+  resetWindow(ms);
+}
@@ -0,0 +1,104 @@
+/****************************************************
+ * StreamStats
+ * Per-channel statistics that are updated one sample at
+ * a time, so a node can send one summary per window
+ * instead of every reading.
+ *
+ *   StreamStats temp(0.2f);
+ *   temp.setLimits(0, 45);                // threshold flags
+ *   temp.setSpike(3.0f, 0.5f);            // z-score flags
+ *   uint8_t f = temp.add(t, millis());    // flags of this sample
+ *   ...
+ *   WindowSummary w;
+ *   temp.close(w, millis());              // and start a new window
+ *
+ * Window (reset by close()): count, Welford mean and
+ * variance, min/max, last, and the least-squares slope
+ * against time (streaming co-moment, so no sample is
+ * kept). Across windows: an EWMA with its exponentially
+ * weighted variance (the baseline for spike detection)
+ * and an EWMA of the rate of change.
+ *
+ * Flags per sample: below/above the limits, more than
+ * zLimit baseline sigmas from the EWMA (after a warm-up,
+ * sigma never below minSigma so a flat DHT11 reading
+ * that steps by one count is not a spike), rate above
+ * maxRate, or NaN. NaN samples are counted but not used.
+ *
+ * Floats only, no heap, no Arduino dependency. Cost per
+ * sample is measured by tools/bench/streamstats_bench.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+enum StatFlags : uint8_t {
+  STAT_LOW     = 0x01,
+  STAT_HIGH    = 0x02,
+  STAT_SPIKE   = 0x04,
+  STAT_RATE    = 0x08,
+  STAT_INVALID = 0x10,
+};
+
+struct WindowSummary {
+  uint32_t startMs;
+  uint32_t endMs;
+  uint16_t count;       // valid samples
+  uint16_t invalid;     // NaN samples
+  uint16_t anomalies;   // samples with any flag but STAT_INVALID
+  uint8_t  flags;       // OR of all sample flags
+  float    mean;
+  float    stddev;      // sample standard deviation, 0 below 2 samples
+  float    min;
+  float    max;
+  float    last;
+  float    slopePerMin; // least-squares trend over the window
+  float    ewma;        // baseline at the end of the window
+};
+
+class StreamStats {
+public:
+  // alpha: EWMA weight of a new sample (0..1]
+  explicit StreamStats(float alpha = 0.2f);
+
+  void setLimits(float lo, float hi);                     // NAN disables a side
+  void setSpike(float zLimit, float minSigma, uint16_t warmup = 8);
+  void setMaxRate(float perSecond);                       // 0 disables
+
+  uint8_t add(float v, uint32_t ms);
+
+  // Summary of the window so far; close() also starts the next one
+  void summary(WindowSummary& out, uint32_t ms) const;
+  void close(WindowSummary& out, uint32_t ms);
+
+  uint16_t count() const { return _n; }
+  float    mean() const { return _mean; }
+  float    ewma() const { return _ewma; }
+  float    ratePerSec() const { return _rate; }
+  uint32_t windowStartMs() const { return _startMs; }
+
+private:
+  void resetWindow(uint32_t ms);
+
+  float    _alpha;
+  float    _lo, _hi;
+  float    _zLimit, _minSigma;
+  uint16_t _warmup;
+  float    _maxRate;
+
+  // Window
+  uint32_t _startMs;
+  bool     _started;
+  uint16_t _n, _invalid, _anomalies;
+  uint8_t  _flags;
+  float    _mean, _m2;          // Welford
+  float    _meanT, _m2T, _cTV;  // time in s since window start, co-moment
+  float    _min, _max, _last;
+
+  // Across windows
+  uint32_t _seen;
+  float    _ewma, _ewvar;
+  float    _rate;
+  float    _prevV;
+  uint32_t _prevMs;
+};
@@ -0,0 +1,119 @@
+#include "Telemetry.h"
+
+#include <string.h>
+
+TelemetryWriter::TelemetryWriter(Print& out, bool leadingDelimiter)
+  : _out(out), _leadingDelimiter(leadingDelimiter), _seq(0) {
+  memset(_schemas, 0, sizeof(_schemas));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+uint8_t* TelemetryWriter::begin(uint8_t* payload, uint8_t type) {
+  payload[0] = type;
+  payload[1] = _seq;
+  telemPut32(payload + 2, millis());
+  return payload + TELEM_HEADER_LEN;
+}
+
+// len covers type..body, room for the crc is left by the callers
+bool TelemetryWriter::finish(uint8_t* payload, size_t len) {
+  telemPut16(payload + len, telemCrc16(payload, len));
+  len += 2;
+
+  uint8_t frame[TELEM_MAX_FRAME + 1];
+  size_t n = 0;
+  if (_leadingDelimiter) frame[n++] = 0;
+  n += cobsEncode(payload, len, frame + n);
+  frame[n++] = 0;
+
+  _out.write(frame, n);
+  _seq++;
+  _stats.frames++;
+  _stats.bytes += n;
+  return true;
+}
+
+bool TelemetryWriter::setSchema(uint8_t stream, const TelemetryField* fields, uint8_t count) {
+  if (stream >= TELEM_STREAMS || count > TELEM_MAX_FIELDS) {
+    _stats.rejected++;
+    return false;
+  }
+  _schemas[stream].fields = fields;
+  _schemas[stream].count = count;
+  return sendSchema(stream);
+}
+
+bool TelemetryWriter::sendSchema(uint8_t stream) {
+  Schema& s = _schemas[stream];
+  uint8_t payload[TELEM_MAX_PAYLOAD];
+  uint8_t* p = begin(payload, TELEM_SCHEMA);
+  uint8_t* end = payload + TELEM_MAX_PAYLOAD - 2;
+
+  *p++ = stream;
+  *p++ = s.count;
+  for (uint8_t i = 0; i < s.count; i++) {
+    size_t nameLen = strlen(s.fields[i].name) + 1;
+    size_t unitLen = strlen(s.fields[i].unit) + 1;
+    if (p + 1 + nameLen + unitLen > end) {
+      _stats.rejected++;
+      return false;
+    }
+    *p++ = (uint8_t)s.fields[i].exp10;
+    memcpy(p, s.fields[i].name, nameLen);
+    p += nameLen;
+    memcpy(p, s.fields[i].unit, unitLen);
+    p += unitLen;
+  }
+  s.sinceSent = 0;
+  return finish(payload, p - payload);
+}
+
+bool TelemetryWriter::sample(uint8_t stream, const int16_t* values, uint8_t count) {
+  if (stream >= TELEM_STREAMS || count > TELEM_MAX_FIELDS) {
+    _stats.rejected++;
+    return false;
+  }
+  Schema& s = _schemas[stream];
+  if (s.fields && ++s.sinceSent >= TELEM_SCHEMA_EVERY) sendSchema(stream);
+
+  uint8_t payload[TELEM_MAX_PAYLOAD];
+  uint8_t* p = begin(payload, TELEM_SAMPLE);
+  *p++ = stream;
+  for (uint8_t i = 0; i < count; i++) {
+    telemPut16(p, (uint16_t)values[i]);
+    p += 2;
+  }
+  return finish(payload, p - payload);
+}
+
+bool TelemetryWriter::event(uint8_t code, const char* text) {
+  uint8_t payload[TELEM_MAX_PAYLOAD];
+  uint8_t* p = begin(payload, TELEM_EVENT);
+  *p++ = code;
+
+  // Long messages are cut, an event is a hint not a log
+  size_t room = payload + TELEM_MAX_PAYLOAD - 2 - p;
+  size_t len = strlen(text);
+  if (len > room) len = room;
+  memcpy(p, text, len);
+  return finish(payload, p + len - payload);
+}
+
+bool TelemetryWriter::profile(const char* name, uint32_t count, uint32_t minUs,
+                              uint32_t avgUs, uint32_t maxUs) {
+  uint8_t payload[TELEM_MAX_PAYLOAD];
+  uint8_t* p = begin(payload, TELEM_PROFILE);
+
+  size_t nameLen = strlen(name) + 1;
+  if (p + nameLen + 16 > payload + TELEM_MAX_PAYLOAD - 2) {
+    _stats.rejected++;
+    return false;
+  }
+  memcpy(p, name, nameLen);
+  p += nameLen;
+  telemPut32(p, count);
+  telemPut32(p + 4, minUs);
+  telemPut32(p + 8, avgUs);
+  telemPut32(p + 12, maxUs);
+  return finish(payload, p + 16 - payload);
+}
@@ -0,0 +1,78 @@
+/****************************************************
+ * Telemetry
+ * Binary records on a Print (usually Serial): samples,
+ * events and profiler dumps as COBS frames with a CRC,
+ * see TelemetryCodec.h for the format.
+ *
+ *   TelemetryWriter telem(Serial);
+ *   static const TelemetryField fields[] = {
+ *     { "temp", "C", -2 }, { "light", "adc", 0 },
+ *   };
+ *   telem.setSchema(0, fields, 2);      // once in setup
+ *   int16_t v[] = { 2315, 1800 };
+ *   telem.sample(0, v, 2);              // 15 bytes on the wire
+ *
+ * The schema is sent once and then again every
+ * TELEM_SCHEMA_EVERY samples of that stream, so the
+ * decoder can label the columns whenever it starts.
+ *
+ * With leadingDelimiter every frame also starts with a
+ * 0x00. That costs a byte but cuts any text printed in
+ * between into its own chunk, so text and frames can
+ * share the port and the decoder passes the text on.
+ *
+ * Frames are built on the stack and written with one
+ * out.write(). Not locked: one writer per task, or wrap
+ * the calls.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include "TelemetryCodec.h"
+
+#define TELEM_STREAMS        4
+#define TELEM_SCHEMA_EVERY   32
+
+struct TelemetryField {
+  const char* name;
+  const char* unit;
+  int8_t      exp10;   // value = raw * 10^exp10
+};
+
+struct TelemetryStats {
+  uint32_t frames;
+  uint32_t bytes;      // on the wire, delimiters included
+  uint32_t rejected;   // too big for a frame, or bad stream
+};
+
+class TelemetryWriter {
+public:
+  explicit TelemetryWriter(Print& out, bool leadingDelimiter = false);
+
+  // fields must stay valid (static), they are resent from here
+  bool setSchema(uint8_t stream, const TelemetryField* fields, uint8_t count);
+
+  bool sample(uint8_t stream, const int16_t* values, uint8_t count);
+  bool event(uint8_t code, const char* text);
+  bool profile(const char* name, uint32_t count, uint32_t minUs,
+               uint32_t avgUs, uint32_t maxUs);
+
+  const TelemetryStats& stats() const { return _stats; }
+
+private:
+  struct Schema {
+    const TelemetryField* fields;
+    uint8_t count;
+    uint8_t sinceSent;
+  };
+
+  uint8_t* begin(uint8_t* payload, uint8_t type);
+  bool     finish(uint8_t* payload, size_t len);
+  bool     sendSchema(uint8_t stream);
+
+  Print&   _out;
+  bool     _leadingDelimiter;
+  uint8_t  _seq;
+  Schema   _schemas[TELEM_STREAMS];
+  TelemetryStats _stats;
+};
@@ -0,0 +1,114 @@
+#include "TelemetryCodec.h"
+
+#include <string.h>
+
+// Bitwise, a 17 byte sample is ~140 shifts: not worth a 512 byte table
+uint16_t telemCrc16(const uint8_t* data, size_t len, uint16_t crc) {
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t codeAt = 0;  // where the current block's length byte goes
+  size_t n = 1;
+  uint8_t code = 1;
+
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      out[codeAt] = code;
+      codeAt = n++;
+      code = 1;
+      continue;
+    }
+    out[n++] = in[i];
+    if (++code == 0xFF) {  // full block of 254, no implied zero after it
+      out[codeAt] = code;
+      codeAt = n++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return n;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t i = 0;
+  size_t n = 0;
+
+  while (i < len) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len) return 0;
+    for (uint8_t k = 1; k < code; k++) {
+      uint8_t b = in[i++];
+      if (b == 0) return 0;
+      out[n++] = b;
+    }
+    if (code != 0xFF && i < len) out[n++] = 0;
+  }
+  return n;
+}
+
+TelemetryReader::TelemetryReader()
+  : _rejected(_buf), _len(0), _rejectedLen(0), _overflow(false), _haveSeq(false), _lastSeq(0) {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+const uint8_t* TelemetryReader::rejected(size_t& len) const {
+  len = _rejectedLen;
+  return _rejected;
+}
+
+bool TelemetryReader::feed(uint8_t b, TelemetryFrame& frame) {
+  _rejectedLen = 0;
+
+  if (b != 0) {
+    if (_len == sizeof(_buf)) {
+      // Too long for a frame: hand it out as text and keep going
+      memcpy(_frame, _buf, _len);
+      _rejected = _frame;
+      _rejectedLen = _len;
+      _len = 0;
+      _overflow = true;
+    }
+    _buf[_len++] = b;
+    return false;
+  }
+
+  uint16_t len = _len;
+  _len = 0;
+
+  if (_overflow) {
+    _overflow = false;
+    _stats.tooLong++;
+    _rejected = _buf;
+    _rejectedLen = len;
+    return false;
+  }
+  if (len == 0) return false;  // back to back delimiters
+
+  size_t n = cobsDecode(_buf, len, _frame);
+  if (n < TELEM_HEADER_LEN + 2 ||
+      telemCrc16(_frame, n - 2) != telemGet16(_frame + n - 2)) {
+    _stats.crcErrors++;
+    _rejected = _buf;
+    _rejectedLen = len;
+    return false;
+  }
+
+  frame.type = _frame[0];
+  frame.seq = _frame[1];
+  frame.ms = telemGet32(_frame + 2);
+  frame.body = _frame + TELEM_HEADER_LEN;
+  frame.bodyLen = n - TELEM_HEADER_LEN - 2;
+
+  if (_haveSeq) _stats.lost += (uint8_t)(frame.seq - _lastSeq - 1);
+  _haveSeq = true;
+  _lastSeq = frame.seq;
+  _stats.frames++;
+  return true;
+}
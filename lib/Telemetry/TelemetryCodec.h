@@ -0,0 +1,112 @@
+/****************************************************
+ * TelemetryCodec
+ * Wire format of the binary telemetry stream, shared by
+ * the sketches (TelemetryWriter) and the PC decoder
+ * (tools/telemdec). No Arduino dependency.
+ *
+ * Every record is one frame:
+ *
+ *   COBS( type | seq | ms[4] | body... | crc[2] ) 0x00
+ *
+ * COBS removes every zero byte from the frame, so 0x00
+ * only ever appears as the delimiter: a reader that joins
+ * mid-stream, or loses bytes, resyncs at the next zero.
+ * seq counts frames (mod 256) so gaps are visible, ms is
+ * the sender's millis(). crc is CRC-16/CCITT-FALSE over
+ * type..body. Multi-byte fields are little endian.
+ *
+ * Bodies:
+ *   SAMPLE   stream, int16 value[n]
+ *   SCHEMA   stream, n, n x (exp10, name\0, unit\0)
+ *            value = raw * 10^exp10, so 2315 with exp -2
+ *            is 23.15. Resent now and then so a late
+ *            reader can label the samples.
+ *   EVENT    code, text (rest of the frame, no \0)
+ *   PROFILE  name\0, count, min us, avg us, max us (u32)
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEM_MAX_PAYLOAD  96                       // type..crc, before COBS
+#define TELEM_MAX_FRAME    (TELEM_MAX_PAYLOAD + TELEM_MAX_PAYLOAD / 254 + 2)
+#define TELEM_HEADER_LEN   6                        // type, seq, ms
+#define TELEM_MAX_FIELDS   16
+
+enum TelemetryType : uint8_t {
+  TELEM_SAMPLE  = 1,
+  TELEM_SCHEMA  = 2,
+  TELEM_EVENT   = 3,
+  TELEM_PROFILE = 4,
+};
+
+uint16_t telemCrc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+// COBS encode len bytes into out (room for len + len/254 + 1), no delimiter
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+// Decode in place is fine (out == in). Returns 0 on a malformed frame.
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+static inline void telemPut16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static inline void telemPut32(uint8_t* p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = v >> 24;
+}
+
+static inline uint16_t telemGet16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t telemGet32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// A checked, decoded frame. body points into the reader's buffer.
+struct TelemetryFrame {
+  uint8_t        type;
+  uint8_t        seq;
+  uint32_t       ms;
+  const uint8_t* body;
+  uint16_t       bodyLen;
+};
+
+struct TelemetryReaderStats {
+  uint32_t frames;     // good frames
+  uint32_t crcErrors;  // includes garbage between frames
+  uint32_t tooLong;    // no delimiter within TELEM_MAX_FRAME
+  uint32_t lost;       // frames missing according to seq
+};
+
+// Byte-at-a-time frame reader for the decoder (or a second ESP32).
+// Bytes that are not part of a good frame can be passed on as text,
+// so a stream that mixes Serial.print() lines with frames still reads.
+class TelemetryReader {
+public:
+  TelemetryReader();
+
+  // Returns true when b completed a good frame, now in `frame`
+  bool feed(uint8_t b, TelemetryFrame& frame);
+
+  // Bytes of the last rejected chunk (valid until the next feed)
+  const uint8_t* rejected(size_t& len) const;
+
+  const TelemetryReaderStats& stats() const { return _stats; }
+
+private:
+  uint8_t  _buf[TELEM_MAX_FRAME];    // raw bytes since the last 0x00
+  uint8_t  _frame[TELEM_MAX_FRAME];  // decoded copy, _buf stays for rejected()
+  const uint8_t* _rejected;
+  uint16_t _len;
+  uint16_t _rejectedLen;
+  bool     _overflow;
+  bool     _haveSeq;
+  uint8_t  _lastSeq;
+  TelemetryReaderStats _stats;
+};
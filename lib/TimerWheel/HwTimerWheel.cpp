@@ -0,0 +1,95 @@
+#ifdef ESP32
+
+#include "HwTimerWheel.h"
+#include <IsrProf.h>
+
+HwTimerWheel* HwTimerWheel::_instance = nullptr;
+
+bool HwTimerWheel::begin(uint8_t timerNum, uint32_t tickUs,
+                         UBaseType_t taskPriority, BaseType_t core) {
+  if (_instance || tickUs == 0 || tickUs > 4000000) return false;
+  _instance = this;
+  _tickUs = tickUs;
+
+  if (xTaskCreatePinnedToCore(dispatchTask, "twheel", 4096, this,
+                              taskPriority, &_task, core) != pdPASS) return false;
+
+  // 80 MHz / 80 = 1 MHz, one count per us
+  _timer = timerBegin(timerNum, 80, true);
+  if (!_timer) return false;
+  timerAttachInterrupt(_timer, &onTimer, true);
+  timerAlarmWrite(_timer, tickUs, true);
+  timerAlarmEnable(_timer);
+  return true;
+}
+
+// ms * 1000 / tickUs without 64-bit math (a libgcc call, in flash):
+// whole ticks of ms first, then the remainder, which fits with tickUs
+// up to 4 s
+uint32_t IRAM_ATTR HwTimerWheel::msToTicks(uint32_t ms) const {
+  return ms / _tickUs * 1000 + ms % _tickUs * 1000 / _tickUs;
+}
+
+void IRAM_ATTR HwTimerWheel::start(SoftTimer& t, uint32_t delayMs, uint32_t periodMs,
+                                   TimerCallback cb, void* arg, TimerMode mode) {
+  uint32_t delay = msToTicks(delayMs);
+  uint32_t period = msToTicks(periodMs);
+  if (periodMs && period == 0) period = 1;
+
+  portENTER_CRITICAL_SAFE(&_mux);
+  _wheel.start(t, delay, period, cb, arg, mode);
+  portEXIT_CRITICAL_SAFE(&_mux);
+}
+
+void IRAM_ATTR HwTimerWheel::cancel(SoftTimer& t) {
+  portENTER_CRITICAL_SAFE(&_mux);
+  _wheel.cancel(t);
+  portEXIT_CRITICAL_SAFE(&_mux);
+}
+
+TimerWheelStats HwTimerWheel::stats() {
+  portENTER_CRITICAL(&_mux);
+  TimerWheelStats s = _wheel.stats();
+  portEXIT_CRITICAL(&_mux);
+  return s;
+}
+
+void IRAM_ATTR HwTimerWheel::onTimer() {
+  HwTimerWheel* self = _instance;
+  uint32_t entry = self->_probe ? self->_probe->enter() : 0;
+
+  portENTER_CRITICAL_ISR(&self->_mux);
+  bool ready = self->_wheel.tick();
+  portEXIT_CRITICAL_ISR(&self->_mux);
+
+  if (ready) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+  }
+
+  if (self->_probe) self->_probe->exit(entry);
+}
+
+// Callbacks run outside the lock. cb and arg are copied under it with
+// the pop: a start() from another task or an IN_TICK callback may
+// rewrite them before the call.
+void HwTimerWheel::dispatchTask(void* arg) {
+  HwTimerWheel* self = (HwTimerWheel*)arg;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    for (;;) {
+      portENTER_CRITICAL(&self->_mux);
+      SoftTimer* t = self->_wheel.popReady();
+      TimerCallback cb = t ? t->cb : nullptr;
+      void* cbArg = t ? t->arg : nullptr;
+      portEXIT_CRITICAL(&self->_mux);
+      if (!t) break;
+      cb(cbArg);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,57 @@
+/****************************************************
+ * HwTimerWheel
+ * TimerWheel on one ESP32 hardware timer.
+ *
+ * The hardware timer fires every tickUs and the ISR runs
+ * TimerWheel::tick() under a spinlock; the ISR and the
+ * wheel's tick path are in IRAM. TIMER_IN_TICK callbacks
+ * run right there, so they must be IRAM_ATTR too (and
+ * everything they call) and never block. If anything
+ * deferred became ready, tick() says so and a dispatch
+ * task is notified to run those callbacks in task
+ * context, outside the lock.
+ *
+ * start()/cancel() may be called from tasks and from
+ * TIMER_IN_TICK callbacks (the spinlock nests on the
+ * same core); they and msToTicks() are in IRAM for that.
+ ****************************************************/
+#pragma once
+
+#ifdef ESP32
+
+#include <Arduino.h>
+#include "TimerWheel.h"
+
+class IsrProbe;
+
+class HwTimerWheel {
+public:
+  // tickUs up to 4 s
+  bool begin(uint8_t timerNum = 0, uint32_t tickUs = 1000,
+             UBaseType_t taskPriority = 3, BaseType_t core = 1);
+
+  void start(SoftTimer& t, uint32_t delayMs, uint32_t periodMs,
+             TimerCallback cb, void* arg, TimerMode mode = TIMER_DEFERRED);
+  void cancel(SoftTimer& t);
+
+  uint32_t msToTicks(uint32_t ms) const;
+  TimerWheelStats stats();
+
+  // Optional: time every tick ISR (see IsrProf), set before begin()
+  void setProbe(IsrProbe* probe) { _probe = probe; }
+
+private:
+  static void IRAM_ATTR onTimer();
+  static void dispatchTask(void* arg);
+
+  static HwTimerWheel* _instance;  // the Arduino timer ISR takes no argument
+
+  TimerWheel   _wheel;
+  hw_timer_t*  _timer = nullptr;
+  TaskHandle_t _task = nullptr;
+  uint32_t     _tickUs = 1000;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+  IsrProbe*    _probe = nullptr;
+};
+
+#endif
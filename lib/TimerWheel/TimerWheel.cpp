@@ -0,0 +1,176 @@
+#include "TimerWheel.h"
+
+#include <string.h>
+
+// The tick path runs in the ESP32 timer ISR, which also fires while
+// flash is busy (writes, OTA): it has to be in IRAM, not cached flash.
+// So are start() and cancel(): IN_TICK callbacks call them from there.
+#ifdef ESP32
+#include <esp_attr.h>
+#define TIMERWHEEL_IRAM IRAM_ATTR
+#else
+#define TIMERWHEEL_IRAM
+#endif
+
+#define LEVEL_MASK  (TimerWheel::SLOTS - 1)
+#define MAX_SPAN    ((1UL << (TimerWheel::LEVELS * TimerWheel::BITS)) - 1)
+
+TimerWheel::TimerWheel()
+  : _jiffies(1), _walk(nullptr), _readyHead(nullptr), _readyTail(nullptr) {
+  memset(_slot, 0, sizeof(_slot));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+void TIMERWHEEL_IRAM TimerWheel::unlink(SoftTimer& t) {
+  if (!t.pprev) return;
+  *t.pprev = t.next;
+  if (t.next) t.next->pprev = t.pprev;
+  t.next = nullptr;
+  t.pprev = nullptr;
+}
+
+// Picks the level from how far away the timer is, the slot from its due tick
+void TIMERWHEEL_IRAM TimerWheel::place(SoftTimer& t) {
+  uint32_t when = t.expires;
+  uint32_t idx = when - _jiffies;
+
+  // Due or overdue (re-armed inside its own tick): next tick
+  if ((int32_t)idx < 0) {
+    when = _jiffies;
+    idx = 0;
+  }
+  if (idx > MAX_SPAN) {  // park at the far edge, cascade will look again
+    when = _jiffies + MAX_SPAN;
+    idx = MAX_SPAN;
+  }
+
+  uint8_t level = 0;
+  while (level < LEVELS - 1 && idx >= (1UL << (BITS * (level + 1)))) level++;
+
+  SoftTimer** head = &_slot[level][(when >> (BITS * level)) & LEVEL_MASK];
+  t.next = *head;
+  if (t.next) t.next->pprev = &t.next;
+  *head = &t;
+  t.pprev = head;
+}
+
+void TIMERWHEEL_IRAM TimerWheel::start(SoftTimer& t, uint32_t delayTicks, uint32_t periodTicks,
+                                       TimerCallback cb, void* arg, TimerMode mode) {
+  unlink(t);
+  if (delayTicks == 0) delayTicks = 1;
+
+  t.cb = cb;
+  t.arg = arg;
+  t.mode = mode;
+  t.period = periodTicks;
+  t.expires = now() + delayTicks;
+  t.gen++;
+  place(t);
+}
+
+void TIMERWHEEL_IRAM TimerWheel::cancel(SoftTimer& t) {
+  unlink(t);
+  t.gen++;  // a ready entry for the old run is dropped by popReady()
+}
+
+// Moves one upper-level slot down, returns the slot index (0 = wrap, go up)
+uint8_t TIMERWHEEL_IRAM TimerWheel::cascade(uint8_t level, uint8_t index) {
+  SoftTimer* t = _slot[level][index];
+  _slot[level][index] = nullptr;
+
+  while (t) {
+    SoftTimer* next = t->next;
+    t->pprev = nullptr;
+    place(*t);
+    _stats.cascaded++;
+    t = next;
+  }
+  return index;
+}
+
+void TIMERWHEEL_IRAM TimerWheel::fire(SoftTimer& t) {
+  _stats.fired++;
+
+  // Re-arm first so a callback may cancel or restart it
+  if (t.period) {
+    t.expires += t.period;
+    place(t);
+  }
+
+  if (t.mode == TIMER_IN_TICK) {
+    t.cb(t.arg);
+    return;
+  }
+
+  if (t.ready) {
+    if (t.readyGen == t.gen) {
+      t.overruns++;
+      _stats.overruns++;
+    } else {
+      t.readyGen = t.gen;  // stale entry from before a restart: reuse it
+    }
+    return;
+  }
+  t.ready = true;
+  t.readyGen = t.gen;
+  t.nextReady = nullptr;
+  if (_readyTail) _readyTail->nextReady = &t;
+  else            _readyHead = &t;
+  _readyTail = &t;
+  _stats.readyDepth++;
+}
+
+bool TIMERWHEEL_IRAM TimerWheel::tick() {
+  uint8_t index = _jiffies & LEVEL_MASK;
+
+  // Every 64 ticks pull the next block down, and so on up the levels
+  if (index == 0) {
+    for (uint8_t level = 1; level < LEVELS; level++) {
+      if (cascade(level, (_jiffies >> (BITS * level)) & LEVEL_MASK) != 0) break;
+    }
+  }
+
+  // Everything in this slot is due now. It is detached onto _walk first:
+  // callbacks may re-add timers, or cancel ones still waiting on _walk.
+  _walk = _slot[0][index];
+  _slot[0][index] = nullptr;
+  if (_walk) _walk->pprev = &_walk;
+  _jiffies++;
+  _stats.ticks++;
+
+  uint16_t count = 0;
+  while (_walk) {
+    SoftTimer& t = *_walk;
+    unlink(t);
+    fire(t);
+    count++;
+  }
+  if (count > _stats.maxPerTick) _stats.maxPerTick = count;
+  return _readyHead != nullptr;
+}
+
+SoftTimer* TimerWheel::popReady() {
+  while (_readyHead) {
+    SoftTimer* t = _readyHead;
+    _readyHead = t->nextReady;
+    if (!_readyHead) _readyTail = nullptr;
+    t->ready = false;
+    _stats.readyDepth--;
+
+    if (t->readyGen == t->gen) {  // else cancelled/restarted since
+      _stats.deferredRun++;
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+uint16_t TimerWheel::runDeferred(uint16_t max) {
+  uint16_t n = 0;
+  SoftTimer* t;
+  while (n < max && (t = popReady()) != nullptr) {
+    t->cb(t->arg);
+    n++;
+  }
+  return n;
+}
@@ -0,0 +1,109 @@
+/****************************************************
+ * TimerWheel
+ * Hierarchical timer wheel: any number of software
+ * timers on one tick source.
+ *
+ * 4 levels x 64 slots, 6 bits each, so timers up to 2^24
+ * ticks (4.6 h at 1 ms) are placed directly, longer ones
+ * are parked in the top level and re-placed as they come
+ * closer. Timers are intrusive list nodes owned by the
+ * caller: start() and cancel() are O(1) and never
+ * allocate, whatever the number of timers.
+ *
+ * tick() advances one tick: it cascades the upper levels
+ * every 64 ticks, then fires the level-0 slot for this
+ * tick. On the ESP32 it runs in the timer ISR, so tick()
+ * and the wheel code under it are IRAM_ATTR there, as are
+ * start() and cancel(), which IN_TICK callbacks may call.
+ * Each timer fires in one of two modes:
+ *   TIMER_IN_TICK   callback runs inside tick(), in the
+ *                   ISR on the ESP32: short, no blocking
+ *                   calls, and IRAM_ATTR along with all
+ *                   it calls, or it crashes the first time
+ *                   the tick lands during a flash write
+ *   TIMER_DEFERRED  timer is put on a ready list that a
+ *                   task drains with runDeferred()
+ * Periodic timers are re-armed from their due tick, not
+ * from when the callback ran, so they never drift. A
+ * deferred timer that fires again before it was run
+ * counts an overrun instead of queueing twice.
+ *
+ * No locking here, this runs as-is on a PC against a
+ * simulated tick. HwTimerWheel adds the ESP32 hardware
+ * timer, the lock and the dispatch task.
+ ****************************************************/
+#pragma once
+
+#include <stdint.h>
+
+typedef void (*TimerCallback)(void* arg);
+
+enum TimerMode : uint8_t { TIMER_IN_TICK, TIMER_DEFERRED };
+
+// Must start zeroed (globals and `SoftTimer t = {};` are)
+struct SoftTimer {
+  // Owned by the wheel
+  SoftTimer*  next;
+  SoftTimer** pprev;       // null when not in the wheel
+  SoftTimer*  nextReady;
+  uint32_t    expires;
+  uint32_t    period;      // 0 = one-shot
+  uint16_t    gen;         // bumped by start/cancel, stale ready entries are skipped
+  uint16_t    readyGen;
+  bool        ready;       // on the deferred list
+  uint32_t    overruns;
+
+  // Set by start()
+  TimerCallback cb;
+  void*         arg;
+  TimerMode     mode;
+};
+
+struct TimerWheelStats {
+  uint32_t ticks;
+  uint32_t fired;
+  uint32_t cascaded;      // re-placements from upper levels
+  uint32_t deferredRun;
+  uint32_t overruns;
+  uint16_t maxPerTick;
+  uint16_t readyDepth;
+};
+
+class TimerWheel {
+public:
+  static const uint8_t  LEVELS = 4;
+  static const uint8_t  BITS   = 6;
+  static const uint16_t SLOTS  = 1 << BITS;
+
+  TimerWheel();
+
+  // First firing after delayTicks (min 1), then every periodTicks (0 = once)
+  void start(SoftTimer& t, uint32_t delayTicks, uint32_t periodTicks,
+             TimerCallback cb, void* arg, TimerMode mode = TIMER_DEFERRED);
+  void cancel(SoftTimer& t);
+  bool active(const SoftTimer& t) const { return t.pprev != nullptr; }
+
+  // One tick of the source; true while deferred timers wait for runDeferred()
+  bool tick();
+
+  // Pops the next deferred timer that is still valid, or null
+  SoftTimer* popReady();
+  // Runs up to max deferred callbacks, returns how many ran
+  uint16_t runDeferred(uint16_t max = 0xFFFF);
+
+  uint32_t now() const { return _jiffies - 1; }   // ticks done so far
+  TimerWheelStats stats() const { return _stats; }
+
+private:
+  void place(SoftTimer& t);
+  static void unlink(SoftTimer& t);
+  uint8_t cascade(uint8_t level, uint8_t index);
+  void fire(SoftTimer& t);
+
+  SoftTimer* _slot[LEVELS][SLOTS];
+  uint32_t   _jiffies;          // the tick tick() processes next
+  SoftTimer* _walk;             // slot being fired
+  SoftTimer* _readyHead;
+  SoftTimer* _readyTail;
+  TimerWheelStats _stats;
+};
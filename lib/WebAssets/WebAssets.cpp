@@ -0,0 +1,46 @@
+#include "WebAssets.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const WebAsset* webAssetFind(const WebAsset* list, size_t n, const char* path) {
+  size_t len = strcspn(path, "? ");
+  for (size_t i = 0; i < n; i++) {
+    if (strlen(list[i].path) == len && strncmp(list[i].path, path, len) == 0) return &list[i];
+  }
+  return nullptr;
+}
+
+bool webAssetFresh(const WebAsset& a, const char* ifNoneMatch) {
+  if (!ifNoneMatch || !*ifNoneMatch) return false;
+  if (strcmp(ifNoneMatch, "*") == 0) return true;
+  // Quoted hex, so a substring match can't hit part of another tag
+  return strstr(ifNoneMatch, a.etag) != nullptr;
+}
+
+const char* webAssetCacheControl(const WebAsset& a) {
+  return a.immutable ? "public, max-age=31536000, immutable" : "no-cache";
+}
+
+size_t webAssetHead(char* buf, size_t size, const WebAsset& a, bool notModified) {
+  int n;
+  if (notModified) {
+    n = snprintf(buf, size,
+                 "HTTP/1.1 304 Not Modified\r\n"
+                 "Cache-Control: %s\r\n"
+                 "ETag: %s\r\n"
+                 "Connection: close\r\n\r\n",
+                 webAssetCacheControl(a), a.etag);
+  } else {
+    n = snprintf(buf, size,
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: %s\r\n"
+                 "Content-Encoding: gzip\r\n"
+                 "Content-Length: %lu\r\n"
+                 "Cache-Control: %s\r\n"
+                 "ETag: %s\r\n"
+                 "Connection: close\r\n\r\n",
+                 a.type, (unsigned long)a.size, webAssetCacheControl(a), a.etag);
+  }
+  return n > 0 && (size_t)n < size ? n : 0;
+}
@@ -0,0 +1,51 @@
+/****************************************************
+ * WebAssets
+ * Serves the gzipped pages tools/webassets/embed.py puts
+ * in include/WebAssetData.h, straight from flash.
+ *
+ *   #include "WebAssetData.h"
+ *   const WebAsset* a = webAssetFind(WEB_ASSETS, "/style.css?v=1f2e");
+ *   if (a && webAssetFresh(*a, ifNoneMatch)) -> 304, no body
+ *   else                                     -> 200, a->gz as is
+ *
+ * The body is never copied or unpacked on the board: it
+ * goes out as stored with Content-Encoding: gzip (every
+ * browser sends Accept-Encoding: gzip; curl needs
+ * --compressed). HTML is sent with no-cache, so a reload
+ * costs a 304 while it hasn't changed; CSS/JS are cached
+ * for a year, their URLs change with their content.
+ *
+ * webAssetHead() writes the whole response head for
+ * sketches that talk HTTP on a bare WiFiClient.
+ ****************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct WebAsset {
+  const char*    path;        // "/" for index.html, else "/name"
+  const char*    type;        // Content-Type
+  const uint8_t* gz;          // gzip body, in flash
+  uint32_t       size;
+  const char*    etag;        // with its quotes, as sent
+  bool           immutable;   // URL carries ?v=<etag>
+};
+
+// The asset for a request path; the query string is ignored
+const WebAsset* webAssetFind(const WebAsset* list, size_t n, const char* path);
+
+template <size_t N>
+const WebAsset* webAssetFind(const WebAsset (&list)[N], const char* path) {
+  return webAssetFind(list, N, path);
+}
+
+// True when the client's If-None-Match (may be null or a list) names
+// this version: answer 304 with no body
+bool webAssetFresh(const WebAsset& a, const char* ifNoneMatch);
+
+const char* webAssetCacheControl(const WebAsset& a);
+
+// "HTTP/1.1 200 OK" or "304 Not Modified" plus the headers and the
+// blank line. Returns the length, 0 if it didn't fit (~220 bytes).
+size_t webAssetHead(char* buf, size_t size, const WebAsset& a, bool notModified);
@@ -0,0 +1,192 @@
+#include "WebServer.h"
+
+#include <strings.h>
+
+// A scripted request arrives whole; this only guards a cut-off one
+#define WEBSERVER_EMU_TIMEOUT_MS 1000
+
+WebServer::WebServer(uint16_t port)
+    : _server(port), _nHandlers(0), _nHeaders(0), _method(HTTP_ANY),
+      _contentLength(CONTENT_LENGTH_NOT_SET), _chunked(false) {}
+
+void WebServer::on(const char* uri, HTTPMethod method, THandlerFunction fn) {
+  if (_nHandlers == WEBSERVER_EMU_HANDLERS) return;
+  _handlers[_nHandlers++] = { uri, method, fn };
+}
+
+void WebServer::collectHeaders(const char* keys[], size_t count) {
+  _nHeaders = count < WEBSERVER_EMU_HEADERS ? count : WEBSERVER_EMU_HEADERS;
+  for (uint8_t i = 0; i < _nHeaders; i++) {
+    _headerKeys[i] = keys[i];
+    _headerValues[i] = "";
+  }
+}
+
+String WebServer::header(const char* name) const {
+  for (uint8_t i = 0; i < _nHeaders; i++) {
+    if (!strcasecmp(_headerKeys[i], name)) return _headerValues[i];
+  }
+  return String();
+}
+
+bool WebServer::hasHeader(const char* name) const {
+  return header(name).length() > 0;
+}
+
+// ---- Request ----
+
+// One line without the CRLF; false on timeout or a closed peer
+bool WebServer::readLine(char* line, size_t size) {
+  size_t n = 0;
+  uint32_t start = millis();
+  while (_client.connected() && millis() - start < WEBSERVER_EMU_TIMEOUT_MS) {
+    int c = _client.read();
+    if (c < 0) continue;   // connected() already let 1 ms pass
+    if (c == '\n') {
+      line[n] = 0;
+      return true;
+    }
+    if (c != '\r' && n < size - 1) line[n++] = c;
+  }
+  return false;
+}
+
+static HTTPMethod parseMethod(const char* m) {
+  static const char* const names[] = { "GET", "HEAD", "POST", "PUT", "PATCH", "DELETE", "OPTIONS" };
+  for (uint8_t i = 0; i < 7; i++) {
+    if (!strcmp(m, names[i])) return (HTTPMethod)(HTTP_GET + i);
+  }
+  return HTTP_ANY;
+}
+
+void WebServer::parseRequest() {
+  _uri = "";
+  _method = HTTP_ANY;
+  for (uint8_t i = 0; i < _nHeaders; i++) _headerValues[i] = "";
+
+  // "GET /path?query HTTP/1.1"
+  char line[256];
+  if (!readLine(line, sizeof(line))) return;
+  char* path = strchr(line, ' ');
+  if (!path) return;
+  *path++ = 0;
+  char* end = strpbrk(path, " ?");
+  if (end) *end = 0;
+  _method = parseMethod(line);
+  _uri = path;
+
+  while (readLine(line, sizeof(line)) && line[0]) {
+    char* colon = strchr(line, ':');
+    if (!colon) continue;
+    *colon = 0;
+    const char* value = colon + 1;
+    while (*value == ' ') value++;
+    for (uint8_t i = 0; i < _nHeaders; i++) {
+      if (!strcasecmp(_headerKeys[i], line)) _headerValues[i] = value;
+    }
+  }
+}
+
+void WebServer::handleClient() {
+  _client = _server.available();
+  if (!_client) return;
+
+  parseRequest();
+  _responseHeaders = "";
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  _chunked = false;
+
+  THandlerFunction fn = _notFound;
+  for (uint8_t i = 0; i < _nHandlers; i++) {
+    const Handler& h = _handlers[i];
+    if ((h.method == HTTP_ANY || h.method == _method) && _uri == h.uri) {
+      fn = h.fn;
+      break;
+    }
+  }
+  if (fn) {
+    fn();
+  } else {
+    send(404, "text/plain", String("Not found: ") + _uri);
+  }
+  _client.stop();
+}
+
+// ---- Response ----
+
+static const char* reason(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 500: return "Internal Server Error";
+    default:  return "";
+  }
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+  String line = name + ": " + value + "\r\n";
+  if (first) {
+    _responseHeaders = line + _responseHeaders;
+  } else {
+    _responseHeaders += line;
+  }
+}
+
+void WebServer::sendHead(int code, const char* type, size_t len) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "HTTP/1.1 %d %s\r\n", code, reason(code));
+  String head(buf);
+  if (type && *type) head = head + "Content-Type: " + type + "\r\n";
+
+  if (_contentLength == CONTENT_LENGTH_NOT_SET) {
+    snprintf(buf, sizeof(buf), "Content-Length: %u\r\n", (unsigned)len);
+    head += buf;
+    _chunked = false;
+  } else if (_contentLength != CONTENT_LENGTH_UNKNOWN) {
+    snprintf(buf, sizeof(buf), "Content-Length: %u\r\n", (unsigned)_contentLength);
+    head += buf;
+    _chunked = false;
+  } else {
+    head += "Transfer-Encoding: chunked\r\n";
+    _chunked = true;
+  }
+  head = head + _responseHeaders + "Connection: close\r\n\r\n";
+
+  _client.write((const uint8_t*)head.c_str(), head.length());
+  _responseHeaders = "";
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+}
+
+void WebServer::send(int code, const char* type, const String& content) {
+  sendHead(code, type, content.length());
+  if (content.length()) sendContent(content);
+}
+
+void WebServer::send_P(int code, const char* type, const char* content) {
+  send_P(code, type, content, strlen(content));
+}
+
+void WebServer::send_P(int code, const char* type, const char* content, size_t len) {
+  _contentLength = len;
+  sendHead(code, type, len);
+  sendContent(content, len);
+}
+
+// Chunked responses end with an empty chunk, sendContent("")
+void WebServer::sendContent(const char* content, size_t len) {
+  if (!_chunked) {
+    _client.write((const uint8_t*)content, len);
+    return;
+  }
+  char size[12];
+  int n = snprintf(size, sizeof(size), "%x\r\n", (unsigned)len);
+  _client.write((const uint8_t*)size, n);
+  _client.write((const uint8_t*)content, len);
+  _client.write((const uint8_t*)"\r\n", 2);
+  if (len == 0) _chunked = false;
+}
@@ -0,0 +1,101 @@
+/****************************************************
+ * WebServer (emulator)
+ * The ESP32 core's WebServer on top of the WiFiEmu
+ * sockets, for the `native` env.
+ *
+ *  - handleClient() takes the next scripted client from
+ *    WiFiServer, reads the request line and the headers
+ *    named in collectHeaders(), runs the matching on()
+ *    handler (onNotFound otherwise) and closes the socket
+ *  - responses are framed like the core does it: status
+ *    line, Content-Type, Content-Length or chunked when
+ *    setContentLength(CONTENT_LENGTH_UNKNOWN), the
+ *    sendHeader() lines, Connection: close
+ *  - the bytes go through WiFiClient, so they land in
+ *    nativeStats().netTxBytes and WIFI_EMU_TX
+ *
+ * Query strings are split off the URI but not parsed.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include <functional>
+
+#define WEBSERVER_EMU_HANDLERS 16
+#define WEBSERVER_EMU_HEADERS  4
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+typedef enum {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+  HTTP_PATCH,
+  HTTP_DELETE,
+  HTTP_OPTIONS,
+} HTTPMethod;
+
+class WebServer {
+public:
+  typedef std::function<void()> THandlerFunction;
+
+  explicit WebServer(uint16_t port = 80);
+
+  void begin() { _server.begin(); }
+  void close() { _server.end(); }
+  void handleClient();
+
+  void on(const char* uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+  void on(const char* uri, HTTPMethod method, THandlerFunction fn);
+  void onNotFound(THandlerFunction fn) { _notFound = fn; }
+
+  void   collectHeaders(const char* keys[], size_t count);
+  String header(const char* name) const;
+  bool   hasHeader(const char* name) const;
+  String uri() const { return _uri; }
+  HTTPMethod method() const { return _method; }
+  WiFiClient client() { return _client; }
+
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t len) { _contentLength = len; }
+  void send(int code, const char* type = nullptr, const String& content = String());
+  void send(int code, const char* type, const char* content) { send(code, type, String(content)); }
+  void send_P(int code, const char* type, const char* content);
+  void send_P(int code, const char* type, const char* content, size_t len);
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t len);
+  void sendContent_P(const char* content, size_t len) { sendContent(content, len); }
+
+private:
+  struct Handler {
+    const char*      uri;
+    HTTPMethod       method;
+    THandlerFunction fn;
+  };
+
+  bool readLine(char* line, size_t size);
+  void parseRequest();
+  void sendHead(int code, const char* type, size_t len);
+
+  WiFiServer       _server;
+  WiFiClient       _client;
+
+  Handler          _handlers[WEBSERVER_EMU_HANDLERS];
+  uint8_t          _nHandlers;
+  THandlerFunction _notFound;
+
+  const char*      _headerKeys[WEBSERVER_EMU_HEADERS];
+  String           _headerValues[WEBSERVER_EMU_HEADERS];
+  uint8_t          _nHeaders;
+
+  String           _uri;
+  HTTPMethod       _method;
+  String           _responseHeaders;
+  size_t           _contentLength;
+  bool             _chunked;
+};
@@ -0,0 +1,136 @@
+/****************************************************
+ * WiFi (emulator)
+ * The ESP32 core's WiFi, WiFiServer and WiFiClient for
+ * the `native` env. Nothing touches a real network.
+ *
+ *  - WiFi.begin() associates after 1.5 s of fake time,
+ *    localIP() is the WiFi.config() address or 192.168.4.2
+ *  - WiFiServer::available() hands out a scripted client
+ *    every WIFI_EMU_REQUEST_MS (env, default 100) of fake
+ *    time. Each sends "GET <path> HTTP/1.1" + headers; the
+ *    paths cycle through WIFI_EMU_REQUESTS (env, comma
+ *    separated, default "/"). A path may carry extra
+ *    header lines: "/state|Accept: application/json"
+ *  - the peer closes after 2 s without data from it, so a
+ *    sketch waiting for more input doesn't spin forever
+ *  - bytes the sketch reads and writes are counted in
+ *    nativeStats().netRxBytes / netTxBytes; what it writes
+ *    is dropped, or appended to WIFI_EMU_TX=<file>
+ *
+ * Sockets are a fixed pool of WIFI_EMU_SOCKETS; copies of
+ * a WiFiClient share one socket like on the board.
+ ****************************************************/
+#pragma once
+
+#include <Arduino.h>
+
+#define WIFI_EMU_SOCKETS  4
+#define WIFI_EMU_RX_SIZE  512
+
+typedef enum {
+  WL_IDLE_STATUS     = 0,
+  WL_NO_SSID_AVAIL   = 1,
+  WL_SCAN_COMPLETED  = 2,
+  WL_CONNECTED       = 3,
+  WL_CONNECT_FAILED  = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED    = 6,
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF    = 0,
+  WIFI_STA    = 1,
+  WIFI_AP     = 2,
+  WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    _b[0] = a;
+    _b[1] = b;
+    _b[2] = c;
+    _b[3] = d;
+  }
+
+  uint8_t operator[](int i) const { return _b[i]; }
+  bool operator==(const IPAddress& o) const { return memcmp(_b, o._b, 4) == 0; }
+  bool operator!=(const IPAddress& o) const { return !(*this == o); }
+  String toString() const;
+  size_t printTo(Print& p) const override;
+
+private:
+  uint8_t _b[4];
+};
+
+class WiFiClient : public Print {
+public:
+  WiFiClient() : _sock(-1) {}
+  explicit WiFiClient(int8_t sock);
+  WiFiClient(const WiFiClient& c);
+  WiFiClient& operator=(const WiFiClient& c);
+  ~WiFiClient();
+
+  int     connect(const char* host, uint16_t port);   // always succeeds, peer sends nothing
+  int     connect(IPAddress ip, uint16_t port);
+  uint8_t connected();
+  int     available();
+  int     read();
+  int     read(uint8_t* buf, size_t size);
+  int     peek();
+  void    stop();
+  void    flush() {}
+  void    setTimeout(uint32_t) {}
+
+  size_t  write(uint8_t c) override;
+  size_t  write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+
+  operator bool() { return connected(); }
+
+private:
+  int8_t _sock;
+};
+
+class WiFiServer {
+public:
+  explicit WiFiServer(uint16_t port = 80) : _port(port), _listening(false), _lastMs(0) {}
+
+  void       begin() { _listening = true; }
+  void       end() { _listening = false; }
+  WiFiClient available();
+  WiFiClient accept() { return available(); }
+
+private:
+  uint16_t _port;
+  bool     _listening;
+  uint32_t _lastMs;
+};
+
+class WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* pass = nullptr);
+  bool        config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                     IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+  bool        disconnect(bool wifiOff = false);
+  bool        mode(wifi_mode_t m) { _mode = m; return true; }
+  bool        setSleep(bool) { return true; }
+  wl_status_t status();
+  bool        isConnected() { return status() == WL_CONNECTED; }
+
+  IPAddress   localIP();
+  int8_t      RSSI() { return status() == WL_CONNECTED ? -58 : 0; }
+
+  int16_t     scanNetworks();
+  String      SSID(uint8_t i);
+  int32_t     RSSI(uint8_t i);
+
+private:
+  wifi_mode_t _mode = WIFI_STA;
+  bool        _begun = false;
+  uint32_t    _beginMs = 0;
+  IPAddress   _ip = IPAddress(192, 168, 4, 2);
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,261 @@
+#include "WiFi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define WIFI_EMU_CONNECT_MS  1500
+#define WIFI_EMU_IDLE_MS     2000
+
+WiFiClass WiFi;
+
+// ---- IPAddress ----
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]);
+  return String(buf);
+}
+
+size_t IPAddress::printTo(Print& p) const {
+  size_t n = 0;
+  for (int i = 0; i < 4; i++) {
+    if (i) n += p.print('.');
+    n += p.print(_b[i], DEC);
+  }
+  return n;
+}
+
+// ---- Socket pool ----
+
+struct EmuSocket {
+  uint8_t  refs;
+  bool     open;       // sketch side
+  bool     peerOpen;
+  char     rx[WIFI_EMU_RX_SIZE];
+  uint16_t rxLen;
+  uint16_t rxPos;
+  uint32_t lastRxMs;   // peer's last activity, for the idle close
+};
+
+static EmuSocket s_sockets[WIFI_EMU_SOCKETS];
+
+static int8_t openSocket(const char* rx, uint16_t len) {
+  for (int8_t i = 0; i < WIFI_EMU_SOCKETS; i++) {
+    EmuSocket& s = s_sockets[i];
+    if (s.refs || s.open) continue;
+    if (len > WIFI_EMU_RX_SIZE) len = WIFI_EMU_RX_SIZE;
+    memcpy(s.rx, rx, len);
+    s.rxLen = len;
+    s.rxPos = 0;
+    s.open = true;
+    s.peerOpen = true;
+    s.lastRxMs = millis();
+    return i;
+  }
+  return -1;
+}
+
+static FILE* txFile() {
+  static bool checked = false;
+  static FILE* f = nullptr;
+  if (!checked) {
+    checked = true;
+    const char* path = getenv("WIFI_EMU_TX");
+    if (path) f = fopen(path, "ab");
+  }
+  return f;
+}
+
+// ---- WiFiClient ----
+
+WiFiClient::WiFiClient(int8_t sock) : _sock(sock) {
+  if (_sock >= 0) s_sockets[_sock].refs++;
+}
+
+WiFiClient::WiFiClient(const WiFiClient& c) : _sock(c._sock) {
+  if (_sock >= 0) s_sockets[_sock].refs++;
+}
+
+WiFiClient& WiFiClient::operator=(const WiFiClient& c) {
+  if (c._sock >= 0) s_sockets[c._sock].refs++;
+  if (_sock >= 0 && --s_sockets[_sock].refs == 0) s_sockets[_sock].open = false;
+  _sock = c._sock;
+  return *this;
+}
+
+// The last copy going away closes the socket, like the core's shared handle
+WiFiClient::~WiFiClient() {
+  if (_sock >= 0 && --s_sockets[_sock].refs == 0) s_sockets[_sock].open = false;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  int8_t sock = openSocket("", 0);
+  if (sock < 0) return 0;
+  WiFiClient c(sock);
+  *this = c;
+  return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  return connect("", port);
+}
+
+uint8_t WiFiClient::connected() {
+  if (_sock < 0) return 0;
+  EmuSocket& s = s_sockets[_sock];
+  if (!s.open) return 0;
+  if (s.rxPos < s.rxLen) return 1;
+
+  // Nothing left to read: a real peer waits a little, then gives up.
+  // Polling costs 1 ms of fake time, so a busy-wait reaches the close.
+  if (s.peerOpen) {
+    delay(1);
+    if (millis() - s.lastRxMs >= WIFI_EMU_IDLE_MS) s.peerOpen = false;
+  }
+  return s.peerOpen;
+}
+
+int WiFiClient::available() {
+  if (_sock < 0 || !s_sockets[_sock].open) return 0;
+  return s_sockets[_sock].rxLen - s_sockets[_sock].rxPos;
+}
+
+int WiFiClient::read() {
+  if (!available()) return -1;
+  EmuSocket& s = s_sockets[_sock];
+  nativeStats().netRxBytes++;
+  return (uint8_t)s.rx[s.rxPos++];
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  int n = 0;
+  while ((size_t)n < size && available()) buf[n++] = read();
+  return n;
+}
+
+int WiFiClient::peek() {
+  return available() ? (uint8_t)s_sockets[_sock].rx[s_sockets[_sock].rxPos] : -1;
+}
+
+void WiFiClient::stop() {
+  if (_sock < 0) return;
+  s_sockets[_sock].open = false;   // for every copy
+  s_sockets[_sock].refs--;
+  _sock = -1;
+}
+
+size_t WiFiClient::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+  if (_sock < 0 || !s_sockets[_sock].open) return 0;
+  nativeStats().netTxBytes += size;
+  if (FILE* f = txFile()) fwrite(buf, 1, size, f);
+  return size;
+}
+
+// ---- WiFiServer ----
+
+// Next path from WIFI_EMU_REQUESTS, round robin
+static void nextPath(char* out, size_t size) {
+  static const char* list = nullptr;
+  static const char* p = nullptr;
+  if (!list) {
+    list = getenv("WIFI_EMU_REQUESTS");
+    if (!list || !*list) list = "/";
+    p = list;
+  }
+  if (!*p) p = list;
+
+  size_t n = 0;
+  while (*p && *p != ',' && n < size - 1) out[n++] = *p++;
+  out[n] = 0;
+  if (*p == ',') p++;
+}
+
+WiFiClient WiFiServer::available() {
+  if (!_listening || WiFi.status() != WL_CONNECTED) return WiFiClient();
+
+  static long everyMs = -1;
+  if (everyMs < 0) {
+    const char* env = getenv("WIFI_EMU_REQUEST_MS");
+    everyMs = env ? atol(env) : 100;
+  }
+  if (millis() - _lastMs < (uint32_t)everyMs) return WiFiClient();
+
+  // "/path|Name: value|Name: value": extra header lines after the path
+  char path[256];
+  nextPath(path, sizeof(path));
+  char extra[256] = "";
+  if (char* bar = strchr(path, '|')) {
+    *bar = 0;
+    size_t n = 0;
+    for (const char* p = bar + 1; *p && n < sizeof(extra) - 3; p++) {
+      if (*p == '|') {
+        extra[n++] = '\r';
+        extra[n++] = '\n';
+      } else {
+        extra[n++] = *p;
+      }
+    }
+    extra[n] = 0;
+  }
+
+  char req[WIFI_EMU_RX_SIZE];
+  int len = snprintf(req, sizeof(req),
+                     "GET %s HTTP/1.1\r\nHost: 192.168.4.2\r\nUser-Agent: wifiemu\r\n"
+                     "%sAccept-Encoding: gzip, deflate\r\n%s%sConnection: close\r\n\r\n",
+                     path, strstr(extra, "Accept:") ? "" : "Accept: text/html\r\n",
+                     extra, extra[0] ? "\r\n" : "");
+
+  int8_t sock = openSocket(req, len < (int)sizeof(req) ? len : sizeof(req) - 1);
+  if (sock < 0) return WiFiClient();  // pool full: the client retries later
+  _lastMs = millis();
+  return WiFiClient(sock);
+}
+
+// ---- WiFiClass ----
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* pass) {
+  _begun = true;
+  _beginMs = millis();
+  return WL_DISCONNECTED;
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                       IPAddress dns1, IPAddress dns2) {
+  _ip = local;
+  return true;
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+  _begun = false;
+  return true;
+}
+
+wl_status_t WiFiClass::status() {
+  if (!_begun) return WL_DISCONNECTED;
+  return millis() - _beginMs >= WIFI_EMU_CONNECT_MS ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP() {
+  return status() == WL_CONNECTED ? _ip : IPAddress();
+}
+
+static const char* const s_ssids[] = { "Pixel :3", "Lab-2.4G", "eduroam" };
+static const int32_t s_rssi[] = { -48, -67, -81 };
+
+int16_t WiFiClass::scanNetworks() {
+  delay(2000);  // an active scan takes about this long
+  return 3;
+}
+
+String WiFiClass::SSID(uint8_t i) {
+  return String(i < 3 ? s_ssids[i] : "");
+}
+
+int32_t WiFiClass::RSSI(uint8_t i) {
+  return i < 3 ? s_rssi[i] : 0;
+}
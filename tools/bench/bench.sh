@@ -0,0 +1,120 @@
+#!/bin/bash
+# bench.sh - every project with an [env:native] section, headless
+#
+#   tools/bench/bench.sh [--loops N] [--csv] [project ...]
+#
+# Builds each project's native env (lib/NativeArduino plus the
+# SSD1306/DHT/WiFi emulators), runs setup() and N loop() passes
+# on the fake clock and prints one row per project from the
+# program's --bench line:
+#
+#   loops/s      real host throughput of loop()
+#   allocs       operator new calls per loop (String growth etc.)
+#   i2c, serial  bytes per loop the board would put on each bus
+#   1wire        DHT bytes per loop (the library caches for 2 s)
+#   net rx/tx    socket bytes per loop (WiFiEmu scripted clients)
+#
+# Host numbers compare versions of the same sketch; they are
+# not ESP32 timings. Sketch output goes to .pio/bench.log.
+#
+# Projects not ported to the native backend (no [env:native],
+# or a native env that only builds unit tests) get an n/a row
+# with the reason. A failed build or run is listed on stderr at
+# the end and the script exits 1.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+LOOPS=2000
+CSV=0
+PROJECTS=()
+FAILED=()
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --loops) LOOPS="$2"; shift 2 ;;
+    --csv)   CSV=1; shift ;;
+    *)       PROJECTS+=("$1"); shift ;;
+  esac
+done
+
+if [ ${#PROJECTS[@]} -eq 0 ]; then
+  for ini in "$ROOT"/*/platformio.ini; do
+    PROJECTS+=("$(basename "$(dirname "$ini")")")
+  done
+fi
+
+# Why a project has no program to run, empty if it has one
+why_na() {
+  local ini="$ROOT/$1/platformio.ini"
+  if [ ! -f "$ini" ]; then
+    echo "no platformio.ini"
+  elif ! grep -q '^\[env:native\]' "$ini"; then
+    echo "no [env:native]"
+  elif grep -q -- '-<main.cpp>' "$ini"; then
+    echo "native env builds unit tests only (pio test -e native)"
+  fi
+}
+
+# Per-project inputs for the emulators
+project_env() {
+  case "$1" in
+    # the page and its assets from flash, then what polls it
+    DHT11_Web_Server-*) echo "WIFI_EMU_REQUESTS=/,/app.js,/style.css,/data,/data,/metrics,/heap WIFI_EMU_REQUEST_MS=100" ;;
+    # a page load, then the two buttons as the page's fetch() sends them
+    Static_IP-*)        echo "WIFI_EMU_REQUESTS=/,/LED=ON|Accept:application/json,/LED=OFF|Accept:application/json WIFI_EMU_REQUEST_MS=100" ;;
+    *)                  echo "" ;;
+  esac
+}
+
+field() {  # field <bench line> <key>
+  sed -n "s|.* $2=\([^ ]*\).*|\1|p" <<< "$1"
+}
+
+if [ $CSV -eq 1 ]; then
+  echo "project,loops_per_s,ns_per_loop,allocs_per_loop,i2c_bytes,serial_bytes,onewire_bytes,net_rx,net_tx"
+else
+  printf "%-32s %12s %10s %8s %8s %8s %7s %8s %8s\n" \
+         project loops/s ns/loop allocs i2c serial 1wire "net rx" "net tx"
+fi
+
+for p in "${PROJECTS[@]}"; do
+  dir="$ROOT/$p"
+  why=$(why_na "$p")
+  if [ -n "$why" ]; then
+    if [ $CSV -eq 1 ]; then
+      echo "$p,n/a,,,,,,,"
+    else
+      printf "%-32s %12s   %s\n" "$p" n/a "$why"
+    fi
+    continue
+  fi
+  if ! pio run -d "$dir" -e native -s > /dev/null; then
+    FAILED+=("$p: native build failed")
+    continue
+  fi
+
+  line=$(env $(project_env "$p") "$dir/.pio/build/native/program" \
+           --loops "$LOOPS" --bench "$p" 2>&1 > "$dir/.pio/bench.log" | grep '^bench:' || true)
+  if [ -z "$line" ]; then
+    FAILED+=("$p: no bench line (see $dir/.pio/bench.log)")
+    continue
+  fi
+
+  vals=()
+  for k in loops/s ns/loop allocs/loop i2c_bytes/loop serial_bytes/loop onewire_bytes/loop net_rx/loop net_tx/loop; do
+    vals+=("$(field "$line" "$k")")
+  done
+
+  if [ $CSV -eq 1 ]; then
+    (IFS=,; echo "$p,${vals[*]}")
+  else
+    printf "%-32s %12s %10s %8s %8s %8s %7s %8s %8s\n" "$p" "${vals[@]}"
+  fi
+done
+
+if [ ${#FAILED[@]} -gt 0 ]; then
+  echo >&2
+  echo "FAILED (${#FAILED[@]} of ${#PROJECTS[@]}):" >&2
+  printf '  %s\n' "${FAILED[@]}" >&2
+  exit 1
+fi
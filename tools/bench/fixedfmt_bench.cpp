@@ -0,0 +1,78 @@
+/****************************************************
+ * fixedfmt_bench
+ * Calls per second of fmtFixed against snprintf("%.*f")
+ * and Arduino's Print::print(float, n), on the PC, over
+ * sensor-range values (-40 to 125) at 0, 1, 2 and 6
+ * decimals. Print writes to a sink that drops the text.
+ *
+ *   g++ -std=gnu++17 -O2 -I lib/NativeArduino -I lib/FixedFmt \
+ *       -o fixedfmt_bench tools/bench/fixedfmt_bench.cpp lib/FixedFmt/FixedFmt.cpp \
+ *       lib/NativeArduino/{NativeArduino,Print,WString}.cpp
+ *
+ *   ./fixedfmt_bench              # 2000000 calls per case
+ *   ./fixedfmt_bench 200000
+ *
+ * Exactness is tools/libtest's test_fixedfmt; this only
+ * times. The ratio is what to look at, ESP32 times are larger.
+ ****************************************************/
+#include <Arduino.h>
+#include <FixedFmt.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define VALUES 1024   // power of two
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+class NullPrint : public Print {
+public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, size_t size) override { return size; }
+};
+
+static const uint8_t DECIMALS[] = { 0, 1, 2, 6 };
+
+int main(int argc, char** argv) {
+  long calls = argc > 1 ? atol(argv[1]) : 2000000;
+
+  // Fixed-seed xorshift: the same values every run
+  static float values[VALUES];
+  uint32_t rng = 0x9E3779B9;
+  for (float& v : values) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    v = -40.0f + (rng >> 8) * (165.0f / (1 << 24));
+  }
+
+  NullPrint sink;
+  char buf[FIXED_NUM_SIZE];
+  size_t total = 0;   // keeps the calls from being dropped
+
+  printf("%-9s %14s %14s %14s %7s %7s\n", "decimals", "fmtFixed/s", "snprintf/s",
+         "print/s", "vs snp", "vs prn");
+  for (uint8_t d : DECIMALS) {
+    double t0 = nowSeconds();
+    for (long i = 0; i < calls; i++) total += fmtFixed(buf, sizeof(buf), values[i & (VALUES - 1)], d);
+    double fixed = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    for (long i = 0; i < calls; i++) total += snprintf(buf, sizeof(buf), "%.*f", d, (double)values[i & (VALUES - 1)]);
+    double snp = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    for (long i = 0; i < calls; i++) total += sink.print(values[i & (VALUES - 1)], d);
+    double prn = nowSeconds() - t0;
+
+    printf("%-9u %14.0f %14.0f %14.0f %6.1fx %6.1fx\n", d, calls / fixed, calls / snp,
+           calls / prn, snp / fixed, prn / fixed);
+  }
+  printf("(%zu characters)\n", total);
+  return 0;
+}
@@ -0,0 +1,153 @@
+/****************************************************
+ * metrics_bench
+ * Render time of metricsRender() on the PC, with the
+ * same metrics DHT11_Web_Server registers (callbacks
+ * return constants here). Two sinks: one that takes
+ * the whole body at once, and the sketch's 512 B chunk
+ * buffer with a send that drops the chunk, so the second
+ * line is what a scrape costs before the socket writes.
+ *
+ *   g++ -std=gnu++17 -O2 -I lib/NativeArduino -I lib/FixedFmt -I lib/Metrics \
+ *       -o metrics_bench tools/bench/metrics_bench.cpp lib/Metrics/Metrics.cpp \
+ *       lib/FixedFmt/FixedFmt.cpp lib/NativeArduino/{NativeArduino,Print}.cpp
+ *
+ *   ./metrics_bench            # 200000 renders per case
+ *   ./metrics_bench 20000
+ *
+ * The ratio and the size are what to look at, ESP32
+ * times are larger.
+ ****************************************************/
+#include <Metrics.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ---- DHT11_Web_Server's metrics, in its order ----
+MetricCallback uptimeSeconds("uptime_seconds", "Seconds since boot", METRIC_GAUGE,
+                             [] { return 86400.0f; });
+MetricCallback heapFree("heap_free_bytes", "Free heap", METRIC_GAUGE,
+                        [] { return 214312.0f; });
+MetricCallback heapMinFree("heap_min_free_bytes", "Lowest free heap since boot", METRIC_GAUGE,
+                           [] { return 198004.0f; });
+MetricCallback heapMaxAlloc("heap_max_alloc_bytes", "Largest allocatable block", METRIC_GAUGE,
+                            [] { return 110580.0f; });
+MetricCallback wifiRssi("wifi_rssi_dbm", "Signal of the connected AP, NaN when not connected",
+                        METRIC_GAUGE, [] { return -61.0f; });
+MetricCallback logDropped("ringlog_dropped_total", "Log lines lost to a full ring", METRIC_COUNTER,
+                          [] { return 0.0f; });
+
+MetricCounter dhtReads("dht_reads_total", "DHT reads, button and background");
+MetricCounter dhtFailures("dht_read_failures_total", "DHT reads that returned NaN");
+MetricCounter dhtFlagged("dht_flagged_readings_total", "Readings flagged by the window stats");
+static const uint32_t dhtReadBounds[] = { 2000, 5000, 10000, 20000, 30000, 50000, 100000 };
+MetricHistogram<7> dhtReadTime("dht_read_duration_seconds", "Time to read humidity and temperature",
+                               dhtReadBounds, 1e-6f);
+MetricGauge temperatureGauge("dht_temperature_celsius", "Last valid temperature");
+MetricGauge humidityGauge("dht_humidity_percent", "Last valid humidity");
+MetricCounter buttonPresses("button_presses_total", "Debounced button presses");
+
+MetricCounter httpRoot("http_requests_total", "HTTP requests by path", "path=\"/\"");
+MetricCounter httpMetrics("http_requests_total", "HTTP requests by path", "path=\"/metrics\"");
+MetricCounter httpOther("http_requests_total", "HTTP requests by path", "path=\"other\"");
+static const uint32_t httpBounds[] = { 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000 };
+MetricHistogram<8> httpTime("http_request_duration_seconds", "Handler time, including the send",
+                            httpBounds, 1e-6f);
+
+// Takes the whole body, like a String or a socket with room to spare
+class BulkSink : public Print {
+public:
+  size_t n = 0;
+  size_t write(uint8_t c) override { buf[n++ & 8191] = c; return 1; }
+  size_t write(const uint8_t* p, size_t len) override {
+    for (size_t i = 0; i < len; i++) buf[(n + i) & 8191] = p[i];
+    n += len;
+    return len;
+  }
+
+private:
+  uint8_t buf[8192];
+};
+
+// The sketch's ChunkedResponse, with sendContent() replaced by a count
+class ChunkSink : public Print {
+public:
+  size_t sent = 0, chunks = 0;
+
+  size_t write(uint8_t c) override {
+    if (_n == sizeof(_buf)) send();
+    _buf[_n++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* p, size_t len) override {
+    size_t done = 0;
+    while (done < len) {
+      if (_n == sizeof(_buf)) send();
+      size_t n = len - done < sizeof(_buf) - _n ? len - done : sizeof(_buf) - _n;
+      memcpy(_buf + _n, p + done, n);
+      _n += n;
+      done += n;
+    }
+    return len;
+  }
+
+  void send() {
+    if (_n) {
+      sent += _n;
+      chunks++;
+    }
+    _n = 0;
+  }
+
+private:
+  uint8_t _buf[512];
+  size_t  _n = 0;
+};
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+  long renders = argc > 1 ? atol(argv[1]) : 200000;
+
+  // Some traffic, so the histograms have counts in several buckets
+  for (uint32_t i = 0; i < 1000; i++) {
+    dhtReads.inc();
+    dhtReadTime.observe(18000 + i * 37 % 30000);
+    httpRoot.inc();
+    httpTime.observe(800 + i * 97 % 90000);
+  }
+  temperatureGauge.set(23.4f);
+  humidityGauge.set(51.0f);
+
+  BulkSink bulk;
+  metricsRender(bulk);
+  size_t bytes = bulk.n;
+
+  double t0 = nowSeconds();
+  for (long i = 0; i < renders; i++) metricsRender(bulk);
+  double tBulk = nowSeconds() - t0;
+
+  ChunkSink chunk;
+  t0 = nowSeconds();
+  for (long i = 0; i < renders; i++) {
+    metricsRender(chunk);
+    chunk.send();
+  }
+  double tChunk = nowSeconds() - t0;
+
+  int metrics = 0;
+  for (const Metric* m = metricsFirst(); m; m = m->next()) metrics++;
+  printf("%d metrics, %lu bytes per scrape, %lu chunks of up to 512 B\n", metrics,
+         (unsigned long)bytes, (unsigned long)(chunk.chunks / renders));
+  printf("bulk sink      %6.2f us/render  %7.0f MB/s\n", tBulk / renders * 1e6,
+         bytes * renders / tBulk / 1e6);
+  printf("512 B chunks   %6.2f us/render  %7.0f MB/s\n", tChunk / renders * 1e6,
+         bytes * renders / tChunk / 1e6);
+  return chunk.sent == bytes * renders ? 0 : 1;
+}
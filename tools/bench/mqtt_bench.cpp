@@ -0,0 +1,135 @@
+/****************************************************
+ * mqtt_bench
+ * Publish throughput of Blynk_DHT's MqttClient on the PC:
+ * the 9-byte SensorPayload at QoS 0 and QoS 1, through an
+ * in-process broker that acks every QoS 1 publish, or a
+ * real one over PosixSocketTransport.
+ *
+ *   g++ -O2 -I Blynk_DHT-Week12-Lecture1/include -o mqtt_bench \
+ *       tools/bench/mqtt_bench.cpp Blynk_DHT-Week12-Lecture1/src/MqttClient.cpp
+ *
+ *   ./mqtt_bench                          # 1000000 per QoS, in-process
+ *   ./mqtt_bench 20000 127.0.0.1:1883     # count, broker
+ *
+ * In-process numbers are the client's own cost (packet
+ * building, window, ack parsing); with a broker they add
+ * the socket and broker round trips. Bytes per message
+ * are what the ESP32 would put on the air.
+ ****************************************************/
+#include "MqttClient.h"
+#include "PosixSocketTransport.h"
+#include "SensorPayload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TOPIC "iotlabs/env-node-1/env"
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t wallClock() {
+  return (uint32_t)(nowSeconds() * 1000);
+}
+
+// Acks CONNECT and every QoS 1 PUBLISH as it is written, drops the rest
+class AckingBroker : public MqttTransport {
+public:
+  bool   open(const char*, uint16_t) override { return _open = true; }
+  void   close() override { _open = false; }
+  bool   isOpen() override { return _open; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    uint8_t type = data[0] & 0xF0;
+    if (type == 0x10) queue((const uint8_t*)"\x20\x02\x00\x00", 4);
+    if (type == 0x30 && (data[0] & 0x06)) {
+      // 1-byte remaining length: the sketch's packets are small
+      uint16_t topicLen = (data[2] << 8) | data[3];
+      uint8_t ack[4] = { 0x40, 2, data[4 + topicLen], data[5 + topicLen] };
+      queue(ack, 4);
+    }
+    return len;
+  }
+
+  int read(uint8_t* buf, size_t max) override {
+    size_t n = _len < max ? _len : max;
+    memcpy(buf, _buf, n);
+    memmove(_buf, _buf + n, _len - n);
+    _len -= n;
+    return (int)n;
+  }
+
+private:
+  void queue(const uint8_t* p, size_t n) {
+    if (_len + n <= sizeof(_buf)) {
+      memcpy(_buf + _len, p, n);
+      _len += n;
+    }
+  }
+
+  bool    _open = false;
+  uint8_t _buf[256];
+  size_t  _len = 0;
+};
+
+static int run(MqttTransport& transport, const char* host, uint16_t port, long count) {
+  MqttClient client(transport, wallClock);
+  client.setServer(host, port);
+  client.setKeepAlive(0);
+  if (!client.connect("iotlabs-bench", true)) {
+    fprintf(stderr, "connect to %s:%u failed\n", host, port);
+    return 1;
+  }
+
+  uint8_t payload[SENSOR_PAYLOAD_SIZE];
+  for (uint8_t qos = 0; qos <= 1; qos++) {
+    MqttStats before = client.stats();
+    long full = 0;
+    double t0 = nowSeconds();
+    for (long i = 0; i < count; i++) {
+      uint8_t n = encodeSensorPayload(payload, 20.0f + (i % 100) * 0.1f, 40.0f + i % 30, 1700000000 + i);
+      bool waited = false;
+      while (!client.publish(TOPIC, payload, n, qos)) {
+        if (!client.connected()) {
+          fprintf(stderr, "connection lost after %ld\n", i);
+          return 1;
+        }
+        if (!waited) full++;   // window full: wait for acks
+        waited = true;
+        client.loop();
+      }
+      client.loop();
+    }
+    while (client.inFlight() && client.connected()) client.loop();
+    double dt = nowSeconds() - t0;
+
+    const MqttStats& s = client.stats();
+    printf("QoS %u  %10.0f msg/s  %6.2f us/msg  %5.1f bytes/msg out  %5.1f in  waited for the window %ld\n",
+           qos, count / dt, dt * 1e6 / count, (double)(s.bytesOut - before.bytesOut) / count,
+           (double)(s.bytesIn - before.bytesIn) / count, full);
+  }
+  client.disconnect();
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  long count = argc > 1 ? atol(argv[1]) : 1000000;
+  if (argc > 2) {
+    char host[64];
+    snprintf(host, sizeof(host), "%s", argv[2]);
+    uint16_t port = 1883;
+    if (char* colon = strrchr(host, ':')) {
+      *colon = 0;
+      port = (uint16_t)atoi(colon + 1);
+    }
+    PosixSocketTransport socket;
+    return run(socket, host, port, count);
+  }
+  AckingBroker broker;
+  return run(broker, "in-process", 0, count);
+}
@@ -0,0 +1,80 @@
+/****************************************************
+ * ringlog_bench
+ * What a log line costs the calling task with RingLog
+ * against Serial.printf, on the PC: RLOG_I with two
+ * floats and with a copied string, the same line through
+ * Print::printf into a Print that throws the bytes away,
+ * and the drain side (formatting) per record.
+ *
+ *   g++ -std=gnu++17 -O2 -I lib/NativeArduino -I lib/FixedFmt -I lib/RingLog \
+ *       -o ringlog_bench tools/bench/ringlog_bench.cpp lib/RingLog/RingLog.cpp \
+ *       lib/FixedFmt/FixedFmt.cpp lib/NativeArduino/{NativeArduino,Print}.cpp
+ *
+ *   ./ringlog_bench            # 2000000 lines per case
+ *   ./ringlog_bench 200000
+ *
+ * The ring is drained every BATCH calls outside the
+ * timed part, so every call finds a free slot.
+ ****************************************************/
+#include <RingLog.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BATCH (RLOG_SLOTS / 2)
+
+// Stands in for Serial: takes the bytes, does nothing with them
+class NullPrint : public Print {
+public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, size_t size) override { return size; }
+};
+
+static NullPrint sink;
+static volatile float temp = 23.4f, hum = 51.0f;
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void logFloats()  { RLOG_I("Temp: %.1f C  Hum: %.0f %%", temp, hum); }
+static void logString()  { RLOG_I("GET %s from %s", "/data", "192.168.1.20"); }
+static void printFloats() { sink.printf("Temp: %.1f C  Hum: %.0f %%\n", temp, hum); }
+
+// Seconds spent in fn over lines calls; drain time goes to *drain
+static double run(void (*fn)(), long lines, double* drain) {
+  double spent = 0, drained = 0;
+  for (long done = 0; done < lines; done += BATCH) {
+    double t0 = nowSeconds();
+    for (int i = 0; i < BATCH; i++) fn();
+    double t1 = nowSeconds();
+    ringLogDrain(sink);
+    drained += nowSeconds() - t1;
+    spent += t1 - t0;
+  }
+  if (drain) *drain = drained;
+  return spent;
+}
+
+int main(int argc, char** argv) {
+  long lines = argc > 1 ? atol(argv[1]) : 2000000;
+  lines -= lines % BATCH;
+  if (lines <= 0) lines = BATCH;
+
+  double drainFloats, drainString;
+  double floats = run(logFloats, lines, &drainFloats);
+  double str = run(logString, lines, &drainString);
+  double print = run(printFloats, lines, nullptr);
+
+  RingLogStats s = ringLogStats();
+  printf("RLOG_I, two floats      %7.1f ns/call   drain %7.1f ns/record\n",
+         floats / lines * 1e9, drainFloats / lines * 1e9);
+  printf("RLOG_I, two strings     %7.1f ns/call   drain %7.1f ns/record\n",
+         str / lines * 1e9, drainString / lines * 1e9);
+  printf("Print::printf, floats   %7.1f ns/call\n", print / lines * 1e9);
+  printf("dropped %lu (should be 0)\n", (unsigned long)s.dropped);
+  return s.dropped ? 1 : 0;
+}
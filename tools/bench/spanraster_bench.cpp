@@ -0,0 +1,87 @@
+/****************************************************
+ * spanraster_bench
+ * Pixels per second through SpanRaster against the GFX
+ * calls it replaces, per primitive, on the PC against the
+ * SSD1306 emulator. Pixel counts are what the primitive
+ * covers on the 128x64 panel (GFX plots each of them).
+ *
+ *   g++ -std=gnu++17 -O2 -I lib/NativeArduino -I lib/SSD1306Emu -I lib/SpanRaster \
+ *       -o spanraster_bench tools/bench/spanraster_bench.cpp lib/SpanRaster/SpanRaster.cpp \
+ *       lib/SSD1306Emu/*.cpp lib/NativeArduino/{NativeArduino,Print,WString,Wire}.cpp
+ *
+ *   ./spanraster_bench            # 200000 calls per case
+ *   ./spanraster_bench 20000
+ *
+ * Exactness is tools/libtest's test_spanraster; this only
+ * times. The ratio is what to look at, ESP32 times are larger.
+ ****************************************************/
+#include <Adafruit_SSD1306.h>
+#include <SpanRaster.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define W 128
+#define H 64
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct Case {
+  const char* name;
+  uint32_t    pixels;   // covered per call
+  void (*gfx)(Adafruit_SSD1306& d, int i);
+  void (*span)(SpanRaster& r, int i);
+};
+
+// i moves the primitive a little each call so nothing is hoisted
+static const Case CASES[] = {
+  { "hline 128",        W,
+    [](Adafruit_SSD1306& d, int i) { d.drawFastHLine(0, i & 63, W, SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.drawFastHLine(0, i & 63, W, SSD1306_INVERSE); } },
+  { "vline 64",         H,
+    [](Adafruit_SSD1306& d, int i) { d.drawFastVLine(i & 127, 0, H, SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.drawFastVLine(i & 127, 0, H, SSD1306_INVERSE); } },
+  { "line diagonal",    W,
+    [](Adafruit_SSD1306& d, int i) { d.drawLine(0, i & 7, W - 1, H - 1 - (i & 7), SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.drawLine(0, i & 7, W - 1, H - 1 - (i & 7), SSD1306_INVERSE); } },
+  { "line shallow",     W,
+    [](Adafruit_SSD1306& d, int i) { d.drawLine(0, i & 31, W - 1, (i & 31) + 9, SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.drawLine(0, i & 31, W - 1, (i & 31) + 9, SSD1306_INVERSE); } },
+  { "rect border",      2 * W + 2 * H - 4,
+    [](Adafruit_SSD1306& d, int i) { d.drawRect(0, 0, W, H, SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.drawRect(0, 0, W, H, SSD1306_INVERSE); } },
+  { "fillRect 60x20",   60 * 20,
+    [](Adafruit_SSD1306& d, int i) { d.fillRect(i & 63, 5 + (i & 31), 60, 20, SSD1306_INVERSE); },
+    [](SpanRaster& r, int i)       { r.fillRect(i & 63, 5 + (i & 31), 60, 20, SSD1306_INVERSE); } },
+  { "fillScreen",       W * H,
+    [](Adafruit_SSD1306& d, int i) { d.fillScreen(i & 1); },
+    [](SpanRaster& r, int i)       { r.fillScreen(i & 1); } },
+};
+
+int main(int argc, char** argv) {
+  long calls = argc > 1 ? atol(argv[1]) : 200000;
+
+  Adafruit_SSD1306 display(W, H);
+  display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  SpanRaster raster(display);
+
+  printf("%-16s %16s %16s %7s\n", "primitive", "GFX px/s", "SpanRaster px/s", "ratio");
+  for (const Case& c : CASES) {
+    double t0 = nowSeconds();
+    for (long i = 0; i < calls; i++) c.gfx(display, (int)i);
+    double gfx = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    for (long i = 0; i < calls; i++) c.span(raster, (int)i);
+    double span = nowSeconds() - t0;
+
+    double pixels = (double)calls * c.pixels;
+    printf("%-16s %16.0f %16.0f %6.1fx\n", c.name, pixels / gfx, pixels / span, gfx / span);
+  }
+  return 0;
+}
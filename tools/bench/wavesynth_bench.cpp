@@ -0,0 +1,78 @@
+/****************************************************
+ * wavesynth_bench
+ * Cost of PWM-Week5-Lecture2's WaveSynth mixing kernel on
+ * the PC: render() in 256-sample blocks (what the I2S task
+ * asks for) with 1..4 voices held in sustain, and
+ * renderDac() with all four.
+ *
+ *   g++ -std=gnu++17 -O2 -I PWM-Week5-Lecture2/include -o wavesynth_bench \
+ *       tools/bench/wavesynth_bench.cpp PWM-Week5-Lecture2/src/WaveSynth.cpp
+ *
+ *   ./wavesynth_bench            # 20000 blocks per case
+ *   ./wavesynth_bench 2000
+ *
+ * "us/block" compares with the 11.6 ms a 256-sample block
+ * lasts at the sketch's 22050 Hz; on the ESP32 the same
+ * ratio is the load I2sDac's stats report.
+ ****************************************************/
+#include "WaveSynth.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RATE   22050
+#define BLOCK  256
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Voices on different waves and pitches, like the demo's melody over a pad
+static void startVoices(WaveSynth& synth, uint8_t voices) {
+  static const SynthWave waves[] = { WAVE_TRIANGLE, WAVE_SAW, WAVE_SINE, WAVE_SQUARE };
+  static const uint16_t hz[] = { 440, 110, 660, 220 };
+  for (uint8_t v = 0; v < voices; v++) synth.noteOn(v, hz[v], waves[v]);
+
+  int16_t warm[BLOCK];
+  for (int i = 0; i < 20; i++) synth.render(warm, BLOCK);   // past attack and decay
+}
+
+static volatile int32_t sink;   // keeps the output observable
+
+static void report(const char* name, uint8_t voices, long blocks, double dt) {
+  double samples = (double)blocks * BLOCK;
+  printf("%-10s %u voice%s %8.1f Msamples/s %8.1f M voice-samples/s %7.3f us/block\n",
+         name, voices, voices == 1 ? " " : "s", samples / dt / 1e6, samples * voices / dt / 1e6,
+         dt * 1e6 / blocks);
+}
+
+int main(int argc, char** argv) {
+  long blocks = argc > 1 ? atol(argv[1]) : 20000;
+
+  for (uint8_t voices = 1; voices <= SYNTH_VOICES; voices++) {
+    WaveSynth synth(RATE);
+    startVoices(synth, voices);
+
+    int16_t out[BLOCK];
+    double t0 = nowSeconds();
+    for (long b = 0; b < blocks; b++) {
+      synth.render(out, BLOCK);
+      sink = sink + out[b & (BLOCK - 1)];
+    }
+    report("render", voices, blocks, nowSeconds() - t0);
+  }
+
+  WaveSynth synth(RATE);
+  startVoices(synth, SYNTH_VOICES);
+  uint16_t frames[2 * BLOCK];
+  double t0 = nowSeconds();
+  for (long b = 0; b < blocks; b++) {
+    synth.renderDac(frames, BLOCK);
+    sink = sink + frames[b & (BLOCK - 1)];
+  }
+  report("renderDac", SYNTH_VOICES, blocks, nowSeconds() - t0);
+  return 0;
+}
@@ -0,0 +1,190 @@
+// fmtFixed against snprintf("%.*f"): pio test -e native -f test_fixedfmt
+#include <unity.h>
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <FixedFmt.h>
+
+static char got[64];
+static char want[64];
+
+// Fixed-seed xorshift, the same floats on every run
+static uint32_t rng;
+
+static uint32_t next32() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static float fromBits(uint32_t bits) {
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+// Same text and length as snprintf, or a message naming the float
+static void assertLikePrintf(float v, uint8_t decimals) {
+  int n = snprintf(want, sizeof(want), "%.*f", decimals, (double)v);
+  size_t len = fmtFixed(got, sizeof(got), v, decimals);
+  if (len == (size_t)n && strcmp(got, want) == 0) return;
+
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  char msg[200];
+  snprintf(msg, sizeof(msg), "0x%08x %.9g, %u decimals: want '%s' got '%s' (%u)",
+           (unsigned)bits, (double)v, decimals, want, got, (unsigned)len);
+  TEST_FAIL_MESSAGE(msg);
+}
+
+static void assertText(const char* expect, float v, uint8_t decimals, const char* err = nullptr) {
+  size_t len = fmtFixed(got, sizeof(got), v, decimals, err);
+  TEST_ASSERT_EQUAL_STRING(expect, got);
+  TEST_ASSERT_EQUAL(strlen(expect), len);
+}
+
+void setUp() {
+  rng = 0x9E3779B9;
+}
+
+void tearDown() {}
+
+// Every decimal count over what the sensors produce: each
+// hundredth and the floats either side of it
+void test_sensor_range_matches_printf() {
+  for (int i = -6000; i <= 16000; i++) {
+    float v = i / 100.0f;
+    float around[3] = { nextafterf(v, -INFINITY), v, nextafterf(v, INFINITY) };
+    for (float f : around) {
+      for (uint8_t d = 0; d <= FIXED_MAX_DECIMALS; d++) assertLikePrintf(f, d);
+    }
+  }
+}
+
+// Random bit patterns across every exponent, both paths
+void test_random_floats_match_printf() {
+  for (int i = 0; i < 300000; i++) {
+    float v = fromBits(next32());
+    if (isnan(v) || isinf(v)) continue;
+    assertLikePrintf(v, (uint8_t)(i % (FIXED_MAX_DECIMALS + 1)));
+  }
+}
+
+void test_subnormals() {
+  assertLikePrintf(fromBits(0x00000001), 6);   // smallest, 1.4e-45
+  assertLikePrintf(fromBits(0x007FFFFF), 6);   // largest subnormal
+  assertLikePrintf(fromBits(0x80000001), 0);   // "-0"
+  for (int i = 0; i < 10000; i++) {
+    float v = fromBits(next32() & 0x807FFFFF);
+    assertLikePrintf(v, (uint8_t)(i % (FIXED_MAX_DECIMALS + 1)));
+  }
+  assertText("-0.000000", fromBits(0x80000001), 6);
+}
+
+// Exactly half a unit is rounded to the even neighbour, like printf
+void test_ties_to_even() {
+  assertText("0", 0.5f, 0);
+  assertText("2", 1.5f, 0);
+  assertText("2", 2.5f, 0);
+  assertText("4", 3.5f, 0);
+  assertText("-2", -2.5f, 0);
+  assertText("0.12", 0.125f, 2);
+  assertText("0.38", 0.375f, 2);
+  assertText("23.2", 23.25f, 1);
+  assertText("23.8", 23.75f, 1);
+  assertText("0.062", 0.0625f, 3);
+  // 23.45f is 23.4500007...: not a tie, rounds up
+  assertText("23.5", 23.45f, 1);
+  // 0.35f is 0.3499999...: rounds down
+  assertText("0.3", 0.35f, 1);
+}
+
+void test_negative_zero() {
+  assertText("-0.0", -0.0f, 1);
+  assertText("-0", -0.0f, 0);
+  assertText("0.0", 0.0f, 1);
+  assertText("-0.0", -0.04f, 1);   // rounds to zero, keeps the sign
+  assertLikePrintf(-0.0f, 3);
+  assertLikePrintf(-0.04f, 1);
+}
+
+void test_nan_and_inf() {
+  assertText("nan", NAN, 1);
+  assertText("-nan", -NAN, 1);
+  assertText("inf", INFINITY, 2);
+  assertText("-inf", -INFINITY, 0);
+
+  assertText("--", NAN, 1, "--");
+  assertText("--", -NAN, 1, "--");
+  assertText("n/a", INFINITY, 1, "n/a");
+  assertText("n/a", -INFINITY, 1, "n/a");
+  assertText("", NAN, 1, "");
+
+  // An error text is only for NaN/inf
+  assertText("21.5", 21.5f, 1, "--");
+}
+
+// From 2^43 up the C library formats it; still the same text
+void test_big_values_fall_back_to_printf() {
+  assertLikePrintf(8796093022208.0f, 1);    // 2^43, the integer path's last
+  assertLikePrintf(17592186044416.0f, 1);   // 2^44, the fallback's first
+  assertLikePrintf(1e15f, 6);
+  assertLikePrintf(-3e20f, 2);
+  assertLikePrintf(FLT_MAX, 0);
+  assertLikePrintf(-FLT_MAX, 6);
+
+  // FLT_MAX with 6 decimals is 46 characters: too long for FixedNum
+  FixedNum big(FLT_MAX, 6);
+  TEST_ASSERT_EQUAL(0, big.length());
+  TEST_ASSERT_EQUAL_STRING("", big.c_str());
+  FixedNum fits(1e15f, 1);
+  TEST_ASSERT_EQUAL_STRING("999999986991104.0", fits.c_str());
+}
+
+void test_too_small_buffer() {
+  char buf[8];
+
+  TEST_ASSERT_EQUAL(5, fmtFixed(buf, 6, -23.4f, 1));
+  TEST_ASSERT_EQUAL_STRING("-23.4", buf);
+
+  memset(buf, 'x', sizeof(buf));
+  TEST_ASSERT_EQUAL(0, fmtFixed(buf, 5, -23.4f, 1));
+  TEST_ASSERT_EQUAL_STRING("", buf);
+
+  memset(buf, 'x', sizeof(buf));
+  TEST_ASSERT_EQUAL(0, fmtFixed(buf, 0, 1.0f, 0));
+  TEST_ASSERT_EQUAL('x', buf[0]);   // size 0: nothing written at all
+
+  TEST_ASSERT_EQUAL(0, fmtFixed(buf, 3, NAN, 1));   // "nan" + \0 is 4
+  TEST_ASSERT_EQUAL_STRING("", buf);
+  TEST_ASSERT_EQUAL(0, fmtFixed(buf, 4, NAN, 1, "Error"));
+  TEST_ASSERT_EQUAL_STRING("", buf);
+
+  TEST_ASSERT_EQUAL(0, fmtFixed(buf, sizeof(buf), 1e20f, 0));   // fallback, 21 chars
+  TEST_ASSERT_EQUAL_STRING("", buf);
+}
+
+// More than FIXED_MAX_DECIMALS is clamped
+void test_decimals_clamped() {
+  assertText("3.141593", 3.14159265f, 9);
+  FixedNum n(3.14159265f, 200);
+  TEST_ASSERT_EQUAL(8, n.length());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sensor_range_matches_printf);
+  RUN_TEST(test_random_floats_match_printf);
+  RUN_TEST(test_subnormals);
+  RUN_TEST(test_ties_to_even);
+  RUN_TEST(test_negative_zero);
+  RUN_TEST(test_nan_and_inf);
+  RUN_TEST(test_big_values_fall_back_to_printf);
+  RUN_TEST(test_too_small_buffer);
+  RUN_TEST(test_decimals_clamped);
+  return UNITY_END();
+}
@@ -0,0 +1,175 @@
+// HeapMon's allocation sites (HEAPMON_TRACE) through NativeArduino's
+// operator new hook: pio test -e native -f test_heaptrace
+#include <unity.h>
+
+#include <HeapMon.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nothing in here may use the heap besides what it traces: the
+// reference model is plain arrays.
+#define SITES     4         // 0 is no scope, "(other)"
+#define MAX_LIVE  200       // under HEAPMON_TRACKED - 1
+#define OPS       200000UL
+
+static const char* const NAMES[SITES] = { "(other)", "trace_a", "trace_b", "trace_c" };
+
+struct Ref {
+  int32_t  liveBytes;
+  uint32_t liveBlocks;
+  uint32_t allocs;
+  uint32_t bytes;
+};
+
+static HeapSite sites[HEAPMON_SITES];
+
+static const HeapSite* site(const char* name) {
+  uint8_t n = heapMonSites(sites);
+  for (uint8_t i = 0; i < n; i++) {
+    if (!strcmp(sites[i].name, name)) return &sites[i];
+  }
+  return nullptr;
+}
+
+// new[] inside the site's HEAP_SCOPE (one scope per line)
+static uint8_t* allocIn(uint8_t s, size_t n) {
+  switch (s) {
+    case 1: { HEAP_SCOPE("trace_a"); return new uint8_t[n]; }
+    case 2: { HEAP_SCOPE("trace_b"); return new uint8_t[n]; }
+    case 3: {
+      HEAP_SCOPE("trace_c");
+      { HEAP_SCOPE("trace_b"); }   // an inner scope that ended is not the innermost
+      return new uint8_t[n];
+    }
+    default: return new uint8_t[n];
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Random alloc/free from several sites, checked after every step
+void test_random_against_reference() {
+  static uint8_t* blocks[MAX_LIVE];
+  static uint16_t sizes[MAX_LIVE];
+  static uint8_t  owner[MAX_LIVE];
+  static Ref before[SITES], ref[SITES];
+  uint32_t live = 0;
+
+  // Register the scopes, then take the starting point
+  for (uint8_t s = 1; s < SITES; s++) delete[] allocIn(s, 1);
+  uint32_t untracked = heapMonUntracked();
+  for (uint8_t s = 0; s < SITES; s++) {
+    const HeapSite* h = site(NAMES[s]);
+    TEST_ASSERT_NOT_NULL(h);
+    before[s] = { h->liveBytes, h->liveBlocks, h->allocs, h->bytes };
+    ref[s] = before[s];
+  }
+
+  srand(49);
+  for (uint32_t op = 0; op < OPS; op++) {
+    bool alloc = live == 0 || (live < MAX_LIVE && rand() % 2);
+    if (alloc) {
+      uint8_t s = rand() % SITES;
+      uint16_t n = 1 + rand() % 512;
+      blocks[live] = allocIn(s, n);
+      sizes[live] = n;
+      owner[live] = s;
+      live++;
+      ref[s].liveBytes += n;
+      ref[s].liveBlocks++;
+      ref[s].allocs++;
+      ref[s].bytes += n;
+    } else {
+      uint32_t i = rand() % live;
+      delete[] blocks[i];
+      ref[owner[i]].liveBytes -= sizes[i];
+      ref[owner[i]].liveBlocks--;
+      live--;
+      blocks[i] = blocks[live];
+      sizes[i] = sizes[live];
+      owner[i] = owner[live];
+    }
+
+    for (uint8_t s = 0; s < SITES; s++) {
+      const HeapSite* h = site(NAMES[s]);
+      if (h->liveBytes != ref[s].liveBytes || h->liveBlocks != ref[s].liveBlocks ||
+          h->allocs != ref[s].allocs || h->bytes != ref[s].bytes) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "op %lu site %s: live %ld/%ld blocks %lu/%lu",
+                 (unsigned long)op, NAMES[s], (long)h->liveBytes, (long)ref[s].liveBytes,
+                 (unsigned long)h->liveBlocks, (unsigned long)ref[s].liveBlocks);
+        TEST_FAIL_MESSAGE(msg);
+      }
+    }
+  }
+
+  while (live) delete[] blocks[--live];
+  for (uint8_t s = 0; s < SITES; s++) {
+    const HeapSite* h = site(NAMES[s]);
+    TEST_ASSERT_EQUAL_INT32(before[s].liveBytes, h->liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(before[s].liveBlocks, h->liveBlocks);
+  }
+  TEST_ASSERT_EQUAL_UINT32(untracked, heapMonUntracked());
+}
+
+// A failed allocation counts against the site and is not tracked
+void test_failed_allocation() {
+  uint32_t failed = site("(other)")->failed;
+  int32_t live = site("(other)")->liveBytes;
+  heapMonTraceAlloc(nullptr, 64);
+  TEST_ASSERT_EQUAL_UINT32(failed + 1, site("(other)")->failed);
+  TEST_ASSERT_EQUAL_INT32(live, site("(other)")->liveBytes);
+}
+
+// More live blocks than the table holds: the rest are counted as
+// untracked, frees of them return (before, a full table hung the
+// probe), and the table works again once blocks are freed.
+#define FAKE_BLOCKS (HEAPMON_TRACKED + 50)
+
+static void* fake(uint32_t i) {
+  return (void*)(uintptr_t)(0x40000000u + i * 16);   // never dereferenced
+}
+
+void test_table_overflow_is_counted_not_hung() {
+  const HeapSite* other = site("(other)");
+  int32_t live = other->liveBytes;
+  uint32_t blocks = other->liveBlocks;
+  uint32_t untracked = heapMonUntracked();
+
+  for (uint32_t i = 0; i < FAKE_BLOCKS; i++) heapMonTraceAlloc(fake(i), 8);
+  other = site("(other)");
+  uint32_t tracked = other->liveBlocks - blocks;
+  uint32_t over = heapMonUntracked() - untracked;
+  TEST_ASSERT_EQUAL_UINT32(FAKE_BLOCKS, tracked + over);
+  TEST_ASSERT_TRUE(tracked < HEAPMON_TRACKED);   // one slot always stays empty
+  TEST_ASSERT_TRUE(over > 0);
+
+  // A pointer the table never saw, with the table full
+  heapMonTraceFree(fake(FAKE_BLOCKS + 7));
+  TEST_ASSERT_EQUAL_UINT32(blocks + tracked, site("(other)")->liveBlocks);
+
+  for (uint32_t i = 0; i < FAKE_BLOCKS; i++) heapMonTraceFree(fake(i));
+  other = site("(other)");
+  TEST_ASSERT_EQUAL_INT32(live, other->liveBytes);
+  TEST_ASSERT_EQUAL_UINT32(blocks, other->liveBlocks);
+
+  // Room again: a new block is tracked, not counted as untracked
+  uint32_t before = heapMonUntracked();
+  heapMonTraceAlloc(fake(1), 24);
+  TEST_ASSERT_EQUAL_UINT32(before, heapMonUntracked());
+  TEST_ASSERT_EQUAL_INT32(live + 24, site("(other)")->liveBytes);
+  heapMonTraceFree(fake(1));
+  TEST_ASSERT_EQUAL_INT32(live, site("(other)")->liveBytes);
+}
+
+int main(int argc, char** argv) {
+  heapMonTraceBegin();
+  UNITY_BEGIN();
+  RUN_TEST(test_random_against_reference);
+  RUN_TEST(test_failed_allocation);
+  RUN_TEST(test_table_overflow_is_counted_not_hung);
+  return UNITY_END();
+}
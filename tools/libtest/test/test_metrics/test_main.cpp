@@ -0,0 +1,195 @@
+// Metrics and the Prometheus renderer: pio test -e native -f test_metrics
+#include <unity.h>
+
+#include <Metrics.h>
+
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Registered in this order, so rendered in this order
+MetricCounter requestsRoot("requests_total", "Requests by path", "path=\"/\"");
+MetricCounter requestsData("requests_total", "Requests by path", "path=\"/data\"");
+MetricGauge   temperature("temperature_celsius", "Last temperature");
+MetricCallback uptime("uptime_seconds", "Seconds since boot", METRIC_GAUGE,
+                      [] { return 12.5f; });
+static const uint32_t latencyBounds[] = { 1000, 2500, 10000 };
+MetricHistogram<3> latency("latency_seconds", "Handler time", latencyBounds, 1e-6f);
+MetricHistogram<3> labelled("queue_wait_seconds", "Wait", latencyBounds, 1e-6f, "q=\"a\"");
+
+// Hammered by the thread test only
+MetricCounter stressCount("stress_total", "Stress increments");
+static const uint32_t stressBounds[] = { 10, 100, 1000, 10000 };
+MetricHistogram<4> stressHist("stress_value", "Stress observations", stressBounds);
+
+class Capture : public Print {
+public:
+  std::string text;
+  size_t write(uint8_t c) override { text += (char)c; return 1; }
+  size_t write(const uint8_t* buf, size_t size) override {
+    text.append((const char*)buf, size);
+    return size;
+  }
+};
+
+// The block of lines from the "# HELP name" line up to the next family
+static std::string family(const std::string& all, const char* name) {
+  std::string head = std::string("# HELP ") + name + " ";
+  size_t at = all.find(head);
+  if (at == std::string::npos) return "";
+  size_t end = all.find("# HELP ", at + head.size());
+  return all.substr(at, end == std::string::npos ? std::string::npos : end - at);
+}
+
+static std::string render() {
+  Capture out;
+  metricsRender(out);
+  return out.text;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_counters_share_one_header() {
+  requestsRoot.inc();
+  requestsRoot.inc(2);
+  requestsData.inc();
+  TEST_ASSERT_EQUAL_UINT32(3, requestsRoot.value());
+  TEST_ASSERT_EQUAL_STRING(
+    "# HELP requests_total Requests by path\n"
+    "# TYPE requests_total counter\n"
+    "requests_total{path=\"/\"} 3\n"
+    "requests_total{path=\"/data\"} 1\n",
+    family(render(), "requests_total").c_str());
+}
+
+void test_gauge_nan_until_set() {
+  TEST_ASSERT_TRUE(isnan(temperature.value()));
+  std::string f = family(render(), "temperature_celsius");
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("# TYPE temperature_celsius gauge\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("temperature_celsius NaN\n"));
+
+  temperature.set(23.25f);
+  f = family(render(), "temperature_celsius");
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("temperature_celsius 23.25\n"));
+  temperature.set(-INFINITY);
+  f = family(render(), "temperature_celsius");
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("temperature_celsius -Inf\n"));
+}
+
+void test_callback_read_at_render() {
+  TEST_ASSERT_EQUAL_STRING(
+    "# HELP uptime_seconds Seconds since boot\n"
+    "# TYPE uptime_seconds gauge\n"
+    "uptime_seconds 12.5\n",
+    family(render(), "uptime_seconds").c_str());
+}
+
+// Buckets are cumulative, bounds scaled and trimmed, sum scaled
+void test_histogram_lines() {
+  latency.observe(400);      // le 0.001
+  latency.observe(1000);     // le 0.001: the bound is inclusive
+  latency.observe(1001);     // le 0.0025
+  latency.observe(9000);     // le 0.01
+  latency.observe(600000);   // +Inf
+  TEST_ASSERT_EQUAL_UINT32(5, latency.count());
+  TEST_ASSERT_EQUAL_STRING(
+    "# HELP latency_seconds Handler time\n"
+    "# TYPE latency_seconds histogram\n"
+    "latency_seconds_bucket{le=\"0.001\"} 2\n"
+    "latency_seconds_bucket{le=\"0.0025\"} 3\n"
+    "latency_seconds_bucket{le=\"0.01\"} 4\n"
+    "latency_seconds_bucket{le=\"+Inf\"} 5\n"
+    "latency_seconds_sum 0.611401\n"
+    "latency_seconds_count 5\n",
+    family(render(), "latency_seconds").c_str());
+}
+
+void test_histogram_labels_come_first() {
+  labelled.observe(50);
+  std::string f = family(render(), "queue_wait_seconds");
+  TEST_ASSERT_NOT_EQUAL(std::string::npos,
+                        f.find("queue_wait_seconds_bucket{q=\"a\",le=\"0.001\"} 1\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("queue_wait_seconds_sum{q=\"a\"} 0.00005\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, f.find("queue_wait_seconds_count{q=\"a\"} 1\n"));
+}
+
+// ---- Updates from several threads while scrapes run ----
+
+#define THREADS     4
+#define PER_THREAD  2000000UL   // increments and observations each
+#define MIN_SCRAPES 11000
+
+// Value on the sample line starting with key
+static unsigned long valueOf(const std::string& text, const char* key) {
+  size_t at = text.find(std::string("\n") + key);
+  if (at == std::string::npos) return (unsigned long)-1;
+  return strtoul(text.c_str() + at + 1 + strlen(key), nullptr, 10);
+}
+
+void test_scrapes_during_updates() {
+  std::atomic<int> running(THREADS);
+  std::vector<std::thread> writers;
+  for (int t = 0; t < THREADS; t++) {
+    writers.emplace_back([t, &running] {
+      uint32_t x = 12345 + t;
+      for (uint32_t i = 0; i < PER_THREAD; i++) {
+        x = x * 1103515245 + 12345;
+        stressCount.inc();
+        stressHist.observe((x >> 16) % 20000);
+      }
+      running--;
+    });
+  }
+
+  // Every scrape: buckets never go down, +Inf equals _count, and
+  // nothing is ever ahead of what the writers could have done
+  static const char* keys[] = {
+    "stress_value_bucket{le=\"10\"} ", "stress_value_bucket{le=\"100\"} ",
+    "stress_value_bucket{le=\"1000\"} ", "stress_value_bucket{le=\"10000\"} ",
+    "stress_value_bucket{le=\"+Inf\"} ",
+  };
+  unsigned long scrapes = 0, mismatched = 0, unordered = 0, lastCount = 0;
+  while (running > 0 || scrapes < MIN_SCRAPES) {
+    std::string text = render();
+    unsigned long prev = 0;
+    for (const char* k : keys) {
+      unsigned long v = valueOf(text, k);
+      if (v < prev || v > THREADS * PER_THREAD) unordered++;
+      prev = v;
+    }
+    unsigned long count = valueOf(text, "stress_value_count ");
+    if (count != prev) mismatched++;
+    if (count < lastCount) unordered++;
+    lastCount = count;
+    scrapes++;
+  }
+  for (auto& w : writers) w.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, mismatched);
+  TEST_ASSERT_EQUAL_UINT32(0, unordered);
+  TEST_ASSERT_TRUE(scrapes >= MIN_SCRAPES);
+
+  // Nothing lost once the writers are done
+  std::string text = render();
+  TEST_ASSERT_EQUAL_UINT32(THREADS * PER_THREAD, stressCount.value());
+  TEST_ASSERT_EQUAL_UINT32(THREADS * PER_THREAD, stressHist.count());
+  TEST_ASSERT_EQUAL_UINT32(THREADS * PER_THREAD, valueOf(text, "stress_total "));
+  TEST_ASSERT_EQUAL_UINT32(THREADS * PER_THREAD, valueOf(text, "stress_value_count "));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_counters_share_one_header);
+  RUN_TEST(test_gauge_nan_until_set);
+  RUN_TEST(test_callback_read_at_render);
+  RUN_TEST(test_histogram_lines);
+  RUN_TEST(test_histogram_labels_come_first);
+  RUN_TEST(test_scrapes_during_updates);
+  return UNITY_END();
+}
@@ -0,0 +1,220 @@
+// RingLog on the PC: pio test -e native -f test_ringlog
+#include <unity.h>
+
+#include <RingLog.h>
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Collects what the drain writes
+class Capture : public Print {
+public:
+  std::string text;
+  size_t write(uint8_t c) override { text += (char)c; return 1; }
+  size_t write(const uint8_t* buf, size_t size) override {
+    text.append((const char*)buf, size);
+    return size;
+  }
+};
+
+// Text after the "[    s.mmm] L " prefix of the first line
+static std::string body(const std::string& line) {
+  size_t at = line.find("] ");
+  size_t end = line.find('\n');
+  return at == std::string::npos ? line : line.substr(at + 4, end - at - 4);
+}
+
+void setUp() {
+  Capture discard;
+  ringLogDrain(discard);
+  ringLogResetStats();
+}
+
+void tearDown() {}
+
+void test_formats_by_stored_type() {
+  Capture out;
+  RLOG_I("t=%.1f n=%d u=%u x=%04x", 23.4f, -7, 40000u, 0xbeef);
+  TEST_ASSERT_EQUAL(1, ringLogDrain(out));
+  TEST_ASSERT_EQUAL_STRING("t=23.4 n=-7 u=40000 x=beef", body(out.text).c_str());
+
+  // A %d given a float prints the number, %f given an int too
+  out.text.clear();
+  RLOG_I("%d %.2f %%", 3.9f, 5);
+  ringLogDrain(out);
+  TEST_ASSERT_EQUAL_STRING("3 5.00 %", body(out.text).c_str());
+}
+
+// "[seconds.millis] level text", stamped at the call, not the drain
+void test_prefix_and_level() {
+  Capture out;
+  nativeAdvanceMicros(12345678);
+  uint32_t ms = micros() / 1000;
+  RLOG_W("late");
+  nativeAdvanceMicros(5000000);
+  ringLogDrain(out);
+  char expect[40];
+  snprintf(expect, sizeof(expect), "[%5lu.%03lu] W late\n",
+           (unsigned long)(ms / 1000), (unsigned long)(ms % 1000));
+  TEST_ASSERT_EQUAL_STRING(expect, out.text.c_str());
+}
+
+void test_missing_argument_printed_as_written() {
+  Capture out;
+  RLOG_I("a=%d b=%5.1f", 1);
+  ringLogDrain(out);
+  TEST_ASSERT_EQUAL_STRING("a=1 b=%5.1f", body(out.text).c_str());
+}
+
+// Strings are copied at the call, so the buffer can change after it
+void test_strings_copied() {
+  Capture out;
+  char buf[16];
+  strcpy(buf, "first");
+  RLOG_I("%s/%s", buf, "second");
+  strcpy(buf, "changed");
+  ringLogDrain(out);
+  TEST_ASSERT_EQUAL_STRING("first/second", body(out.text).c_str());
+}
+
+// Past RLOG_TEXT the rest is cut, a string with no room reads as ""
+void test_long_strings_cut() {
+  Capture out;
+  char big[RLOG_TEXT * 2];
+  memset(big, 'x', sizeof(big) - 1);
+  big[sizeof(big) - 1] = 0;
+  RLOG_I("[%s][%s]", big, "tail");
+  ringLogDrain(out);
+  std::string expect = "[" + std::string(RLOG_TEXT - 1, 'x') + "][]";
+  TEST_ASSERT_EQUAL_STRING(expect.c_str(), body(out.text).c_str());
+}
+
+void test_isr_entry() {
+  Capture out;
+  RLOG_ISR(RLOG_LEVEL_WARN, "tick %u late %u", 7, 250);
+  RLOG_ISR(RLOG_LEVEL_DEBUG, "compiled out %u %u", 1, 2);   // below RLOG_LEVEL
+  TEST_ASSERT_EQUAL(1, ringLogDrain(out));
+  TEST_ASSERT_EQUAL_STRING("tick 7 late 250", body(out.text).c_str());
+}
+
+// A full ring drops instead of blocking, and the drain says how many
+void test_full_ring_drops_and_reports() {
+  Capture out;
+  for (int i = 0; i < RLOG_SLOTS + 5; i++) RLOG_I("n %d", i);
+  RingLogStats s = ringLogStats();
+  TEST_ASSERT_EQUAL_UINT32(RLOG_SLOTS, s.written);
+  TEST_ASSERT_EQUAL_UINT32(5, s.dropped);
+  TEST_ASSERT_EQUAL_UINT32(RLOG_SLOTS, s.maxUsed);
+
+  TEST_ASSERT_EQUAL(RLOG_SLOTS, ringLogDrain(out));
+  TEST_ASSERT_EQUAL(0, out.text.find("[ringlog] 5 messages dropped\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, out.text.find(" I n 31\n"));
+  TEST_ASSERT_EQUAL(std::string::npos, out.text.find(" I n 32\n"));
+
+  // Reported once; logging works again once drained
+  out.text.clear();
+  RLOG_I("again");
+  ringLogDrain(out);
+  TEST_ASSERT_EQUAL(std::string::npos, out.text.find("dropped"));
+  TEST_ASSERT_EQUAL_STRING("again", body(out.text).c_str());
+}
+
+void test_drain_max() {
+  Capture out;
+  for (int i = 0; i < 5; i++) RLOG_I("m %d", i);
+  TEST_ASSERT_EQUAL(2, ringLogDrain(out, 2));
+  TEST_ASSERT_EQUAL(3, ringLogDrain(out));
+  TEST_ASSERT_EQUAL(0, ringLogDrain(out));
+}
+
+// ---- Many producers, one drainer ----
+
+#define PRODUCERS 4
+#define MESSAGES  2000000UL   // in total
+
+// Parses the drained text as it arrives: each line is "p <id> <n>
+// <id+n>" or a drop report. Per producer, n must only go up.
+class Checker : public Print {
+public:
+  uint32_t next[PRODUCERS] = {};
+  uint32_t delivered = 0, droppedReported = 0, garbled = 0, reordered = 0;
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override {
+    line.append((const char*)buf, size);
+    size_t nl;
+    while ((nl = line.find('\n')) != std::string::npos) {
+      check(line.substr(0, nl));
+      line.erase(0, nl + 1);
+    }
+    return size;
+  }
+
+private:
+  std::string line;
+
+  void check(const std::string& l) {
+    unsigned long dropped;
+    unsigned id, n, sum;
+    if (sscanf(l.c_str(), "[ringlog] %lu messages dropped", &dropped) == 1) {
+      droppedReported += dropped;
+      return;
+    }
+    size_t at = l.find("] I p ");
+    if (at == std::string::npos ||
+        sscanf(l.c_str() + at, "] I p %u %u %u", &id, &n, &sum) != 3 ||
+        id >= PRODUCERS || sum != id + n) {
+      garbled++;
+      return;
+    }
+    if (n < next[id]) reordered++;
+    next[id] = n + 1;
+    delivered++;
+  }
+};
+
+void test_producers_and_drainer() {
+  Checker check;
+  std::atomic<bool> producing(true);
+
+  std::thread drainer([&] {
+    while (producing) ringLogDrain(check);
+    ringLogDrain(check);
+  });
+  std::vector<std::thread> producers;
+  for (unsigned id = 0; id < PRODUCERS; id++) {
+    producers.emplace_back([id] {
+      for (unsigned n = 0; n < MESSAGES / PRODUCERS; n++) RLOG_I("p %u %u %u", id, n, id + n);
+    });
+  }
+  for (auto& t : producers) t.join();
+  producing = false;
+  drainer.join();
+  ringLogDrain(check);   // a final drop report, if any
+
+  RingLogStats s = ringLogStats();
+  TEST_ASSERT_EQUAL_UINT32(0, check.garbled);
+  TEST_ASSERT_EQUAL_UINT32(0, check.reordered);
+  TEST_ASSERT_EQUAL_UINT32(MESSAGES, check.delivered + s.dropped);
+  TEST_ASSERT_EQUAL_UINT32(s.written, check.delivered);
+  TEST_ASSERT_EQUAL_UINT32(s.dropped, check.droppedReported);
+  TEST_ASSERT_TRUE(check.delivered > 0);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_formats_by_stored_type);
+  RUN_TEST(test_prefix_and_level);
+  RUN_TEST(test_missing_argument_printed_as_written);
+  RUN_TEST(test_strings_copied);
+  RUN_TEST(test_long_strings_cut);
+  RUN_TEST(test_isr_entry);
+  RUN_TEST(test_full_ring_drops_and_reports);
+  RUN_TEST(test_drain_max);
+  RUN_TEST(test_producers_and_drainer);
+  return UNITY_END();
+}
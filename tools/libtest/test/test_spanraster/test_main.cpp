@@ -0,0 +1,184 @@
+// SpanRaster against the GFX calls it replaces, pixel for pixel:
+// pio test -e native -f test_spanraster
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Adafruit_SSD1306.h>
+#include <SpanRaster.h>
+
+#define W 128
+#define H 64
+
+// gfx draws through Adafruit GFX, span through SpanRaster
+static Adafruit_SSD1306 gfx(W, H);
+static Adafruit_SSD1306 span(W, H);
+static SpanRaster raster(span);
+
+static const uint16_t COLORS[] = { SSD1306_WHITE, SSD1306_BLACK, SSD1306_INVERSE };
+
+// Fixed-seed xorshift, the same cases on every run
+static uint32_t rng;
+
+static int16_t randRange(int16_t lo, int16_t hi) {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return lo + (int16_t)(rng % (uint32_t)(hi - lo + 1));
+}
+
+// Half-lit background, so BLACK and INVERSE have something to change
+static void startFrame() {
+  gfx.clearDisplay();
+  span.clearDisplay();
+  for (int16_t i = 0; i < W * H / 8; i++) {
+    uint8_t b = (uint8_t)randRange(0, 255);
+    gfx.getBuffer()[i] = b;
+    span.getBuffer()[i] = b;
+  }
+}
+
+static void assertSameFrame(const char* what) {
+  if (memcmp(gfx.getBuffer(), span.getBuffer(), W * H / 8) == 0) return;
+
+  char msg[128];
+  for (int16_t y = 0; y < H; y++) {
+    for (int16_t x = 0; x < W; x++) {
+      if (gfx.getPixel(x, y) != span.getPixel(x, y)) {
+        snprintf(msg, sizeof(msg), "%s: first difference at (%d, %d)", what, x, y);
+        TEST_FAIL_MESSAGE(msg);
+      }
+    }
+  }
+}
+
+void setUp() {
+  rng = 0x2545F491;
+  gfx.setRotation(0);
+  span.setRotation(0);
+}
+
+void tearDown() {}
+
+void test_hlines() {
+  char what[96];
+  for (int i = 0; i < 2000; i++) {
+    startFrame();
+    int16_t x = randRange(-20, W + 10), y = randRange(-4, H + 3), w = randRange(-5, W + 20);
+    uint16_t c = COLORS[i % 3];
+    gfx.drawFastHLine(x, y, w, c);
+    raster.drawFastHLine(x, y, w, c);
+    snprintf(what, sizeof(what), "hline(%d, %d, %d, %u)", x, y, w, c);
+    assertSameFrame(what);
+  }
+}
+
+void test_vlines() {
+  char what[96];
+  for (int i = 0; i < 2000; i++) {
+    startFrame();
+    int16_t x = randRange(-4, W + 3), y = randRange(-20, H + 10), h = randRange(-5, H + 20);
+    uint16_t c = COLORS[i % 3];
+    gfx.drawFastVLine(x, y, h, c);
+    raster.drawFastVLine(x, y, h, c);
+    snprintf(what, sizeof(what), "vline(%d, %d, %d, %u)", x, y, h, c);
+    assertSameFrame(what);
+  }
+}
+
+// Every octant, single points, and ends off the panel
+void test_lines() {
+  char what[96];
+  for (int i = 0; i < 5000; i++) {
+    startFrame();
+    int16_t x0 = randRange(-40, W + 40), y0 = randRange(-40, H + 40);
+    int16_t x1 = randRange(-40, W + 40), y1 = randRange(-40, H + 40);
+    if (i % 10 == 0) x1 = x0;
+    if (i % 10 == 1) y1 = y0;
+    if (i % 10 == 2) { x1 = x0; y1 = y0; }
+    uint16_t c = COLORS[i % 3];
+    gfx.drawLine(x0, y0, x1, y1, c);
+    raster.drawLine(x0, y0, x1, y1, c);
+    snprintf(what, sizeof(what), "line(%d, %d, %d, %d, %u)", x0, y0, x1, y1, c);
+    assertSameFrame(what);
+  }
+}
+
+// The sketches' panel border, and the corners INVERSE draws twice
+void test_rects() {
+  startFrame();
+  gfx.drawRect(0, 0, W, H, SSD1306_WHITE);
+  raster.drawRect(0, 0, W, H, SSD1306_WHITE);
+  assertSameFrame("border");
+
+  char what[96];
+  for (int i = 0; i < 3000; i++) {
+    startFrame();
+    int16_t x = randRange(-20, W + 5), y = randRange(-20, H + 5);
+    int16_t w = randRange(0, W + 20), h = randRange(0, H + 20);
+    uint16_t c = COLORS[i % 3];
+    gfx.drawRect(x, y, w, h, c);
+    raster.drawRect(x, y, w, h, c);
+    snprintf(what, sizeof(what), "rect(%d, %d, %d, %d, %u)", x, y, w, h, c);
+    assertSameFrame(what);
+  }
+}
+
+void test_fill_rects() {
+  char what[96];
+  for (int i = 0; i < 3000; i++) {
+    startFrame();
+    int16_t x = randRange(-20, W + 5), y = randRange(-20, H + 5);
+    int16_t w = randRange(0, W + 20), h = randRange(0, H + 20);
+    uint16_t c = COLORS[i % 3];
+    gfx.fillRect(x, y, w, h, c);
+    raster.fillRect(x, y, w, h, c);
+    snprintf(what, sizeof(what), "fillRect(%d, %d, %d, %d, %u)", x, y, w, h, c);
+    assertSameFrame(what);
+  }
+}
+
+void test_fill_screen() {
+  for (uint8_t i = 0; i < 3; i++) {
+    startFrame();
+    gfx.fillScreen(COLORS[i]);
+    raster.fillScreen(COLORS[i]);
+    assertSameFrame("fillScreen");
+  }
+}
+
+// Rotated panels go through GFX, so still the same pixels
+void test_rotated_falls_back() {
+  char what[96];
+  for (uint8_t r = 1; r < 4; r++) {
+    gfx.setRotation(r);
+    span.setRotation(r);
+    for (int i = 0; i < 200; i++) {
+      startFrame();
+      int16_t x0 = randRange(-10, W), y0 = randRange(-10, W);
+      int16_t x1 = randRange(-10, W), y1 = randRange(-10, W);
+      gfx.drawLine(x0, y0, x1, y1, SSD1306_INVERSE);
+      raster.drawLine(x0, y0, x1, y1, SSD1306_INVERSE);
+      gfx.fillRect(x0, y0, 20, 9, SSD1306_WHITE);
+      raster.fillRect(x0, y0, 20, 9, SSD1306_WHITE);
+      snprintf(what, sizeof(what), "rotation %u, line(%d, %d, %d, %d)", r, x0, y0, x1, y1);
+      assertSameFrame(what);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  gfx.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  span.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_hlines);
+  RUN_TEST(test_vlines);
+  RUN_TEST(test_lines);
+  RUN_TEST(test_rects);
+  RUN_TEST(test_fill_rects);
+  RUN_TEST(test_fill_screen);
+  RUN_TEST(test_rotated_falls_back);
+  return UNITY_END();
+}
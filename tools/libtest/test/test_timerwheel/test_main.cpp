@@ -0,0 +1,305 @@
+// TimerWheel on a simulated tick: pio test -e native -f test_timerwheel
+#include <unity.h>
+
+#include <TimerWheel.h>
+
+#define SPAN (1UL << (TimerWheel::LEVELS * TimerWheel::BITS))   // 2^24 ticks
+
+static TimerWheel* wheel;
+
+// Ticks a timer fired at, as seen from its callback
+struct Fired {
+  uint32_t at[8];
+  uint8_t  count;
+};
+
+static void record(void* arg) {
+  Fired& f = *(Fired*)arg;
+  if (f.count < 8) f.at[f.count] = wheel->now();
+  f.count++;
+}
+
+// Runs ticks and the deferred callbacks after each, like the dispatch task
+static void run(uint32_t ticks) {
+  while (ticks--) {
+    wheel->tick();
+    wheel->runDeferred();
+  }
+}
+
+void setUp() {
+  wheel = new TimerWheel();
+}
+
+void tearDown() {
+  delete wheel;
+}
+
+// Delays on both sides of each level boundary fire on their tick exactly
+void test_cascade_across_levels() {
+  static const uint32_t delays[] = {
+    1, 2, 63, 64, 65, 127, 4095, 4096, 4097, 262143, 262144, 262145, SPAN - 1
+  };
+  const uint8_t n = sizeof(delays) / sizeof(delays[0]);
+  static SoftTimer timers[n];
+  static Fired fired[n];
+
+  run(37);   // not aligned to a slot boundary
+  uint32_t start = wheel->now();
+  for (uint8_t i = 0; i < n; i++) {
+    timers[i] = SoftTimer();
+    fired[i] = Fired();
+    wheel->start(timers[i], delays[i], 0, record, &fired[i], TIMER_IN_TICK);
+  }
+
+  run(SPAN + 10);
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_MESSAGE(1, fired[i].count, "fired once");
+    TEST_ASSERT_EQUAL_UINT32(start + delays[i], fired[i].at[0]);
+    TEST_ASSERT_FALSE(wheel->active(timers[i]));
+  }
+  TEST_ASSERT_TRUE(wheel->stats().cascaded > 0);
+}
+
+// Past the top level the timer is parked and placed again on each pass
+void test_long_delays_wrap_the_top_level() {
+  static SoftTimer a, b;
+  static Fired fa, fb;
+  a = SoftTimer(); b = SoftTimer();
+  fa = Fired(); fb = Fired();
+
+  run(5);
+  uint32_t start = wheel->now();
+  wheel->start(a, SPAN, 0, record, &fa, TIMER_IN_TICK);
+  wheel->start(b, 2 * SPAN + 12345, 0, record, &fb, TIMER_IN_TICK);
+
+  run(SPAN - 1);
+  TEST_ASSERT_EQUAL(0, fa.count);
+  run(1);
+  TEST_ASSERT_EQUAL(1, fa.count);
+  TEST_ASSERT_EQUAL_UINT32(start + SPAN, fa.at[0]);
+
+  run(SPAN + 12344);
+  TEST_ASSERT_EQUAL(0, fb.count);
+  run(1);
+  TEST_ASSERT_EQUAL(1, fb.count);
+  TEST_ASSERT_EQUAL_UINT32(start + 2 * SPAN + 12345, fb.at[0]);
+}
+
+// Re-armed from the due tick: no drift over many periods, even when late
+void test_periodic_does_not_drift() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  wheel->start(t, 3, 70, record, &f, TIMER_IN_TICK);
+  uint32_t start = wheel->now();
+  run(3 + 70 * 7);
+  TEST_ASSERT_EQUAL(8, f.count);
+  for (uint8_t i = 0; i < 8; i++) TEST_ASSERT_EQUAL_UINT32(start + 3 + 70 * i, f.at[i]);
+  TEST_ASSERT_TRUE(wheel->active(t));
+}
+
+void test_zero_delay_is_next_tick() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  uint32_t start = wheel->now();
+  wheel->start(t, 0, 0, record, &f, TIMER_IN_TICK);
+  run(1);
+  TEST_ASSERT_EQUAL(1, f.count);
+  TEST_ASSERT_EQUAL_UINT32(start + 1, f.at[0]);
+}
+
+// ---- Callbacks that change the wheel while it fires ----
+
+static SoftTimer victim;
+static Fired     victimFired;
+
+static void cancelVictim(void* arg) {
+  wheel->cancel(victim);
+  record(arg);
+}
+
+// Both due on one tick: whichever runs first, the cancelled one must not fire
+void test_cancel_inside_callback_same_tick() {
+  static SoftTimer killer;
+  static Fired killerFired;
+  killer = SoftTimer(); victim = SoftTimer();
+  killerFired = Fired(); victimFired = Fired();
+
+  // The slot list is LIFO: the victim, added first, fires after the killer
+  wheel->start(victim, 10, 0, record, &victimFired, TIMER_IN_TICK);
+  wheel->start(killer, 10, 0, cancelVictim, &killerFired, TIMER_IN_TICK);
+  run(20);
+  TEST_ASSERT_EQUAL(1, killerFired.count);
+  TEST_ASSERT_EQUAL(0, victimFired.count);
+  TEST_ASSERT_FALSE(wheel->active(victim));
+}
+
+void test_cancel_inside_callback_deferred() {
+  static SoftTimer killer;
+  static Fired killerFired;
+  killer = SoftTimer(); victim = SoftTimer();
+  killerFired = Fired(); victimFired = Fired();
+
+  wheel->start(killer, 10, 0, cancelVictim, &killerFired, TIMER_IN_TICK);
+  wheel->start(victim, 10, 5, record, &victimFired, TIMER_DEFERRED);
+  run(40);
+  TEST_ASSERT_EQUAL(1, killerFired.count);
+  TEST_ASSERT_EQUAL(0, victimFired.count);   // ready entry dropped by generation
+}
+
+static SoftTimer self;
+static Fired     selfFired;
+
+// First run moves itself to a new schedule, the period is replaced
+static void rearmSelf(void* arg) {
+  record(arg);
+  if (selfFired.count == 1) wheel->start(self, 100, 0, rearmSelf, arg, TIMER_IN_TICK);
+}
+
+void test_rearm_inside_callback() {
+  self = SoftTimer(); selfFired = Fired();
+
+  uint32_t start = wheel->now();
+  wheel->start(self, 5, 7, rearmSelf, &selfFired, TIMER_IN_TICK);
+  run(200);
+  TEST_ASSERT_EQUAL(2, selfFired.count);
+  TEST_ASSERT_EQUAL_UINT32(start + 5, selfFired.at[0]);
+  TEST_ASSERT_EQUAL_UINT32(start + 105, selfFired.at[1]);
+  TEST_ASSERT_FALSE(wheel->active(self));
+}
+
+static void cancelSelf(void* arg) {
+  record(arg);
+  if (selfFired.count == 3) wheel->cancel(self);
+}
+
+void test_periodic_cancels_itself() {
+  self = SoftTimer(); selfFired = Fired();
+
+  wheel->start(self, 1, 1, cancelSelf, &selfFired, TIMER_DEFERRED);
+  run(50);
+  TEST_ASSERT_EQUAL(3, selfFired.count);
+  TEST_ASSERT_FALSE(wheel->active(self));
+}
+
+// ---- Generations: stale ready entries ----
+
+// Fired but not yet run, then cancelled: the callback never runs
+void test_stale_entry_after_cancel_is_dropped() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  wheel->start(t, 2, 0, record, &f, TIMER_DEFERRED);
+  wheel->tick();
+  TEST_ASSERT_TRUE(wheel->tick());   // ready
+  wheel->cancel(t);
+  TEST_ASSERT_NULL(wheel->popReady());
+  TEST_ASSERT_EQUAL(0, f.count);
+  TEST_ASSERT_EQUAL(0, wheel->stats().readyDepth);
+}
+
+// Restarted while its old run waits: that run is dropped, the new
+// schedule fires once at its own tick
+void test_restart_drops_queued_run() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  wheel->start(t, 1, 0, record, &f, TIMER_DEFERRED);
+  wheel->tick();                        // queued
+  uint32_t restartAt = wheel->now();
+  wheel->start(t, 3, 0, record, &f, TIMER_DEFERRED);
+  TEST_ASSERT_EQUAL(0, wheel->runDeferred());
+
+  run(3);
+  TEST_ASSERT_EQUAL(1, f.count);
+  TEST_ASSERT_EQUAL_UINT32(restartAt + 3, f.at[0]);
+  TEST_ASSERT_EQUAL(0, wheel->stats().overruns);
+}
+
+// Restarted and fired again before the task ran: the queued entry
+// is taken over, one run, no overrun
+void test_restart_while_queued() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  wheel->start(t, 1, 0, record, &f, TIMER_DEFERRED);
+  wheel->tick();                        // queued with the old generation
+  wheel->start(t, 1, 0, record, &f, TIMER_DEFERRED);
+  wheel->tick();                        // fires again: takes over the queued entry
+  TEST_ASSERT_EQUAL(1, wheel->runDeferred());
+  TEST_ASSERT_EQUAL(1, f.count);
+  TEST_ASSERT_EQUAL(0, wheel->stats().overruns);
+}
+
+// A deferred periodic that fires again before it ran counts an overrun
+void test_overrun_counted_not_queued_twice() {
+  static SoftTimer t;
+  static Fired f;
+  t = SoftTimer(); f = Fired();
+
+  wheel->start(t, 1, 1, record, &f, TIMER_DEFERRED);
+  for (int i = 0; i < 5; i++) wheel->tick();
+  TEST_ASSERT_EQUAL(1, wheel->stats().readyDepth);
+  TEST_ASSERT_EQUAL_UINT32(4, t.overruns);
+  TEST_ASSERT_EQUAL_UINT32(4, wheel->stats().overruns);
+  TEST_ASSERT_EQUAL(1, wheel->runDeferred());
+  TEST_ASSERT_EQUAL(0, wheel->stats().readyDepth);
+}
+
+// tick() reports waiting deferred work, in-tick timers never leave any
+void test_tick_reports_ready() {
+  static SoftTimer inTick, deferred;
+  static Fired f;
+  inTick = SoftTimer(); deferred = SoftTimer(); f = Fired();
+
+  wheel->start(inTick, 1, 0, record, &f, TIMER_IN_TICK);
+  wheel->start(deferred, 2, 0, record, &f, TIMER_DEFERRED);
+  TEST_ASSERT_FALSE(wheel->tick());
+  TEST_ASSERT_TRUE(wheel->tick());
+  TEST_ASSERT_TRUE(wheel->tick());      // still waiting
+  wheel->runDeferred();
+  TEST_ASSERT_FALSE(wheel->tick());
+  TEST_ASSERT_EQUAL(2, f.count);
+}
+
+// Many timers on one slot, started and cancelled in any order
+void test_many_timers_one_slot() {
+  static SoftTimer t[100];
+  static Fired f[100];
+  for (int i = 0; i < 100; i++) {
+    t[i] = SoftTimer();
+    f[i] = Fired();
+    wheel->start(t[i], 300, 0, record, &f[i], TIMER_IN_TICK);
+  }
+  for (int i = 0; i < 100; i += 3) wheel->cancel(t[i]);
+
+  run(300);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL(i % 3 ? 1 : 0, f[i].count);
+  TEST_ASSERT_EQUAL(66, wheel->stats().maxPerTick);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_cascade_across_levels);
+  RUN_TEST(test_long_delays_wrap_the_top_level);
+  RUN_TEST(test_periodic_does_not_drift);
+  RUN_TEST(test_zero_delay_is_next_tick);
+  RUN_TEST(test_cancel_inside_callback_same_tick);
+  RUN_TEST(test_cancel_inside_callback_deferred);
+  RUN_TEST(test_rearm_inside_callback);
+  RUN_TEST(test_periodic_cancels_itself);
+  RUN_TEST(test_stale_entry_after_cancel_is_dropped);
+  RUN_TEST(test_restart_drops_queued_run);
+  RUN_TEST(test_restart_while_queued);
+  RUN_TEST(test_overrun_counted_not_queued_twice);
+  RUN_TEST(test_tick_reports_ready);
+  RUN_TEST(test_many_timers_one_slot);
+  return UNITY_END();
+}
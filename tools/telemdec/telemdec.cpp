@@ -0,0 +1,404 @@
+/****************************************************
+ * telemdec
+ * Decodes the binary telemetry stream (lib/Telemetry) on
+ * a Linux PC into CSV or JSON lines.
+ *
+ *   g++ -O2 -I lib/Telemetry -o telemdec \
+ *       tools/telemdec/telemdec.cpp lib/Telemetry/TelemetryCodec.cpp
+ *
+ *   ./telemdec /dev/ttyUSB0 > samples.csv        # 115200 raw
+ *   ./telemdec --json --text capture.bin         # file or stdin
+ *   ./telemdec --bench 1000000                   # throughput
+ *
+ * CSV has the samples only, one header line per schema;
+ * events and profiler records go to stderr. JSON has one
+ * object per record. --text copies whatever was not a
+ * frame (Serial.print lines in mixed mode) to stderr.
+ * Counters (frames, CRC errors, lost) are printed at the
+ * end or on Ctrl-C.
+ ****************************************************/
+#include "TelemetryCodec.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_STREAMS 16
+
+struct Field {
+  char   name[24];
+  char   unit[12];
+  int8_t exp10;
+};
+
+struct Schema {
+  bool    known;
+  uint8_t count;
+  Field   fields[TELEM_MAX_FIELDS];
+};
+
+static Schema   s_schemas[MAX_STREAMS];
+static int      s_headerStream = -1;   // CSV header currently in effect
+static bool     s_headerLabelled = false;
+static bool     s_json = false;
+static bool     s_text = false;
+static uint64_t s_bytesIn = 0;
+static volatile sig_atomic_t s_stop = 0;
+
+static double nowSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ---- Output ----
+
+static void printValue(FILE* out, int16_t raw, int8_t exp10) {
+  if (exp10 >= 0) {
+    long v = raw;
+    for (int8_t i = 0; i < exp10; i++) v *= 10;
+    fprintf(out, "%ld", v);
+  } else {
+    fprintf(out, "%.*f", -exp10, raw * pow(10.0, exp10));
+  }
+}
+
+// Copies a string field out of a body, false if it runs off the end
+static bool takeString(const uint8_t*& p, const uint8_t* end, char* dst, size_t size) {
+  const uint8_t* z = (const uint8_t*)memchr(p, 0, end - p);
+  if (!z) return false;
+  size_t len = z - p;
+  if (len >= size) len = size - 1;
+  memcpy(dst, p, len);
+  dst[len] = 0;
+  p = z + 1;
+  return true;
+}
+
+static void jsonString(FILE* out, const char* s, size_t len) {
+  fputc('"', out);
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = s[i];
+    if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+    else if (c < 0x20)         fprintf(out, "\\u%04x", c);
+    else                       fputc(c, out);
+  }
+  fputc('"', out);
+}
+
+static void onSchema(const TelemetryFrame& f, FILE* out) {
+  if (f.bodyLen < 2 || f.body[0] >= MAX_STREAMS) return;
+  Schema& s = s_schemas[f.body[0]];
+  Schema next = {};
+  next.count = f.body[1];
+  if (next.count > TELEM_MAX_FIELDS) return;
+
+  const uint8_t* p = f.body + 2;
+  const uint8_t* end = f.body + f.bodyLen;
+  for (uint8_t i = 0; i < next.count; i++) {
+    if (p >= end) return;
+    next.fields[i].exp10 = (int8_t)*p++;
+    if (!takeString(p, end, next.fields[i].name, sizeof(next.fields[i].name)) ||
+        !takeString(p, end, next.fields[i].unit, sizeof(next.fields[i].unit))) return;
+  }
+  next.known = true;
+
+  // Resent schemas are the norm, only a change needs a new header
+  if (memcmp(&next, &s, sizeof(s)) != 0) {
+    s = next;
+    if (s_headerStream == f.body[0]) s_headerStream = -1;
+  }
+  if (s_json) {
+    fprintf(out, "{\"type\":\"schema\",\"ms\":%u,\"stream\":%u,\"fields\":[",
+            (unsigned)f.ms, f.body[0]);
+    for (uint8_t i = 0; i < s.count; i++) {
+      fprintf(out, "%s{\"name\":\"%s\",\"unit\":\"%s\",\"exp10\":%d}", i ? "," : "",
+              s.fields[i].name, s.fields[i].unit, s.fields[i].exp10);
+    }
+    fprintf(out, "]}\n");
+  }
+}
+
+static void onSample(const TelemetryFrame& f, FILE* out) {
+  if (f.bodyLen < 1) return;
+  uint8_t stream = f.body[0];
+  uint8_t n = (f.bodyLen - 1) / 2;
+  const Schema* s = stream < MAX_STREAMS && s_schemas[stream].known &&
+                    s_schemas[stream].count == n ? &s_schemas[stream] : nullptr;
+
+  if (s_json) {
+    fprintf(out, "{\"type\":\"sample\",\"ms\":%u,\"seq\":%u,\"stream\":%u",
+            (unsigned)f.ms, f.seq, stream);
+    for (uint8_t i = 0; i < n; i++) {
+      int16_t raw = (int16_t)telemGet16(f.body + 1 + 2 * i);
+      if (s) fprintf(out, ",\"%s\":", s->fields[i].name);
+      else   fprintf(out, ",\"v%u\":", i);
+      printValue(out, raw, s ? s->fields[i].exp10 : 0);
+    }
+    fprintf(out, "}\n");
+    return;
+  }
+
+  // New stream, or the schema for unlabelled columns showed up
+  if (s_headerStream != stream || (s && !s_headerLabelled)) {
+    fprintf(out, "ms,seq,stream");
+    for (uint8_t i = 0; i < n; i++) {
+      if (!s)                      fprintf(out, ",v%u", i);
+      else if (s->fields[i].unit[0]) fprintf(out, ",%s_%s", s->fields[i].name, s->fields[i].unit);
+      else                         fprintf(out, ",%s", s->fields[i].name);
+    }
+    fputc('\n', out);
+    s_headerStream = stream;
+    s_headerLabelled = s != nullptr;
+  }
+
+  fprintf(out, "%u,%u,%u", (unsigned)f.ms, f.seq, stream);
+  for (uint8_t i = 0; i < n; i++) {
+    fputc(',', out);
+    printValue(out, (int16_t)telemGet16(f.body + 1 + 2 * i), s ? s->fields[i].exp10 : 0);
+  }
+  fputc('\n', out);
+}
+
+static void onEvent(const TelemetryFrame& f, FILE* out) {
+  if (f.bodyLen < 1) return;
+  const char* text = (const char*)f.body + 1;
+  size_t len = f.bodyLen - 1;
+  if (s_json) {
+    fprintf(out, "{\"type\":\"event\",\"ms\":%u,\"seq\":%u,\"code\":%u,\"text\":",
+            (unsigned)f.ms, f.seq, f.body[0]);
+    jsonString(out, text, len);
+    fprintf(out, "}\n");
+  } else {
+    fprintf(stderr, "event %u ms code %u: %.*s\n", (unsigned)f.ms, f.body[0], (int)len, text);
+  }
+}
+
+static void onProfile(const TelemetryFrame& f, FILE* out) {
+  const uint8_t* p = f.body;
+  const uint8_t* end = f.body + f.bodyLen;
+  char name[32];
+  if (!takeString(p, end, name, sizeof(name)) || end - p < 16) return;
+
+  uint32_t count = telemGet32(p), minUs = telemGet32(p + 4);
+  uint32_t avgUs = telemGet32(p + 8), maxUs = telemGet32(p + 12);
+  if (s_json) {
+    fprintf(out, "{\"type\":\"profile\",\"ms\":%u,\"seq\":%u,\"name\":", (unsigned)f.ms, f.seq);
+    jsonString(out, name, strlen(name));
+    fprintf(out, ",\"count\":%u,\"min_us\":%u,\"avg_us\":%u,\"max_us\":%u}\n",
+            count, minUs, avgUs, maxUs);
+  } else {
+    fprintf(stderr, "profile %u ms %-14s count %u min %u avg %u max %u us\n",
+            (unsigned)f.ms, name, count, minUs, avgUs, maxUs);
+  }
+}
+
+static void onFrame(const TelemetryFrame& f, FILE* out) {
+  switch (f.type) {
+    case TELEM_SAMPLE:  onSample(f, out);  break;
+    case TELEM_SCHEMA:  onSchema(f, out);  break;
+    case TELEM_EVENT:   onEvent(f, out);   break;
+    case TELEM_PROFILE: onProfile(f, out); break;
+    default:            break;  // newer sender, skip
+  }
+}
+
+static void decode(TelemetryReader& reader, const uint8_t* data, size_t len, FILE* out) {
+  TelemetryFrame f;
+  for (size_t i = 0; i < len; i++) {
+    if (reader.feed(data[i], f)) {
+      onFrame(f, out);
+    } else if (s_text) {
+      size_t n;
+      const uint8_t* text = reader.rejected(n);
+      while (n && (text[n - 1] == '\n' || text[n - 1] == '\r')) n--;
+      while (n && (text[0] == '\n' || text[0] == '\r')) { text++; n--; }
+      if (n) fprintf(stderr, "%.*s\n", (int)n, (const char*)text);
+    }
+  }
+  s_bytesIn += len;
+}
+
+static void printStats(const TelemetryReader& reader, double seconds) {
+  const TelemetryReaderStats& s = reader.stats();
+  fprintf(stderr, "frames %u  crc errors %u  too long %u  lost %u  bytes %llu",
+          s.frames, s.crcErrors, s.tooLong, s.lost, (unsigned long long)s_bytesIn);
+  if (seconds > 0) fprintf(stderr, "  %.2f s", seconds);
+  fputc('\n', stderr);
+}
+
+// ---- Serial port ----
+
+static speed_t baudConstant(long baud) {
+  switch (baud) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    default:      return 0;
+  }
+}
+
+static bool makeRaw(int fd, long baud) {
+  termios t;
+  if (tcgetattr(fd, &t) != 0) return false;
+  cfmakeraw(&t);
+  speed_t speed = baudConstant(baud);
+  if (!speed) {
+    fprintf(stderr, "unsupported baud rate %ld\n", baud);
+    return false;
+  }
+  cfsetispeed(&t, speed);
+  cfsetospeed(&t, speed);
+  t.c_cflag |= CLOCAL | CREAD;
+  t.c_cc[VMIN] = 1;
+  t.c_cc[VTIME] = 0;
+  return tcsetattr(fd, TCSANOW, &t) == 0;
+}
+
+// ---- Benchmark ----
+
+// Same layout TelemetryWriter produces, without the Arduino side
+static size_t buildSample(uint8_t seq, uint32_t ms, const int16_t* v, uint8_t n, uint8_t* out) {
+  uint8_t payload[TELEM_MAX_PAYLOAD];
+  payload[0] = TELEM_SAMPLE;
+  payload[1] = seq;
+  telemPut32(payload + 2, ms);
+  payload[6] = 0;
+  for (uint8_t i = 0; i < n; i++) telemPut16(payload + 7 + 2 * i, (uint16_t)v[i]);
+  size_t len = 7 + 2 * n;
+  telemPut16(payload + len, telemCrc16(payload, len));
+  size_t w = cobsEncode(payload, len + 2, out);
+  out[w++] = 0;
+  return w;
+}
+
+static int bench(long count) {
+  // The LDR_DHT sketch's sample: temp, humidity, light adc, mV
+  size_t cap = (size_t)count * 24 + 256;   // a 4 value sample is 19 bytes
+  uint8_t* stream = (uint8_t*)malloc(cap);
+  if (!stream) return 1;
+
+  size_t len = 0;
+  static const uint8_t schema[] = {
+    TELEM_SCHEMA, 0, 0, 0, 0, 0, 0, 4,
+    0xFE, 't', 'e', 'm', 'p', 0, 'C', 0,
+    0xFE, 'h', 'u', 'm', 0, '%', 0,
+    0, 'l', 'i', 'g', 'h', 't', 0, 'a', 'd', 'c', 0,
+    0xFD, 'v', 'o', 'l', 't', 0, 'V', 0,
+  };
+  uint8_t payload[sizeof(schema) + 2];
+  memcpy(payload, schema, sizeof(schema));
+  telemPut16(payload + sizeof(schema), telemCrc16(schema, sizeof(schema)));
+  len += cobsEncode(payload, sizeof(payload), stream + len);
+  stream[len++] = 0;
+
+  srand(1);
+  for (long i = 0; i < count; i++) {
+    int16_t v[4] = { (int16_t)(2000 + rand() % 1000), (int16_t)(3000 + rand() % 4000),
+                     (int16_t)(rand() % 4096), (int16_t)(rand() % 3300) };
+    len += buildSample((uint8_t)(i + 1), 2000 * i, v, 4, stream + len);
+  }
+
+  // The text line the sketch prints for the same sample
+  char line[128];
+  int textLen = snprintf(line, sizeof(line),
+                         "Temperature: %.2f \xC2\xB0""C  |  Humidity: %.2f %%  |  Light ADC: %d  |  Voltage: %.2f V\r\n",
+                         23.15, 45.00, 1234, 0.99);
+  double frameLen = (double)(len - (sizeof(payload) + 2)) / count;
+  printf("wire bytes per sample: text %d, binary %.0f (%.0f %% less, %.2f ms vs %.2f ms at 115200)\n",
+         textLen, frameLen, 100.0 * (1 - frameLen / textLen), textLen * 10 / 115.2, frameLen * 10 / 115.2);
+
+  FILE* devnull = fopen("/dev/null", "w");
+  for (int pass = 0; pass < 3; pass++) {
+    TelemetryReader reader;
+    s_json = pass == 2;
+    s_headerStream = -1;
+    memset(s_schemas, 0, sizeof(s_schemas));
+    const char* what[] = { "frames only", "to CSV", "to JSON" };
+
+    double t0 = nowSeconds();
+    if (pass == 0) {
+      TelemetryFrame f;
+      for (size_t i = 0; i < len; i++) reader.feed(stream[i], f);
+    } else {
+      decode(reader, stream, len, devnull);
+    }
+    double dt = nowSeconds() - t0;
+
+    printf("%-12s %8.1f MB/s  %6.2f M frames/s  (%u frames, %u bad)\n", what[pass],
+           len / dt / 1e6, reader.stats().frames / dt / 1e6,
+           reader.stats().frames, reader.stats().crcErrors);
+  }
+  fclose(devnull);
+  free(stream);
+  return 0;
+}
+
+// ---- Main ----
+
+static void onSignal(int) {
+  s_stop = 1;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: telemdec [--json] [--text] [--baud N] [file|tty]   (stdin if none)\n"
+          "       telemdec --bench N\n");
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  long baud = 115200;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--json"))                     s_json = true;
+    else if (!strcmp(argv[i], "--text"))                s_text = true;
+    else if (!strcmp(argv[i], "--baud") && i + 1 < argc) baud = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--bench") && i + 1 < argc) return bench(atol(argv[++i]));
+    else if (argv[i][0] == '-' && argv[i][1])           { usage(); return 2; }
+    else                                                path = argv[i];
+  }
+
+  int fd = 0;
+  if (path && strcmp(path, "-") != 0) {
+    fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+      fprintf(stderr, "%s: %s\n", path, strerror(errno));
+      return 1;
+    }
+  }
+  if (isatty(fd) && !makeRaw(fd, baud)) return 1;
+
+  // A live port never ends: flush per read and stop cleanly on Ctrl-C
+  struct sigaction sa = {};
+  sa.sa_handler = onSignal;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  bool live = isatty(fd);
+
+  TelemetryReader reader;
+  uint8_t buf[65536];
+  double t0 = nowSeconds();
+  while (!s_stop) {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    decode(reader, buf, n, stdout);
+    if (live) fflush(stdout);
+  }
+  fflush(stdout);
+  printStats(reader, nowSeconds() - t0);
+  return 0;
+}
@@ -0,0 +1,178 @@
+"""
+embed.py - a project's data/ directory as gzip arrays in flash
+
+    python3 tools/webassets/embed.py PROJECT_DIR       # by hand
+    extra_scripts = pre:../tools/webassets/embed.py    # platformio.ini
+
+Every file in PROJECT_DIR/data is minified (HTML, CSS, JS),
+gzipped and written to PROJECT_DIR/include/WebAssetData.h as
+a constexpr byte array plus a WEB_ASSETS[] table for
+lib/WebAssets: path, Content-Type, size and an ETag (hash of
+the minified text, so it only changes when the page does).
+
+data/index.html is served as "/". HTML is revalidated on
+every load (no-cache + ETag, a 304 when unchanged); the
+other files are cached for a year, which is safe because
+their references in the HTML are rewritten to
+"name?v=<etag>": a new build is a new URL.
+
+The minifiers are deliberately simple: comments and
+indentation go, nothing is renamed. JS keeps its line
+breaks, so a missing semicolon can't join two statements.
+The header is only rewritten when its content changes, so
+an unchanged data/ doesn't rebuild the sketch.
+"""
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+TYPES = {
+    ".html": "text/html",
+    ".css":  "text/css",
+    ".js":   "application/javascript",
+    ".json": "application/json",
+    ".svg":  "image/svg+xml",
+    ".ico":  "image/x-icon",
+    ".png":  "image/png",
+}
+
+
+def minify_css(s):
+    s = re.sub(r"/\*.*?\*/", "", s, flags=re.S)
+    s = re.sub(r"\s+", " ", s)
+    s = re.sub(r"\s*([{}:;,>])\s*", r"\1", s)
+    return s.replace(";}", "}").strip()
+
+
+def minify_js(s):
+    out = []
+    for line in s.splitlines():
+        line = line.strip()
+        if line and not line.startswith("//"):
+            out.append(line)
+    return "\n".join(out)
+
+
+def minify_html(s):
+    # <script> and <style> bodies get their own minifier
+    parts = re.split(r"(<script[^>]*>.*?</script>|<style[^>]*>.*?</style>)", s, flags=re.S | re.I)
+    out = []
+    for part in parts:
+        m = re.match(r"(<(script|style)[^>]*>)(.*?)(</\2>)", part, flags=re.S | re.I)
+        if m:
+            body = minify_js(m.group(3)) if m.group(2).lower() == "script" else minify_css(m.group(3))
+            out.append(m.group(1) + body + m.group(4))
+        else:
+            part = re.sub(r"<!--.*?-->", "", part, flags=re.S)
+            part = re.sub(r">\s*\n\s*<", "><", part)   # indentation, not "</b> <span>"
+            part = re.sub(r"\s+", " ", part)
+            part = re.sub(r"(?<=>)\s+$", "", part)   # next to a <script>/<style>
+            part = re.sub(r"^\s+(?=<)", "", part)
+            out.append(part)
+    return "".join(out).strip()
+
+
+MINIFY = {".html": minify_html, ".css": minify_css, ".js": minify_js}
+
+
+def c_name(name):
+    return "WEB_" + re.sub(r"[^0-9A-Za-z]", "_", name)
+
+
+def load(data_dir):
+    assets = []
+    for name in sorted(os.listdir(data_dir)):
+        path = os.path.join(data_dir, name)
+        if not os.path.isfile(path) or name.startswith("."):
+            continue
+        ext = os.path.splitext(name)[1].lower()
+        with open(path, "rb") as f:
+            raw = f.read()
+        body = raw
+        if ext in MINIFY:
+            body = MINIFY[ext](raw.decode("utf-8")).encode("utf-8")
+        assets.append({
+            "name": name,
+            "ext": ext,
+            "raw": len(raw),
+            "body": body,
+            "etag": hashlib.sha1(body).hexdigest()[:12],
+        })
+
+    # Versioned URLs for everything an HTML page references
+    by_name = {a["name"]: a for a in assets}
+    for a in assets:
+        if a["ext"] != ".html":
+            continue
+        text = a["body"].decode("utf-8")
+        for ref, other in by_name.items():
+            if other["ext"] != ".html":
+                text = re.sub(r'(["\'/])%s(["\'])' % re.escape(ref),
+                              r"\g<1>%s?v=%s\g<2>" % (ref, other["etag"]), text)
+        a["body"] = text.encode("utf-8")
+        a["etag"] = hashlib.sha1(a["body"]).hexdigest()[:12]
+
+    for a in assets:
+        a["gz"] = gzip.compress(a["body"], 9, mtime=0)
+    return assets
+
+
+def render(assets):
+    lines = [
+        "// Generated by tools/webassets/embed.py from data/, do not edit.",
+        "#pragma once",
+        "",
+        "#include <WebAssets.h>",
+        "",
+    ]
+    for a in assets:
+        lines.append("// %s: %d bytes, %d minified, %d gzipped"
+                     % (a["name"], a["raw"], len(a["body"]), len(a["gz"])))
+        lines.append("constexpr uint8_t %s[] = {" % c_name(a["name"]))
+        gz = a["gz"]
+        for i in range(0, len(gz), 16):
+            lines.append("  " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("constexpr WebAsset WEB_ASSETS[] = {")
+    for a in assets:
+        path = "/" if a["name"] == "index.html" else "/" + a["name"]
+        lines.append('  { "%s", "%s", %s, sizeof(%s), "\\"%s\\"", %s },'
+                     % (path, TYPES.get(a["ext"], "application/octet-stream"),
+                        c_name(a["name"]), c_name(a["name"]), a["etag"],
+                        "false" if a["ext"] == ".html" else "true"))
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def embed(project_dir):
+    data_dir = os.path.join(project_dir, "data")
+    if not os.path.isdir(data_dir):
+        return
+    assets = load(data_dir)
+    out_path = os.path.join(project_dir, "include", "WebAssetData.h")
+    text = render(assets)
+
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            old = f.read()
+    if old != text:
+        with open(out_path, "w") as f:
+            f.write(text)
+
+    for a in assets:
+        print("web: %-12s %6d -> %6d minified -> %6d gzip"
+              % (a["name"], a["raw"], len(a["body"]), len(a["gz"])))
+
+
+if "Import" in globals():   # run by PlatformIO as an extra script
+    Import("env")  # noqa: F821
+    embed(env.subst("$PROJECT_DIR"))  # noqa: F821
+elif __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: embed.py PROJECT_DIR")
+    embed(sys.argv[1])